@@ -33,25 +33,21 @@ namespace BobTests
         }
 
 
-        // 1 = reset to GCHeap
-        // 2 = push new arena allocator
-        // 3 = push GCHeap
-        // 4 = pop
         static void AllocReset()
         {
-            GC.AddMemoryPressure(1);
+            GC.ResetArenas();
         }
         static void AllocPushNew()
         {
-            GC.AddMemoryPressure(2);
+            GC.PushNewArena();
         }
         static void AllocPushGCHeap()
         {
-            GC.AddMemoryPressure(3);
+            GC.PushGCHeap();
         }
         static void AllocPop()
         {
-            GC.AddMemoryPressure(4);
+            GC.PopArena();
         }
     }
 }
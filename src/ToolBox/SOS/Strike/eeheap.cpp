@@ -1911,3 +1911,168 @@ DWORD_PTR PrintModuleHeapInfo(__out_ecount(count) DWORD_PTR *moduleList, int cou
 
     return toReturn;
 }
+
+/**********************************************************************\
+* Routine Description:                                                 *
+*                                                                      *
+*    ArenaInfo reads the arena directory out of the target process and  *
+*    walks the buffers and objects of individual arenas.               *
+*                                                                      *
+\**********************************************************************/
+ArenaInfo::ArenaInfo()
+    : mDirectory(NULL), mBufferTable(NULL)
+{
+}
+
+ArenaInfo::~ArenaInfo()
+{
+    if (mDirectory)
+        delete mDirectory;
+
+    if (mBufferTable)
+        delete [] mBufferTable;
+}
+
+BOOL ArenaInfo::Init()
+{
+    mDirectory = new (std::nothrow) ArenaDirectory;
+    if (mDirectory == NULL)
+    {
+        ReportOOM();
+        return FALSE;
+    }
+
+    if (!SafeReadMemory(TO_TADDR(ARENA_DIRECTORY_ADDRESS), mDirectory, sizeof(ArenaDirectory), NULL))
+        return FALSE;
+
+    if (mDirectory->m_signature != ARENA_DIRECTORY_SIGNATURE)
+        return FALSE;
+
+    if (mDirectory->m_version != ARENA_DIRECTORY_VERSION)
+    {
+        ExtErr("Arena directory version %d is not supported by this SOS (expected %d)\n",
+            mDirectory->m_version, ARENA_DIRECTORY_VERSION);
+        return FALSE;
+    }
+
+    // The buffer table is indexed by slot from the start of the arena range; only
+    // slots below m_nextSlot have ever been handed out.
+    LONG slots = mDirectory->m_nextSlot;
+    if (slots <= 0 || (ULONG64)slots * sizeof(short) > ARENA_DIRECTORY_OFFSET)
+    {
+        ExtErr("Arena directory is corrupt (next slot %d)\n", slots);
+        return FALSE;
+    }
+
+    mBufferTable = new (std::nothrow) short[slots];
+    if (mBufferTable == NULL)
+    {
+        ReportOOM();
+        return FALSE;
+    }
+
+    if (!SafeReadMemory(TO_TADDR(ARENA_RANGE_BASE), mBufferTable, (ULONG)(slots * sizeof(short)), NULL))
+    {
+        ExtErr("Unable to read the arena buffer table at %p\n", (ULONG64)ARENA_RANGE_BASE);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+int ArenaInfo::GetArenaId(TADDR addr) const
+{
+    if (!IsArenaAddress(addr))
+        return -1;
+
+    LONG slot = AddressToSlot(addr);
+    if (slot < mDirectory->m_firstSlot || slot >= mDirectory->m_nextSlot)
+        return -1;
+
+    short id = mBufferTable[slot];
+    if (id < 0 || GetArena(id) == 0)
+        return -1;
+
+    return id;
+}
+
+void ArenaInfo::WalkBuffers(int id, BufferCallback callback, void *token) const
+{
+    LONG slot = mDirectory->m_firstSlot;
+    while (slot < mDirectory->m_nextSlot)
+    {
+        if (mBufferTable[slot] != id)
+        {
+            slot++;
+            continue;
+        }
+
+        LONG end = slot + 1;
+        while (end < mDirectory->m_nextSlot && mBufferTable[end] == id)
+            end++;
+
+        callback(SlotToAddress(slot), SlotToAddress(end), token);
+        slot = end;
+    }
+}
+
+struct ArenaObjectWalkArgs
+{
+    ArenaInfo::ObjectCallback Callback;
+    void *Token;
+};
+
+static void WalkArenaBufferObjects(TADDR start, TADDR end, void *token)
+{
+    ArenaObjectWalkArgs *args = (ArenaObjectWalkArgs *)token;
+    LinearReadCache cache;
+
+    size_t objSize = 0;
+    for (TADDR taddrObj = start; taddrObj < end; taddrObj += objSize)
+    {
+        if (IsInterrupt())
+            return;
+
+        // Anything that doesn't turn out to be an object is skipped one word at a time.
+        objSize = sizeof(TADDR);
+
+        TADDR taddrMT;
+        if (!cache.Read(taddrObj, &taddrMT))
+        {
+            // Guard region at the end of a buffer (or the uncommitted tail of a
+            // large buffer): resume at the start of the next buffer slot.
+            TADDR next = (TADDR)(ARENA_RANGE_BASE +
+                (((ULONG64)taddrObj - ARENA_RANGE_BASE) / ARENA_BUFFER_RESERVE_SIZE + 1) * ARENA_BUFFER_RESERVE_SIZE);
+            objSize = next - taddrObj;
+            continue;
+        }
+
+        taddrMT &= ~3;
+
+        // MethodTables never live in the arena range, which rules out the pointers
+        // in the arena's own bookkeeping without asking the DAC.
+        if (taddrMT == 0 || ArenaInfo::IsArenaAddress(taddrMT) || !IsMethodTable(taddrMT))
+            continue;
+
+        // Past an object whose size can't be worked out there is no telling where
+        // the next one starts, so the rest of the buffer is not walked.
+        size_t size;
+        BOOL bContainsPointers;
+        if (!GetSizeEfficient(taddrObj, taddrMT, FALSE, size, bContainsPointers) ||
+            size == 0 || taddrObj + size > end)
+        {
+            ExtOut("Bad object %p in arena buffer %p-%p, skipping the rest of the buffer\n",
+                SOS_PTR(taddrObj), SOS_PTR(start), SOS_PTR(end));
+            return;
+        }
+
+        args->Callback(taddrObj, taddrMT, size, args->Token);
+        objSize = Align(size);
+    }
+}
+
+void ArenaInfo::WalkObjects(int id, ObjectCallback callback, void *token) const
+{
+    ArenaObjectWalkArgs args = { callback, token };
+    WalkBuffers(id, WalkArenaBufferObjects, &args);
+}
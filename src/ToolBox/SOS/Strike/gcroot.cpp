@@ -1317,16 +1317,22 @@ void PrintNotReachableInRange(TADDR rngStart, TADDR rngEnd, BOOL bExcludeReadyFo
 #define card_word_width ((size_t)32)
 
 // 
-// The value of card_size is determined empirically according to the average size of an object
-// In the code we also rely on the assumption that one card_table entry (DWORD) covers an entire os page
+// The write barriers dirty a byte of the card table per (1 << card_byte_shift) bytes of
+// heap, so a card is an eighth of that. This mirrors GC_CARD_BYTE_SHIFT in gc.h, builds
+// that lower it (CLR_GC_CARD_BYTE_SHIFT) define it for SOS as well.
 //
-#if defined (_TARGET_AMD64_)
-#define card_size ((size_t)(2*DT_OS_PAGE_SIZE/card_word_width))
+#ifndef GC_CARD_BYTE_SHIFT
+#if defined (_TARGET_WIN64_)
+#define GC_CARD_BYTE_SHIFT  11
 #else
-#define card_size ((size_t)(DT_OS_PAGE_SIZE/card_word_width))
-#endif //_TARGET_AMD64_
+#define GC_CARD_BYTE_SHIFT  10
+#endif // _TARGET_WIN64_
+#endif // GC_CARD_BYTE_SHIFT
+
+#define card_byte_shift     GC_CARD_BYTE_SHIFT
+#define card_size ((size_t)1 << (card_byte_shift - 3))
 
-// so card_size = 128 on x86, 256 on x64
+// so card_size = 128 on 32-bit, 256 on 64-bit by default
 
 inline
 size_t card_word (size_t card)
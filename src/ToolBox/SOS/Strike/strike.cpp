@@ -1506,6 +1506,16 @@ HRESULT PrintObj(TADDR taObj, BOOL bPrintFields = TRUE)
     DWORD_PTR size = (DWORD_PTR)objData.Size;
     ExtOut("Size:        %" POINTERSIZE_TYPE "d(0x%" POINTERSIZE_TYPE "x) bytes\n", size, size);
 
+    if (ArenaInfo::IsArenaAddress(taObj))
+    {
+        ArenaInfo arenas;
+        int arenaId = arenas.Init() ? arenas.GetArenaId(taObj) : -1;
+        if (arenaId >= 0)
+            DMLOut("Arena:       %d (%s)\n", arenaId, DMLDumpArena(arenas.GetArena(arenaId)));
+        else
+            ExtOut("Arena:       <unknown>\n");
+    }
+
     if (_wcscmp(obj.GetTypeName(), W("System.RuntimeType")) == 0)
     {
         PrintRuntimeTypeInfo(taObj, objData);
@@ -4116,6 +4126,239 @@ DECLARE_API(DumpHeap)
     }
 }
 
+struct ArenaTotals
+{
+    size_t Buffers;
+    size_t Objects;
+    size_t Size;
+    HeapStat *Stats;
+};
+
+static void CountArenaBuffer(TADDR start, TADDR end, void *token)
+{
+    ArenaTotals *totals = (ArenaTotals *)token;
+    totals->Buffers += (end - start) / ARENA_BUFFER_RESERVE_SIZE;
+}
+
+static void AddArenaObject(TADDR obj, TADDR mt, size_t size, void *token)
+{
+    ArenaTotals *totals = (ArenaTotals *)token;
+    totals->Objects++;
+    totals->Size += size;
+
+    if (totals->Stats)
+        totals->Stats->Add((DWORD_PTR)mt, (DWORD)size);
+}
+
+static void PrintArenaBuffer(TADDR start, TADDR end, void *token)
+{
+    ArenaTotals *totals = (ArenaTotals *)token;
+    totals->Buffers += (end - start) / ARENA_BUFFER_RESERVE_SIZE;
+
+    ExtOut("%p  %p  %8" POINTERSIZE_TYPE "u\n", SOS_PTR(start), SOS_PTR(end), (size_t)((end - start) / ARENA_BUFFER_RESERVE_SIZE));
+}
+
+/**********************************************************************\
+* Routine Description:                                                 *
+*                                                                      *
+*    This function lists the live arenas with the number of buffers    *  
+*    and objects in each.  Arena memory is not part of the GC heap, so *
+*    none of it shows up in !DumpHeap.                                 *
+*                                                                      *
+\**********************************************************************/
+DECLARE_API(Arenas)
+{
+    INIT_API();
+    MINIDUMP_NOT_SUPPORTED();
+
+    BOOL bShort = FALSE;
+    BOOL dml = FALSE;
+
+    CMDOption option[] = 
+    {   // name, vptr, type, hasValue
+        {"-short", &bShort, COBOOL, FALSE},
+#ifndef FEATURE_PAL
+        {"/d", &dml, COBOOL, FALSE},
+#endif
+    };
+    if (!GetCMDOption(args, option, _countof(option), NULL, 0, NULL))
+    {
+        return Status;
+    }
+
+    EnableDMLHolder dmlHolder(dml);
+    ArenaInfo arenas;
+    if (!arenas.Init())
+    {
+        ExtOut("No arenas found\n");
+        return Status;
+    }
+
+    if (bShort)
+        ExtOut("%6s %" POINTERSIZE "s %8s %8s\n", "Id", "Arena", "RefCount", "Buffers");
+    else
+        ExtOut("%6s %" POINTERSIZE "s %8s %8s %8s %12s\n", "Id", "Arena", "RefCount", "Buffers", "Objects", "Size");
+
+    size_t count = 0;
+    ArenaTotals all = { 0, 0, 0, NULL };
+    for (int id = 0; id < ARENA_DIRECTORY_MAX_ARENAS && !IsInterrupt(); id++)
+    {
+        TADDR arena = arenas.GetArena(id);
+        if (arena == 0)
+            continue;
+
+        ArenaTotals totals = { 0, 0, 0, NULL };
+        arenas.WalkBuffers(id, CountArenaBuffer, &totals);
+
+        if (bShort)
+        {
+            DMLOut("%6d %s %8d %8" POINTERSIZE_TYPE "u\n", id, DMLDumpArena(arena), arenas.GetRefCount(id), totals.Buffers);
+        }
+        else
+        {
+            arenas.WalkObjects(id, AddArenaObject, &totals);
+            DMLOut("%6d %s %8d %8" POINTERSIZE_TYPE "u %8" POINTERSIZE_TYPE "u %12" POINTERSIZE_TYPE "u\n", id, DMLDumpArena(arena), arenas.GetRefCount(id),
+                totals.Buffers, totals.Objects, totals.Size);
+        }
+
+        count++;
+        all.Buffers += totals.Buffers;
+        all.Objects += totals.Objects;
+        all.Size += totals.Size;
+    }
+
+    if (bShort)
+        ExtOut("Total %" POINTERSIZE_TYPE "u arenas, %" POINTERSIZE_TYPE "u buffers\n", count, all.Buffers);
+    else
+        ExtOut("Total %" POINTERSIZE_TYPE "u arenas, %" POINTERSIZE_TYPE "u buffers, %" POINTERSIZE_TYPE "u objects, %" POINTERSIZE_TYPE "u bytes\n",
+            count, all.Buffers, all.Objects, all.Size);
+
+    return Status;
+}
+
+/**********************************************************************\
+* Routine Description:                                                 *
+*                                                                      *
+*    This function dumps the objects allocated in one arena, given     *  
+*    either its id or the address of its Arena object, followed by a   *
+*    histogram of the types found.                                     *
+*                                                                      *
+\**********************************************************************/
+DECLARE_API(DumpArena)
+{
+    INIT_API();
+    MINIDUMP_NOT_SUPPORTED();
+
+    BOOL bStat = FALSE;
+    BOOL bBuffers = FALSE;
+    BOOL dml = FALSE;
+    StringHolder arenaExpr;
+    size_t nArg;
+
+    CMDOption option[] = 
+    {   // name, vptr, type, hasValue
+        {"-stat", &bStat, COBOOL, FALSE},
+        {"-buffers", &bBuffers, COBOOL, FALSE},
+#ifndef FEATURE_PAL
+        {"/d", &dml, COBOOL, FALSE},
+#endif
+    };
+    CMDValue arg[] = 
+    {   // vptr, type
+        {&arenaExpr.data, COSTRING}
+    };
+    if (!GetCMDOption(args, option, _countof(option), arg, _countof(arg), &nArg))
+    {
+        return Status;
+    }
+    if (nArg != 1)
+    {
+        ExtOut("Usage: !DumpArena [-stat] [-buffers] <arena id | arena address>\n");
+        return Status;
+    }
+
+    EnableDMLHolder dmlHolder(dml);
+    ArenaInfo arenas;
+    if (!arenas.Init())
+    {
+        ExtOut("No arenas found\n");
+        return Status;
+    }
+
+    // Anything that evaluates to an address in the arena range is taken as the arena
+    // (or an object in it); anything else is a decimal arena id.
+    int id = -1;
+    TADDR addr = TO_TADDR(GetExpression(arenaExpr.data));
+    if (ArenaInfo::IsArenaAddress(addr))
+    {
+        id = arenas.GetArenaId(addr);
+    }
+    else
+    {
+        char *pEnd;
+        ULONG value = strtoul(arenaExpr.data, &pEnd, 10);
+        if (pEnd == arenaExpr.data || *pEnd != '\0' || value >= ARENA_DIRECTORY_MAX_ARENAS)
+        {
+            ExtOut("Invalid arena id or address %s\n", arenaExpr.data);
+            ExtOut("Usage: !DumpArena [-stat] [-buffers] <arena id | arena address>\n");
+            return Status;
+        }
+        id = (int)value;
+    }
+
+    TADDR arena = arenas.GetArena(id);
+    if (arena == 0)
+    {
+        ExtOut("%s is not a live arena\n", arenaExpr.data);
+        return Status;
+    }
+
+    ExtOut("Arena:       %d\n", id);
+    ExtOut("Address:     %p\n", SOS_PTR(arena));
+    ExtOut("RefCount:    %d\n", arenas.GetRefCount(id));
+
+    ArenaTotals totals = { 0, 0, 0, NULL };
+    if (bBuffers)
+    {
+        ExtOut("%" POINTERSIZE "s  %" POINTERSIZE "s  %8s\n", "Start", "End", "Slots");
+        arenas.WalkBuffers(id, PrintArenaBuffer, &totals);
+    }
+    else
+    {
+        arenas.WalkBuffers(id, CountArenaBuffer, &totals);
+    }
+    ExtOut("Buffers:     %" POINTERSIZE_TYPE "u\n", totals.Buffers);
+
+    HeapStat stats;
+    totals.Stats = &stats;
+
+    if (!bStat)
+        ExtOut("%" POINTERSIZE "s %" POINTERSIZE "s %8s\n", "Address", "MT", "Size");
+
+    struct ObjectPrinter
+    {
+        static void Print(TADDR obj, TADDR mt, size_t size, void *token)
+        {
+            AddArenaObject(obj, mt, size, token);
+            DMLOut("%s %s %8" POINTERSIZE_TYPE "u\n", DMLObject(obj), DMLDumpHeapMT(mt), size);
+        }
+    };
+    arenas.WalkObjects(id, bStat ? AddArenaObject : ObjectPrinter::Print, &totals);
+
+    if (IsInterrupt())
+    {
+        ExtOut("Interrupted, data may be incomplete.\n");
+        return Status;
+    }
+
+    ExtOut("\n");
+    stats.Sort();
+    stats.Print();
+    ExtOut("Total %" POINTERSIZE_TYPE "u bytes in %" POINTERSIZE_TYPE "u buffers\n", totals.Size, totals.Buffers);
+
+    return Status;
+}
+
 DECLARE_API(VerifyHeap)
 {    
     INIT_API();
@@ -4183,7 +4426,8 @@ enum oom_reason
     oom_cant_reserve = 3,
     oom_loh = 4,
     oom_low_mem = 5,
-    oom_unproductive_full_gc = 6
+    oom_unproductive_full_gc = 6,
+    oom_commit_hard_limit = 7
 };
 
 static const char *const str_oom[] = 
@@ -4194,7 +4438,8 @@ static const char *const str_oom[] =
     "This is likely to be a bug in GC", // oom_cant_reserve 
     "Didn't have enough memory to allocate an LOH segment", // oom_loh 
     "Low on memory during GC", // oom_low_mem 
-    "Could not do a full GC" // oom_unproductive_full_gc
+    "Could not do a full GC", // oom_unproductive_full_gc
+    "Would exceed the hard limit of the GC heap" // oom_commit_hard_limit
 };
 
 static const char *const str_fgm[] = 
@@ -9536,6 +9781,55 @@ DECLARE_API(PathTo)
 
 
 
+struct ArenaReferrerArgs
+{
+    TADDR Target;
+    size_t Count;
+};
+
+static void PrintArenaReferrer(TADDR obj, TADDR mt, size_t size, void *token)
+{
+    ArenaReferrerArgs *args = (ArenaReferrerArgs *)token;
+
+    try
+    {
+        for (sos::RefIterator itr(obj); itr; ++itr)
+        {
+            if (*itr == args->Target)
+            {
+                sos::Object referrer = obj;
+                DMLOut("    %s %S\n", DMLObject(obj), referrer.GetTypeName());
+                args->Count++;
+                break;
+            }
+        }
+    }
+    catch (const sos::Exception &)
+    {
+        // Not an object after all; the arena walk is heuristic.
+    }
+}
+
+static void PrintArenaReferrers(TADDR obj)
+{
+    ArenaInfo arenas;
+    int id = arenas.Init() ? arenas.GetArenaId(obj) : -1;
+    if (id < 0)
+    {
+        ExtOut("%p is in the arena range but not in a live arena.\n\n", SOS_PTR(obj));
+        return;
+    }
+
+    DMLOut("%p is allocated in arena %d (%s), which is referenced %d times from arena stacks.\n",
+        SOS_PTR(obj), id, DMLDumpArena(arenas.GetArena(id)), arenas.GetRefCount(id));
+    ExtOut("It stays alive until the arena is released, regardless of GC roots.\n");
+
+    ArenaReferrerArgs referrers = { obj, 0 };
+    ExtOut("Referenced from objects in the same arena:\n");
+    arenas.WalkObjects(id, PrintArenaReferrer, &referrers);
+    ExtOut("Found %" POINTERSIZE_TYPE "u arena referrers.\n\n", referrers.Count);
+}
+
 /**********************************************************************\
 * Routine Description:                                                 *
 *                                                                      *
@@ -9578,6 +9872,13 @@ DECLARE_API(GCRoot)
     }
 
     EnableDMLHolder dmlHolder(dml);      
+
+    // Objects in an arena are kept alive by the arena itself, not by the GC.  Report
+    // the arena and the arena objects referring to the target, then look for GC roots
+    // as usual (which only finds references from the GC heap, stacks and handles).
+    if (ArenaInfo::IsArenaAddress(TO_TADDR(obj)))
+        PrintArenaReferrers(TO_TADDR(obj));
+
     GCRootImpl gcroot;
     int i = gcroot.PrintRootsForObject(obj, all == TRUE, bNoStacks == TRUE);
     
@@ -5408,6 +5408,7 @@ const char * const DMLFormats[] =
     "<exec cmd=\"!DumpRCW /d %s\">%s</exec>",       // DML_RCWrapper
     "<exec cmd=\"!DumpCCW /d %s\">%s</exec>",       // DML_CCWrapper
     "<exec cmd=\"!ClrStack -i %S %d\">%S</exec>",   // DML_ManagedVar
+    "<exec cmd=\"!DumpArena /d %s\">%s</exec>",     // DML_DumpArena
 };
 
 void ConvertToLower(__out_ecount(len) char *buffer, size_t len)
@@ -177,6 +177,7 @@ extern IXCLRDataProcess *g_clrData;
 extern ISOSDacInterface *g_sos;
 
 #include "dacprivate.h"
+#include "arenadirectory.h"
 
 interface ICorDebugProcess;
 extern ICorDebugProcess * g_pCorDebugProcess;
@@ -339,6 +340,7 @@ namespace Output
         DML_RCWrapper,
         DML_CCWrapper,
         DML_ManagedVar,
+        DML_DumpArena,
     };
 
     /**********************************************************************\
@@ -427,6 +429,7 @@ inline void ExtOutIndent()  { WhitespaceOut(Output::g_Indent << 2); }
 // DML Generation Methods
 #define DMLListNearObj(addr) Output::BuildHexValue(addr, Output::DML_ListNearObj).GetPtr()
 #define DMLDumpHeapMT(addr) Output::BuildHexValue(addr, Output::DML_DumpHeapMT).GetPtr()
+#define DMLDumpArena(addr) Output::BuildHexValue(addr, Output::DML_DumpArena).GetPtr()
 #define DMLMethodTable(addr) Output::BuildHexValue(addr, Output::DML_MethodTable).GetPtr()
 #define DMLMethodDesc(addr) Output::BuildHexValue(addr, Output::DML_MethodDesc).GetPtr()
 #define DMLClass(addr) Output::BuildHexValue(addr, Output::DML_EEClass).GetPtr()
@@ -2006,6 +2009,67 @@ size_t NextOSPageAddress (size_t addr);
 BOOL GetSizeEfficient(DWORD_PTR dwAddrCurrObj, 
     DWORD_PTR dwAddrMethTable, BOOL bLarge, size_t& s, BOOL& bContainsPointers);
 
+/* Enumerates arenas and the objects allocated in them.  Arena memory is not
+ * part of the GC heap; everything is found through the ArenaDirectory and
+ * buffer table the runtime keeps at a fixed address (see arenadirectory.h).
+ */
+class ArenaInfo
+{
+public:
+    typedef void (*BufferCallback)(TADDR start, TADDR end, void *token);
+    typedef void (*ObjectCallback)(TADDR obj, TADDR mt, size_t size, void *token);
+
+    ArenaInfo();
+    ~ArenaInfo();
+
+    /* Reads the arena directory and buffer table out of the target.
+     * Returns FALSE if the target process has no arenas.
+     */
+    BOOL Init();
+
+    static BOOL IsArenaAddress(TADDR addr)
+    {
+        return (addr >> ARENA_ADDRESS_SHIFT) == 1;
+    }
+
+    /* Returns the id of the arena owning the buffer addr is in, -1 if none. */
+    int GetArenaId(TADDR addr) const;
+
+    /* Returns the address of the Arena object, 0 if the id is not in use. */
+    TADDR GetArena(int id) const
+    {
+        return (id >= 0 && id < ARENA_DIRECTORY_MAX_ARENAS) ? TO_TADDR(mDirectory->m_arenaById[id]) : 0;
+    }
+
+    LONG GetRefCount(int id) const
+    {
+        return mDirectory->m_refCount[id];
+    }
+
+    /* Calls callback for each run of consecutive buffer slots owned by an arena. */
+    void WalkBuffers(int id, BufferCallback callback, void *token) const;
+
+    /* Calls callback for each object found in the buffers of an arena.  The walk
+     * skips words that don't look like a MethodTable, since arena buffers also hold
+     * the arena's own bookkeeping (the Arena object, buffer list and caches).
+     */
+    void WalkObjects(int id, ObjectCallback callback, void *token) const;
+
+private:
+    TADDR SlotToAddress(LONG slot) const
+    {
+        return (TADDR)(ARENA_RANGE_BASE + (ULONG64)slot * ARENA_BUFFER_RESERVE_SIZE);
+    }
+
+    LONG AddressToSlot(TADDR addr) const
+    {
+        return (LONG)(((ULONG64)addr - ARENA_RANGE_BASE) / ARENA_BUFFER_RESERVE_SIZE);
+    }
+
+    ArenaDirectory *mDirectory;
+    short *mBufferTable;
+};
+
 // ObjSize now uses the methodtable cache for its work too.
 size_t ObjectSize (DWORD_PTR obj, BOOL fIsLargeObject=FALSE);
 size_t ObjectSize(DWORD_PTR obj, DWORD_PTR mt, BOOL fIsValueClass, BOOL fIsLargeObject=FALSE);
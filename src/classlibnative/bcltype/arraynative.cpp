@@ -16,6 +16,7 @@
 #include "field.h"
 #include "security.h"
 #include "invokeutil.h"
+#include "../../gc/Arena.h"
 
 FCIMPL1(INT32, ArrayNative::GetRank, ArrayBase* array)
 {
@@ -986,6 +987,46 @@ void ArrayNative::ArrayCopyNoTypeCheck(BASEARRAYREF pSrc, unsigned int srcIndex,
     }
 }
 
+// Copies elements between arrays in different heaps (the GC heap and an arena, or two
+// different arenas).  References cannot simply be copied, so every element is marshaled
+// into the destination's heap.  The elements are marshaled in batches rather than
+// through SetObjectReference one at a time.  Marshaling into the GC heap allocates, so
+// the arrays are passed by protected reference and never by element address.
+void ArrayNative::ArrayMarshalNoTypeCheck(BASEARRAYREF pSrc, unsigned int srcIndex, BASEARRAYREF pDest, unsigned int destIndex, unsigned int length)
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_TRIGGERS;
+        MODE_COOPERATIVE;
+        SO_TOLERANT;
+        PRECONDITION(pSrc != NULL);
+        PRECONDITION(srcIndex >= 0);
+        PRECONDITION(pDest != NULL);
+        PRECONDITION(length > 0);
+        PRECONDITION(pSrc != pDest);
+    }
+    CONTRACTL_END;
+
+    struct _gc
+    {
+        BASEARRAYREF src;
+        BASEARRAYREF dest;
+    } gc;
+
+    gc.src = pSrc;
+    gc.dest = pDest;
+
+    GCPROTECT_BEGIN(gc);
+
+    TypeHandle elementTH = gc.dest->GetArrayElementTypeHandle();
+    MethodTable *pElementMT = elementTH.IsValueType() ? elementTH.AsMethodTable() : NULL;
+
+    ArenaManager::ArenaMarshalArray((Object**)&gc.dest, destIndex, (Object**)&gc.src, srcIndex, length, pElementMT);
+
+    GCPROTECT_END();
+}
+
 FCIMPL6(void, ArrayNative::ArrayCopy, ArrayBase* m_pSrc, INT32 m_iSrcIndex, ArrayBase* m_pDst, INT32 m_iDstIndex, INT32 m_iLength, CLR_BOOL reliable)
 {
     FCALL_CONTRACT;
@@ -1064,7 +1105,13 @@ FCIMPL6(void, ArrayNative::ArrayCopy, ArrayBase* m_pSrc, INT32 m_iSrcIndex, Arra
         FCThrowResVoid(kArrayTypeMismatchException, W("ArrayTypeMismatch_CantAssignType"));
     }
 
-    if (r == AssignWillWork) {
+    // Classify the heaps once for the whole copy.  References can be moved in bulk within
+    // the GC heap or within one arena; anything else has to be marshaled, which can
+    // trigger a GC and so needs the helper frame.
+    BOOL marshal = gc.pDst->GetMethodTable()->ContainsPointers() &&
+        !ArenaManager::IsSameHeapAddress(OBJECTREFToObject(gc.pDst), OBJECTREFToObject(gc.pSrc));
+
+    if (r == AssignWillWork && !marshal) {
         if (m_iLength > 0)
             ArrayCopyNoTypeCheck(gc.pSrc, m_iSrcIndex - srcLB, gc.pDst, m_iDstIndex - destLB, m_iLength);
 
@@ -1072,6 +1119,8 @@ FCIMPL6(void, ArrayNative::ArrayCopy, ArrayBase* m_pSrc, INT32 m_iSrcIndex, Arra
         return;
     }
     else if (reliable) {
+        // Array.ConstrainedCopy must not fail halfway through, but both a cast check and
+        // marshaling between heaps (which allocates the clones) can.
         FCThrowResVoid(kArrayTypeMismatchException, W("ArrayTypeMismatch_ConstrainedCopy"));
     }
 
@@ -1085,16 +1134,19 @@ FCIMPL6(void, ArrayNative::ArrayCopy, ArrayBase* m_pSrc, INT32 m_iSrcIndex, Arra
     if (r == AssignWrongType)
         COMPlusThrow(kArrayTypeMismatchException, W("ArrayTypeMismatch_CantAssignType"));
 
-    // If we were called from Array.ConstrainedCopy, ensure that the array copy
-    // is guaranteed to succeed.
-    _ASSERTE(!reliable || r == AssignWillWork);
+    // Array.ConstrainedCopy only gets here for copies that are guaranteed to succeed,
+    // which are all done above.
+    _ASSERTE(!reliable);
 
     if (m_iLength > 0)
     {
         switch (r)
         {
             case AssignWillWork:
-                ArrayCopyNoTypeCheck(gc.pSrc, m_iSrcIndex - srcLB, gc.pDst, m_iDstIndex - destLB, m_iLength);
+                if (marshal)
+                    ArrayMarshalNoTypeCheck(gc.pSrc, m_iSrcIndex - srcLB, gc.pDst, m_iDstIndex - destLB, m_iLength);
+                else
+                    ArrayCopyNoTypeCheck(gc.pSrc, m_iSrcIndex - srcLB, gc.pDst, m_iDstIndex - destLB, m_iLength);
                 break;
 
             case AssignUnboxValueClass:
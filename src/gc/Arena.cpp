@@ -35,8 +35,10 @@ TypeHandle LoadExactFieldType(FieldDesc *pFD, MethodTable *pEnclosingMT, AppDoma
 // for as long as possible after it is free.
 
 unsigned int ArenaManager::lastId = 0;
-void *ArenaManager::m_arenaById[c_maxArenas];
-unsigned long ArenaManager::m_refCount[c_maxArenas];
+void **ArenaManager::m_arenaById;
+LONG *ArenaManager::m_refCount;
+LONG *ArenaManager::m_generation;
+ArenaDirectory *ArenaManager::m_directory;
 
 ////////////////////////////////////////////////////////
 // ArenaVector
@@ -684,8 +686,8 @@ public:
 
 private:
 	static const size_t maxBuffers = ArenaManager::c_arenaBaseSize / ArenaManager::c_bufferReserveSize;
-	static const ArenaId recycled = (ArenaId)-1;
-	static const ArenaId empty = (ArenaId)-2;
+	static const ArenaId recycled = ARENA_SLOT_RECYCLED;
+	static const ArenaId empty = ARENA_SLOT_EMPTY;
 
 
 	static ArenaVirtualMemoryState s;
@@ -694,7 +696,11 @@ public:
 
 	static void Initialize()
 	{
-		size_t allocNeeded = maxBuffers * sizeof(ArenaId) + ArenaManager::c_guardPageSize * 2;
+		static_assert(ArenaManager::c_arenaBaseAddress == ARENA_RANGE_BASE, "arena directory out of sync");
+		static_assert(ArenaManager::c_bufferReserveSize == ARENA_BUFFER_RESERVE_SIZE, "arena directory out of sync");
+		static_assert(maxBuffers * sizeof(ArenaId) <= ARENA_DIRECTORY_OFFSET, "buffer table overlaps the arena directory");
+
+		size_t allocNeeded = ARENA_DIRECTORY_OFFSET + sizeof(ArenaDirectory) + ArenaManager::c_guardPageSize * 2;
 		size_t allocSize = (allocNeeded / ArenaManager::c_bufferReserveSize + 1)
 			* ArenaManager::c_bufferReserveSize;
 
@@ -722,10 +728,22 @@ public:
 			MemoryException();
 		}
 
-		s.m_nextSlot = ArenaManager::c_bufferReserveSize / ArenaManager::c_bufferSize;
+		s.m_nextSlot = (BufferId)(allocSize / ArenaManager::c_bufferReserveSize);
 		s.m_startSlot = s.m_nextSlot;
 		s.m_circleNextSlot = s.m_nextSlot;
 		s.m_numberOfRecycleBuffers = 0;
+
+		ArenaDirectory *directory = Directory();
+		directory->m_bufferSize = ArenaManager::c_bufferSize;
+		directory->m_firstSlot = s.m_startSlot;
+		directory->m_nextSlot = s.m_nextSlot;
+		directory->m_version = ARENA_DIRECTORY_VERSION;
+		directory->m_signature = ARENA_DIRECTORY_SIGNATURE;
+	}
+
+	static ArenaDirectory *Directory()
+	{
+		return (ArenaDirectory*)ARENA_DIRECTORY_ADDRESS;
 	}
 
 private:
@@ -842,6 +860,7 @@ public:
 			{
 				MemoryException();
 			}
+			Directory()->m_nextSlot = s.m_nextSlot;
 		}
 		else
 		{
@@ -1151,13 +1170,14 @@ void ArenaManager::InitArena()
 #endif // VERIFYALLOC
 #endif // DEBUG
 
-	for (int i = 0; i < c_maxArenas; i++)
-	{
-		m_arenaById[i] = nullptr;
-		m_refCount[i] = 0;
-	}
-
 	ArenaVirtualMemory::Initialize();
+
+	// The directory is in memory committed (and zeroed) by ArenaVirtualMemory::Initialize
+	static_assert(sizeof(void*) == sizeof(ULONG64), "arena directory requires 64 bit pointers");
+	m_directory = ArenaVirtualMemory::Directory();
+	m_arenaById = (void**)m_directory->m_arenaById;
+	m_refCount = m_directory->m_refCount;
+	m_generation = m_directory->m_generation;
 #ifdef VERIFYALLOC
 	ClrVirtualAlloc((LPVOID)0x60000000000, 1024 * 1024 * 1024, MEM_COMMIT, PAGE_READWRITE);
 	*(size_t*)0x60000000000 = 0x60000000008;
@@ -1190,15 +1210,19 @@ void ArenaManager::VerifyAllArenaObjects()
 
 void ArenaManager::DereferenceId(int id)
 {
-	if (m_arenaById[id] == nullptr)
-	{
-		Log("*arenaError", id);
-		assert(m_arenaById[id]);
-	}
-	unsigned long& r = m_refCount[id];
+	LONG& r = m_refCount[id];
 	assert(r > 0);
 	if (0 == InterlockedDecrement(&r))
 	{
+		// TryReferenceToken may briefly hold a reference on an id whose arena
+		// is still being made, but never the last one: the creator's reference
+		// goes only after MakeArena has published the arena.
+		if (m_arenaById[id] == nullptr)
+		{
+			Log("*arenaError", id);
+			assert(m_arenaById[id]);
+			return;
+		}
 		Log("Arena is deleted", id, (size_t)m_arenaById[id]);
 		auto arena = m_arenaById[id];
 		m_arenaById[id] = nullptr;
@@ -1213,7 +1237,7 @@ void ArenaManager::ReferenceId(int id)
 		Log("*arenaError", id);
 		assert(m_arenaById[id]);
 	}
-	unsigned long& r = m_refCount[id];
+	LONG& r = m_refCount[id];
 	if (r <= 0)
 	{
 		Log("*refcount error");
@@ -1222,6 +1246,31 @@ void ArenaManager::ReferenceId(int id)
 	InterlockedIncrement(&r);
 }
 
+bool ArenaManager::TryReferenceToken(int token)
+{
+	int id = token & c_tokenIdMask;
+	LONG *r = &m_refCount[id];
+	for (;;)
+	{
+		LONG was = *r;
+		if (was <= 0) return false;
+		if (was == InterlockedCompareExchange(r, was + 1, was)) break;
+	}
+
+	// the generation is bumped before a reused id gets its first reference,
+	// so once we hold a reference a stale token can no longer match.
+	if (MakeToken((ArenaId)id) != token || m_arenaById[id] == nullptr)
+	{
+		// the id belongs to a newer arena, whose other references may all
+		// have gone meanwhile: release ours like any other so that the arena
+		// is deleted if it was the last one
+		DereferenceId(id);
+		return false;
+	}
+
+	return true;
+}
+
 int ArenaManager::getId()
 {
 	int id = lastId + 1;
@@ -1233,6 +1282,8 @@ int ArenaManager::getId()
 			auto was = lastId;
 			if (was == InterlockedCompareExchange(&lastId, id, was))
 			{
+				m_generation[id]++;
+				MemoryBarrier();
 				m_refCount[id] = 1;
 				return id;
 			}
@@ -1254,55 +1305,55 @@ ArenaId ArenaManager::GetArenaId()
 	return ArenaVirtualMemory::GetArenaId(arena);
 }
 
-void _cdecl ArenaManager::SetAllocator(unsigned int type)
+int ArenaManager::GetArenaToken()
+{
+	void *arena = GetArenaStack().Current();
+	if (arena == nullptr) return -1;
+	return MakeToken(ArenaVirtualMemory::GetArenaId(arena));
+}
+
+void ArenaManager::PushArenaToken(int token)
 {
+	if (token == -1 || !TryReferenceToken(token))
+	{
+		PushGC();
+		return;
+	}
+
 	ArenaStack &arenaStack = GetArenaStack();
-	ArenaThread *current_arena;
-	switch (type)
+	ArenaThread *arenaThread = (ArenaThread*)arenaStack.LookupArenaThread(token);
+	if (arenaThread == nullptr)
 	{
-	case 1:
-		for (int i = 0; i < arenaStack.Size(); i++)
-		{
-			DereferenceId(ArenaVirtualMemory::GetArenaId(arenaStack[i]));
-		}
+		arenaThread = ((Arena*)m_arenaById[token & c_tokenIdMask])->SpawnArenaThread();
+		arenaStack.CacheArenaThread(token, arenaThread);
+	}
 
-		arenaStack.Reset();
-		break;
-	case 2:
-		current_arena = MakeArena()->BaseArenaThread();
-		arenaStack.Push(current_arena);
-		Log("Arena Push", arenaStack.Size());
-		break;
-	case 3:
-		PushGC();
-		Log("GC Push", arenaStack.Size());
-		break;
-	case 4:
-		Pop();
-		Log("Pop", arenaStack.Size());
-		break;
-	case 5:
-		Pop();
-		Log("Pop", arenaStack.Size());
-		break;
-	default:
-		if (!(type >= 1024 && type < (1024 + c_maxArenas)))
-		{
-			Log("*error type", type);
-			return;
-		}
-		ReferenceId(type - 1024);
-		//Log("Arena Reference to spawn", type - 1024,(size_t)(arenaById[type - 1024]));
-		current_arena = ((Arena*)m_arenaById[type - 1024])->SpawnArenaThread();
-		assert(current_arena != nullptr);
-		arenaStack.Push(current_arena);
-		Log("Arena RePush", arenaStack.Size());
-		//Log("Arena reuse Push", arenaStack.Size());
-		if (GetArenaStack().Size() > 1)
+	arenaStack.Push(arenaThread);
+	Log("Arena Token Push", arenaStack.Size(), token);
+}
+
+void ArenaManager::PushNewArena()
+{
+	ArenaStack &arenaStack = GetArenaStack();
+	ArenaThread *arenaThread = MakeArena()->BaseArenaThread();
+	arenaStack.CacheArenaThread(MakeToken(ArenaVirtualMemory::GetArenaId(arenaThread)), arenaThread);
+	arenaStack.Push(arenaThread);
+	Log("Arena Push", arenaStack.Size());
+}
+
+void ArenaManager::ResetArenas()
+{
+	ArenaStack &arenaStack = GetArenaStack();
+	for (int i = 0; i < arenaStack.Size(); i++)
+	{
+		if (arenaStack[i] != nullptr)
 		{
-			//Log("over Arena reuse Push", GetArenaStack().Size());
+			DereferenceId(ArenaVirtualMemory::GetArenaId(arenaStack[i]));
 		}
 	}
+
+	arenaStack.Reset();
+	Log("Arena Reset");
 }
 
 void *ArenaManager::CreateBuffer(ArenaId arenaId, size_t len)
@@ -1534,6 +1585,149 @@ struct MarshalRequest
 	}
 };
 
+////////////////////////////////////////////////////////
+// MarshalRoots
+//
+// The addresses a marshal is working with: the source of every queued
+// request, the slot its clone goes to, and the clone being filled in.
+// Cloning into the GC heap allocates, and the allocation can trigger a
+// compacting GC that moves the destination array and the clones made so
+// far.  The roots are reported to the GC as interior pointers so that it
+// updates them, and the marshal reads its addresses from here again after
+// every call that can trigger a GC.  Arena addresses never move and are not
+// reported.
+////////////////////////////////////////////////////////
+
+class MarshalRoots
+{
+	static const size_t c_initialSize = 64;
+	static const size_t c_noFreeRoot = (size_t)-1;
+
+	FrameWithCookie<GCFrame> m_frame;
+	Thread *m_thread;
+	Object **m_roots;
+	void **m_fixed;
+	size_t m_size;
+	size_t m_reserved;
+	// Released roots are reused before the arrays grow, so that they stay as
+	// long as the most roots in use at once rather than all roots ever added.
+	// The free list is threaded through m_fixed.
+	size_t m_free;
+
+public:
+	MarshalRoots(Thread *thread)
+	{
+		m_thread = thread;
+		m_size = 0;
+		m_reserved = c_initialSize;
+		m_free = c_noFreeRoot;
+		m_roots = Allocate<Object*>(m_reserved);
+		m_fixed = Allocate<void*>(m_reserved);
+		ArenaManager::MemClear(m_roots, sizeof(Object*) * m_reserved);
+		m_frame.Init(m_thread, (OBJECTREF*)m_roots, (UINT)m_reserved, TRUE);
+	}
+
+	~MarshalRoots()
+	{
+		m_frame.Pop();
+		delete[] m_roots;
+		delete[] m_fixed;
+	}
+
+	size_t Add(void *p)
+	{
+		size_t root = m_free;
+		if (root != c_noFreeRoot)
+		{
+			m_free = (size_t)m_fixed[root];
+		}
+		else
+		{
+			if (m_size == m_reserved)
+			{
+				Grow();
+			}
+			root = m_size++;
+		}
+
+		bool fixed = p == nullptr || ISARENA(p);
+		m_roots[root] = fixed ? nullptr : (Object*)p;
+		m_fixed[root] = fixed ? p : nullptr;
+		return root;
+	}
+
+	void *Get(size_t root)
+	{
+		return m_roots[root] != nullptr ? (void*)m_roots[root] : m_fixed[root];
+	}
+
+	// Stops reporting the root once the request using it is done, and makes it
+	// available to the next Add.
+	void Release(size_t root)
+	{
+		m_roots[root] = nullptr;
+		m_fixed[root] = (void*)m_free;
+		m_free = root;
+	}
+
+private:
+	// The marshal has already written part of its clones when it needs more
+	// roots, and it cannot be undone, so running out of memory here is fatal.
+	template <typename T>
+	static T *Allocate(size_t count)
+	{
+		T *p = new (nothrow) T[count];
+		if (p == nullptr)
+		{
+			EEPOLICY_HANDLE_FATAL_ERROR(COR_E_OUTOFMEMORY);
+		}
+		return p;
+	}
+
+	void Grow()
+	{
+		size_t reserved = m_reserved * 2;
+		Object **roots = Allocate<Object*>(reserved);
+		void **fixed = Allocate<void*>(reserved);
+		ArenaManager::MemClear(roots, sizeof(Object*) * reserved);
+		ArenaManager::MemCopy(roots, m_roots, sizeof(Object*) * m_size);
+		ArenaManager::MemCopy(fixed, m_fixed, sizeof(void*) * m_size);
+
+		// Nothing can trigger a GC between popping the frame over the old
+		// array and pushing the one over the new array.
+		m_frame.Pop();
+		delete[] m_roots;
+		delete[] m_fixed;
+		m_roots = roots;
+		m_fixed = fixed;
+		m_reserved = reserved;
+		m_frame.Init(m_thread, (OBJECTREF*)m_roots, (UINT)m_reserved, TRUE);
+	}
+};
+
+// A MarshalRequest waiting in the marshal queue, with its addresses held in MarshalRoots.
+struct QueuedMarshalRequest
+{
+	size_t dstRoot;
+	size_t srcRoot;
+	size_t valueTypeSize;
+	MethodTable *pMT;
+
+	QueuedMarshalRequest()
+	{
+		dstRoot = 0;
+		srcRoot = 0;
+	}
+
+	QueuedMarshalRequest(MarshalRoots &roots, const MarshalRequest &request)
+	{
+		dstRoot = roots.Add(request.dst);
+		srcRoot = roots.Add(request.src);
+		valueTypeSize = request.valueTypeSize;
+		pMT = request.pMT;
+	}
+};
+
 // We may need to recursively marshal objects, however we cannot use recursive functions
 // because we operate in cooperative mode with the GC, which means that we must be GC safe
 // as of the execution of each 'ret' instruction.  Thus we will use a queue to manage recursion.
@@ -1547,22 +1741,88 @@ void ArenaManager::ArenaMarshal (void*idst, void*isrc)
 	STATIC_CONTRACT_SO_TOLERANT;
 
 	if (isrc == nullptr) return;
+	MarshalRequest request((Object*)isrc, (Object**)idst);
+	MarshalQueue(&request, 1);
+}
+
+// Array copies between heaps queue up to c_marshalBatchSize elements at a time, so that
+// the elements share one pass of the queue instead of one ArenaMarshal call each.  Each
+// batch can trigger a GC, so the element addresses of the next one are derived from the
+// protected array references again.
+void ArenaManager::ArenaMarshalArray(Object **ppDst, size_t dstIndex, Object **ppSrc, size_t srcIndex, size_t count, MethodTable *pElementMT)
+{
+	STATIC_CONTRACT_MODE_COOPERATIVE;
+	STATIC_CONTRACT_NOTHROW;
+	STATIC_CONTRACT_GC_TRIGGERS;
+	STATIC_CONTRACT_SO_TOLERANT;
+
+	MarshalRequest batch[c_marshalBatchSize];
+	size_t elementSize = ((ArrayBase*)*ppSrc)->GetComponentSize();
+
+	for (size_t first = 0; first < count; first += c_marshalBatchSize)
+	{
+		size_t last = min(count, first + c_marshalBatchSize);
+		char *pSrcData = (char*)((ArrayBase*)*ppSrc)->GetDataPtr() + srcIndex * elementSize;
+		char *pDstData = (char*)((ArrayBase*)*ppDst)->GetDataPtr() + dstIndex * elementSize;
+		size_t batchCount = 0;
+
+		for (size_t i = first; i < last; i++)
+		{
+			char *pSrc = pSrcData + i * elementSize;
+			char *pDst = pDstData + i * elementSize;
+			if (pElementMT == nullptr)
+			{
+				Object *src = *(Object**)pSrc;
+				if (src == nullptr)
+				{
+					*(Object**)pDst = nullptr;
+					continue;
+				}
+
+				batch[batchCount++] = MarshalRequest(src, (Object**)pDst);
+			}
+			else
+			{
+				batch[batchCount++] = MarshalRequest((Object*)pSrc, (Object**)pDst, elementSize, pElementMT);
+			}
+		}
+
+		if (batchCount != 0)
+		{
+			MarshalQueue(batch, batchCount);
+		}
+	}
+}
+
+void ArenaManager::MarshalQueue(MarshalRequest *requests, size_t count)
+{
+	STATIC_CONTRACT_MODE_COOPERATIVE;
+	STATIC_CONTRACT_NOTHROW;
+	STATIC_CONTRACT_GC_TRIGGERS;
+	STATIC_CONTRACT_SO_TOLERANT;
+
 	Thread *thread = GetThread();
 	void* errorSource = nullptr;
 
-	ArenaVector<MarshalRequest> queue;
+	// The requests are still raw addresses; they go into the roots before anything
+	// can trigger a GC.
+	MarshalRoots roots(thread);
+	ArenaVector<QueuedMarshalRequest> queue;
 #ifdef _DEBUG
 rerunMarshal :
 	ArenaVector<MarshalRequest> verifyList;
+	int gcCount = GCHeap::GetGCHeap()->CollectionCount(0);
 #endif
-	queue.PushBack(MarshalRequest((Object*)isrc, (Object**)idst));
+	for (size_t i = 0; i < count; i++)
+	{
+		queue.PushBack(QueuedMarshalRequest(roots, requests[i]));
+	}
 
 	while (!queue.IsEmpty())
 	{
-		MarshalRequest request = queue.PopFront();
-		queue.DeleteRepeat(request);
-		Object *src = request.src;
-		Object **dst = request.dst;
+		QueuedMarshalRequest request = queue.PopFront();
+		Object *src = (Object*)roots.Get(request.srcRoot);
+		Object **dst = (Object**)roots.Get(request.dstRoot);
 		if (src == errorSource)
 		{
 			src = (Object*)errorSource;
@@ -1595,13 +1855,14 @@ rerunMarshal :
 
 		Object* clone = nullptr;
 		bool suppressCacheWrite = false;
+		size_t cloneRoot = (size_t)-1;
 
 		if (pMT->IsMarshaledByRef())
 		{
 			clone = src;
 			suppressCacheWrite = true;  
 #ifdef ARENA_LOGGING
-			Log("Marshal By Ref", (size_t)src, (size_t)idst,name);
+			Log("Marshal By Ref", (size_t)src, (size_t)dst,name);
 #endif // ARENA_LOGGING
 
 		} 
@@ -1616,7 +1877,7 @@ rerunMarshal :
 			{
 				suppressCacheWrite = true;
 #ifdef ARENA_LOGGING
-				Log("cached clone", (size_t)src, (size_t)clone, name, (size_t)idst);
+				Log("cached clone", (size_t)src, (size_t)clone, name, (size_t)dst);
 #endif // ARENA_LOGGING
 			}
 		}
@@ -1627,7 +1888,7 @@ rerunMarshal :
 			// Allocate memory for clone from either GC or arena
 			if (request.valueTypeSize != 0)
 			{
-				clone = (Object*)request.dst;
+				clone = (Object*)dst;
 			}
 			else {
 				if (dstAllocator == nullptr)
@@ -1640,6 +1901,10 @@ rerunMarshal :
 						clone = (Object*)GCHeap::GetGCHeap()->Alloc(size, flags);
 					// Pop is guaranteed not to call a method on the stack if it follows a PushGC();
 					Pop(thread);
+
+					// The allocation may have moved the source and the destination.
+					src = (Object*)roots.Get(request.srcRoot);
+					dst = (Object**)roots.Get(request.dstRoot);
 				}
 				else
 				{
@@ -1648,6 +1913,7 @@ rerunMarshal :
 				// copy the message table pointer  leave the rest zero.
 				*(size_t*)clone = *(size_t*)src;
 			}
+			cloneRoot = roots.Add(clone);
 
 			if (pMT == g_pStringClass)
 			{
@@ -1671,12 +1937,12 @@ rerunMarshal :
 				case ELEMENT_TYPE_VALUETYPE:
 					for (size_t i = ioffset; i < ioffset + numComponents*componentSize; i += componentSize)
 					{
-						queue.PushBack(
+						queue.PushBack(QueuedMarshalRequest(roots,
 							MarshalRequest(
 								(Object*)((char*)src + i),
 								(Object**)((char*)clone + i),
 								componentSize,
-								ty.AsMethodTable()));
+								ty.AsMethodTable())));
 					}
 
 					break;
@@ -1698,7 +1964,7 @@ rerunMarshal :
 						Object **pDst = (Object **)((char*)clone + i);
 						if (pSrc != nullptr)
 						{
-							queue.PushBack(MarshalRequest(pSrc, pDst));
+							queue.PushBack(QueuedMarshalRequest(roots, MarshalRequest(pSrc, pDst)));
 						}
 					}
 				}
@@ -1775,13 +2041,18 @@ rerunMarshal :
 						case ELEMENT_TYPE_VALUETYPE:
 						{
 							TypeHandle th = LoadExactFieldType(&pSrcFields[i], pMT, GetAppDomain());
-							queue.PushBack(
+
+							// Loading the field type can trigger a GC.
+							src = (Object*)roots.Get(request.srcRoot);
+							clone = (Object*)roots.Get(cloneRoot);
+
+							queue.PushBack(QueuedMarshalRequest(roots,
 								MarshalRequest(
 									(Object*)((char*)src + offset),
 									(Object**)((char*)clone + offset),
 									th.AsMethodTable()->GetBaseSize(),
 									th.AsMethodTable()
-									));
+									)));
 						}
 						break;
 
@@ -1795,9 +2066,9 @@ rerunMarshal :
 							if (pSrc != nullptr)
 							{
 								void** rdst = (void**)((char*)clone + offset);
-								queue.PushBack(MarshalRequest(
+								queue.PushBack(QueuedMarshalRequest(roots, MarshalRequest(
 									(Object*)pSrc,
-									(Object**)rdst));
+									(Object**)rdst)));
 							}
 						}
 						break;
@@ -1868,6 +2139,14 @@ rerunMarshal :
 #endif // VERIFYALLOC
 		}
 
+		if (cloneRoot != (size_t)-1)
+		{
+			// Cloning the fields may have loaded types, and so triggered a GC.
+			src = (Object*)roots.Get(request.srcRoot);
+			dst = (Object**)roots.Get(request.dstRoot);
+			clone = (Object*)roots.Get(cloneRoot);
+		}
+
 #ifdef DEBUG
 		if (request.valueTypeSize==0)
 		{ 
@@ -1897,9 +2176,17 @@ rerunMarshal :
 				ErectWriteBarrier(dst, clone);
 			}
 		}
+
+		roots.Release(request.srcRoot);
+		roots.Release(request.dstRoot);
+		if (cloneRoot != (size_t)-1)
+		{
+			roots.Release(cloneRoot);
+		}
 	}
 #ifdef _DEBUG
-	while (!verifyList.IsEmpty())
+	// The verify list holds raw addresses, which a GC during the marshal invalidates.
+	while (gcCount == GCHeap::GetGCHeap()->CollectionCount(0) && !verifyList.IsEmpty())
 	{
 		auto request = verifyList.PopFront();
 		size_t* pSrc = (size_t*)request.src;
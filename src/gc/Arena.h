@@ -4,6 +4,7 @@
 #include <vcruntime.h>
 #include "common.h"
 #include "..\vm\threads.h"
+#include "arenadirectory.h"
 
 
 //#define VERIFYALLOC
@@ -15,6 +16,7 @@ typedef int BufferId;
 class Arena;
 class ArenaThread;
 class ArenaStack;
+struct MarshalRequest;
 
 ////////////////////////////////////////////////////////
 // ArenaStack
@@ -28,6 +30,18 @@ class ArenaStack
 {
 	// Initialized with fixed stack depth
 	static const int c_arenaStackDepth = 10;
+
+	// Number of ArenaThreads remembered for arenas that are re-pushed
+	// onto this thread (see ArenaManager::PushArenaToken)
+	static const int c_arenaThreadCacheSize = 4;
+
+	struct ArenaThreadCacheEntry
+	{
+		// The arena token (id + generation) the ArenaThread belongs to, -1 if unused
+		int m_token;
+		void *m_arenaThread;
+	};
+
 	void *m_current = nullptr;
 	void **m_stack = nullptr;
 	size_t m_size = 0;
@@ -35,11 +49,19 @@ class ArenaStack
 
 	void *m_fixedStack[c_arenaStackDepth];
 
+	ArenaThreadCacheEntry m_arenaThreadCache[c_arenaThreadCacheSize];
+	int m_arenaThreadCacheNext = 0;
+
 public:
 	ArenaStack()
 	{
 		m_stack = m_fixedStack;
 		m_reserved = c_arenaStackDepth;
+		for (int i = 0; i < c_arenaThreadCacheSize; i++)
+		{
+			m_arenaThreadCache[i].m_token = -1;
+			m_arenaThreadCache[i].m_arenaThread = nullptr;
+		}
 	}
 
 	~ArenaStack()
@@ -103,6 +125,33 @@ public:
 
 		return m_stack[m_size];
 	}
+
+	// Returns the ArenaThread this thread last used for the arena
+	// identified by token, or nullptr if there is none.  The caller
+	// must hold a reference on the arena, so that the token is known
+	// to still be live.
+	void *LookupArenaThread(int token)
+	{
+		for (int i = 0; i < c_arenaThreadCacheSize; i++)
+		{
+			if (m_arenaThreadCache[i].m_token == token)
+			{
+				return m_arenaThreadCache[i].m_arenaThread;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// Remembers the ArenaThread used by this thread for an arena, evicting
+	// the oldest entry.  Entries for arenas that have been destroyed are
+	// never matched again because the token generation has moved on.
+	void CacheArenaThread(int token, void *arenaThread)
+	{
+		m_arenaThreadCache[m_arenaThreadCacheNext].m_token = token;
+		m_arenaThreadCache[m_arenaThreadCacheNext].m_arenaThread = arenaThread;
+		m_arenaThreadCacheNext = (m_arenaThreadCacheNext + 1) % c_arenaThreadCacheSize;
+	}
 };
 
 ////////////////////////////////////////////////////////
@@ -140,14 +189,26 @@ public:
 	static const size_t c_guardPageSize = 16 * 1024;
 	static const size_t c_bufferSize = c_bufferReserveSize - c_guardPageSize;
 
-	static const int c_maxArenas = 4096;
+	static const int c_maxArenas = ARENA_DIRECTORY_MAX_ARENAS;
 
 	// number of 1M buffers that will be used for recycling.
 	static const int c_maxRecycleBuffers = 100;
+	// Arena tokens combine the arena id with a generation count, so that
+	// a token captured for an arena that has since been destroyed never
+	// matches a new arena that happens to reuse the same id.
+	static const int c_tokenIdBits = 12;
+	static const int c_tokenIdMask = (1 << c_tokenIdBits) - 1;
+	static const LONG c_tokenGenerationMask = 0x7ffff;
 private:
-	// Reservation system for all arenas.
-	static unsigned long m_refCount[c_maxArenas];
-	static void *m_arenaById[c_maxArenas];
+	// Reservation system for all arenas.  The tables live in the ArenaDirectory
+	// at a fixed address in the arena range, so that SOS can find them.
+	static LONG *m_refCount;
+	static void **m_arenaById;
+
+	// Incremented each time an id is handed to a new arena
+	static LONG *m_generation;
+
+	static ArenaDirectory *m_directory;
 #ifdef ARENA_LOGGING
 	static HANDLE m_hFile;
 	static int m_lcnt;
@@ -171,6 +232,15 @@ private:
 	// adds to the reference count
 	static void ReferenceId(int id);
 
+	// adds to the reference count if the arena identified by token
+	// is still alive, returns false otherwise.
+	static bool TryReferenceToken(int token);
+
+	static int MakeToken(ArenaId id)
+	{
+		return (int)(((m_generation[id] & c_tokenGenerationMask) << c_tokenIdBits) | id);
+	}
+
 	// Gets the allocator at the top of the stack
 	static void *ArenaManager::GetArena()
 	{
@@ -195,6 +265,13 @@ private:
 
 	static void RegisterForFinalization(Object *o, size_t size);
 
+	// Number of array elements ArenaMarshalArray queues at once.  The marshal
+	// queue is not indexed, so very long queues are slower than several short ones.
+	static const size_t c_marshalBatchSize = 64;
+
+	// Clones the objects described by requests, and everything they reference.
+	static void MarshalQueue(MarshalRequest *requests, size_t count);
+
 	static void MemCopy(void *idst, void *isrc, size_t len)
 	{
 #if defined(BIT64)
@@ -227,13 +304,13 @@ public:
 	// Initializes all Arena structures (call this once per process, before all other calls).
 	static void InitArena();
 
-	// This is the method that the user C# process calls to set the allocator state
-	// 1 = reset to GCHeap
-	// 2 = push new arena allocator
-	// 3 = push GCHeap
-	// 4 = pop
-	// 1024+ push old arena
-	static void SetAllocator(unsigned int type);
+	// Creates a new arena and pushes it onto this thread's arena stack, it is
+	// released by the matching Pop().
+	static void PushNewArena();
+
+	// Pops every allocator off this thread's arena stack, so that it allocates
+	// from the GC heap again.
+	static void ResetArenas();
 
 	// Gets the arenaID for the current arena in this thread,
 	// returns -1, if no arena is the current allocator for this thread.
@@ -242,6 +319,17 @@ public:
 	// Gets the arena ID given an address of an object, arena or arenathread
 	static ArenaId GetArenaId(void *addr);
 
+	// Gets a token identifying the current arena for this thread, that
+	// can later be passed to PushArenaToken on any thread.
+	// returns -1, if no arena is the current allocator for this thread.
+	static int GetArenaToken();
+
+	// Pushes the arena identified by token onto this thread's arena stack,
+	// reusing the ArenaThread this thread last used for that arena.  If token
+	// is -1, or the arena no longer exists, the GC heap is pushed instead, so
+	// every call must be balanced by exactly one Pop().
+	static void PushArenaToken(int token);
+
 	// returns null if no arena allocator is active, otherwise returns
 	// a pointer to an allocated buffer
 	static void *Allocate(size_t jsize, uint32_t flags);
@@ -311,6 +399,15 @@ public:
 	// a pointer to the cloned object at target.
 	static void ArenaMarshal(void *target, void *src);
 
+	// Marshals count array elements, starting at srcIndex in the array *ppSrc,
+	// to the array *ppTarget starting at targetIndex, in batches rather than one
+	// ArenaMarshal call per element.  ppTarget and ppSrc must point at
+	// GC-protected references; the element addresses are derived from them
+	// again for every batch.  If pElementMT is nullptr the elements are object
+	// references, otherwise they are value types of that type.  The arrays
+	// must be different.
+	static void ArenaMarshalArray(Object **ppTarget, size_t targetIndex, Object **ppSrc, size_t srcIndex, size_t count, MethodTable *pElementMT);
+
 	// True if the supplied pointer is within the arena
 	// address space (the address space from 400'00000000 to 7ff'ffffffff)
 	// values above this range (i.e. 7fff'00000000) are not arena, but rather code
@@ -322,6 +419,12 @@ public:
 	// True if p and q are both pointers within the same arena
 	static bool IsSameArenaAddress(void *p, void *q); 
 
+	// True if references can be copied from q to p without marshaling,
+	// i.e. both are in the GC heap or both are in the same arena.
+	static bool IsSameHeapAddress(void *p, void *q) {
+		return IsArenaAddress(p) ? IsSameArenaAddress(p, q) : !IsArenaAddress(q);
+	}
+
 #ifdef VERIFYALLOC
 	static void VerifyObject(Object *o, MethodTable *pMT = nullptr);
 	static void VerifyClass(Object *o, MethodTable *pMT = nullptr);
@@ -337,13 +440,7 @@ public:
 	// Creates a buffer in the arena virtual address space
 	static void *CreateBuffer(ArenaId arenaId, size_t len = ArenaManager::c_bufferSize);
 
-#if defined(BIT64)
-	// Card byte shift is different on 64bit.
-#define card_byte_shift     11
-#else
-#define card_byte_shift     10
-#endif
-
+	// card_byte_shift and card_bundle_byte_shift come from gc.h
 #define card_byte(addr) (((size_t)(addr)) >> card_byte_shift)
 
 	// to guarantee inline, this code is cloned from GCSample
@@ -361,7 +458,14 @@ public:
 			// with g_lowest/highest_address check above. See comment in code:gc_heap::grow_brick_card_tables.
 			uint8_t* pCardByte = (uint8_t *)*(volatile uint8_t **)(&g_card_table) + card_byte((uint8_t *)dst);
 			if (*pCardByte != 0xFF)
+			{
 				*pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+				uint8_t* pCardBundleByte = (uint8_t *)*(volatile uint8_t **)(&g_card_bundle_table) + ((size_t)dst >> card_bundle_byte_shift);
+				if (*pCardBundleByte != 0xFF)
+					*pCardBundleByte = 0xFF;
+#endif
+			}
 		}
 #endif
 	}
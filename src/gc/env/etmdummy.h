@@ -52,6 +52,7 @@
 #define FireEtwGCSampledObjectAllocationLow(Address, TypeID, ObjectCountForTypeSample, TotalSizeForTypeSample, ClrInstanceID) 0
 #define FireEtwPinObjectAtGCTime(HandleID, ObjectID, ObjectSize, TypeName, ClrInstanceID) 0
 #define FireEtwGCTriggered(Reason, ClrInstanceID) 0
+#define FireEtwGCPhaseTimes(Count, Depth, Suspend, MarkRoots, MarkHandles, MarkCards, Plan, Relocate, Compact, Sweep, Resume, ClrInstanceID) 0
 #define FireEtwGCBulkRootCCW(Count, ClrInstanceID, Values_Len_, Values) 0
 #define FireEtwGCBulkRCW(Count, ClrInstanceID, Values_Len_, Values) 0
 #define FireEtwGCBulkRootStaticVar(Count, AppDomainID, ClrInstanceID, Values_Len_, Values) 0
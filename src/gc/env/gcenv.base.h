@@ -558,6 +558,11 @@ public:
         UNSUPPORTED_GCConfigLogFile,
         UNSUPPORTED_BGCSpinCount,
         UNSUPPORTED_BGCSpin,
+        UNSUPPORTED_GCMarkPrefetch,
+        UNSUPPORTED_GCDynamicHeapCount,
+        UNSUPPORTED_GCHeapHardLimitMB,
+        UNSUPPORTED_GCHeapHardLimitPercent,
+        UNSUPPORTED_GCGradualDecommit,
         EXTERNAL_GCStressStart,
         INTERNAL_GCStressStartAtJit,
         INTERNAL_DbgDACSkipVerifyDlls,
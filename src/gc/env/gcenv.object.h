@@ -141,6 +141,11 @@ public:
         return m_dwLength;
     }
 
+    void SetNumComponents(uint32_t dwLength)
+    {
+        m_dwLength = dwLength;
+    }
+
     static size_t GetOffsetOfNumComponents()
     {
         return offsetof(ArrayBase, m_dwLength);
@@ -18,6 +18,7 @@
 // 
 
 #include "gcpriv.h"
+#include "softwarewritewatch.h"
 
 #define USE_INTROSORT
 
@@ -1436,19 +1437,21 @@ void reset_memory (uint8_t* o, size_t sizeo);
 
 #ifdef WRITE_WATCH
 
+#ifndef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
 static bool virtual_alloc_write_watch = false;
+#endif // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
 
-static bool write_watch_capability = false;
+static bool hardware_write_watch_capability = false;
 
 #ifndef DACCESS_COMPILE
 
 //check if the write watch APIs are supported.
 
-void write_watch_api_supported()
+void hardware_write_watch_api_supported()
 {
     if (GCToOSInterface::SupportsWriteWatch())
     {
-        write_watch_capability = true;
+        hardware_write_watch_capability = true;
         dprintf (2, ("WriteWatch supported"));
     }
     else
@@ -1459,11 +1462,61 @@ void write_watch_api_supported()
 
 #endif //!DACCESS_COMPILE
 
-inline bool can_use_write_watch()
+inline bool can_use_hardware_write_watch()
 {
-    return write_watch_capability;
+    return hardware_write_watch_capability;
 }
 
+// With software write watch the GC heap is tracked by the write barriers
+// (see softwarewritewatch.h) and doesn't need OS support.
+inline bool can_use_write_watch_for_gc_heap()
+{
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    return true;
+#else // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    return can_use_hardware_write_watch();
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+}
+
+// Card bundles watch the card table itself, which the barriers don't
+// record in the software table. Unless they are manually managed, the
+// barriers then set the bundle of every card they dirty.
+inline bool can_use_write_watch_for_card_table()
+{
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    return true;
+#else // !FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    return can_use_hardware_write_watch();
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+}
+
+#ifndef DACCESS_COMPILE
+
+inline void reset_write_watch_for_gc_heap (void* base_address, size_t region_size)
+{
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    SoftwareWriteWatch::ClearDirty (base_address, region_size);
+#else // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    GCToOSInterface::ResetWriteWatch (base_address, region_size);
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+}
+
+inline bool get_write_watch_for_gc_heap (bool reset, void* base_address, size_t region_size,
+                                         void** dirty_pages, uintptr_t* dirty_page_count_ref,
+                                         bool is_runtime_suspended)
+{
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    SoftwareWriteWatch::GetDirty (base_address, region_size, dirty_pages, dirty_page_count_ref,
+                                  reset, is_runtime_suspended);
+    return true;
+#else // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    UNREFERENCED_PARAMETER(is_runtime_suspended);
+    return GCToOSInterface::GetWriteWatch (reset, base_address, region_size, dirty_pages, dirty_page_count_ref);
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+}
+
+#endif //!DACCESS_COMPILE
+
 #else
 #define mem_reserve (MEM_RESERVE)
 #endif //WRITE_WATCH
@@ -2114,6 +2167,13 @@ const int max_snoop_level = 128;
 
 #define GC_EPHEMERAL_DECOMMIT_TIMEOUT 5000
 
+#ifdef MULTIPLE_HEAPS
+// With gradual decommit at most 160MB/s are released, in steps
+// taken every 100ms.
+#define DECOMMIT_SIZE_PER_MILLISECOND (160*1024)
+#define DECOMMIT_TIME_STEP_MILLISECONDS (100)
+#endif //MULTIPLE_HEAPS
+
 inline
 size_t align_on_page (size_t add)
 {
@@ -2238,6 +2298,10 @@ sorted_table* gc_heap::seg_table;
 #ifdef MULTIPLE_HEAPS
 CLREvent    gc_heap::ee_suspend_event;
 size_t      gc_heap::min_balance_threshold = 0;
+BOOL        gc_heap::dynamic_heap_count_p = FALSE;
+dynamic_heap_count_data gc_heap::dynamic_heap_count;
+BOOL        gc_heap::gradual_decommit_p = FALSE;
+BOOL        gc_heap::gradual_decommit_in_progress_p = FALSE;
 #endif //MULTIPLE_HEAPS
 
 VOLATILE(BOOL) gc_heap::gc_started;
@@ -2248,6 +2312,7 @@ CLREvent    gc_heap::gc_start_event;
 
 SVAL_IMPL_NS(int, SVR, gc_heap, n_heaps);
 SPTR_IMPL_NS(PTR_gc_heap, SVR, gc_heap, g_heaps);
+int         gc_heap::n_active_heaps = 0;
 
 size_t*     gc_heap::g_promoted;
 
@@ -2311,6 +2376,32 @@ uint64_t    gc_heap::entry_available_physical_mem;
 
 bool        gc_heap::restricted_physical_memory_p = false;
 
+size_t      gc_heap::heap_hard_limit = 0;
+
+size_t      gc_heap::current_total_committed = 0;
+
+size_t      gc_heap::committed_by_bucket[total_commit_buckets];
+
+CLRCriticalSection gc_heap::check_commit_cs;
+
+uint64_t    gc_heap::total_commit_bytes = 0;
+
+uint64_t    gc_heap::total_decommit_bytes = 0;
+
+uint64_t    gc_heap::last_pause_phase_time[max_pause_phase];
+
+size_t      gc_heap::last_pause_phase_gc_index = 0;
+
+int         gc_heap::last_pause_phase_generation = 0;
+
+uint32_t    gc_heap::last_pause_phases_run = 0;
+
+BOOL        gc_heap::pause_phases_pending = FALSE;
+
+uint64_t    gc_heap::pause_phase_histogram[max_pause_phase][PAUSE_PHASE_HISTOGRAM_BUCKETS];
+
+uint64_t    gc_heap::pause_phase_total_time[max_pause_phase];
+
 #ifdef BACKGROUND_GC
 CLREvent    gc_heap::bgc_start_event;
 
@@ -2435,6 +2526,8 @@ size_t      gc_heap::mark_stack_array_length = 0;
 
 mark*       gc_heap::mark_stack_array = 0;
 
+BOOL        gc_heap::mark_prefetch_p = FALSE;
+
 BOOL        gc_heap::verify_pinned_queue_p = FALSE;
 
 uint8_t*    gc_heap::oldest_pinned_plug = 0;
@@ -2583,6 +2676,10 @@ size_t gc_heap::interesting_data_per_gc[max_idp_count];
 //size_t gc_heap::interesting_data_per_heap[max_idp_count];
 //size_t gc_heap::interesting_mechanisms_per_heap[max_im_count];
 #endif //GC_CONFIG_DRIVEN
+
+uint64_t gc_heap::pause_phase_time[max_pause_phase];
+
+uint32_t gc_heap::pause_phases_run = 0;
 #endif //MULTIPLE_HEAPS
 
 no_gc_region_info gc_heap::current_no_gc_region_info;
@@ -2652,6 +2749,9 @@ GARY_IMPL(size_t, interesting_mechanism_bits_per_heap, max_gc_mechanism_bits_cou
 alloc_list gc_heap::loh_alloc_list [NUM_LOH_ALIST-1];
 alloc_list gc_heap::gen2_alloc_list[NUM_GEN2_ALIST-1];
 
+allocator gc_heap::poh_allocator;
+alloc_list gc_heap::poh_alloc_list [NUM_POH_ALIST-1];
+
 dynamic_data gc_heap::dynamic_data_table [NUMBERGENERATIONS+1];
 gc_history_per_heap gc_heap::gc_data_per_heap;
 size_t gc_heap::maxgen_pinned_compact_before_advance = 0;
@@ -3939,6 +4039,18 @@ heap_segment* heap_segment_next_rw (heap_segment* seg)
     return heap_segment_rw (ns);
 }
 
+//returns the next rw segment LOH compaction can move objects to,
+//the pinned object segments are skipped.
+heap_segment* heap_segment_next_compacted (heap_segment* seg)
+{
+    heap_segment* ns = heap_segment_next_rw (seg);
+    while ((ns != 0) && heap_segment_poh_p (ns))
+    {
+        ns = heap_segment_next_rw (ns);
+    }
+    return ns;
+}
+
 // returns the segment before seg.
 heap_segment* heap_segment_prev_rw (heap_segment* begin, heap_segment* seg)
 {
@@ -4255,7 +4367,11 @@ void* virtual_alloc (size_t size)
         }
     }
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    uint32_t flags = VirtualReserveFlags::None;
+#else // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
     uint32_t flags = virtual_alloc_write_watch ? VirtualReserveFlags::WriteWatch : VirtualReserveFlags::None;
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
     void* prgmem = GCToOSInterface::VirtualReserve (0, requested_size, card_size * card_word_width, flags);
     void *aligned_mem = prgmem;
 
@@ -4611,6 +4727,7 @@ gc_heap::get_segment (size_t size, BOOL loh_p)
 
             if (gc_heap::grow_brick_card_tables (start, end, size, result, __this, loh_p) != 0)
             {
+                release_committed ((uint8_t*)heap_segment_committed (result) - (uint8_t*)mem);
                 virtual_free (mem, size);
                 return 0;
             }
@@ -4649,10 +4766,12 @@ void release_segment (heap_segment* sg)
 {
     ptrdiff_t delta = 0;
     FireEtwGCFreeSegment_V1((size_t)heap_segment_mem(sg), GetClrInstanceId());
+    gc_heap::release_committed ((uint8_t*)heap_segment_committed (sg)-(uint8_t*)sg);
     virtual_free (sg, (uint8_t*)heap_segment_reserved (sg)-(uint8_t*)sg);
 }
 
-heap_segment* gc_heap::get_segment_for_loh (size_t size
+heap_segment* gc_heap::get_segment_for_loh (size_t size,
+                                           BOOL pinned_p
 #ifdef MULTIPLE_HEAPS
                                            , gc_heap* hp
 #endif //MULTIPLE_HEAPS
@@ -4668,6 +4787,12 @@ heap_segment* gc_heap::get_segment_for_loh (size_t size
         heap_segment_heap (res) = hp;
 #endif //MULTIPLE_HEAPS
         res->flags |= heap_segment_flags_loh;
+        // This has to be set before the segment is threaded, other threads
+        // can allocate on it as soon as we release the gc lock.
+        if (pinned_p)
+        {
+            res->flags |= heap_segment_flags_poh;
+        }
 
         FireEtwGCCreateSegment_V1((size_t)heap_segment_mem(res), (size_t)(heap_segment_reserved (res) - heap_segment_mem(res)), ETW::GCLog::ETW_GC_INFO::LARGE_OBJECT_HEAP, GetClrInstanceId());
 
@@ -4696,7 +4821,7 @@ void gc_heap::thread_loh_segment (heap_segment* new_seg)
 }
 
 heap_segment*
-gc_heap::get_large_segment (size_t size, BOOL* did_full_compact_gc)
+gc_heap::get_large_segment (size_t size, BOOL pinned_p, BOOL* did_full_compact_gc)
 {
     *did_full_compact_gc = FALSE;
     size_t last_full_compact_gc_count = get_full_compact_gc_count();
@@ -4732,7 +4857,7 @@ gc_heap::get_large_segment (size_t size, BOOL* did_full_compact_gc)
             (current_c_gc_state == c_gc_state_marking));
 #endif //BACKGROUND_GC
 
-    heap_segment* res = get_segment_for_loh (size
+    heap_segment* res = get_segment_for_loh (size, pinned_p
 #ifdef MULTIPLE_HEAPS
                                             , this
 #endif //MULTIPLE_HEAPS
@@ -4913,7 +5038,7 @@ public:
     static int select_heap(alloc_context* acontext, int hint)
     {
         if (GCToOSInterface::CanGetCurrentProcessorNumber())
-            return proc_no_to_heap_no[GCToOSInterface::GetCurrentProcessorNumber() % gc_heap::n_heaps];
+            return proc_no_to_heap_no[GCToOSInterface::GetCurrentProcessorNumber() % gc_heap::n_heaps] % gc_heap::n_active_heaps;
 
         unsigned sniff_index = Interlocked::Increment(&cur_sniff_index);
         sniff_index %= n_sniff_buffers;
@@ -4924,7 +5049,7 @@ public:
 
         uint8_t *l_sniff_buffer = sniff_buffer;
         unsigned l_n_sniff_buffers = n_sniff_buffers;
-        for (int heap_number = 0; heap_number < gc_heap::n_heaps; heap_number++)
+        for (int heap_number = 0; heap_number < gc_heap::n_active_heaps; heap_number++)
         {
             int this_access_time = access_time(l_sniff_buffer, heap_number, sniff_index, l_n_sniff_buffers);
             if (this_access_time < best_access_time)
@@ -5203,11 +5328,19 @@ void gc_heap::gc_thread_function ()
 
         if (heap_number == 0)
         {
-            gc_heap::ee_suspend_event.Wait(INFINITE, FALSE);
+            uint32_t wait_time = (gradual_decommit_in_progress_p ? DECOMMIT_TIME_STEP_MILLISECONDS : INFINITE);
+            uint32_t wait_result = gc_heap::ee_suspend_event.Wait(wait_time, FALSE);
+            if (wait_result == WAIT_TIMEOUT)
+            {
+                gradual_decommit_in_progress_p = decommit_step (DECOMMIT_TIME_STEP_MILLISECONDS);
+                continue;
+            }
 
+            uint64_t suspend_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
             BEGIN_TIMING(suspend_ee_during_log);
             GCToEEInterface::SuspendEE(GCToEEInterface::SUSPEND_FOR_GC);
             END_TIMING(suspend_ee_during_log);
+            last_pause_phase_time[pause_phase_suspend] = (uint64_t)GCToOSInterface::QueryPerformanceCounter() - suspend_start;
 
             proceed_with_gc_p = TRUE;
 
@@ -5253,9 +5386,11 @@ void gc_heap::gc_thread_function ()
 
             gc_heap::gc_started = FALSE;
 
+            uint64_t resume_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
             BEGIN_TIMING(restart_ee_during_log);
             GCToEEInterface::RestartEE(TRUE);
             END_TIMING(restart_ee_during_log);
+            record_pause_phases (TRUE, resume_start);
             process_sync_log_stats();
 
             dprintf (SPINLOCK_LOG, ("GC Lgc"));
@@ -6364,11 +6499,21 @@ void gc_heap::clear_card (size_t card)
               (size_t)card_address (card+1)));
 }
 
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+size_t cardw_card_bundle (size_t cardw);
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
 inline
 void gc_heap::set_card (size_t card)
 {
     card_table [card_word (card)] =
         (card_table [card_word (card)] | (1 << card_bit (card)));
+
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    // The bundle bits are only set here and by the barriers, nothing
+    // watches the card table for us.
+    card_bundle_set (cardw_card_bundle (card_word (card)));
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 }
 
 inline
@@ -6464,6 +6609,16 @@ void gc_heap::card_bundles_set (size_t start_cardb, size_t end_cardb)
 
 }
 
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+void gc_heap::card_bundle_set (size_t cardb)
+{
+    if (!card_bundle_set_p (cardb))
+    {
+        card_bundle_table [card_bundle_word (cardb)] |= (1 << card_bundle_bit (cardb));
+    }
+}
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
 BOOL gc_heap::card_bundle_set_p (size_t cardb)
 {
     return ( card_bundle_table [ card_bundle_word (cardb) ] & (1 << card_bundle_bit (cardb)));
@@ -6483,14 +6638,15 @@ size_t size_card_bundle_of (uint8_t* from, uint8_t* end)
     return ((end - from) / (card_size*card_word_width*card_bundle_size*card_bundle_word_width)) * sizeof (uint32_t);
 }
 
-uint32_t* translate_card_bundle_table (uint32_t* cb)
+// lowest_address is the lowest address covered by the card table cb belongs to.
+uint32_t* translate_card_bundle_table (uint32_t* cb, uint8_t* lowest_address)
 {
-    return (uint32_t*)((uint8_t*)cb - ((((size_t)g_lowest_address) / (card_size*card_word_width*card_bundle_size*card_bundle_word_width)) * sizeof (uint32_t)));
+    return (uint32_t*)((uint8_t*)cb - ((((size_t)lowest_address) / (card_size*card_word_width*card_bundle_size*card_bundle_word_width)) * sizeof (uint32_t)));
 }
 
 void gc_heap::enable_card_bundles ()
 {
-    if (can_use_write_watch() && (!card_bundles_enabled()))
+    if (can_use_write_watch_for_card_table() && (!card_bundles_enabled()))
     {
         dprintf (3, ("Enabling card bundles"));
         //set all of the card bundles
@@ -6528,6 +6684,12 @@ public:
 
     size_t      size;
     uint32_t*   next_card_table;
+
+    // What the table has charged to the heap hard limit: everything before
+    // the mark array, and the parts of the mark array committed since.
+    size_t      committed;
+    // The next older table that is still allocated, see all_card_tables.
+    uint32_t*   next_allocated_card_table;
 };
 
 //These are accessors on untranslated cardtable
@@ -6790,6 +6952,61 @@ size_t& card_table_size (uint32_t* c_table)
     return ((card_table_info*)((uint8_t*)c_table - sizeof (card_table_info)))->size;
 }
 
+inline
+size_t& card_table_committed (uint32_t* c_table)
+{
+    return ((card_table_info*)((uint8_t*)c_table - sizeof (card_table_info)))->committed;
+}
+
+inline
+uint32_t*& card_table_next_allocated (uint32_t* c_table)
+{
+    return ((card_table_info*)((uint8_t*)c_table - sizeof (card_table_info)))->next_allocated_card_table;
+}
+
+// Every card table that hasn't been destroyed yet, newest first. Unlike the
+// card_table_next chain this includes a table that is still being set up,
+// so that its mark array commits can be charged to it.
+static uint32_t* all_card_tables = 0;
+
+// A new table starts out charged with the commit_size bytes before its mark array.
+void add_allocated_card_table (uint32_t* c_table, size_t commit_size)
+{
+    card_table_committed (c_table) = commit_size;
+    card_table_next_allocated (c_table) = all_card_tables;
+    all_card_tables = c_table;
+}
+
+// Returns the table whose memory address is in, 0 if there is none.
+uint32_t* allocated_card_table_of (uint8_t* address)
+{
+    for (uint32_t* c_table = all_card_tables; c_table; c_table = card_table_next_allocated (c_table))
+    {
+        uint8_t* table_start = (uint8_t*)&card_table_refcount (c_table);
+        if ((address >= table_start) && (address < (table_start + card_table_size (c_table))))
+        {
+            return c_table;
+        }
+    }
+
+    return 0;
+}
+
+// Takes the table off all_card_tables and gives back what it charged to the
+// hard limit, its memory is about to be released.
+void remove_allocated_card_table (uint32_t* c_table)
+{
+    uint32_t** link = &all_card_tables;
+    while (*link != c_table)
+    {
+        assert (*link);
+        link = &card_table_next_allocated (*link);
+    }
+    *link = card_table_next_allocated (c_table);
+
+    gc_heap::release_committed (card_table_committed (c_table), commit_bucket_bookkeeping);
+}
+
 void own_card_table (uint32_t* c_table)
 {
     card_table_refcount (c_table) += 1;
@@ -6842,6 +7059,7 @@ void destroy_card_table (uint32_t* c_table)
 {
 //  delete (uint32_t*)&card_table_refcount(c_table);
 
+    remove_allocated_card_table (c_table);
     GCToOSInterface::VirtualRelease (&card_table_refcount(c_table), card_table_size(c_table));
     dprintf (2, ("Table Virtual Free : %Ix", (size_t)&card_table_refcount(c_table)));
 }
@@ -6866,13 +7084,26 @@ uint32_t* gc_heap::make_card_table (uint8_t* start, uint8_t* end)
     size_t cb = 0;
 
 #ifdef CARD_BUNDLE
-    if (can_use_write_watch())
+    if (can_use_write_watch_for_card_table())
     {
+#ifndef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
         virtual_reserve_flags |= VirtualReserveFlags::WriteWatch;
+#endif //!FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
         cb = size_card_bundle_of (g_lowest_address, g_highest_address);
     }
 #endif //CARD_BUNDLE
 
+    size_t wws = 0;
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    size_t sw_ww_table_offset = 0;
+    if (gc_can_use_concurrent)
+    {
+        size_t sw_ww_size_before_table = sizeof (card_table_info) + cs + bs + cb;
+        sw_ww_table_offset = SoftwareWriteWatch::GetTableStartByteOffset (sw_ww_size_before_table);
+        wws = sw_ww_table_offset - sw_ww_size_before_table + SoftwareWriteWatch::GetTableByteSize (start, end);
+    }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 #ifdef GROWABLE_SEG_MAPPING_TABLE
     size_t st = size_seg_mapping_table_of (g_lowest_address, g_highest_address);
 #else //GROWABLE_SEG_MAPPING_TABLE
@@ -6881,7 +7112,7 @@ uint32_t* gc_heap::make_card_table (uint8_t* start, uint8_t* end)
 
     // it is impossible for alloc_size to overflow due bounds on each of 
     // its components.
-    size_t alloc_size = sizeof (uint8_t)*(bs + cs + cb + ms + st + sizeof (card_table_info));
+    size_t alloc_size = sizeof (uint8_t)*(bs + cs + cb + wws + ms + st + sizeof (card_table_info));
     size_t alloc_size_aligned = Align (alloc_size, g_SystemInfo.dwAllocationGranularity-1);
 
     uint32_t* ct = (uint32_t*)GCToOSInterface::VirtualReserve (0, alloc_size_aligned, 0, virtual_reserve_flags);
@@ -6895,13 +7126,20 @@ uint32_t* gc_heap::make_card_table (uint8_t* start, uint8_t* end)
     // mark array will be committed separately (per segment).
     size_t commit_size = alloc_size - ms;
 
-    if (!GCToOSInterface::VirtualCommit ((uint8_t*)ct, commit_size))
+    if (!virtual_commit ((uint8_t*)ct, commit_size, commit_bucket_bookkeeping, -1))
     {
         dprintf (2, ("Table commit failed"));
         GCToOSInterface::VirtualRelease ((uint8_t*)ct, alloc_size_aligned);
         return 0;
     }
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    if (gc_can_use_concurrent)
+    {
+        SoftwareWriteWatch::InitializeUntranslatedTable ((uint8_t*)ct + sw_ww_table_offset, start);
+    }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
     // initialize the ref count
     ct = (uint32_t*)((uint8_t*)ct+sizeof (card_table_info));
     card_table_refcount (ct) = 0;
@@ -6910,20 +7148,21 @@ uint32_t* gc_heap::make_card_table (uint8_t* start, uint8_t* end)
     card_table_brick_table (ct) = (short*)((uint8_t*)ct + cs);
     card_table_size (ct) = alloc_size_aligned;
     card_table_next (ct) = 0;
+    add_allocated_card_table (ct, commit_size);
 
 #ifdef CARD_BUNDLE
     card_table_card_bundle_table (ct) = (uint32_t*)((uint8_t*)card_table_brick_table (ct) + bs);
 #endif //CARD_BUNDLE
 
 #ifdef GROWABLE_SEG_MAPPING_TABLE
-    seg_mapping_table = (seg_mapping*)((uint8_t*)card_table_brick_table (ct) + bs + cb);
+    seg_mapping_table = (seg_mapping*)((uint8_t*)card_table_brick_table (ct) + bs + cb + wws);
     seg_mapping_table = (seg_mapping*)((uint8_t*)seg_mapping_table - 
                                         size_seg_mapping_table_of (0, (align_lower_segment (g_lowest_address))));
 #endif //GROWABLE_SEG_MAPPING_TABLE
 
 #ifdef MARK_ARRAY
     if (gc_can_use_concurrent)
-        card_table_mark_array (ct) = (uint32_t*)((uint8_t*)card_table_brick_table (ct) + bs + cb + st);
+        card_table_mark_array (ct) = (uint32_t*)((uint8_t*)card_table_brick_table (ct) + bs + cb + wws + st);
     else
         card_table_mark_array (ct) = NULL;
 #endif //MARK_ARRAY
@@ -7016,6 +7255,9 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
 
         uint32_t virtual_reserve_flags = VirtualReserveFlags::None;
         uint32_t* saved_g_card_table = g_card_table;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+        uint32_t* saved_g_card_bundle_table = g_card_bundle_table;
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
         uint32_t* ct = 0;
         short* bt = 0;
 
@@ -7033,13 +7275,27 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
         size_t cb = 0;
 
 #ifdef CARD_BUNDLE
-        if (can_use_write_watch())
+        if (can_use_write_watch_for_card_table())
         {
+#ifndef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
             virtual_reserve_flags = VirtualReserveFlags::WriteWatch;
+#endif //!FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
             cb = size_card_bundle_of (saved_g_lowest_address, saved_g_highest_address);
         }
 #endif //CARD_BUNDLE
 
+        size_t wws = 0;
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+        size_t sw_ww_table_offset = 0;
+        if (gc_can_use_concurrent)
+        {
+            size_t sw_ww_size_before_table = sizeof (card_table_info) + cs + bs + cb;
+            sw_ww_table_offset = SoftwareWriteWatch::GetTableStartByteOffset (sw_ww_size_before_table);
+            wws = sw_ww_table_offset - sw_ww_size_before_table +
+                  SoftwareWriteWatch::GetTableByteSize (saved_g_lowest_address, saved_g_highest_address);
+        }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 #ifdef GROWABLE_SEG_MAPPING_TABLE
         size_t st = size_seg_mapping_table_of (saved_g_lowest_address, saved_g_highest_address);
 #else //GROWABLE_SEG_MAPPING_TABLE
@@ -7048,10 +7304,10 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
 
         // it is impossible for alloc_size to overflow due bounds on each of 
         // its components.
-        size_t alloc_size = sizeof (uint8_t)*(bs + cs + cb + ms +st + sizeof (card_table_info));
+        size_t alloc_size = sizeof (uint8_t)*(bs + cs + cb + wws + ms +st + sizeof (card_table_info));
         size_t alloc_size_aligned = Align (alloc_size, g_SystemInfo.dwAllocationGranularity-1);
-        dprintf (GC_TABLE_LOG, ("brick table: %Id; card table: %Id; mark array: %Id, card bundle: %Id, seg table: %Id",
-                                  bs, cs, ms, cb, st));
+        dprintf (GC_TABLE_LOG, ("brick table: %Id; card table: %Id; mark array: %Id, card bundle: %Id, sw ww table: %Id, seg table: %Id",
+                                  bs, cs, ms, cb, wws, st));
 
         uint8_t* mem = (uint8_t*)GCToOSInterface::VirtualReserve (0, alloc_size_aligned, 0, virtual_reserve_flags);
 
@@ -7068,16 +7324,19 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
             // mark array will be committed separately (per segment).
             size_t commit_size = alloc_size - ms;
 
-            if (!GCToOSInterface::VirtualCommit (mem, commit_size))
+            if (!virtual_commit (mem, commit_size, commit_bucket_bookkeeping, -1))
             {
                 dprintf (GC_TABLE_LOG, ("Table commit failed"));
                 set_fgm_result (fgm_commit_table, commit_size, loh_p);
                 goto fail;
             }
+
+            ct = (uint32_t*)(mem + sizeof (card_table_info));
+            card_table_refcount (ct) = 0;
+            card_table_size (ct) = alloc_size_aligned;
+            add_allocated_card_table (ct, commit_size);
         }
 
-        ct = (uint32_t*)(mem + sizeof (card_table_info));
-        card_table_refcount (ct) = 0;
         card_table_lowest_address (ct) = saved_g_lowest_address;
         card_table_highest_address (ct) = saved_g_highest_address;
         card_table_next (ct) = &g_card_table[card_word (gcard_of (la))];
@@ -7104,7 +7363,7 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
 
 #ifdef GROWABLE_SEG_MAPPING_TABLE
         {
-            seg_mapping* new_seg_mapping_table = (seg_mapping*)((uint8_t*)card_table_brick_table (ct) + bs + cb);
+            seg_mapping* new_seg_mapping_table = (seg_mapping*)((uint8_t*)card_table_brick_table (ct) + bs + cb + wws);
             new_seg_mapping_table = (seg_mapping*)((uint8_t*)new_seg_mapping_table -
                                               size_seg_mapping_table_of (0, (align_lower_segment (saved_g_lowest_address))));
             memcpy(&new_seg_mapping_table[seg_mapping_word_of(g_lowest_address)],
@@ -7117,13 +7376,19 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
 
 #ifdef MARK_ARRAY
         if(gc_can_use_concurrent)
-            card_table_mark_array (ct) = (uint32_t*)((uint8_t*)card_table_brick_table (ct) + bs + cb + st);
+            card_table_mark_array (ct) = (uint32_t*)((uint8_t*)card_table_brick_table (ct) + bs + cb + wws + st);
         else
             card_table_mark_array (ct) = NULL;
 #endif //MARK_ARRAY
 
         g_card_table = translate_card_table (ct);
 
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+        // Published together with the card table, StompWriteBarrierResize
+        // below patches both into the barriers.
+        g_card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (ct), saved_g_lowest_address);
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
         dprintf (GC_TABLE_LOG, ("card table: %Ix(translated: %Ix), seg map: %Ix, mark array: %Ix", 
             (size_t)ct, (size_t)g_card_table, (size_t)seg_mapping_table, (size_t)card_table_mark_array (ct)));
 
@@ -7155,6 +7420,41 @@ int gc_heap::grow_brick_card_tables (uint8_t* start,
         }
 #endif //BACKGROUND_GC
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+        if (gc_can_use_concurrent)
+        {
+            // Unlike the card table, the write watch table is not merged
+            // lazily from the old tables, so the dirty state is copied over
+            // and the barriers switched to the new table with the runtime
+            // suspended. Being a GC thread is not enough: a BGC thread runs
+            // concurrently with the runtime outside of its suspensions, when
+            // GcInProgress is off, and then has to suspend it like a user
+            // thread does. We are called with gc_lock held, which is what
+            // keeps a concurrent revisit_written_pages off the table.
+            BOOL is_runtime_suspended = (IsGCThread() && GCHeap::IsGCInProgress());
+            if (!is_runtime_suspended)
+            {
+                GCToEEInterface::SuspendEE(GCToEEInterface::SUSPEND_FOR_GC_PREP);
+            }
+
+            SoftwareWriteWatch::SetResizedUntranslatedTable (mem + sw_ww_table_offset,
+                                                             saved_g_lowest_address,
+                                                             saved_g_highest_address);
+
+            StompWriteBarrierResize(la != saved_g_lowest_address);
+
+            g_lowest_address = saved_g_lowest_address;
+            VolatileStore(&g_highest_address, saved_g_highest_address);
+
+            if (!is_runtime_suspended)
+            {
+                GCToEEInterface::RestartEE(FALSE);
+            }
+
+            return 0;
+        }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
         // This passes a bool telling whether we need to switch to the post
         // grow version of the write barrier.  This test tells us if the new
         // segment was allocated at a lower address than the old, requiring
@@ -7184,7 +7484,16 @@ fail:
                 g_card_table = saved_g_card_table; 
             }
 
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+            g_card_bundle_table = saved_g_card_bundle_table;
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
             //delete (uint32_t*)((uint8_t*)ct - sizeof(card_table_info));
+            if (ct)
+            {
+                remove_allocated_card_table (ct);
+            }
+
             if (!GCToOSInterface::VirtualRelease (mem, alloc_size_aligned))
             {
                 dprintf (GC_TABLE_LOG, ("GCToOSInterface::VirtualRelease failed"));
@@ -7370,7 +7679,7 @@ void gc_heap::copy_brick_card_table()
     assert (!gc_can_use_concurrent || 
             (((uint8_t*)card_table_card_bundle_table (ct) + size_card_bundle_of (g_lowest_address, g_highest_address) + st) == (uint8_t*)card_table_mark_array (ct)));
 #endif //MARK_ARRAY && _DEBUG
-    card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (ct));
+    card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (ct), g_lowest_address);
     assert (&card_bundle_table [card_bundle_word (cardw_card_bundle (card_word (card_of (g_lowest_address))))] ==
             card_table_card_bundle_table (ct));
 
@@ -8907,12 +9216,98 @@ int gc_heap::object_gennum_plan (uint8_t* o)
 #pragma optimize("", on)        // Go back to command line default optimizations
 #endif //_MSC_VER && _TARGET_X86_
 
+// Charges size bytes to the committed total, fails if that would go over the hard limit.
+bool gc_heap::commit_within_hard_limit (size_t size, commit_bucket bucket)
+{
+    if (!heap_hard_limit)
+        return true;
+
+    bool within_limit_p = false;
+
+    check_commit_cs.Enter();
+    if ((current_total_committed + size) <= heap_hard_limit)
+    {
+        current_total_committed += size;
+        committed_by_bucket[bucket] += size;
+        within_limit_p = true;
+    }
+    check_commit_cs.Leave();
+
+    if (!within_limit_p)
+    {
+        dprintf (1, ("committing %Id bytes would exceed the hard limit %Id (%Id committed, %Id of it bookkeeping)",
+                     size, heap_hard_limit, current_total_committed, committed_by_bucket[commit_bucket_bookkeeping]));
+    }
+
+    return within_limit_p;
+}
+
+void gc_heap::release_committed (size_t size, commit_bucket bucket)
+{
+    if (!heap_hard_limit)
+        return;
+
+    check_commit_cs.Enter();
+    assert (committed_by_bucket[bucket] >= size);
+    committed_by_bucket[bucket] -= size;
+    current_total_committed -= size;
+    check_commit_cs.Leave();
+}
+
+bool gc_heap::virtual_commit (void* address, size_t size, commit_bucket bucket, int h_number)
+{
+    if (!commit_within_hard_limit (size, bucket))
+        return false;
+
+    bool commit_succeeded_p = (h_number < 0) ?
+        GCToOSInterface::VirtualCommit (address, size) :
+        virtual_alloc_commit_for_heap (address, size, h_number);
+
+    if (!commit_succeeded_p)
+    {
+        release_committed (size, bucket);
+        return false;
+    }
+
+    if (bucket == commit_bucket_heap)
+    {
+        count_commit_change (size, true);
+    }
+    return true;
+}
+
+bool gc_heap::virtual_decommit (void* address, size_t size, commit_bucket bucket)
+{
+    bool decommit_succeeded_p = GCToOSInterface::VirtualDecommit (address, size);
+
+    if (decommit_succeeded_p)
+    {
+        release_committed (size, bucket);
+        if (bucket == commit_bucket_heap)
+        {
+            count_commit_change (size, false);
+        }
+    }
+
+    return decommit_succeeded_p;
+}
+
+void gc_heap::count_commit_change (size_t size, bool commit_p)
+{
+    check_commit_cs.Enter();
+    if (commit_p)
+        total_commit_bytes += size;
+    else
+        total_decommit_bytes += size;
+    check_commit_cs.Leave();
+}
+
 heap_segment* gc_heap::make_heap_segment (uint8_t* new_pages, size_t size, int h_number)
 {
     size_t initial_commit = SEGMENT_INITIAL_COMMIT;
 
     //Commit the first page
-    if (!virtual_alloc_commit_for_heap (new_pages, initial_commit, h_number))
+    if (!virtual_commit (new_pages, initial_commit, commit_bucket_heap, h_number))
     {
         return 0;
     }
@@ -8949,6 +9344,9 @@ void gc_heap::init_heap_segment (heap_segment* seg)
     heap_segment_background_allocated (seg) = 0;
     heap_segment_saved_bg_allocated (seg) = 0;
 #endif //BACKGROUND_GC
+#ifdef MULTIPLE_HEAPS
+    heap_segment_decommit_target (seg) = 0;
+#endif //MULTIPLE_HEAPS
 }
 
 //Releases the segment to the OS.
@@ -9034,7 +9432,20 @@ void gc_heap::decommit_heap_segment_pages (heap_segment* seg,
         page_start += max(extra_space, 32*OS_PAGE_SIZE);
         size -= max (extra_space, 32*OS_PAGE_SIZE);
 
-        GCToOSInterface::VirtualDecommit (page_start, size);
+#ifdef MULTIPLE_HEAPS
+        // The background GC thread and low memory decommit right away, otherwise
+        // decommit_step releases the pages a few at a time after the GC so that
+        // the ones needed again before then are not committed a second time.
+        if (gradual_decommit_p && !settings.concurrent && !g_low_memory_status && !heap_hard_limit)
+        {
+            dprintf (3, ("Decommit target of heap segment %Ix is %Ix", (size_t)seg, (size_t)page_start));
+            heap_segment_decommit_target (seg) = page_start;
+            gradual_decommit_in_progress_p = TRUE;
+            return;
+        }
+#endif //MULTIPLE_HEAPS
+
+        virtual_decommit (page_start, size, commit_bucket_heap);
         dprintf (3, ("Decommitting heap segment [%Ix, %Ix[(%d)", 
             (size_t)page_start, 
             (size_t)(page_start + size),
@@ -9045,6 +9456,11 @@ void gc_heap::decommit_heap_segment_pages (heap_segment* seg,
             heap_segment_used (seg) = heap_segment_committed (seg);
         }
     }
+
+#ifdef MULTIPLE_HEAPS
+    // Whatever is left committed now is kept
+    heap_segment_decommit_target (seg) = 0;
+#endif //MULTIPLE_HEAPS
 }
 
 //decommit all pages except one or 2
@@ -9059,7 +9475,7 @@ void gc_heap::decommit_heap_segment (heap_segment* seg)
 #endif //BACKGROUND_GC
 
     size_t size = heap_segment_committed (seg) - page_start;
-    GCToOSInterface::VirtualDecommit (page_start, size);
+    virtual_decommit (page_start, size, commit_bucket_heap);
 
     //re-init the segment object
     heap_segment_committed (seg) = page_start;
@@ -9193,6 +9609,7 @@ void gc_heap::update_card_table_bundle()
 {
     if (card_bundles_enabled())
     {
+#ifndef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
         uint8_t* base_address = (uint8_t*)(&card_table[card_word (card_of (lowest_address))]);
         uint8_t* saved_base_address = base_address;
         uintptr_t bcount = array_size;
@@ -9239,6 +9656,7 @@ void gc_heap::update_card_table_bundle()
         } while ((bcount >= array_size) && (base_address < high_address));
 
         GCToOSInterface::ResetWriteWatch (saved_base_address, saved_region_size);
+#endif //!FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 
 #ifdef _DEBUG
 
@@ -9299,7 +9717,7 @@ void gc_heap::reset_ww_by_chunk (uint8_t* start_address, size_t total_reset_size
         next_reset_size = ((remaining_reset_size >= ww_reset_quantum) ? ww_reset_quantum : remaining_reset_size);
         if (next_reset_size)
         {
-            GCToOSInterface::ResetWriteWatch (start_address, next_reset_size);
+            reset_write_watch_for_gc_heap (start_address, next_reset_size);
             reset_size += next_reset_size;
 
             switch_one_quantum();
@@ -9368,7 +9786,7 @@ void gc_heap::reset_write_watch (BOOL concurrent_p)
 #endif //TIME_WRITE_WATCH
             dprintf (3, ("h%d: soh ww: [%Ix(%Id)", heap_number, (size_t)base_address, region_size));
             //reset_ww_by_chunk (base_address, region_size);
-            GCToOSInterface::ResetWriteWatch (base_address, region_size);
+            reset_write_watch_for_gc_heap (base_address, region_size);
 
 #ifdef TIME_WRITE_WATCH
             unsigned int time_stop = GetCycleCount32();
@@ -9411,7 +9829,7 @@ void gc_heap::reset_write_watch (BOOL concurrent_p)
 #endif //TIME_WRITE_WATCH
             dprintf (3, ("h%d: loh ww: [%Ix(%Id)", heap_number, (size_t)base_address, region_size));
             //reset_ww_by_chunk (base_address, region_size);
-            GCToOSInterface::ResetWriteWatch (base_address, region_size);
+            reset_write_watch_for_gc_heap (base_address, region_size);
 
 #ifdef TIME_WRITE_WATCH
             unsigned int time_stop = GetCycleCount32();
@@ -9633,12 +10051,16 @@ HRESULT gc_heap::initialize_gc (size_t segment_size,
     HRESULT hres = S_OK;
 
 #ifdef WRITE_WATCH
-    write_watch_api_supported();
+    hardware_write_watch_api_supported();
 #ifdef BACKGROUND_GC
-    if (can_use_write_watch () && g_pConfig->GetGCconcurrent()!=0)
+    if (can_use_write_watch_for_gc_heap() && g_pConfig->GetGCconcurrent()!=0)
     {
         gc_can_use_concurrent = true;
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+        assert (OS_PAGE_SIZE == ((size_t)1 << SOFTWARE_WRITE_WATCH_AddressToTableByteIndexShift));
+#else // !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
         virtual_alloc_write_watch = true;
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
     }
     else
     {
@@ -9647,6 +10069,33 @@ HRESULT gc_heap::initialize_gc (size_t segment_size,
 #endif //BACKGROUND_GC
 #endif //WRITE_WATCH
 
+    // The hard limit has to be known before the first segment is committed
+    // so every commit is accounted for.
+    check_commit_cs.Initialize();
+    current_total_committed = 0;
+    memset (committed_by_bucket, 0, sizeof (committed_by_bucket));
+    heap_hard_limit = (size_t)CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_GCHeapHardLimitMB) * 1024 * 1024;
+
+    if (!heap_hard_limit)
+    {
+        uint32_t hard_limit_percent = CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_GCHeapHardLimitPercent);
+        if ((hard_limit_percent > 0) && (hard_limit_percent < 100))
+        {
+            GCMemoryStatus ms;
+            GCToOSInterface::GetMemoryStatus (&ms);
+            uint64_t physical_mem = ms.ullTotalPhys;
+            uint64_t physical_memory_limit = GCToOSInterface::GetRestrictedPhysicalMemoryLimit();
+            if (physical_memory_limit)
+            {
+                physical_mem = min (physical_mem, physical_memory_limit);
+            }
+
+            heap_hard_limit = (size_t)(physical_mem * hard_limit_percent / 100);
+        }
+    }
+
+    dprintf (1, ("heap hard limit: %Id", heap_hard_limit));
+
     reserved_memory = 0;
     unsigned block_count;
 #ifdef MULTIPLE_HEAPS
@@ -9670,7 +10119,7 @@ HRESULT gc_heap::initialize_gc (size_t segment_size,
     uint64_t th = (uint64_t)SH_TH_CARD_BUNDLE;
 #endif //MULTIPLE_HEAPS
 
-    if ((can_use_write_watch() && reserved_memory >= th))
+    if ((can_use_write_watch_for_card_table() && reserved_memory >= th))
     {
         settings.card_bundles = TRUE;
     }
@@ -9687,11 +10136,25 @@ HRESULT gc_heap::initialize_gc (size_t segment_size,
     if (!g_card_table)
         return E_OUTOFMEMORY;
 
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    g_card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (&g_card_table [card_word (gcard_of (g_lowest_address))]),
+                                                       g_lowest_address);
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
     gc_started = FALSE;
 
 #ifdef MULTIPLE_HEAPS
     n_heaps = number_of_heaps;
 
+    // With a dynamic heap count allocations start on a single heap,
+    // update_dynamic_heap_count activates more as the load requires.
+    dynamic_heap_count_p = (CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_GCDynamicHeapCount) != 0);
+    n_active_heaps = (dynamic_heap_count_p ? 1 : n_heaps);
+    memset (&dynamic_heap_count, 0, sizeof (dynamic_heap_count));
+
+    gradual_decommit_p = (CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_GCGradualDecommit) != 0);
+    gradual_decommit_in_progress_p = FALSE;
+
     g_heaps = new (nothrow) gc_heap* [number_of_heaps];
     if (!g_heaps)
         return E_OUTOFMEMORY;
@@ -9816,6 +10279,8 @@ gc_heap::init_semi_shared()
     last_gc_index = 0;
     should_expand_in_full_gc = FALSE;
 
+    mark_prefetch_p = (CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_GCMarkPrefetch) != 0);
+
 #ifdef FEATURE_LOH_COMPACTION
     loh_compaction_always_p = (g_pConfig->GetGCLOHCompactionMode() != 0);
     loh_compaction_mode = loh_compaction_default;
@@ -10180,7 +10645,7 @@ gc_heap::init_gc_heap (int  h_number)
     lowest_address = card_table_lowest_address (ct);
 
 #ifdef CARD_BUNDLE
-    card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (ct));
+    card_bundle_table = translate_card_bundle_table (card_table_card_bundle_table (ct), g_lowest_address);
     assert (&card_bundle_table [card_bundle_word (cardw_card_bundle (card_word (card_of (g_lowest_address))))] ==
             card_table_card_bundle_table (ct));
 #endif //CARD_BUNDLE
@@ -10234,6 +10699,8 @@ gc_heap::init_gc_heap (int  h_number)
     //assign the alloc_list for the large generation 
     generation_table [max_generation+1].free_list_allocator = allocator(NUM_LOH_ALIST, BASE_LOH_ALIST, loh_alloc_list);
     generation_table [max_generation+1].gen_num = max_generation+1;
+    poh_allocator = allocator(NUM_POH_ALIST, BASE_POH_ALIST, poh_alloc_list);
+    poh_allocator.clear();
     make_generation (generation_table [max_generation+1],lseg, heap_segment_mem (lseg), 0);
     heap_segment_allocated (lseg) = heap_segment_mem (lseg) + Align (min_obj_size, get_alignment_constant (FALSE));
     heap_segment_used (lseg) = heap_segment_allocated (lseg) - plug_skew;
@@ -10286,6 +10753,10 @@ gc_heap::init_gc_heap (int  h_number)
     //needs to be done after the dynamic data has been initialized
 #ifndef MULTIPLE_HEAPS
     allocation_running_amount = dd_min_gc_size (dynamic_data_of (0));
+#else
+    gen0_budget_peak = 0;
+    gen0_budget_previous_peak = 0;
+    gen0_budget_window_start = 0;
 #endif //!MULTIPLE_HEAPS
 
     fgn_last_alloc = dd_min_gc_size (dynamic_data_of (0));
@@ -10593,9 +11064,17 @@ BOOL gc_heap::grow_heap_segment (heap_segment* seg, uint8_t* high_address)
                 "Growing heap_segment: %Ix high address: %Ix\n",
                 (size_t)seg, (size_t)high_address);
 
+    if (heap_hard_limit)
+    {
+        // Don't let the minimum growth push us over the limit when what is needed would fit.
+        size_t needed_size = align_on_page ((size_t)(high_address - heap_segment_committed (seg)));
+        size_t remaining_size = heap_hard_limit - min (heap_hard_limit, current_total_committed);
+        c_size = max (needed_size, min (c_size, remaining_size));
+    }
+
     dprintf(3, ("Growing segment allocation %Ix %Ix", (size_t)heap_segment_committed(seg),c_size));
     
-    if (!virtual_alloc_commit_for_heap(heap_segment_committed (seg), c_size, heap_number))
+    if (!virtual_commit (heap_segment_committed (seg), c_size, commit_bucket_heap, heap_number))
     {
         dprintf(3, ("Cannot grow heap segment"));
         return FALSE;
@@ -11232,6 +11711,13 @@ void gc_heap::handle_oom (int heap_num, oom_reason reason, size_t alloc_size,
         reason = oom_low_mem;
     }
 
+    if (heap_hard_limit && ((reason == oom_cant_commit) || (reason == oom_loh)) &&
+        ((current_total_committed + alloc_size) > heap_hard_limit))
+    {
+        // We couldn't commit because of the limit, not because the OS is out of memory.
+        reason = oom_commit_hard_limit;
+    }
+
     oom_info.reason = reason;
     oom_info.allocated = allocated;
     oom_info.reserved = reserved;
@@ -11665,7 +12151,8 @@ void gc_heap::bgc_loh_alloc_clr (uint8_t* alloc_start,
 
 BOOL gc_heap::a_fit_free_list_large_p (size_t size, 
                                        alloc_context* acontext,
-                                       int align_const)
+                                       int align_const,
+                                       BOOL pinned_p)
 {
 #ifdef BACKGROUND_GC
     wait_for_background_planning (awr_loh_alloc_during_plan);
@@ -11674,7 +12161,7 @@ BOOL gc_heap::a_fit_free_list_large_p (size_t size,
     BOOL can_fit = FALSE;
     int gen_number = max_generation + 1;
     generation* gen = generation_of (gen_number);
-    allocator* loh_allocator = generation_allocator (gen); 
+    allocator* loh_allocator = (pinned_p ? &poh_allocator : generation_allocator (gen)); 
 
 #ifdef FEATURE_LOH_COMPACTION
     size_t loh_pad = Align (loh_padding_obj_size, align_const);
@@ -11730,7 +12217,7 @@ BOOL gc_heap::a_fit_free_list_large_p (size_t size,
                     }
                     if (remain_size >= Align(min_free_list, align_const))
                     {
-                        loh_thread_gap_front (remain, remain_size, gen);
+                        loh_thread_gap_front (remain, remain_size, gen, loh_allocator);
                         assert (remain_size >= Align (min_obj_size, align_const));
                     }
                     else
@@ -11875,6 +12362,7 @@ BOOL gc_heap::loh_a_fit_segment_end_p (int gen_number,
                                        size_t size, 
                                        alloc_context* acontext,
                                        int align_const,
+                                       BOOL pinned_p,
                                        BOOL* commit_failed_p,
                                        oom_reason* oom_r)
 {
@@ -11884,8 +12372,13 @@ BOOL gc_heap::loh_a_fit_segment_end_p (int gen_number,
 
     while (seg)
     {
-        if (a_fit_segment_end_p (gen_number, seg, (size - Align (min_obj_size, align_const)), 
-                                 acontext, align_const, commit_failed_p))
+        // Pinned objects only go on pinned object segments and nothing else does.
+        if (!heap_segment_poh_p (seg) != !pinned_p)
+        {
+            seg = heap_segment_next_rw (seg);
+        }
+        else if (a_fit_segment_end_p (gen_number, seg, (size - Align (min_obj_size, align_const)), 
+                                      acontext, align_const, commit_failed_p))
         {
             acontext->alloc_limit += Align (min_obj_size, align_const);
             can_allocate_p = TRUE;
@@ -12335,6 +12828,7 @@ size_t gc_heap::get_large_seg_size (size_t size)
 BOOL gc_heap::loh_get_new_seg (generation* gen,
                                size_t size,
                                int align_const,
+                               BOOL pinned_p,
                                BOOL* did_full_compact_gc,
                                oom_reason* oom_r)
 {
@@ -12345,7 +12839,7 @@ BOOL gc_heap::loh_get_new_seg (generation* gen,
 
     size_t seg_size = get_large_seg_size (size);
 
-    heap_segment* new_seg = get_large_segment (seg_size, did_full_compact_gc);
+    heap_segment* new_seg = get_large_segment (seg_size, pinned_p, did_full_compact_gc);
 
     if (new_seg)
     {
@@ -12410,15 +12904,16 @@ BOOL gc_heap::loh_try_fit (int gen_number,
                            size_t size, 
                            alloc_context* acontext,
                            int align_const,
+                           BOOL pinned_p,
                            BOOL* commit_failed_p,
                            oom_reason* oom_r)
 {
     BOOL can_allocate = TRUE;
 
-    if (!a_fit_free_list_large_p (size, acontext, align_const))
+    if (!a_fit_free_list_large_p (size, acontext, align_const, pinned_p))
     {
         can_allocate = loh_a_fit_segment_end_p (gen_number, size, 
-                                                acontext, align_const, 
+                                                acontext, align_const, pinned_p,
                                                 commit_failed_p, oom_r);
 
 #ifdef BACKGROUND_GC
@@ -12529,7 +13024,8 @@ void gc_heap::add_saved_loh_state (allocation_state loh_state_to_save, EEThreadI
 BOOL gc_heap::allocate_large (int gen_number,
                               size_t size, 
                               alloc_context* acontext,
-                              int align_const)
+                              int align_const,
+                              BOOL pinned_p)
 {
 #ifdef BACKGROUND_GC
     if (recursive_gc_sync::background_running_p() && (current_c_gc_state != c_gc_state_planning))
@@ -12600,7 +13096,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 loh_alloc_state = (can_use_existing_p ?
                                         a_state_can_allocate : 
                                         (commit_failed_p ? 
@@ -12615,7 +13111,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 // Even after we got a new seg it doesn't necessarily mean we can allocate,
                 // another LOH allocating thread could have beat us to acquire the msl so 
                 // we need to try again.
@@ -12629,7 +13125,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 // Even after we got a new seg it doesn't necessarily mean we can allocate,
                 // another LOH allocating thread could have beat us to acquire the msl so 
                 // we need to try again. However, if we failed to commit, which means we 
@@ -12649,7 +13145,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 loh_alloc_state = (can_use_existing_p ? a_state_can_allocate : a_state_cant_allocate);
                 assert ((loh_alloc_state == a_state_can_allocate) == (acontext->alloc_ptr != 0));
                 assert ((loh_alloc_state != a_state_cant_allocate) || (oom_r != oom_no_failure));
@@ -12661,7 +13157,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 loh_alloc_state = (can_use_existing_p ?
                                         a_state_can_allocate : 
                                         (commit_failed_p ? 
@@ -12676,7 +13172,7 @@ BOOL gc_heap::allocate_large (int gen_number,
                 BOOL can_use_existing_p = FALSE;
 
                 can_use_existing_p = loh_try_fit (gen_number, size, acontext, 
-                                                  align_const, &commit_failed_p, &oom_r);
+                                                  align_const, pinned_p, &commit_failed_p, &oom_r);
                 loh_alloc_state = (can_use_existing_p ?
                                         a_state_can_allocate : 
                                         (commit_failed_p ? 
@@ -12692,7 +13188,7 @@ BOOL gc_heap::allocate_large (int gen_number,
 
                 current_full_compact_gc_count = get_full_compact_gc_count();
 
-                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, &did_full_compacting_gc, &oom_r);
+                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, pinned_p, &did_full_compacting_gc, &oom_r);
                 loh_alloc_state = (can_get_new_seg_p ? 
                                         a_state_try_fit_new_seg : 
                                         (did_full_compacting_gc ? 
@@ -12707,7 +13203,7 @@ BOOL gc_heap::allocate_large (int gen_number,
 
                 current_full_compact_gc_count = get_full_compact_gc_count();
 
-                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, &did_full_compacting_gc, &oom_r);
+                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, pinned_p, &did_full_compacting_gc, &oom_r);
                 // Since we release the msl before we try to allocate a seg, other
                 // threads could have allocated a bunch of segments before us so
                 // we might need to retry.
@@ -12723,7 +13219,7 @@ BOOL gc_heap::allocate_large (int gen_number,
              
                 current_full_compact_gc_count = get_full_compact_gc_count();
 
-                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, &did_full_compacting_gc, &oom_r); 
+                can_get_new_seg_p = loh_get_new_seg (gen, size, align_const, pinned_p, &did_full_compacting_gc, &oom_r); 
                 loh_alloc_state = (can_get_new_seg_p ? 
                                         a_state_try_fit_new_seg : 
                                         (did_full_compacting_gc ? 
@@ -12810,7 +13306,7 @@ exit:
 }
 
 int gc_heap::try_allocate_more_space (alloc_context* acontext, size_t size,
-                                   int gen_number)
+                                   int gen_number, BOOL pinned_p)
 {
     if (gc_heap::gc_started)
     {
@@ -12900,7 +13396,7 @@ int gc_heap::try_allocate_more_space (alloc_context* acontext, size_t size,
 
     BOOL can_allocate = ((gen_number == 0) ?
         allocate_small (gen_number, size, acontext, align_const) :
-        allocate_large (gen_number, size, acontext, align_const));
+        allocate_large (gen_number, size, acontext, align_const, pinned_p));
    
     if (can_allocate)
     {
@@ -12936,8 +13432,11 @@ int gc_heap::try_allocate_more_space (alloc_context* acontext, size_t size,
 #ifdef MULTIPLE_HEAPS
 void gc_heap::balance_heaps (alloc_context* acontext)
 {
+    // A context whose heap was deactivated at the last GC is moved off it right away
+    BOOL inactive_heap_p = ((acontext->alloc_count != 0) &&
+                            (acontext->alloc_heap->pGenGCHeap->heap_number >= n_active_heaps));
 
-    if (acontext->alloc_count < 4)
+    if ((acontext->alloc_count < 4) && !inactive_heap_p)
     {
         if (acontext->alloc_count == 0)
         {
@@ -12969,6 +13468,9 @@ void gc_heap::balance_heaps (alloc_context* acontext)
                 set_home_heap = TRUE;
         }
 
+        if (inactive_heap_p)
+            set_home_heap = TRUE;
+
         if (set_home_heap)
         {
 /*
@@ -12994,8 +13496,18 @@ void gc_heap::balance_heaps (alloc_context* acontext)
                 size_t delta = dd_min_size (dd)/4;
 
                 int start, end, finish;
-                heap_select::get_heap_range_for_heap(org_hp->heap_number, &start, &end);
-                finish = start + n_heaps;
+                if (n_active_heaps < n_heaps)
+                {
+                    // The active heaps are the lowest numbered ones, don't bother with numa nodes
+                    start = 0;
+                    end = n_active_heaps;
+                    finish = n_active_heaps;
+                }
+                else
+                {
+                    heap_select::get_heap_range_for_heap(org_hp->heap_number, &start, &end);
+                    finish = start + n_heaps;
+                }
 
 try_again:
                 do
@@ -13012,6 +13524,10 @@ try_again:
                     if (max_alloc_context_count > 1)
                         max_size /= max_alloc_context_count;
 
+                    // Any active heap is better than an inactive one
+                    if (inactive_heap_p)
+                        max_size = -SSIZE_T_MAX;
+
                     for (int i = start; i < end; i++)
                     {
                         gc_heap* hp = GCHeap::GetHeap(i%n_heaps)->pGenGCHeap;
@@ -13164,10 +13680,123 @@ try_again:
         return org_hp;
     }
 }
+
+// Called by heap 0 at the start of every blocking GC, with the EE suspended
+void gc_heap::record_dynamic_heap_count_gc_start()
+{
+    dynamic_heap_count_data* dhc = &dynamic_heap_count;
+    dhc->gc_start_time = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
+    size_t gen0_allocated = 0;
+    for (int i = 0; i < n_heaps; i++)
+    {
+        dynamic_data* dd = g_heaps[i]->dynamic_data_of (0);
+        ptrdiff_t allocated = (ptrdiff_t)dd_desired_allocation (dd) - dd_new_allocation (dd);
+        if (allocated > 0)
+            gen0_allocated += (size_t)allocated;
+    }
+    dhc->gen0_allocated = gen0_allocated;
+}
+
+// Called by the last thread to join at the end of a blocking GC, before the
+// gen0 budgets are equalized.
+//
+// The active heap count is driven by the share of time spent in GC: when the
+// median over the last dynamic_heap_count_data::sample_count GCs goes above
+// target_gc_percent more heaps are activated so each GC comes later, when it
+// is well below heaps are deactivated as long as the measured gen0 allocation
+// rate wouldn't trigger gen0 GCs more often than every min_gc_interval_ms.
+void gc_heap::update_dynamic_heap_count()
+{
+    const double target_gc_percent = 5.0;
+    const double shrink_gc_percent = 1.0;
+    const uint64_t min_gc_interval_ms = 50;
+
+    dynamic_heap_count_data* dhc = &dynamic_heap_count;
+    uint64_t now = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
+    if ((dhc->last_gc_end_time != 0) && (dhc->gc_start_time > dhc->last_gc_end_time))
+    {
+        dynamic_heap_count_data::sample* s = &dhc->samples[dhc->sample_index];
+        s->mutator_time = dhc->gc_start_time - dhc->last_gc_end_time;
+        s->gc_time = now - dhc->gc_start_time;
+        s->gen0_allocated = dhc->gen0_allocated;
+        dhc->sample_index = (dhc->sample_index + 1) % dynamic_heap_count_data::sample_count;
+        dhc->samples_since_change++;
+    }
+    dhc->last_gc_end_time = now;
+
+    if (dhc->samples_since_change < dynamic_heap_count_data::sample_count)
+        return;
+
+    double gc_percents[dynamic_heap_count_data::sample_count];
+    uint64_t total_mutator_time = 0;
+    uint64_t total_gen0_allocated = 0;
+    for (int i = 0; i < dynamic_heap_count_data::sample_count; i++)
+    {
+        dynamic_heap_count_data::sample* s = &dhc->samples[i];
+        gc_percents[i] = (double)s->gc_time * 100.0 / (double)(s->gc_time + s->mutator_time);
+        total_mutator_time += s->mutator_time;
+        total_gen0_allocated += s->gen0_allocated;
+    }
+
+    // The median, so that a single unusual GC doesn't change the heap count
+    for (int i = 1; i < dynamic_heap_count_data::sample_count; i++)
+    {
+        for (int j = i; (j > 0) && (gc_percents[j - 1] > gc_percents[j]); j--)
+        {
+            double t = gc_percents[j];
+            gc_percents[j] = gc_percents[j - 1];
+            gc_percents[j - 1] = t;
+        }
+    }
+    double median_gc_percent = gc_percents[dynamic_heap_count_data::sample_count / 2];
+
+    int new_n_active_heaps = n_active_heaps;
+
+    if ((median_gc_percent > target_gc_percent) && (n_active_heaps < n_heaps))
+    {
+        // Double the heap count when far off the target, grow by half of it otherwise
+        int step = ((median_gc_percent > 2 * target_gc_percent) ? n_active_heaps : max (1, n_active_heaps / 2));
+        new_n_active_heaps = min (n_heaps, n_active_heaps + step);
+    }
+    else if ((median_gc_percent < shrink_gc_percent) && (n_active_heaps > 1))
+    {
+        int candidate = n_active_heaps - max (1, n_active_heaps / 4);
+
+        // Each active heap gets about the average gen0 budget of the active heaps
+        size_t total_budget = 0;
+        for (int i = 0; i < n_active_heaps; i++)
+        {
+            total_budget += dd_desired_allocation (g_heaps[i]->dynamic_data_of (0));
+        }
+        double budget_per_heap = (double)total_budget / n_active_heaps;
+
+        double gen0_allocation_rate = ((total_mutator_time != 0) ?
+                                       ((double)total_gen0_allocated / (double)total_mutator_time) :
+                                       0.0);
+        double min_gc_interval = (double)qpf * min_gc_interval_ms / 1000;
+
+        if ((gen0_allocation_rate == 0.0) ||
+            ((budget_per_heap * candidate / gen0_allocation_rate) >= min_gc_interval))
+        {
+            new_n_active_heaps = candidate;
+        }
+    }
+
+    if (new_n_active_heaps != n_active_heaps)
+    {
+        dprintf (GTC_LOG, ("GC#%d: %d%% of the time in GC, going from %d to %d active heaps",
+            VolatileLoad(&settings.gc_index), (int)median_gc_percent, n_active_heaps, new_n_active_heaps));
+
+        n_active_heaps = new_n_active_heaps;
+        dhc->samples_since_change = 0;
+    }
+}
 #endif //MULTIPLE_HEAPS
 
 BOOL gc_heap::allocate_more_space(alloc_context* acontext, size_t size,
-                                  int alloc_generation_number)
+                                  int alloc_generation_number, BOOL pinned_p)
 {
     int status;
     do
@@ -13176,15 +13805,15 @@ BOOL gc_heap::allocate_more_space(alloc_context* acontext, size_t size,
         if (alloc_generation_number == 0) 
         {
             balance_heaps (acontext);
-            status = acontext->alloc_heap->pGenGCHeap->try_allocate_more_space (acontext, size, alloc_generation_number);
+            status = acontext->alloc_heap->pGenGCHeap->try_allocate_more_space (acontext, size, alloc_generation_number, pinned_p);
         }
         else
         {
             gc_heap* alloc_heap = balance_heaps_loh (acontext, size);
-            status = alloc_heap->try_allocate_more_space (acontext, size, alloc_generation_number);
+            status = alloc_heap->try_allocate_more_space (acontext, size, alloc_generation_number, pinned_p);
         }
 #else
-        status = try_allocate_more_space (acontext, size, alloc_generation_number);
+        status = try_allocate_more_space (acontext, size, alloc_generation_number, pinned_p);
 #endif //MULTIPLE_HEAPS
     } while (status == -1);
     
@@ -13215,7 +13844,7 @@ CObjectHeader* gc_heap::allocate (size_t jsize, alloc_context* acontext)
 #pragma inline_depth(0)
 #endif //_MSC_VER
 
-            if (! allocate_more_space (acontext, size, 0))
+            if (! allocate_more_space (acontext, size, 0, FALSE))
                 return 0;
 
 #ifdef _MSC_VER
@@ -15029,6 +15658,12 @@ void gc_heap::gc1()
     mark_time = plan_time = reloc_time = compact_time = sweep_time = 0;
 #endif //TIME_GC
 
+    if (!settings.concurrent)
+    {
+        memset (pause_phase_time, 0, sizeof (pause_phase_time));
+        pause_phases_run = 0;
+    }
+
     verify_soh_segment_list();
 
     int n = settings.condemned_generation;
@@ -15399,6 +16034,11 @@ void gc_heap::gc1()
         {
             gc_heap::internal_gc_done = false;
 
+            if (dynamic_heap_count_p)
+            {
+                update_dynamic_heap_count();
+            }
+
             //equalize the new desired size of the generations
             int limit = settings.condemned_generation;
             if (limit == max_generation)
@@ -15409,7 +16049,10 @@ void gc_heap::gc1()
             {
                 size_t total_desired = 0;
 
-                for (int i = 0; i < gc_heap::n_heaps; i++)
+                // Only the active heaps allocate in gen0, so only they share its budget
+                int budget_heaps = ((gen == 0) ? gc_heap::n_active_heaps : gc_heap::n_heaps);
+
+                for (int i = 0; i < budget_heaps; i++)
                 {
                     gc_heap* hp = gc_heap::g_heaps[i];
                     dynamic_data* dd = hp->dynamic_data_of (gen);
@@ -15423,7 +16066,7 @@ void gc_heap::gc1()
                     total_desired = temp_total_desired;
                 }
 
-                size_t desired_per_heap = Align (total_desired/gc_heap::n_heaps,
+                size_t desired_per_heap = Align (total_desired/budget_heaps,
                                                     get_alignment_constant ((gen != (max_generation+1))));
 
                 if (gen == 0)
@@ -15478,13 +16121,20 @@ void gc_heap::gc1()
                 {
                     gc_heap* hp = gc_heap::g_heaps[i];
                     dynamic_data* dd = hp->dynamic_data_of (gen);
-                    dd_desired_allocation (dd) = desired_per_heap;
-                    dd_gc_new_allocation (dd) = desired_per_heap;
-                    dd_new_allocation (dd) = desired_per_heap;
+                    size_t desired = desired_per_heap;
+                    if (i >= budget_heaps)
+                    {
+                        // An inactive heap, keep its gen0 as small as possible so
+                        // decommit_ephemeral_segment_pages can release the space.
+                        desired = Align (dd_min_size (dd), get_alignment_constant (TRUE));
+                    }
+                    dd_desired_allocation (dd) = desired;
+                    dd_gc_new_allocation (dd) = desired;
+                    dd_new_allocation (dd) = desired;
 
                     if (gen == 0)
                     {
-                        hp->fgn_last_alloc = desired_per_heap;
+                        hp->fgn_last_alloc = desired;
                     }
                 }
             }
@@ -15709,7 +16359,7 @@ BOOL gc_heap::find_loh_space_for_no_gc()
     while (seg)
     {
         size_t remaining = heap_segment_reserved (seg) - heap_segment_allocated (seg);
-        if (remaining >= loh_allocation_no_gc)
+        if ((remaining >= loh_allocation_no_gc) && !heap_segment_poh_p (seg))
         {
             saved_loh_segment_no_gc = seg;
             break;
@@ -15720,7 +16370,7 @@ BOOL gc_heap::find_loh_space_for_no_gc()
     if (!saved_loh_segment_no_gc && current_no_gc_region_info.minimal_gc_p)
     {
         // If no full GC is allowed, we try to get a new seg right away.
-        saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc)
+        saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc), FALSE
 #ifdef MULTIPLE_HEAPS
                                                       , this
 #endif //MULTIPLE_HEAPS
@@ -16117,7 +16767,7 @@ void gc_heap::allocate_for_no_gc_after_gc()
                     gc_heap* hp = g_heaps[i];
                     if (hp->gc_policy == policy_expand)
                     {
-                        hp->saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc), hp);
+                        hp->saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc), FALSE, hp);
                         if (!(hp->saved_loh_segment_no_gc))
                             current_no_gc_region_info.start_status = start_no_gc_no_memory;
                     }
@@ -16127,7 +16777,7 @@ void gc_heap::allocate_for_no_gc_after_gc()
 #else //MULTIPLE_HEAPS
             if (gc_policy == policy_expand)
             {
-                saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc));
+                saved_loh_segment_no_gc = get_segment_for_loh (get_large_seg_size (loh_allocation_no_gc), FALSE);
                 if (!saved_loh_segment_no_gc)
                     current_no_gc_region_info.start_status = start_no_gc_no_memory;
             }
@@ -16187,6 +16837,10 @@ int gc_heap::garbage_collect (int n)
         clear_gen0_bricks();
 #endif //MULTIPLE_HEAPS
 
+#ifdef FEATURE_PREMORTEM_FINALIZATION
+        finalize_queue->MergeRegistrationBuffers();
+#endif // FEATURE_PREMORTEM_FINALIZATION
+
         if ((settings.pause_mode == pause_no_gc) && current_no_gc_region_info.minimal_gc_p)
         {
 #ifdef MULTIPLE_HEAPS
@@ -16408,6 +17062,11 @@ int gc_heap::garbage_collect (int n)
             do_pre_gc();
 
 #ifdef MULTIPLE_HEAPS
+            if (dynamic_heap_count_p && !settings.concurrent)
+            {
+                record_dynamic_heap_count_gc_start();
+            }
+
             gc_start_event.Reset();
             //start all threads on the roots.
             dprintf(3, ("Starting all gc threads for gc"));
@@ -17313,6 +17972,76 @@ inline void Prefetch (void* addr)
     UNREFERENCED_PARAMETER(addr);
 }
 #endif //PREFETCH
+
+// Unlike Prefetch above this one is always on, it's used by the mark queue
+// below which does nothing but hide the latency of the prefetch.
+inline void PrefetchForMark (void* addr)
+{
+#if defined(_MSC_VER) && defined(PF_TEMPORAL_LEVEL_1)
+    PreFetchCacheLine (PF_TEMPORAL_LEVEL_1, addr);
+#elif defined(__GNUC__)
+    __builtin_prefetch (addr);
+#else
+    UNREFERENCED_PARAMETER(addr);
+#endif
+}
+
+// A small FIFO of children that have been read from their parent but not
+// marked yet. Marking an object reads its method table so on heaps made
+// of small, scattered objects the mark loop stalls on a cache miss for
+// almost every child. With the queue the child is prefetched when it's
+// read and only marked once MARK_QUEUE_SLOTS other children have been
+// read after it, by which time it's hopefully in the cache.
+//
+// Callers must mark what they get back from queue and drain the queue
+// before they're done marking.
+#define MARK_QUEUE_SLOTS 16
+
+class mark_queue
+{
+    uint8_t* slots[MARK_QUEUE_SLOTS];
+    size_t   current;
+
+public:
+    mark_queue()
+    {
+        memset (slots, 0, sizeof (slots));
+        current = 0;
+    }
+
+    // Prefetches o and parks it in the queue, returns the object that has
+    // been waiting the longest (may be 0).
+    uint8_t* queue (uint8_t* o)
+    {
+        if (o)
+        {
+            PrefetchForMark (o);
+        }
+
+        uint8_t* oldest = slots[current];
+        slots[current] = o;
+        current = (current + 1) % MARK_QUEUE_SLOTS;
+        return oldest;
+    }
+
+    // Returns the next object still waiting, 0 once the queue is empty.
+    uint8_t* dequeue ()
+    {
+        for (int i = 0; i < MARK_QUEUE_SLOTS; i++)
+        {
+            uint8_t* o = slots[current];
+            slots[current] = 0;
+            current = (current + 1) % MARK_QUEUE_SLOTS;
+            if (o)
+            {
+                return o;
+            }
+        }
+
+        return 0;
+    }
+};
+
 #ifdef MH_SC_MARK
 inline
 VOLATILE(uint8_t*)& gc_heap::ref_mark_stack (gc_heap* hp, int index)
@@ -17374,6 +18103,9 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
     // update mark list.
     BOOL  full_p = (settings.condemned_generation == max_generation);
 
+    mark_queue children;
+    BOOL queue_p = mark_prefetch_p;
+
     assert ((start >= oo) && (start < oo+size(oo)));
 
 #ifndef MH_SC_MARK
@@ -17416,6 +18148,10 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
                                           {
                                               uint8_t* o = *ppslot;
                                               Prefetch(o);
+                                              if (queue_p)
+                                              {
+                                                  o = children.queue (o);
+                                              }
                                               if (gc_mark (o, gc_low, gc_high))
                                               {
                                                   if (full_p)
@@ -17506,6 +18242,10 @@ void gc_heap::mark_object_simple1 (uint8_t* oo, uint8_t* start THREAD_NUMBER_DCL
                                        {
                                            uint8_t* o = *ppslot;
                                            Prefetch(o);
+                                           if (queue_p)
+                                           {
+                                               o = children.queue (o);
+                                           }
                                            if (gc_mark (o, gc_low, gc_high))
                                            {
                                                 if (full_p)
@@ -17579,6 +18319,41 @@ more_to_do:
             sorted_tos = min ((size_t)sorted_tos, (size_t)mark_stack_tos);
 #endif //SORT_MARK_STACK
         }
+        else if (queue_p)
+        {
+            // The stack is empty but the children still in the queue haven't
+            // been marked yet. Push the first one that has children and take
+            // it off the stack like any other object - a partially marked
+            // object expects its own slot right below the one that records
+            // where to continue.
+            uint8_t* o = 0;
+            while ((o = children.dequeue()) != 0)
+            {
+                if (gc_mark (o, gc_low, gc_high))
+                {
+                    if (full_p)
+                    {
+                        m_boundary_fullgc (o);
+                    }
+                    else
+                    {
+                        m_boundary (o);
+                    }
+                    size_t obj_size = size (o);
+                    promoted_bytes (thread) += obj_size;
+                    if (contain_pointers_or_collectible (o))
+                    {
+                        *(mark_stack_tos++) = o;
+                        break;
+                    }
+                }
+            }
+
+            if (o == 0)
+                break;
+
+            goto next_level;
+        }
         else
             break;
     }
@@ -17995,6 +18770,9 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
 
     background_mark_stack_tos = background_mark_stack_array;
 
+    mark_queue children;
+    BOOL queue_p = mark_prefetch_p;
+
     while (1)
     {
 #ifdef MULTIPLE_HEAPS
@@ -18033,6 +18811,10 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
                     {
                         uint8_t* o = *ppslot;
                         Prefetch(o);
+                        if (queue_p)
+                        {
+                            o = children.queue (o);
+                        }
                         if (background_mark (o, 
                                              background_saved_lowest_address, 
                                              background_saved_highest_address))
@@ -18122,6 +18904,10 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
                     {
                         uint8_t* o = *ppslot;
                         Prefetch(o);
+                        if (queue_p)
+                        {
+                            o = children.queue (o);
+                        }
 
                         if (background_mark (o, 
                                             background_saved_lowest_address, 
@@ -18167,7 +18953,47 @@ void gc_heap::background_mark_simple1 (uint8_t* oo THREAD_NUMBER_DCL)
         }
 #endif //SORT_MARK_STACK
 
-        allow_fgc();
+        // A foreground GC that happens in allow_fgc only updates what is on
+        // the mark stack, so nothing can be left in the queue at that point.
+        // The request to yield is read once, allow_fgc is only called if the
+        // queue was drained for it (it may find the request gone, but a
+        // request that shows up in between waits for the next round).
+        // Once the stack is empty the queue needs to be emptied anyway.
+        BOOL yield_p = !queue_p || GCToEEInterface::CatchAtSafePoint(bgc_thread);
+
+        if (queue_p &&
+            ((background_mark_stack_tos == background_mark_stack_array) || yield_p))
+        {
+            uint8_t* o = 0;
+            while ((o = children.dequeue()) != 0)
+            {
+                if (background_mark (o, 
+                                     background_saved_lowest_address, 
+                                     background_saved_highest_address))
+                {
+                    size_t obj_size = size (o);
+                    bpromoted_bytes (thread) += obj_size;
+                    if (contain_pointers_or_collectible (o))
+                    {
+                        if (background_mark_stack_tos < mark_stack_limit)
+                        {
+                            *(background_mark_stack_tos++) = o;
+                        }
+                        else
+                        {
+                            dprintf (3,("mark stack overflow for object %Ix ", (size_t)o));
+                            background_min_overflow_address = min (background_min_overflow_address, o);
+                            background_max_overflow_address = max (background_max_overflow_address, o);
+                        }
+                    }
+                }
+            }
+        }
+
+        if (yield_p)
+        {
+            allow_fgc();
+        }
 
         if (!(background_mark_stack_tos == background_mark_stack_array))
         {
@@ -18448,9 +19274,9 @@ void gc_heap::fix_card_table ()
 #ifdef TIME_WRITE_WATCH
             unsigned int time_start = GetCycleCount32();
 #endif //TIME_WRITE_WATCH
-            bool success = GCToOSInterface::GetWriteWatch(reset_watch_state, base_address, region_size,
-                                                          (void**)g_addresses,
-                                                          &bcount);
+            bool success = get_write_watch_for_gc_heap (reset_watch_state, base_address, region_size,
+                                                        (void**)g_addresses,
+                                                        &bcount, true);
             assert (success);
 
 #ifdef TIME_WRITE_WATCH
@@ -18460,14 +19286,16 @@ void gc_heap::fix_card_table ()
                     time_stop - time_start, tot_cycles);
 #endif //TIME_WRITE_WATCH
 
-            assert( ((card_size * card_word_width)&(OS_PAGE_SIZE-1))==0 );
             //printf ("%Ix written into\n", bcount);
             dprintf (3,("Found %Id pages written", bcount));
             for (unsigned  i = 0; i < bcount; i++)
             {
-                for (unsigned j = 0; j< (card_size*card_word_width)/OS_PAGE_SIZE; j++)
+                // A card word covers less than a page with small cards
+                size_t start_cardw = card_word (card_of (g_addresses [i]));
+                size_t end_cardw = card_word (card_of (g_addresses [i] + OS_PAGE_SIZE - 1));
+                for (size_t cardw = start_cardw; cardw <= end_cardw; cardw++)
                 {
-                    card_table [card_word (card_of (g_addresses [i]))+j] = ~0u;
+                    card_table [cardw] = ~0u;
                 }
                 dprintf (2,("Set Cards [%Ix:%Ix, %Ix:%Ix[",
                       card_of (g_addresses [i]), (size_t)g_addresses [i],
@@ -18488,7 +19316,7 @@ void gc_heap::fix_card_table ()
             align_on_page (generation_allocation_start (generation_of (0)));
         size_t region_size =
             heap_segment_allocated (ephemeral_heap_segment) - base_address;
-        GCToOSInterface::ResetWriteWatch (base_address, region_size);
+        reset_write_watch_for_gc_heap (base_address, region_size);
     }
 #endif //BACKGROUND_GC
 #endif //WRITE_WATCH
@@ -18885,6 +19713,11 @@ size_t gc_heap::committed_size()
 
 size_t gc_heap::get_total_committed_size()
 {
+    if (heap_hard_limit)
+    {
+        return current_total_committed;
+    }
+
     size_t total_committed = 0;
 
 #ifdef MULTIPLE_HEAPS
@@ -18906,6 +19739,21 @@ void gc_heap::get_memory_info (uint32_t* memory_load,
                                uint64_t* available_physical,
                                uint64_t* available_page_file)
 {
+    if (heap_hard_limit)
+    {
+        // The load is how close the heap is to its limit, what else is using memory
+        // doesn't matter since we'll throw OOM when we get to the limit anyway.
+        size_t committed = current_total_committed;
+        if (memory_load)
+            *memory_load = (uint32_t)((float)committed * 100.0 / (float)heap_hard_limit);
+        if (available_physical)
+            *available_physical = heap_hard_limit - min (heap_hard_limit, committed);
+        if (available_page_file)
+            *available_page_file = 0;
+
+        return;
+    }
+
     if (restricted_physical_memory_p)
     {
         size_t working_set_size = GCToOSInterface::GetCurrentPhysicalMemory();
@@ -19184,6 +20032,9 @@ void gc_heap::scan_dependent_handles (int condemned_gen_number, ScanContext *sc,
         gc_t_join.join(this, gc_join_rescan_dependent_handles);
         if (gc_t_join.joined())
         {
+            // Partitioned rescans need fresh segment claims.
+            GCScan::GcNextPartitionedHandleScanPass();
+
             // Restart all the workers.
             dprintf(3, ("Starting all gc thread for dependent handle promotion"));
             gc_t_join.restart();
@@ -19191,7 +20042,9 @@ void gc_heap::scan_dependent_handles (int condemned_gen_number, ScanContext *sc,
 
         // If the portion of the dependent handle table managed by this worker has handles that could still be
         // promoted perform a rescan. If the rescan resulted in at least one promotion note this fact since it
-        // could require a rescan of handles on this or other workers.
+        // could require a rescan of handles on this or other workers. When the scans are partitioned the
+        // portion is the set of segments this worker claimed last time; the workers that do rescan claim all
+        // the segments between them, so the others can still sit this one out.
         if (GCScan::GcDhUnpromotedHandlesExist(sc))
             if (GCScan::GcDhReScan(sc))
                 s_fUnscannedPromotions = TRUE;
@@ -19319,6 +20172,8 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
         num_sizedrefs = SystemDomain::System()->GetTotalNumSizedRefHandles();
 
 #ifdef MULTIPLE_HEAPS
+        // the handle promotion scans below are shared by all the GC threads up to the long weak scan
+        GCScan::GcBeginPartitionedHandleScans();
 
 #ifdef MH_SC_MARK
         if (full_p)
@@ -19369,6 +20224,9 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
 
         //%type%  category = quote (mark);
 
+        // Sized refs are handles, they count with the handle table.
+        uint64_t phase_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
         if ((condemned_gen_number == max_generation) && (num_sizedrefs > 0))
         {
             GCScan::GcScanSizedRefs(GCHeap::Promote, condemned_gen_number, max_generation, &sc);
@@ -19385,6 +20243,8 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
 #endif //MULTIPLE_HEAPS
         }
     
+        phase_start = add_pause_phase_time (pause_phase_mark_handles, phase_start);
+
         dprintf(3,("Marking Roots"));
 
         GCScan::GcScanRoots(GCHeap::Promote,
@@ -19408,6 +20268,7 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
 
         fire_mark_event (heap_number, ETW::GC_ROOT_FQ, (promoted_bytes (heap_number) - last_promoted_bytes));
         last_promoted_bytes = promoted_bytes (heap_number);
+        phase_start = add_pause_phase_time (pause_phase_mark_roots, phase_start);
 
 // MTHTS
         {
@@ -19419,6 +20280,7 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
             fire_mark_event (heap_number, ETW::GC_ROOT_HANDLES, (promoted_bytes (heap_number) - last_promoted_bytes));
             last_promoted_bytes = promoted_bytes (heap_number);
         }
+        phase_start = add_pause_phase_time (pause_phase_mark_handles, phase_start);
 
 #ifdef TRACE_GC
         size_t promoted_before_cards = promoted_bytes (heap_number);
@@ -19463,6 +20325,7 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
                 (promoted_bytes (heap_number) - promoted_before_cards)));
             fire_mark_event (heap_number, ETW::GC_ROOT_OLDER, (promoted_bytes (heap_number) - last_promoted_bytes));
             last_promoted_bytes = promoted_bytes (heap_number);
+            add_pause_phase_time (pause_phase_mark_cards, phase_start);
         }
     }
 
@@ -19480,8 +20343,10 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
     // to optimize away further scans. The call to scan_dependent_handles is what will cycle through more
     // iterations if required and will also perform processing of any mark stack overflow once the dependent
     // handle table has been fully promoted.
+    uint64_t dependent_handles_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
     GCScan::GcDhInitialScan(GCHeap::Promote, condemned_gen_number, max_generation, &sc);
     scan_dependent_handles(condemned_gen_number, &sc, true);
+    add_pause_phase_time (pause_phase_mark_handles, dependent_handles_start);
 
 #ifdef MULTIPLE_HEAPS
     dprintf(3, ("Joining for short weak handle scan"));
@@ -19551,6 +20416,8 @@ void gc_heap::mark_phase (int condemned_gen_number, BOOL mark_only_p)
     gc_t_join.join(this, gc_join_null_dead_long_weak);
     if (gc_t_join.joined())
     {
+        GCScan::GcEndPartitionedHandleScans();
+
         //start all threads on the roots.
         dprintf(3, ("Starting all gc thread for weak pointer deletion"));
         gc_t_join.restart();
@@ -20565,7 +21432,7 @@ retry:
                     }
                     else
                     {
-                        heap_segment* next_seg = heap_segment_next (seg);
+                        heap_segment* next_seg = heap_segment_next_compacted (seg);
                         assert (generation_allocation_pointer (gen)>=
                                 heap_segment_mem (seg));
                         // Verify that all pinned plugs for this segment are consumed
@@ -20694,6 +21561,7 @@ BOOL gc_heap::plan_loh()
     }
 
     seg = start_seg;
+    assert (!heap_segment_poh_p (seg));
 
     //Skip the generation gap object
     o = o + AlignQword (size (o));
@@ -20726,7 +21594,15 @@ BOOL gc_heap::plan_loh()
             size_t size = AlignQword (size (o));
             dprintf (1235, ("%Ix(%Id) M", o, size));
 
-            if (pinned (o))
+            if (heap_segment_poh_p (seg))
+            {
+                // Objects on the pinned object segments stay where they are
+                // and don't go through the pinned plug queue, compact_loh
+                // sweeps these segments instead.
+                new_address = o;
+                heap_segment_plan_allocated (seg) = o + size;
+            }
+            else if (pinned (o))
             {
                 // We don't clear the pinned bit yet so we can check in 
                 // compact phase how big a free object we should allocate
@@ -20787,7 +21663,7 @@ BOOL gc_heap::plan_loh()
             heap_segment_plan_allocated (nseg) =
                 generation_allocation_pointer (gen);
             //switch allocation segment
-            nseg = heap_segment_next_rw (nseg);
+            nseg = heap_segment_next_compacted (nseg);
             generation_allocation_segment (gen) = nseg;
             //reset the allocation pointer and limits
             generation_allocation_pointer (gen) =
@@ -20823,6 +21699,7 @@ void gc_heap::compact_loh()
     uint8_t* free_space_start = o;
     uint8_t* free_space_end = o;
     generation_allocator (gen)->clear();
+    poh_allocator.clear();
     generation_free_list_space (gen) = 0;
     generation_free_obj_space (gen) = 0;
 
@@ -20876,6 +21753,7 @@ void gc_heap::compact_loh()
             else
             {
                 o = heap_segment_mem (seg);
+                free_space_start = o;
             }
         }
 
@@ -20888,7 +21766,14 @@ void gc_heap::compact_loh()
             uint8_t* reloc = o;
             clear_marked (o);
 
-            if (pinned (o))
+            if (heap_segment_poh_p (seg))
+            {
+                // Not moved, the dead space in front of the object becomes
+                // free space on the pinned object segment.
+                clear_pinned (o);
+                thread_gap (free_space_start, (o - free_space_start), gen, &poh_allocator);
+            }
+            else if (pinned (o))
             {
                 // We are relying on the fact the pinned objects are always looked at in the same order 
                 // in plan phase and in compact phase.
@@ -20898,6 +21783,7 @@ void gc_heap::compact_loh()
 
                 loh_pad = pinned_len (m);
                 clear_pinned (o);
+                thread_gap ((reloc - loh_pad), loh_pad, gen);
             }
             else
             {
@@ -20905,10 +21791,9 @@ void gc_heap::compact_loh()
 
                 reloc += loh_node_relocation_distance (o);
                 gcmemcopy (reloc, o, size, TRUE);
+                thread_gap ((reloc - loh_pad), loh_pad, gen);
             }
 
-            thread_gap ((reloc - loh_pad), loh_pad, gen);
-
             o = o + size;
             free_space_start = o;
             if (o < heap_segment_allocated (seg))
@@ -21187,6 +22072,8 @@ void gc_heap::plan_phase (int condemned_gen_number)
     start = GetCycleCount32();
 #endif //TIME_GC
 
+    uint64_t plan_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
     dprintf (2,("---- Plan Phase ---- Condemned generation %d, promotion: %d",
                 condemned_gen_number, settings.promotion ? 1 : 0));
 
@@ -22138,6 +23025,8 @@ void gc_heap::plan_phase (int condemned_gen_number)
     plan_time = finish - start;
 #endif //TIME_GC
 
+    add_pause_phase_time (pause_phase_plan, plan_start);
+
     // We may update write barrier code.  We assume here EE has been suspended if we are on a GC thread.
     assert(GCHeap::IsGCInProgress());
 
@@ -22820,6 +23709,8 @@ void gc_heap::make_free_lists (int condemned_gen_number)
     start = GetCycleCount32();
 #endif //TIME_GC
 
+    uint64_t sweep_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
     //Promotion has to happen in sweep case.
     assert (settings.promotion);
 
@@ -22939,6 +23830,8 @@ void gc_heap::make_free_lists (int condemned_gen_number)
     finish = GetCycleCount32();
     sweep_time = finish - start;
 #endif //TIME_GC
+
+    add_pause_phase_time (pause_phase_sweep, sweep_start);
 }
 
 void gc_heap::make_free_list_in_brick (uint8_t* tree, make_free_args* args)
@@ -23017,7 +23910,7 @@ void gc_heap::make_free_list_in_brick (uint8_t* tree, make_free_args* args)
     }
 }
 
-void gc_heap::thread_gap (uint8_t* gap_start, size_t size, generation*  gen)
+void gc_heap::thread_gap (uint8_t* gap_start, size_t size, generation*  gen, allocator* gen_allocator)
 {
     assert (generation_allocation_start (gen));
     if ((size > 0))
@@ -23040,7 +23933,11 @@ void gc_heap::thread_gap (uint8_t* gap_start, size_t size, generation*  gen)
         if ((size >= min_free_list))
         {
             generation_free_list_space (gen) += size;
-            generation_allocator (gen)->thread_item (gap_start, size);
+            if (!gen_allocator)
+            {
+                gen_allocator = generation_allocator (gen);
+            }
+            gen_allocator->thread_item (gap_start, size);
         }
         else
         {
@@ -23049,16 +23946,22 @@ void gc_heap::thread_gap (uint8_t* gap_start, size_t size, generation*  gen)
     }
 }
 
-void gc_heap::loh_thread_gap_front (uint8_t* gap_start, size_t size, generation*  gen)
+void gc_heap::loh_thread_gap_front (uint8_t* gap_start, size_t size, generation*  gen, allocator* gen_allocator)
 {
     assert (generation_allocation_start (gen));
     if (size >= min_free_list)
     {
         generation_free_list_space (gen) += size;
-        generation_allocator (gen)->thread_item_front (gap_start, size);
+        gen_allocator->thread_item_front (gap_start, size);
     }
 }
 
+inline
+allocator* gc_heap::loh_allocator_of (heap_segment* seg)
+{
+    return (heap_segment_poh_p (seg) ? &poh_allocator : generation_allocator (large_object_generation));
+}
+
 void gc_heap::make_unused_array (uint8_t* x, size_t size, BOOL clearp, BOOL resetp)
 {
     dprintf (3, ("Making unused array [%Ix, %Ix[",
@@ -24119,6 +25022,8 @@ void gc_heap::relocate_phase (int condemned_gen_number,
         start = GetCycleCount32();
 #endif //TIME_GC
 
+    uint64_t relocate_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+
 //  %type%  category = quote (relocate);
     dprintf (2,("---- Relocate phase -----"));
 
@@ -24208,6 +25113,8 @@ void gc_heap::relocate_phase (int condemned_gen_number,
         reloc_time = finish - start;
 #endif //TIME_GC
 
+    add_pause_phase_time (pause_phase_relocate, relocate_start);
+
     dprintf(2,( "---- End of Relocate phase ----"));
 }
 
@@ -24293,6 +25200,14 @@ void  gc_heap::gcmemcopy (uint8_t* dest, uint8_t* src, size_t len, BOOL copy_car
         //dprintf(3,(" Memcopy [%Ix->%Ix, %Ix->%Ix[", (size_t)src, (size_t)dest, (size_t)src+len, (size_t)dest+len));
         dprintf(3,(" mc: [%Ix->%Ix, %Ix->%Ix[", (size_t)src, (size_t)dest, (size_t)src+len, (size_t)dest+len));
         memcopy (dest - plug_skew, src - plug_skew, (int)len);
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+        // OS write watch sees the copy, the software one has to be told.
+        // [src - plug_skew, src[ is an ObjHeader without references.
+        if (SoftwareWriteWatch::IsEnabledForGCHeap())
+        {
+            SoftwareWriteWatch::SetDirtyRegion (dest, len - plug_skew);
+        }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
         copy_cards_range (dest, src, len, copy_cards_p);
     }
 }
@@ -24560,6 +25475,7 @@ void gc_heap::compact_phase (int condemned_gen_number,
         unsigned finish;
         start = GetCycleCount32();
 #endif //TIME_GC
+    uint64_t compact_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
     generation*   condemned_gen = generation_of (condemned_gen_number);
     uint8_t*  start_address = first_condemned_address;
     size_t   current_brick = brick_of (start_address);
@@ -24683,6 +25599,8 @@ void gc_heap::compact_phase (int condemned_gen_number,
     compact_time = finish - start;
 #endif //TIME_GC
 
+    add_pause_phase_time (pause_phase_compact, compact_start);
+
     concurrent_print_time_delta ("compact end");
 
     dprintf(2,("---- End of Compact phase ----"));
@@ -24978,6 +25896,9 @@ void gc_heap::background_scan_dependent_handles (ScanContext *sc)
         bgc_t_join.join(this, gc_join_rescan_dependent_handles);
         if (bgc_t_join.joined())
         {
+            // Partitioned rescans need fresh segment claims.
+            GCScan::GcNextPartitionedHandleScanPass();
+
             // Restart all the workers.
             dprintf(3, ("Starting all gc thread for dependent handle promotion"));
             bgc_t_join.restart();
@@ -25187,6 +26108,45 @@ BOOL gc_heap::commit_mark_array_new_seg (gc_heap* hp,
     return TRUE;
 }
 
+// The mark array pages are charged to the card table they are part of, and
+// given back when they are decommitted or the table is destroyed. A page at
+// the edge of a range can be shared with the range of another segment, so it
+// may be charged more than once; the table gives all of it back in the end.
+BOOL gc_heap::commit_mark_array_pages (uint8_t* commit_start, size_t size)
+{
+    if (!virtual_commit (commit_start, size, commit_bucket_bookkeeping, -1))
+        return FALSE;
+
+    if (heap_hard_limit)
+    {
+        uint32_t* c_table = allocated_card_table_of (commit_start);
+        assert (c_table);
+        check_commit_cs.Enter();
+        card_table_committed (c_table) += size;
+        check_commit_cs.Leave();
+    }
+
+    return TRUE;
+}
+
+BOOL gc_heap::decommit_mark_array_pages (uint8_t* decommit_start, size_t size)
+{
+    if (!virtual_decommit (decommit_start, size, commit_bucket_bookkeeping))
+        return FALSE;
+
+    if (heap_hard_limit)
+    {
+        uint32_t* c_table = allocated_card_table_of (decommit_start);
+        assert (c_table);
+        check_commit_cs.Enter();
+        assert (card_table_committed (c_table) >= size);
+        card_table_committed (c_table) -= size;
+        check_commit_cs.Leave();
+    }
+
+    return TRUE;
+}
+
 BOOL gc_heap::commit_mark_array_by_range (uint8_t* begin, uint8_t* end, uint32_t* mark_array_addr)
 {
     size_t beg_word = mark_word_of (begin);
@@ -25207,7 +26167,7 @@ BOOL gc_heap::commit_mark_array_by_range (uint8_t* begin, uint8_t* end, uint32_t
                             size));
 #endif //SIMPLE_DPRINTF
 
-    if (GCToOSInterface::VirtualCommit (commit_start, size))
+    if (commit_mark_array_pages (commit_start, size))
     {
         // We can only verify the mark array is cleared from begin to end, the first and the last
         // page aren't necessarily all cleared 'cause they could be used by other segments or 
@@ -25452,7 +26412,7 @@ void gc_heap::decommit_mark_array_by_seg (heap_segment* seg)
         
         if (decommit_start < decommit_end)
         {
-            if (!GCToOSInterface::VirtualDecommit (decommit_start, size))
+            if (!decommit_mark_array_pages (decommit_start, size))
             {
                 dprintf (GC_TABLE_LOG, ("GCToOSInterface::VirtualDecommit on %Ix for %Id bytes failed", 
                                         decommit_start, size));
@@ -25576,6 +26536,26 @@ void gc_heap::background_mark_phase ()
             dprintf (BGC_LOG, ("setting cm_in_progress"));
             c_write (cm_in_progress, TRUE);
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+            // Resetting the software table is just a memset so unlike OS
+            // write watch it's done before the EE is restarted, and the
+            // barriers must be recording from the moment it runs again.
+            concurrent_print_time_delta ("CRWW begin");
+
+#ifdef MULTIPLE_HEAPS
+            for (int i = 0; i < n_heaps; i++)
+            {
+                g_heaps[i]->reset_write_watch (FALSE);
+            }
+#else
+            reset_write_watch (FALSE);
+#endif //MULTIPLE_HEAPS
+
+            SoftwareWriteWatch::EnableForGCHeap();
+
+            concurrent_print_time_delta ("CRWW");
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
             //restart all thread, doing the marking from the array
             assert (dont_restart_ee_p);
             dont_restart_ee_p = FALSE;
@@ -25595,11 +26575,14 @@ void gc_heap::background_mark_phase ()
         {
             disable_preemptive (current_thread, TRUE);
 
-#ifdef WRITE_WATCH
+#ifdef MULTIPLE_HEAPS
+            int i;
+#endif //MULTIPLE_HEAPS
+
+#if defined(WRITE_WATCH) && !defined(FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP)
             concurrent_print_time_delta ("CRWW begin");
 
 #ifdef MULTIPLE_HEAPS
-            int i;
             for (i = 0; i < n_heaps; i++)
             {
                 g_heaps[i]->reset_write_watch (TRUE);
@@ -25609,7 +26592,7 @@ void gc_heap::background_mark_phase ()
 #endif //MULTIPLE_HEAPS
 
             concurrent_print_time_delta ("CRWW");
-#endif //WRITE_WATCH
+#endif //WRITE_WATCH && !FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
 
 #ifdef MULTIPLE_HEAPS
             for (i = 0; i < n_heaps; i++)
@@ -25776,6 +26759,10 @@ void gc_heap::background_mark_phase ()
         bgc_t_join.join(this, gc_join_after_absorb);
         if (bgc_t_join.joined())
         {
+            // the EE stays suspended up to the long weak scan, so the BGC threads share
+            // the handle promotion scans of the final mark like the foreground GC threads do
+            GCScan::GcBeginPartitionedHandleScans();
+
             dprintf(3, ("Joining BGC threads after absorb"));
             bgc_t_join.restart();
         }
@@ -25800,6 +26787,9 @@ void gc_heap::background_mark_phase ()
         //concurrent_print_time_delta ("nonconcurrent marking stack roots");
         concurrent_print_time_delta ("NRS");
 
+        // objects registered since the BGC started
+        finalize_queue->MergeRegistrationBuffers();
+
 //        finalize_queue->EnterFinalizeLock();
         finalize_queue->GcScanRoots(background_promote, heap_number, 0);
 //        finalize_queue->LeaveFinalizeLock();
@@ -25840,6 +26830,12 @@ void gc_heap::background_mark_phase ()
         if (bgc_t_join.joined())
 #endif //MULTIPLE_HEAPS
         {
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+            // Every heap is done with its final revisit_written_pages, the
+            // barriers can stop recording while the EE is still suspended.
+            SoftwareWriteWatch::DisableForGCHeap();
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
             GCToEEInterface::AfterGcScanRoots (max_generation, max_generation, &sc);
 
 #ifdef MULTIPLE_HEAPS
@@ -25892,6 +26888,8 @@ void gc_heap::background_mark_phase ()
     bgc_t_join.join(this, gc_join_null_dead_long_weak);
     if (bgc_t_join.joined())
     {
+        GCScan::GcEndPartitionedHandleScans();
+
         dprintf(2, ("Joining BGC threads for weak pointer deletion"));
         bgc_t_join.restart();
     }
@@ -26325,9 +27323,26 @@ void gc_heap::revisit_written_pages (BOOL concurrent_p, BOOL reset_only_p)
                     ptrdiff_t region_size = high_address - base_address;
                     dprintf (3, ("h%d: gw: [%Ix(%Id)", heap_number, (size_t)base_address, (size_t)region_size));
 
-                    bool success = GCToOSInterface::GetWriteWatch (reset_watch_state, base_address, region_size,
-                                                                   (void**)background_written_addresses,
-                                                                   &bcount);
+                    bool is_runtime_suspended = !concurrent_p;
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+                    // grow_brick_card_tables replaces the software table
+                    // under gc_lock, keep it from doing so while we read it.
+                    if (!is_runtime_suspended)
+                    {
+                        enter_spin_lock (&gc_lock);
+                    }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
+                    bool success = get_write_watch_for_gc_heap (reset_watch_state, base_address, region_size,
+                                                                (void**)background_written_addresses,
+                                                                &bcount, is_runtime_suspended);
+
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+                    if (!is_runtime_suspended)
+                    {
+                        leave_spin_lock (&gc_lock);
+                    }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
 
     //#ifdef _DEBUG
                     if (!success)
@@ -27151,6 +28166,12 @@ void gc_heap::copy_cards_for_addresses (uint8_t* dest, uint8_t* src, size_t len)
 
     if (card_set_p (card_of (src + len - 1)))
         set_card (end_dest_card);
+
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    // copy_cards writes the card words directly
+    card_bundles_set (cardw_card_bundle (card_word (card_of (dest))),
+                      cardw_card_bundle (align_cardw_on_bundle (card_word (end_dest_card) + 1)));
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 }
 
 #ifdef BACKGROUND_GC
@@ -29825,7 +30846,7 @@ size_t gc_heap::joined_youngest_desired (size_t new_allocation)
         uint32_t num_heaps = 1;
 
 #ifdef MULTIPLE_HEAPS
-        num_heaps = gc_heap::n_heaps;
+        num_heaps = gc_heap::n_active_heaps;
 #endif //MULTIPLE_HEAPS
 
         size_t total_new_allocation = new_allocation * num_heaps;
@@ -30037,6 +31058,32 @@ void gc_heap::decommit_ephemeral_segment_pages()
     }
 #endif //!MULTIPLE_HEAPS
 
+#ifdef MULTIPLE_HEAPS
+    if (heap_number >= n_active_heaps)
+    {
+        // Nothing is allocated here until the heap is activated again
+        slack_space = min (slack_space, dd_desired_allocation (dd));
+    }
+
+    if (gradual_decommit_p)
+    {
+        // Keep what gen0 has needed lately, decommit_step releases the rest
+        // gradually so a drop in the budget doesn't free it all at once.
+        if ((dd_time_clock (dd) - gen0_budget_window_start) >= GC_EPHEMERAL_DECOMMIT_TIMEOUT)
+        {
+            gen0_budget_previous_peak = gen0_budget_peak;
+            gen0_budget_peak = 0;
+            gen0_budget_window_start = dd_time_clock (dd);
+        }
+
+        size_t gen0_budget = dd_desired_allocation (dd);
+        gen0_budget_peak = max (gen0_budget_peak, gen0_budget);
+
+        size_t retained_space = max (gen0_budget_peak, gen0_budget_previous_peak);
+        slack_space = min (slack_space, retained_space);
+    }
+    else
+#endif //MULTIPLE_HEAPS
     if (settings.condemned_generation >= (max_generation-1))
     {
         size_t new_slack_space = 
@@ -30059,6 +31106,104 @@ void gc_heap::decommit_ephemeral_segment_pages()
     current_gc_data_per_heap->extra_gen0_committed = heap_segment_committed (ephemeral_heap_segment) - heap_segment_allocated (ephemeral_heap_segment);
 }
 
+#ifdef MULTIPLE_HEAPS
+// Called by the heap 0 GC thread between GCs. A step gives up on what
+// is busy (a GC, an allocation holding more_space_lock) and lets the
+// next one try again.
+BOOL gc_heap::decommit_step (size_t step_milliseconds)
+{
+    if (!try_enter_spin_lock (&gc_lock))
+        return TRUE;
+
+    BOOL more_p = FALSE;
+#ifdef BACKGROUND_GC
+    if (recursive_gc_sync::background_running_p())
+    {
+        // Leave the segments alone while the background GC is sweeping them
+        more_p = TRUE;
+    }
+    else
+#endif //BACKGROUND_GC
+    {
+        size_t budget = DECOMMIT_SIZE_PER_MILLISECOND * step_milliseconds;
+        for (int i = 0; i < n_heaps; i++)
+        {
+            if (g_heaps[i]->decommit_segments_step (&budget))
+                more_p = TRUE;
+        }
+    }
+
+    leave_spin_lock (&gc_lock);
+    return more_p;
+}
+
+BOOL gc_heap::decommit_segments_step (size_t* budget)
+{
+    if (!try_enter_spin_lock (&more_space_lock))
+        return TRUE;
+
+    BOOL more_p = FALSE;
+    for (int gen_number = max_generation; gen_number <= (max_generation + 1); gen_number++)
+    {
+        heap_segment* seg = heap_segment_rw (generation_start_segment (generation_of (gen_number)));
+        while (seg)
+        {
+            if (decommit_segment_step (seg, budget))
+                more_p = TRUE;
+            seg = heap_segment_next_rw (seg);
+        }
+    }
+
+    leave_spin_lock (&more_space_lock);
+    return more_p;
+}
+
+BOOL gc_heap::decommit_segment_step (heap_segment* seg, size_t* budget)
+{
+    uint8_t* target = heap_segment_decommit_target (seg);
+    if (!target)
+        return FALSE;
+
+    // Between GCs the ephemeral segment is allocated in up to alloc_allocated
+    uint8_t* allocated = ((seg == ephemeral_heap_segment) ? alloc_allocated : heap_segment_allocated (seg));
+    uint8_t* committed = heap_segment_committed (seg);
+    if ((align_on_page (allocated) > target) || (committed <= target))
+    {
+        // Either done or the space is being used again
+        heap_segment_decommit_target (seg) = 0;
+        return FALSE;
+    }
+
+    size_t size = align_lower_page (min ((size_t)(committed - target), *budget));
+    if (size == 0)
+        return TRUE;
+
+    uint8_t* page_start = committed - size;
+    if (!virtual_decommit (page_start, size, commit_bucket_heap))
+    {
+        heap_segment_decommit_target (seg) = 0;
+        return FALSE;
+    }
+
+    dprintf (3, ("Decommit step on heap segment [%Ix, %Ix[(%d)",
+        (size_t)page_start,
+        (size_t)committed,
+        size));
+    *budget -= size;
+    heap_segment_committed (seg) = page_start;
+    if (heap_segment_used (seg) > heap_segment_committed (seg))
+    {
+        heap_segment_used (seg) = heap_segment_committed (seg);
+    }
+
+    if (page_start > target)
+        return TRUE;
+
+    heap_segment_decommit_target (seg) = 0;
+    return FALSE;
+}
+#endif //MULTIPLE_HEAPS
+
 size_t gc_heap::new_allocation_limit (size_t size, size_t free_size, int gen_number)
 {
     dynamic_data* dd        = dynamic_data_of (gen_number);
@@ -30492,7 +31637,7 @@ BOOL gc_heap::ephemeral_gen_fit_p (gc_tuning_point tp)
     }
 }
 
-CObjectHeader* gc_heap::allocate_large_object (size_t jsize, int64_t& alloc_bytes)
+CObjectHeader* gc_heap::allocate_large_object (size_t jsize, int64_t& alloc_bytes, BOOL pinned_p)
 {
     //create a new alloc context because gen3context is shared.
     alloc_context acontext;
@@ -30550,7 +31695,7 @@ CObjectHeader* gc_heap::allocate_large_object (size_t jsize, int64_t& alloc_byte
 #ifdef _MSC_VER
 #pragma inline_depth(0)
 #endif //_MSC_VER
-    if (! allocate_more_space (&acontext, (size + pad), max_generation+1))
+    if (! allocate_more_space (&acontext, (size + pad), max_generation+1, pinned_p))
     {
         return 0;
     }
@@ -31379,6 +32524,7 @@ void gc_heap::background_sweep()
                     dprintf (2, ("sweeping gen3 objects"));
                     generation_free_obj_space (gen) = 0;
                     generation_allocator (gen)->clear();
+                    poh_allocator.clear();
                     generation_free_list_space (gen) = 0;
 
                     dprintf (2, ("bgs: seg: %Ix, [%Ix, %Ix[%Ix", (size_t)seg,
@@ -31421,7 +32567,8 @@ void gc_heap::background_sweep()
                 dprintf (2, ("loh fr: [%Ix-%Ix[(%Id)", plug_end, plug_start, plug_start-plug_end));
             }
 
-            thread_gap (plug_end, plug_start-plug_end, gen);
+            thread_gap (plug_end, plug_start-plug_end, gen,
+                        ((gen == large_object_generation) ? loh_allocator_of (seg) : 0));
             if (gen != large_object_generation)
             {
                 add_gen_free (max_generation, plug_start-plug_end);
@@ -31564,6 +32711,7 @@ void gc_heap::sweep_large_objects ()
     uint8_t* plug_start       = o;
 
     generation_allocator (gen)->clear();
+    poh_allocator.clear();
     generation_free_list_space (gen) = 0;
     generation_free_obj_space (gen) = 0;
 
@@ -31617,7 +32765,7 @@ void gc_heap::sweep_large_objects ()
         {
             plug_start = o;
             //everything between plug_end and plug_start is free
-            thread_gap (plug_end, plug_start-plug_end, gen);
+            thread_gap (plug_end, plug_start-plug_end, gen, loh_allocator_of (seg));
 
             BOOL m = TRUE;
             while (m)
@@ -32826,6 +33974,12 @@ gc_heap::verify_free_lists ()
                                  (size_t)free_list));
                     FATAL_GC_ERROR();
                 }
+                if ((gen_num == max_generation+1) && heap_segment_poh_p (seg_mapping_table_segment_of (free_list)))
+                {
+                    dprintf (3, ("Verifiying Heap: curr free list item %Ix is on a pinned object segment",
+                                 (size_t)free_list));
+                    FATAL_GC_ERROR();
+                }
                     
                 prev = free_list;
                 free_list = free_list_slot (free_list);
@@ -32850,6 +34004,22 @@ gc_heap::verify_free_lists ()
             sz *=2;
         }
     }
+
+    for (unsigned int a_l_number = 0; a_l_number < poh_allocator.number_of_buckets(); a_l_number++)
+    {
+        uint8_t* free_list = poh_allocator.alloc_list_head_of (a_l_number);
+        while (free_list)
+        {
+            heap_segment* seg = seg_mapping_table_segment_of (free_list);
+            if (!((CObjectHeader*)free_list)->IsFree() || !seg || !heap_segment_poh_p (seg))
+            {
+                dprintf (3, ("Verifiying Heap: pinned object free list item %Ix isn't free on a pinned object segment",
+                             (size_t)free_list));
+                FATAL_GC_ERROR();
+            }
+            free_list = free_list_slot (free_list);
+        }
+    }
 }
 
 void
@@ -33527,9 +34697,19 @@ HRESULT GCHeap::Initialize ()
         gc_heap::total_physical_mem = min (gc_heap::total_physical_mem, physical_memory_limit);
     }
 
+    if (gc_heap::heap_hard_limit)
+    {
+        // The heap can't use more than the hard limit so that's the physical memory
+        // the budgets and the memory load are based on.
+        gc_heap::total_physical_mem = min (gc_heap::total_physical_mem, (uint64_t)gc_heap::heap_hard_limit);
+    }
+
+    // Processors this process can use, which in a container can be fewer than the machine has.
+    uint32_t nprocs = GCToOSInterface::GetCurrentProcessCpuCount();
+
     gc_heap::mem_one_percent = gc_heap::total_physical_mem / 100;
 #ifndef MULTIPLE_HEAPS
-    gc_heap::mem_one_percent /= g_SystemInfo.dwNumberOfProcessors;
+    gc_heap::mem_one_percent /= nprocs;
 #endif //!MULTIPLE_HEAPS
 
     // We should only use this if we are in the "many process" mode which really is only applicable
@@ -33541,7 +34721,7 @@ HRESULT GCHeap::Initialize ()
     int available_mem_th = 10;
     if (gc_heap::total_physical_mem >= ((uint64_t)80 * 1024 * 1024 * 1024))
     {
-        int adjusted_available_mem_th = 3 + (int)((float)47 / (float)(g_SystemInfo.dwNumberOfProcessors));
+        int adjusted_available_mem_th = 3 + (int)((float)47 / (float)nprocs);
         available_mem_th = min (available_mem_th, adjusted_available_mem_th);
     }
 
@@ -34231,7 +35411,7 @@ GCHeap::Alloc( size_t size, uint32_t flags REQD_ALIGN_DCL)
 
         alloc_context* acontext = 0;
 
-        if (size < LARGE_OBJECT_SIZE)
+        if ((size < LARGE_OBJECT_SIZE) && !(flags & GC_ALLOC_PINNED_OBJECT_HEAP))
         {
             acontext = generation_alloc_context (hp->generation_of (0));
 
@@ -34248,7 +35428,8 @@ GCHeap::Alloc( size_t size, uint32_t flags REQD_ALIGN_DCL)
         {
             acontext = generation_alloc_context (hp->generation_of (max_generation+1));
 
-            newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh);
+            newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh,
+                                                            (flags & GC_ALLOC_PINNED_OBJECT_HEAP));
 #ifdef FEATURE_STRUCTALIGN
             newAlloc = (Object*) hp->pad_for_alignment_large ((uint8_t*) newAlloc, requiredAlignment, size);
 #endif // FEATURE_STRUCTALIGN
@@ -34375,7 +35556,7 @@ GCHeap::AllocAlign8Common(void* _hp, alloc_context* acontext, size_t size, uint3
     GCStress<gc_on_alloc>::MaybeTrigger(acontext);
 #endif // FEATURE_REDHAWK
 
-    if (size < LARGE_OBJECT_SIZE)
+    if ((size < LARGE_OBJECT_SIZE) && !(flags & GC_ALLOC_PINNED_OBJECT_HEAP))
     {
 #ifdef TRACE_GC
         AllocSmallCount++;
@@ -34434,13 +35615,14 @@ GCHeap::AllocAlign8Common(void* _hp, alloc_context* acontext, size_t size, uint3
         // The LOH always guarantees at least 8-byte alignment, regardless of platform. Moreover it doesn't
         // support mis-aligned object headers so we can't support biased headers as above. Luckily for us
         // we've managed to arrange things so the only case where we see a bias is for boxed value types and
-        // these can never get large enough to be allocated on the LOH.
+        // these can never get large enough to be allocated on the LOH. The pinned object heap has the same
+        // layout and only takes arrays.
         ASSERT(65536 < LARGE_OBJECT_SIZE);
         ASSERT((flags & GC_ALLOC_ALIGN8_BIAS) == 0);
 
         alloc_context* acontext = generation_alloc_context (hp->generation_of (max_generation+1));
 
-        newAlloc = (Object*) hp->allocate_large_object (size, acontext->alloc_bytes_loh);
+        newAlloc = (Object*) hp->allocate_large_object (size, acontext->alloc_bytes_loh, (flags & GC_ALLOC_PINNED_OBJECT_HEAP));
         ASSERT(((size_t)newAlloc & 7) == 0);
     }
 
@@ -34512,7 +35694,8 @@ GCHeap::AllocLHeap( size_t size, uint32_t flags REQD_ALIGN_DCL)
 
     alloc_context* acontext = generation_alloc_context (hp->generation_of (max_generation+1));
 
-    newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh);
+    newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh,
+                                                    (flags & GC_ALLOC_PINNED_OBJECT_HEAP));
 #ifdef FEATURE_STRUCTALIGN
     newAlloc = (Object*) hp->pad_for_alignment_large ((uint8_t*) newAlloc, requiredAlignment, size);
 #endif // FEATURE_STRUCTALIGN
@@ -34588,7 +35771,7 @@ GCHeap::Alloc(alloc_context* acontext, size_t size, uint32_t flags REQD_ALIGN_DC
 #endif //_PREFAST_
 #endif //MULTIPLE_HEAPS
 
-    if (size < LARGE_OBJECT_SIZE)
+    if ((size < LARGE_OBJECT_SIZE) && !(flags & GC_ALLOC_PINNED_OBJECT_HEAP))
     {
 
 #ifdef TRACE_GC
@@ -34602,7 +35785,8 @@ GCHeap::Alloc(alloc_context* acontext, size_t size, uint32_t flags REQD_ALIGN_DC
     }
     else 
     {
-        newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh);
+        newAlloc = (Object*) hp->allocate_large_object (size + ComputeMaxStructAlignPadLarge(requiredAlignment), acontext->alloc_bytes_loh,
+                                                        (flags & GC_ALLOC_PINNED_OBJECT_HEAP));
 #ifdef FEATURE_STRUCTALIGN
         newAlloc = (Object*) hp->pad_for_alignment_large ((uint8_t*) newAlloc, requiredAlignment, size);
 #endif // FEATURE_STRUCTALIGN
@@ -34869,6 +36053,98 @@ GCHeap::GarbageCollectTry (int generation, BOOL low_memory_p, int mode)
     return GarbageCollectGeneration (gen, reason);
 }
 
+uint64_t gc_heap::add_pause_phase_time (gc_pause_phase phase, uint64_t phase_start)
+{
+    uint64_t now = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
+    pause_phase_time[phase] += now - phase_start;
+    pause_phases_run |= (1 << phase);
+    return now;
+}
+
+// Called at the end of a blocking GC. With server GC the heaps wait for
+// each other at the join after every phase, so the slowest heap is what
+// the pause is made of.
+void gc_heap::collect_pause_phases()
+{
+    last_pause_phases_run = (1 << pause_phase_suspend);
+#ifdef MULTIPLE_HEAPS
+    for (int i = 0; i < n_heaps; i++)
+    {
+        last_pause_phases_run |= g_heaps[i]->pause_phases_run;
+    }
+#else
+    last_pause_phases_run |= pause_phases_run;
+#endif //MULTIPLE_HEAPS
+
+    for (int phase = pause_phase_mark_roots; phase < pause_phase_resume; phase++)
+    {
+#ifdef MULTIPLE_HEAPS
+        uint64_t phase_time = 0;
+        for (int i = 0; i < n_heaps; i++)
+        {
+            phase_time = max (phase_time, g_heaps[i]->pause_phase_time[phase]);
+        }
+#else
+        uint64_t phase_time = pause_phase_time[phase];
+#endif //MULTIPLE_HEAPS
+        last_pause_phase_time[phase] = phase_time;
+    }
+
+    last_pause_phase_gc_index = VolatileLoad(&settings.gc_index);
+    last_pause_phase_generation = settings.condemned_generation;
+    pause_phases_pending = TRUE;
+}
+
+void gc_heap::record_pause_phases (BOOL restarted_ee, uint64_t resume_start)
+{
+    if (!pause_phases_pending)
+        return;
+
+    pause_phases_pending = FALSE;
+    if (restarted_ee)
+    {
+        last_pause_phase_time[pause_phase_resume] = (uint64_t)GCToOSInterface::QueryPerformanceCounter() - resume_start;
+        last_pause_phases_run |= (1 << pause_phase_resume);
+    }
+
+    // Phases the GC skipped are reported as 0 in the event but left out of
+    // the histograms, where they would pile up in the first bucket.
+    uint32_t phase_us[max_pause_phase];
+    for (int phase = 0; phase < max_pause_phase; phase++)
+    {
+        if (!(last_pause_phases_run & (1 << phase)))
+        {
+            phase_us[phase] = 0;
+            continue;
+        }
+
+        uint64_t us = last_pause_phase_time[phase] * 1000000 / (uint64_t)qpf;
+
+        int bucket = 0;
+        while ((bucket < (PAUSE_PHASE_HISTOGRAM_BUCKETS - 1)) && (us >> (bucket + 1)))
+        {
+            bucket++;
+        }
+
+        pause_phase_histogram[phase][bucket]++;
+        pause_phase_total_time[phase] += us;
+        phase_us[phase] = (uint32_t)min (us, (uint64_t)UINT32_MAX);
+    }
+
+    FireEtwGCPhaseTimes ((uint32_t)last_pause_phase_gc_index,
+                         (uint32_t)last_pause_phase_generation,
+                         phase_us[pause_phase_suspend],
+                         phase_us[pause_phase_mark_roots],
+                         phase_us[pause_phase_mark_handles],
+                         phase_us[pause_phase_mark_cards],
+                         phase_us[pause_phase_plan],
+                         phase_us[pause_phase_relocate],
+                         phase_us[pause_phase_compact],
+                         phase_us[pause_phase_sweep],
+                         phase_us[pause_phase_resume],
+                         GetClrInstanceId());
+}
+
 void gc_heap::do_pre_gc()
 {
     STRESS_LOG_GC_STACK;
@@ -35051,6 +36327,7 @@ void gc_heap::do_post_gc()
     {
         GCProfileWalkHeap();
         initGCShadow();
+        collect_pause_phases();
     }
 
 #ifdef TRACE_GC
@@ -35122,6 +36399,30 @@ unsigned GCHeap::GetGcCount()
     return (unsigned int)VolatileLoad(&pGenGCHeap->settings.gc_index);
 }
 
+void GCHeap::GetCommitCounters(uint64_t* commitBytes, uint64_t* decommitBytes)
+{
+    gc_heap::check_commit_cs.Enter();
+    *commitBytes = gc_heap::total_commit_bytes;
+    *decommitBytes = gc_heap::total_decommit_bytes;
+    gc_heap::check_commit_cs.Leave();
+}
+
+// The counts are updated without a lock by the GC, a GC that is being
+// recorded may only show up in some of them.
+uint64_t GCHeap::GetPausePhaseHistogram(int phase, uint64_t* buckets, int bucketCount)
+{
+    if ((phase < 0) || (phase >= max_pause_phase))
+        return 0;
+
+    int count = min (bucketCount, PAUSE_PHASE_HISTOGRAM_BUCKETS);
+    for (int i = 0; i < count; i++)
+    {
+        buckets[i] = VolatileLoad(&gc_heap::pause_phase_histogram[phase][i]);
+    }
+
+    return VolatileLoad(&gc_heap::pause_phase_total_time[phase]);
+}
+
 size_t
 GCHeap::GarbageCollectGeneration (unsigned int gen, gc_reason reason)
 {
@@ -35203,9 +36504,12 @@ GCHeap::GarbageCollectGeneration (unsigned int gen, gc_reason reason)
             cooperative_mode = gc_heap::enable_preemptive (current_thread);
 
             dprintf (2, ("Suspending EE"));
+            uint64_t suspend_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
             BEGIN_TIMING(suspend_ee_during_log);
             GCToEEInterface::SuspendEE(GCToEEInterface::SUSPEND_FOR_GC);
             END_TIMING(suspend_ee_during_log);
+            gc_heap::last_pause_phase_time[pause_phase_suspend] = 
+                (uint64_t)GCToOSInterface::QueryPerformanceCounter() - suspend_start;
             gc_heap::proceed_with_gc_p = gc_heap::should_proceed_with_gc();
             gc_heap::disable_preemptive (current_thread, cooperative_mode);
             if (gc_heap::proceed_with_gc_p)
@@ -35289,6 +36593,8 @@ GCHeap::GarbageCollectGeneration (unsigned int gen, gc_reason reason)
 #endif //BACKGROUND_GC
 
 #ifndef MULTIPLE_HEAPS
+        BOOL restarted_ee = TRUE;
+        uint64_t resume_start = (uint64_t)GCToOSInterface::QueryPerformanceCounter();
 #ifdef BACKGROUND_GC
         if (!gc_heap::dont_restart_ee_p)
         {
@@ -35298,7 +36604,14 @@ GCHeap::GarbageCollectGeneration (unsigned int gen, gc_reason reason)
             END_TIMING(restart_ee_during_log);
 #ifdef BACKGROUND_GC
         }
+        else
+        {
+            restarted_ee = FALSE;
+        }
 #endif //BACKGROUND_GC
+        // If a BGC was started the BGC thread restarts the EE, the ephemeral
+        // GC done before it then has no resume phase.
+        gc_heap::record_pause_phases (restarted_ee, resume_start);
 #endif //!MULTIPLE_HEAPS
 
     }
@@ -35727,6 +37040,17 @@ size_t GCHeap::GetValidGen0MaxSize(size_t seg_size)
     if (gen0size >= (seg_size / 2))
         gen0size = seg_size / 2;
 
+    // With a hard limit the gen0 budgets of all heaps must leave most of the limit to the older generations.
+    if (gc_heap::heap_hard_limit)
+    {
+#ifdef MULTIPLE_HEAPS
+        size_t gen0size_limit = gc_heap::heap_hard_limit / (8 * gc_heap::n_heaps);
+#else //MULTIPLE_HEAPS
+        size_t gen0size_limit = gc_heap::heap_hard_limit / 8;
+#endif //MULTIPLE_HEAPS
+        gen0size = max (min (gen0size, gen0size_limit), (size_t)(256*1024));
+    }
+
     return (gen0size);
 }
 
@@ -35916,6 +37240,13 @@ GCHeap::SetCardsAfterBulkCopy( Object **StartPoint, size_t len )
         (GCHeap::GetGCHeap()->WhichGeneration( (Object*) StartPoint ) == 0))
         return;
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    if (SoftwareWriteWatch::IsEnabledForGCHeap() && (len != 0))
+    {
+        SoftwareWriteWatch::SetDirtyRegion (StartPoint, len);
+    }
+#endif //FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
     rover = StartPoint;
     end = StartPoint + (len/sizeof(Object*));
     while (rover < end)
@@ -35926,6 +37257,14 @@ GCHeap::SetCardsAfterBulkCopy( Object **StartPoint, size_t len )
             size_t card = gcard_of ((uint8_t*)rover);
 
             Interlocked::Or (&g_card_table[card/card_word_width], (1U << (card % card_word_width)));
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+            // Same as the write barriers, a whole byte of bundles is dirtied
+            uint8_t* card_bundle_byte = (uint8_t*)g_card_bundle_table + ((size_t)rover >> card_bundle_byte_shift);
+            if (*card_bundle_byte != 0xFF)
+            {
+                *card_bundle_byte = 0xFF;
+            }
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
             // Skip to next card for the object
             rover = (Object**)align_on_card ((uint8_t*)(rover+1));
         }
@@ -35963,19 +37302,30 @@ bool CFinalize::Initialize()
         GC_NOTRIGGER;
     } CONTRACTL_END;
 
-    m_Array = new (nothrow)(Object*[100]);
+    // leave room for draining all the registration buffers
+    const size_t initial_size = 100 + RegistrationBufferCount * RegistrationBufferSize;
+
+    m_Array = new (nothrow)(Object*[initial_size]);
+    m_RegistrationBuffers = new (nothrow)(RegistrationBuffer[RegistrationBufferCount]);
 
-    if (!m_Array)
+    if (!m_Array || !m_RegistrationBuffers)
     {
-        ASSERT (m_Array);
-        STRESS_LOG_OOM_STACK(sizeof(Object*[100]));
+        ASSERT (m_Array && m_RegistrationBuffers);
+        STRESS_LOG_OOM_STACK(sizeof(Object*[initial_size]) + sizeof(RegistrationBuffer[RegistrationBufferCount]));
         if (g_pConfig->IsGCBreakOnOOMEnabled())
         {
             GCToOSInterface::DebugBreak();
         }
         return false;
     }
-    m_EndArray = &m_Array[100];
+    m_EndArray = &m_Array[initial_size];
+
+    memset (m_RegistrationBuffers, 0, sizeof(RegistrationBuffer[RegistrationBufferCount]));
+    for (int i = 0; i < RegistrationBufferCount; i++)
+    {
+        m_RegistrationBuffers[i].active = TRUE;
+    }
+    m_ActiveRegistrationBuffers = RegistrationBufferCount;
 
     for (int i =0; i < FreeList; i++)
     {
@@ -35993,6 +37343,7 @@ bool CFinalize::Initialize()
 CFinalize::~CFinalize()
 {
     delete m_Array;
+    delete [] m_RegistrationBuffers;
 }
 
 size_t CFinalize::GetPromotedCount ()
@@ -36053,7 +37404,34 @@ CFinalize::RegisterForFinalization (int gen, Object* obj, size_t size)
         GC_NOTRIGGER;
     } CONTRACTL_END;
 
+    RegistrationBuffer* buffer = NULL;
+
+    if ((gen == 0) && !g_fFinalizerRunOnShutDown)
+    {
+        // Take a slot in the buffer of this processor, the common case for new objects.
+        // Registering runs in cooperative mode so the GC can't start before the slot is
+        // filled in.
+        buffer = GetRegistrationBuffer();
+        if (buffer->count < RegistrationBufferSize)
+        {
+            int32_t slot = Interlocked::Increment (&buffer->count) - 1;
+            if (slot < RegistrationBufferSize)
+            {
+                buffer->items[slot] = obj;
+                return true;
+            }
+        }
+    }
+
     EnterFinalizeLock();
+
+    // The buffer is full or closed, move its objects to the queue so that it
+    // can be opened again below.
+    if (buffer)
+    {
+        DrainRegistrationBuffer (buffer);
+    }
+
     // Adjust gen
     unsigned int dest = 0;
 
@@ -36068,32 +37446,48 @@ CFinalize::RegisterForFinalization (int gen, Object* obj, size_t size)
     else
         dest = gen_segment (gen);
 
-    // Adjust boundary for segments so that GC will keep objects alive.
-    Object*** s_i = &SegQueue (FreeList);
-    if ((*s_i) == m_EndArray)
+    if (!EnsureRoom (1, TRUE))
     {
-        if (!GrowArray())
+        LeaveFinalizeLock();
+        if (method_table(obj) == NULL)
         {
-            LeaveFinalizeLock();
-            if (method_table(obj) == NULL)
-            {
-                // If the object is uninitialized, a valid size should have been passed.
-                assert (size >= Align (min_obj_size));
-                dprintf (3, ("Making unused array [%Ix, %Ix[", (size_t)obj, (size_t)(obj+size)));
-                ((CObjectHeader*)obj)->SetFree(size);
-            }
-            STRESS_LOG_OOM_STACK(0);
-            if (g_pConfig->IsGCBreakOnOOMEnabled())
-            {
-                GCToOSInterface::DebugBreak();
-            }
+            // If the object is uninitialized, a valid size should have been passed.
+            assert (size >= Align (min_obj_size));
+            dprintf (3, ("Making unused array [%Ix, %Ix[", (size_t)obj, (size_t)(obj+size)));
+            ((CObjectHeader*)obj)->SetFree(size);
+        }
+        STRESS_LOG_OOM_STACK(0);
+        if (g_pConfig->IsGCBreakOnOOMEnabled())
+        {
+            GCToOSInterface::DebugBreak();
+        }
 #ifdef FEATURE_REDHAWK
-            return false;
+        return false;
 #else
-            ThrowOutOfMemory();
+        ThrowOutOfMemory();
 #endif
-        }
     }
+
+    InsertItem (dest, obj);
+
+    if (buffer)
+    {
+        OpenRegistrationBuffer (buffer, TRUE);
+    }
+
+    LeaveFinalizeLock();
+
+    return true;
+}
+
+// Adds obj at the end of segment dest, the array must have room for it.
+void
+CFinalize::InsertItem (unsigned int dest, Object* obj)
+{
+    // Adjust boundary for segments so that GC will keep objects alive.
+    Object*** s_i = &SegQueue (FreeList);
+    assert ((*s_i) < m_EndArray);
+
     Object*** end_si = &SegQueueLimit (dest);
     do
     {
@@ -36114,10 +37508,98 @@ CFinalize::RegisterForFinalization (int gen, Object* obj, size_t size)
     **s_i = obj;
     // increment the fill pointer
     (*s_i)++;
+}
 
-    LeaveFinalizeLock();
+// Makes sure the array has room for count more objects on top of the contents
+// of the active registration buffers.
+BOOL
+CFinalize::EnsureRoom (size_t count, BOOL can_grow)
+{
+    size_t needed = count + (size_t)m_ActiveRegistrationBuffers * RegistrationBufferSize;
+    while ((size_t)(m_EndArray - SegQueue (FreeList)) < needed)
+    {
+        if (!can_grow || !GrowArray())
+        {
+            return FALSE;
+        }
+    }
 
-    return true;
+    return TRUE;
+}
+
+inline
+CFinalize::RegistrationBuffer*
+CFinalize::GetRegistrationBuffer()
+{
+    uint32_t index = (GCToOSInterface::CanGetCurrentProcessorNumber() ?
+                      GCToOSInterface::GetCurrentProcessorNumber() :
+                      GCToOSInterface::GetCurrentThreadIdForLogging());
+    return &m_RegistrationBuffers[index % RegistrationBufferCount];
+}
+
+// Closes the buffer and moves its objects to the gen 0 segment. Needs the lock,
+// or the EE suspended.
+void
+CFinalize::DrainRegistrationBuffer (RegistrationBuffer* buffer)
+{
+    if (!buffer->active)
+        return;
+
+    // registrations that come after this take the lock
+    int32_t count = Interlocked::Exchange (&buffer->count, RegistrationBufferSize);
+    count = min (count, RegistrationBufferSize);
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        // the slot may have been handed out and not filled in yet
+        Object* obj;
+        while ((obj = VolatileLoad (&buffer->items[i])) == NULL)
+        {
+            YieldProcessor();
+        }
+
+        buffer->items[i] = NULL;
+        InsertItem (gen_segment (0), obj);
+    }
+
+    buffer->active = FALSE;
+    m_ActiveRegistrationBuffers--;
+}
+
+void
+CFinalize::DrainRegistrationBuffers()
+{
+    for (int i = 0; i < RegistrationBufferCount; i++)
+    {
+        DrainRegistrationBuffer (&m_RegistrationBuffers[i]);
+    }
+}
+
+// Reopens a drained buffer if the array has room for its contents. The buffer
+// stays closed otherwise and the next registration on it tries again.
+void
+CFinalize::OpenRegistrationBuffer (RegistrationBuffer* buffer, BOOL can_grow)
+{
+    if (buffer->active || !EnsureRoom (RegistrationBufferSize, can_grow))
+        return;
+
+    buffer->active = TRUE;
+    m_ActiveRegistrationBuffers++;
+    Interlocked::Exchange (&buffer->count, 0);
+}
+
+// Called by the GC before it looks at the queue, with the EE suspended.
+void
+CFinalize::MergeRegistrationBuffers()
+{
+    DrainRegistrationBuffers();
+
+    // the GC doesn't allocate, buffers that don't fit are opened by the
+    // next registration instead
+    for (int i = 0; i < RegistrationBufferCount; i++)
+    {
+        OpenRegistrationBuffer (&m_RegistrationBuffers[i], FALSE);
+    }
 }
 
 Object*
@@ -36168,6 +37650,7 @@ CFinalize::SetSegForShutDown(BOOL fHasLock)
 
     if (!fHasLock)
         EnterFinalizeLock();
+    DrainRegistrationBuffers();
     for (i = 0; i <= max_generation; i++)
     {
         unsigned int seg = gen_segment (i);
@@ -36305,6 +37788,7 @@ CFinalize::FinalizeAppDomain (AppDomain *pDomain, BOOL fRunFinalizers)
     unsigned int startSeg = gen_segment (max_generation);
 
     EnterFinalizeLock();
+    DrainRegistrationBuffers();
 
     for (unsigned int Seg = startSeg; Seg <= gen_segment (0); Seg++)
     {
@@ -77,7 +77,8 @@ enum oom_reason
     oom_cant_reserve = 3,
     oom_loh = 4,
     oom_low_mem = 5,
-    oom_unproductive_full_gc = 6
+    oom_unproductive_full_gc = 6,
+    oom_commit_hard_limit = 7
 };
 
 struct oom_history
@@ -119,6 +120,32 @@ GPTR_DECL(uint32_t,g_card_table);
 }
 #endif
 
+// The write barriers dirty a whole card table byte at (address >> card_byte_shift),
+// that is 8 cards of (1 << (card_byte_shift - 3)) bytes each. It can be lowered at
+// build time for heaps where old objects are large and sparsely written to, the GC
+// then has less to scan per dirty card. Only the Unix amd64 assembly barriers take
+// it from here, the other ones hard code the default.
+#ifndef GC_CARD_BYTE_SHIFT
+#if defined(BIT64)
+#define GC_CARD_BYTE_SHIFT  11
+#else
+#define GC_CARD_BYTE_SHIFT  10
+#endif // BIT64
+#endif // GC_CARD_BYTE_SHIFT
+
+#define card_byte_shift     GC_CARD_BYTE_SHIFT
+
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+// Without write watch on the card table, the write barriers set the card bundle
+// of every card they dirty. A byte of the bundle table covers 8 bundles of
+// 32 card words, so it is indexed with (address >> card_bundle_byte_shift).
+#define card_bundle_byte_shift (card_byte_shift + 10)
+
+#ifndef DACCESS_COMPILE
+extern "C" uint32_t* g_card_bundle_table;
+#endif // !DACCESS_COMPILE
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+
 #ifdef DACCESS_COMPILE
 class DacHeapWalker;
 #endif
@@ -320,6 +347,28 @@ enum end_no_gc_region_status
     end_no_gc_alloc_exceeded = 3
 };
 
+// !!!!!!!!!!!!!!!!!!!!!!!
+// make sure you change the def in bcl\system\gc.cs 
+// if you change this!
+enum gc_pause_phase
+{
+    pause_phase_suspend = 0,
+    pause_phase_mark_roots = 1,
+    pause_phase_mark_handles = 2,
+    pause_phase_mark_cards = 3,
+    pause_phase_plan = 4,
+    pause_phase_relocate = 5,
+    pause_phase_compact = 6,
+    pause_phase_sweep = 7,
+    pause_phase_resume = 8,
+    max_pause_phase = 9
+};
+
+// The time blocking GCs spend in each pause phase is counted in log2
+// buckets of microseconds: bucket 0 has the times under 2us, bucket i
+// the times in [2^i, 2^(i+1)[ and the last bucket everything longer.
+#define PAUSE_PHASE_HISTOGRAM_BUCKETS 24
+
 enum bgc_state
 {
     bgc_not_in_process = 0,
@@ -363,6 +412,9 @@ void record_global_mechanism (int mech_index);
 #define GC_ALLOC_CONTAINS_REF 0x2
 #define GC_ALLOC_ALIGN8_BIAS 0x4
 #define GC_ALLOC_ALIGN8 0x8
+// Allocate on the pinned object heap whatever the size: the object never moves
+// so it can be pinned for as long as needed without fragmenting gen0/gen1.
+#define GC_ALLOC_PINNED_OBJECT_HEAP 0x10
 
 class GCHeap {
     friend struct ::_DacGlobals;
@@ -597,6 +649,13 @@ public:
     virtual size_t  GetLastGCDuration(int generation) = 0;
     virtual size_t  GetNow() = 0;
     virtual unsigned GetGcCount() = 0;
+
+    // Copies up to bucketCount buckets of the histogram of phase (a gc_pause_phase)
+    // into buckets and returns the total time spent in it, in microseconds.
+    virtual uint64_t GetPausePhaseHistogram(int phase, uint64_t* buckets, int bucketCount) = 0;
+
+    // Bytes of GC heap memory committed and decommitted since the process started.
+    virtual void GetCommitCounters(uint64_t* commitBytes, uint64_t* decommitBytes) = 0;
     virtual void TraceGCSegments() = 0;
 
     virtual void PublishObject(uint8_t* obj) = 0;
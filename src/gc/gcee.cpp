@@ -877,6 +877,7 @@ segment_handle GCHeap::RegisterFrozenSegment(segment_info *pseginfo)
 #if defined (MULTIPLE_HEAPS) && !defined (ISOLATED_HEAPS)
     gc_heap* heap = gc_heap::g_heaps[0];
     heap_segment_heap(seg) = heap;
+    heap_segment_decommit_target(seg) = 0;
 #else
     gc_heap* heap = pGenGCHeap;
 #endif //MULTIPLE_HEAPS && !ISOLATED_HEAPS
@@ -204,6 +204,10 @@ public:
  
     unsigned GetGcCount();
 
+    uint64_t GetPausePhaseHistogram(int phase, uint64_t* buckets, int bucketCount);
+
+    void GetCommitCounters(uint64_t* commitBytes, uint64_t* decommitBytes);
+
     Object* GetNextFinalizable() { return GetNextFinalizableObject(); };
     size_t GetNumberOfFinalizable() { return GetNumberFinalizableObjects(); }
 
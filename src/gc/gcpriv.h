@@ -68,7 +68,7 @@ inline void FATAL_GC_ERROR()
 
 #define MARK_LIST         //used sorted list to speed up plan phase
 
-#define BACKGROUND_GC   //concurrent background GC (requires WRITE_WATCH)
+#define BACKGROUND_GC   //concurrent background GC (requires WRITE_WATCH, OS or software - see softwarewritewatch.h)
 
 #ifdef SERVER_GC
 #define MH_SC_MARK //scalable marking
@@ -87,7 +87,7 @@ inline void FATAL_GC_ERROR()
 
 #define INTERIOR_POINTERS   //Allow interior pointers in the code manager
 
-#define CARD_BUNDLE         //enable card bundle feature.(requires WRITE_WATCH)
+#define CARD_BUNDLE         //enable card bundle feature.(requires OS WRITE_WATCH)
 
 // If this is defined we use a map for segments in order to find the heap for 
 // a segment fast. But it does use more memory as we have to cover the whole
@@ -492,6 +492,15 @@ enum gc_type
     gc_type_max = 3
 };
 
+// What a commit is charged to under the heap hard limit: the segments, or the
+// card tables and mark arrays the GC keeps about them.
+enum commit_bucket
+{
+    commit_bucket_heap = 0,
+    commit_bucket_bookkeeping = 1,
+    total_commit_buckets = 2
+};
+
 #define v_high_memory_load_th 97
 
 //encapsulates the mechanism for the current gc
@@ -1058,6 +1067,34 @@ struct no_gc_region_info
     BOOL minimal_gc_p;
 };
 
+#ifdef MULTIPLE_HEAPS
+// What gc_heap::update_dynamic_heap_count decides on, recorded at every
+// blocking GC.
+struct dynamic_heap_count_data
+{
+    static const int sample_count = 3;
+
+    struct sample
+    {
+        // Ticks from the end of the previous blocking GC to the start of this one
+        uint64_t mutator_time;
+        // Ticks from the start of this GC to the point where the heap count is updated
+        uint64_t gc_time;
+        // gen0 bytes allocated on all heaps between the two GCs
+        size_t   gen0_allocated;
+    };
+
+    sample   samples[sample_count];
+    int      sample_index;
+    // Samples taken with the current heap count, only full sets are acted on
+    int      samples_since_change;
+
+    uint64_t gc_start_time;
+    uint64_t last_gc_end_time;
+    size_t   gen0_allocated;
+};
+#endif //MULTIPLE_HEAPS
+
 // if you change these, make sure you update them for sos (strike.cpp) as well.
 // 
 // !!!NOTE!!!
@@ -1239,8 +1276,9 @@ public:
     // For LOH allocations we only update the alloc_bytes_loh in allocation
     // context - we don't actually use the ptr/limit from it so I am
     // making this explicit by not passing in the alloc_context.
+    // pinned_p allocates on the pinned object segments, see heap_segment_flags_poh.
     PER_HEAP
-    CObjectHeader* allocate_large_object (size_t size, int64_t& alloc_bytes);
+    CObjectHeader* allocate_large_object (size_t size, int64_t& alloc_bytes, BOOL pinned_p);
 
 #ifdef FEATURE_STRUCTALIGN
     PER_HEAP
@@ -1421,10 +1459,12 @@ protected:
                             int align_const);
     PER_HEAP
     int try_allocate_more_space (alloc_context* acontext, size_t jsize,
-                                 int alloc_generation_number);
+                                 int alloc_generation_number,
+                                 BOOL pinned_p);
     PER_HEAP
     BOOL allocate_more_space (alloc_context* acontext, size_t jsize,
-                              int alloc_generation_number);
+                              int alloc_generation_number,
+                              BOOL pinned_p);
 
     PER_HEAP
     size_t get_full_compact_gc_count();
@@ -1483,7 +1523,8 @@ protected:
     PER_HEAP
     BOOL a_fit_free_list_large_p (size_t size, 
                                   alloc_context* acontext,
-                                  int align_const);
+                                  int align_const,
+                                  BOOL pinned_p);
 
     PER_HEAP
     BOOL a_fit_segment_end_p (int gen_number,
@@ -1497,12 +1538,14 @@ protected:
                                   size_t size, 
                                   alloc_context* acontext,
                                   int align_const,
+                                  BOOL pinned_p,
                                   BOOL* commit_failed_p,
                                   oom_reason* oom_r);
     PER_HEAP
     BOOL loh_get_new_seg (generation* gen,
                           size_t size,
                           int align_const,
+                          BOOL pinned_p,
                           BOOL* commit_failed_p,
                           oom_reason* oom_r);
 
@@ -1535,6 +1578,7 @@ protected:
                       size_t size, 
                       alloc_context* acontext,
                       int align_const,
+                      BOOL pinned_p,
                       BOOL* commit_failed_p,
                       oom_reason* oom_r);
 
@@ -1571,7 +1615,8 @@ protected:
     BOOL allocate_large (int gen_number,
                          size_t size, 
                          alloc_context* acontext,
-                         int align_const);
+                         int align_const,
+                         BOOL pinned_p);
 
     PER_HEAP_ISOLATED
     int init_semi_shared();
@@ -1625,11 +1670,12 @@ protected:
     PER_HEAP_ISOLATED
     void seg_mapping_table_remove_segment (heap_segment* seg);
     PER_HEAP
-    heap_segment* get_large_segment (size_t size, BOOL* did_full_compact_gc);
+    heap_segment* get_large_segment (size_t size, BOOL pinned_p, BOOL* did_full_compact_gc);
     PER_HEAP
     void thread_loh_segment (heap_segment* new_seg);
     PER_HEAP_ISOLATED
-    heap_segment* get_segment_for_loh (size_t size
+    heap_segment* get_segment_for_loh (size_t size,
+                                      BOOL pinned_p
 #ifdef MULTIPLE_HEAPS
                                       , gc_heap* hp
 #endif //MULTIPLE_HEAPS
@@ -1707,6 +1753,10 @@ protected:
     void card_bundle_clear(size_t cardb);
     PER_HEAP
     void card_bundles_set (size_t start_cardb, size_t end_cardb);
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    PER_HEAP
+    void card_bundle_set (size_t cardb);
+#endif //FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
     PER_HEAP
     BOOL card_bundle_set_p (size_t cardb);
     PER_HEAP
@@ -2208,10 +2258,14 @@ protected:
     void make_free_lists (int condemned_gen_number);
     PER_HEAP
     void make_free_list_in_brick (uint8_t* tree, make_free_args* args);
+    // gen_allocator defaults to the free list of gen, the LOH sweep passes
+    // the one of the segment the gap is on (see loh_allocator_of).
+    PER_HEAP
+    void thread_gap (uint8_t* gap_start, size_t size, generation*  gen, allocator* gen_allocator=0);
     PER_HEAP
-    void thread_gap (uint8_t* gap_start, size_t size, generation*  gen);
+    void loh_thread_gap_front (uint8_t* gap_start, size_t size, generation*  gen, allocator* gen_allocator);
     PER_HEAP
-    void loh_thread_gap_front (uint8_t* gap_start, size_t size, generation*  gen);
+    allocator* loh_allocator_of (heap_segment* seg);
     PER_HEAP
     void make_unused_array (uint8_t* x, size_t size, BOOL clearp=FALSE, BOOL resetp=FALSE);
     PER_HEAP
@@ -2640,6 +2694,12 @@ protected:
     PER_HEAP_ISOLATED
     void verify_mark_array_cleared (uint8_t* begin, uint8_t* end, uint32_t* mark_array_addr);
 
+    PER_HEAP_ISOLATED
+    BOOL commit_mark_array_pages (uint8_t* commit_start, size_t size);
+
+    PER_HEAP_ISOLATED
+    BOOL decommit_mark_array_pages (uint8_t* decommit_start, size_t size);
+
     PER_HEAP_ISOLATED
     BOOL commit_mark_array_by_range (uint8_t* begin,
                                      uint8_t* end,
@@ -2906,6 +2966,52 @@ public:
 
     PER_HEAP_ISOLATED
     size_t min_balance_threshold;
+
+    // Set by GCDynamicHeapCount, n_active_heaps then follows the load
+    PER_HEAP_ISOLATED
+    BOOL dynamic_heap_count_p;
+
+    PER_HEAP_ISOLATED
+    dynamic_heap_count_data dynamic_heap_count;
+
+    PER_HEAP_ISOLATED
+    void record_dynamic_heap_count_gc_start();
+
+    PER_HEAP_ISOLATED
+    void update_dynamic_heap_count();
+
+    // Set by GCGradualDecommit, the free space at the end of the segments
+    // is then left committed after a GC and released by decommit_step.
+    PER_HEAP_ISOLATED
+    BOOL gradual_decommit_p;
+
+    // Some segments still have a decommit target, the heap 0 GC thread
+    // wakes up every DECOMMIT_TIME_STEP_MILLISECONDS to call decommit_step.
+    PER_HEAP_ISOLATED
+    BOOL gradual_decommit_in_progress_p;
+
+    // Largest gen0 budget of the current and the previous
+    // GC_EPHEMERAL_DECOMMIT_TIMEOUT window, the ephemeral segment
+    // keeps that much committed.
+    PER_HEAP
+    size_t gen0_budget_peak;
+
+    PER_HEAP
+    size_t gen0_budget_previous_peak;
+
+    PER_HEAP
+    size_t gen0_budget_window_start;
+
+    // Decommits up to step_milliseconds worth of pages above the decommit
+    // targets, returns whether there is more to do.
+    PER_HEAP_ISOLATED
+    BOOL decommit_step (size_t step_milliseconds);
+
+    PER_HEAP
+    BOOL decommit_segments_step (size_t* budget);
+
+    PER_HEAP
+    BOOL decommit_segment_step (heap_segment* seg, size_t* budget);
 #else //MULTIPLE_HEAPS
 
     PER_HEAP
@@ -2956,6 +3062,102 @@ public:
     PER_HEAP_ISOLATED
     bool restricted_physical_memory_p;
 
+    // The most the GC heap may have committed, 0 if there is no limit.
+    // When set, committing past it fails like running out of memory
+    // and the limit stands in for the physical memory.
+    PER_HEAP_ISOLATED
+    size_t heap_hard_limit;
+
+    // Committed memory, heap and bookkeeping together, only kept up to
+    // date with a hard limit.
+    PER_HEAP_ISOLATED
+    size_t current_total_committed;
+
+    // The part of current_total_committed in each commit_bucket.
+    PER_HEAP_ISOLATED
+    size_t committed_by_bucket[total_commit_buckets];
+
+    PER_HEAP_ISOLATED
+    CLRCriticalSection check_commit_cs;
+
+    PER_HEAP_ISOLATED
+    bool commit_within_hard_limit (size_t size, commit_bucket bucket);
+
+    PER_HEAP_ISOLATED
+    void release_committed (size_t size, commit_bucket bucket);
+
+    // h_number picks the NUMA node for heap memory, bookkeeping passes -1.
+    PER_HEAP_ISOLATED
+    bool virtual_commit (void* address, size_t size, commit_bucket bucket, int h_number);
+
+    PER_HEAP_ISOLATED
+    bool virtual_decommit (void* address, size_t size, commit_bucket bucket);
+
+    // Bytes of heap segment memory committed and decommitted since
+    // the start of the process, updated under check_commit_cs.
+    PER_HEAP_ISOLATED
+    uint64_t total_commit_bytes;
+
+    PER_HEAP_ISOLATED
+    uint64_t total_decommit_bytes;
+
+    PER_HEAP_ISOLATED
+    void count_commit_change (size_t size, bool commit_p);
+
+    // Time spent by this heap in each pause phase of the current blocking GC,
+    // in QueryPerformanceCounter ticks. Suspension and resumption are global
+    // and only kept in last_pause_phase_time.
+    PER_HEAP
+    uint64_t pause_phase_time[max_pause_phase];
+
+    // Bit mask of the phases this heap went through in the current blocking GC;
+    // a GC that doesn't compact has no relocate and compact phase, for example.
+    PER_HEAP
+    uint32_t pause_phases_run;
+
+    // Ticks of each pause phase of the last blocking GC; with server GC a
+    // phase takes as long as the slowest heap.
+    PER_HEAP_ISOLATED
+    uint64_t last_pause_phase_time[max_pause_phase];
+
+    PER_HEAP_ISOLATED
+    size_t last_pause_phase_gc_index;
+
+    PER_HEAP_ISOLATED
+    int last_pause_phase_generation;
+
+    // Phases any heap went through in the last blocking GC. Only these are
+    // added to the histograms.
+    PER_HEAP_ISOLATED
+    uint32_t last_pause_phases_run;
+
+    // Set when last_pause_phase_time has been filled in for a blocking GC
+    // that hasn't been added to the histograms yet.
+    PER_HEAP_ISOLATED
+    BOOL pause_phases_pending;
+
+    // Number of blocking GCs per pause phase and log2 bucket of microseconds.
+    PER_HEAP_ISOLATED
+    uint64_t pause_phase_histogram[max_pause_phase][PAUSE_PHASE_HISTOGRAM_BUCKETS];
+
+    // Total microseconds spent in each pause phase.
+    PER_HEAP_ISOLATED
+    uint64_t pause_phase_total_time[max_pause_phase];
+
+    // Adds the ticks since phase_start to phase and returns the current
+    // timestamp so consecutive phases can be chained.
+    PER_HEAP
+    uint64_t add_pause_phase_time (gc_pause_phase phase, uint64_t phase_start);
+
+    PER_HEAP_ISOLATED
+    void collect_pause_phases();
+
+    // Called once the EE has been restarted with the time the restart
+    // started at, adds the last blocking GC to the histograms. restarted_ee
+    // is FALSE when the restart was left to a BGC started by the GC.
+    PER_HEAP_ISOLATED
+    void record_pause_phases (BOOL restarted_ee, uint64_t resume_start);
+
     PER_HEAP_ISOLATED
     size_t last_gc_index;
 
@@ -3016,6 +3218,10 @@ protected:
     PER_HEAP
     mark*       mark_stack_array;
 
+    // Whether the mark loops prefetch children through a mark_queue
+    PER_HEAP_ISOLATED
+    BOOL        mark_prefetch_p;
+
     PER_HEAP
     BOOL       verify_pinned_queue_p;
 
@@ -3424,6 +3630,17 @@ protected:
     PER_HEAP 
     alloc_list loh_alloc_list[NUM_LOH_ALIST-1];
 
+    // Free space on the pinned object segments. It is kept apart from the
+    // LOH free list so objects that can move never end up on a segment that
+    // is not compacted, and starts with smaller buckets since pinned buffers
+    // are usually well below the LOH threshold.
+#define NUM_POH_ALIST (8)
+#define BASE_POH_ALIST (4*1024)
+    PER_HEAP
+    allocator poh_allocator;
+    PER_HEAP
+    alloc_list poh_alloc_list[NUM_POH_ALIST-1];
+
 #define NUM_GEN2_ALIST (12)
 #ifdef BIT64
 #define BASE_GEN2_ALIST (1*256)
@@ -3675,6 +3892,12 @@ public:
     SVAL_DECL(int, n_heaps);
     SPTR_DECL(PTR_gc_heap, g_heaps);
 
+    // Allocation contexts are only balanced over heaps [0, n_active_heaps[,
+    // the other heaps keep their survivors but get no new allocations. This
+    // is n_heaps unless dynamic_heap_count_p is set.
+    PER_HEAP_ISOLATED
+    int n_active_heaps;
+
     static
     size_t*   g_promoted;
 #ifdef BACKGROUND_GC
@@ -3733,7 +3956,33 @@ private:
     EEThreadId lockowner_threadid;
 #endif // _DEBUG
 
+    // New objects are registered in one of these buffers (picked by processor)
+    // without taking the lock; the GC moves them to the gen 0 segment before it
+    // looks at the queue. A buffer is active from the time it is opened until it
+    // is drained, the array always has room for the contents of the active ones.
+    static const int RegistrationBufferCount = 16;
+    static const int RegistrationBufferSize = 64;
+
+    struct RegistrationBuffer
+    {
+        // slots handed out so far, RegistrationBufferSize or more once the buffer
+        // is full or closed
+        VOLATILE(int32_t) count;
+        BOOL active;
+        uint8_t cache_separator[HS_CACHE_LINE_SIZE - sizeof (int32_t) - sizeof (BOOL)];
+        Object* items[RegistrationBufferSize];
+    };
+
+    RegistrationBuffer* m_RegistrationBuffers;
+    int m_ActiveRegistrationBuffers;
+
     BOOL GrowArray();
+    BOOL EnsureRoom (size_t count, BOOL can_grow);
+    void InsertItem (unsigned int dest, Object* obj);
+    RegistrationBuffer* GetRegistrationBuffer();
+    void DrainRegistrationBuffer (RegistrationBuffer* buffer);
+    void DrainRegistrationBuffers();
+    void OpenRegistrationBuffer (RegistrationBuffer* buffer, BOOL can_grow);
     void MoveItem (Object** fromIndex,
                    unsigned int fromSeg,
                    unsigned int toSeg);
@@ -3764,6 +4013,7 @@ public:
     void EnterFinalizeLock();
     void LeaveFinalizeLock();
     bool RegisterForFinalization (int gen, Object* obj, size_t size=0);
+    void MergeRegistrationBuffers();
     Object* GetNextFinalizableObject (BOOL only_non_critical=FALSE);
     BOOL ScanForFinalization (promote_func* fn, int gen,BOOL mark_only_p, gc_heap* hp);
     void RelocateFinalizationData (int gen, gc_heap* hp);
@@ -4163,6 +4413,10 @@ struct loh_padding_obj
 // for segments whose mark array is only partially committed.
 #define heap_segment_flags_ma_pcommitted 128
 #endif //BACKGROUND_GC
+// LOH segments that only hold objects allocated with GC_ALLOC_PINNED_OBJECT_HEAP.
+// They are swept with the LOH but never compacted, LOH compaction does not
+// move objects into or out of them.
+#define heap_segment_flags_poh          256
 
 //need to be careful to keep enough pad items to fit a relocation node
 //padded to QuadWord before the plug_skew
@@ -4185,6 +4439,8 @@ public:
 
 #ifdef MULTIPLE_HEAPS
     gc_heap*        heap;
+    // Where gc_heap::decommit_step stops decommitting, 0 if there's nothing to do
+    uint8_t*        decommit_target;
 #endif //MULTIPLE_HEAPS
 
 #ifdef _MSC_VER
@@ -4244,6 +4500,12 @@ BOOL heap_segment_loh_p (heap_segment * inst)
     return !!(inst->flags & heap_segment_flags_loh);
 }
 
+inline
+BOOL heap_segment_poh_p (heap_segment * inst)
+{
+    return !!(inst->flags & heap_segment_flags_poh);
+}
+
 #ifdef BACKGROUND_GC
 inline
 BOOL heap_segment_decommitted_p (heap_segment * inst)
@@ -4287,6 +4549,11 @@ gc_heap*& heap_segment_heap (heap_segment* inst)
 {
     return inst->heap;
 }
+inline
+uint8_t*& heap_segment_decommit_target (heap_segment* inst)
+{
+    return inst->decommit_target;
+}
 #endif //MULTIPLE_HEAPS
 
 #ifndef MULTIPLE_HEAPS
@@ -4329,14 +4596,15 @@ extern "C" uint8_t* g_ephemeral_high;
 #define card_word_width ((size_t)32)
 
 //
-// The value of card_size is determined empirically according to the average size of an object
-// In the code we also rely on the assumption that one card_table entry (uint32_t) covers an entire os page
+// The value of card_size is determined empirically according to the average size of an object.
+// The write barriers dirty a byte of the card table at a time so a card is an eighth of what
+// card_byte_shift (see gc.h) covers: 256 bytes on 64-bit and 128 bytes on 32-bit by default.
 //
-#if defined (BIT64)
-#define card_size ((size_t)(2*OS_PAGE_SIZE/card_word_width))
-#else
-#define card_size ((size_t)(OS_PAGE_SIZE/card_word_width))
-#endif // BIT64
+#define card_size ((size_t)1 << (card_byte_shift - 3))
+
+#if (GC_CARD_BYTE_SHIFT < 8) || (GC_CARD_BYTE_SHIFT > 11)
+#error GC_CARD_BYTE_SHIFT must be between 8 (256 byte card bytes) and 11 (2KB card bytes)
+#endif
 
 inline
 size_t card_word (size_t card)
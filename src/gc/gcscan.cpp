@@ -110,6 +110,28 @@ bool GCScan::GcDhReScan(ScanContext* sc)
     return Ref_ScanDependentHandlesForPromotion(pDhContext);
 }
 
+// Server GC spreads the blocking handle promotion scans of the mark phase and of the background GC final
+// mark (pinning, strong and dependent handles) across its threads between these calls, see
+// Ref_BeginPartitionedScans. All of them must be made by a single thread while the GC threads are joined.
+void GCScan::GcBeginPartitionedHandleScans()
+{
+    WRAPPER_NO_CONTRACT;
+    Ref_BeginPartitionedScans();
+}
+
+// Called before each dependent handle rescan so that the threads claim the handle table segments afresh.
+void GCScan::GcNextPartitionedHandleScanPass()
+{
+    WRAPPER_NO_CONTRACT;
+    Ref_NextPartitionedScanPass();
+}
+
+void GCScan::GcEndPartitionedHandleScans()
+{
+    WRAPPER_NO_CONTRACT;
+    Ref_EndPartitionedScans();
+}
+
 /*
  * Scan for dead weak pointers
  */
@@ -80,6 +80,12 @@ class GCScan
     // any objects were promoted as a result.
     static bool GcDhReScan(ScanContext* sc);
 
+    // Partition the blocking handle promotion scans of server GC (foreground mark and background final mark)
+    // across the GC threads (calls are made inside joins).
+    static void GcBeginPartitionedHandleScans();
+    static void GcNextPartitionedHandleScanPass();
+    static void GcEndPartitionedHandleScans();
+
     // post-promotions callback
     static void GcPromotionsGranted (int condemned, int max_gen, 
                                      ScanContext* sc);
@@ -905,6 +905,7 @@ void HndEnumHandles(HHANDLETABLE hTable, const uint32_t *puType, uint32_t uTypeC
     info.uFlags          = (fAsync? HNDGCF_ASYNC : HNDGCF_NORMAL);
     info.fEnumUserData   = fEnumUserData;
     info.dwAgeMask       = 0;
+    info.dwScanId        = 0;
     info.pCurrentSegment = NULL;
     info.pfnScan         = pfnEnum;
     info.param1          = lParam1;
@@ -933,12 +934,25 @@ void HndEnumHandles(HHANDLETABLE hTable, const uint32_t *puType, uint32_t uTypeC
  * enables ephemeral scanning of the table, and optionally ages the write barrier
  * as it scans.
  *
+ * A non-zero scanId makes the scan partitioned: several GC threads may scan the
+ * table with the same id at once and each segment is scanned by the first one to
+ * claim it.  Partitioned scans leave the segment list alone (no freeing, trimming
+ * or chain resorting) since other threads may be walking it.
+ *
  */
 void HndScanHandlesForGC(HHANDLETABLE hTable, HANDLESCANPROC scanProc, uintptr_t param1, uintptr_t param2,
-                         const uint32_t *types, uint32_t typeCount, uint32_t condemned, uint32_t maxgen, uint32_t flags)
+                         const uint32_t *types, uint32_t typeCount, uint32_t condemned, uint32_t maxgen, uint32_t flags,
+                         uint32_t scanId)
 {
     WRAPPER_NO_CONTRACT;
 
+    // partitioned scans take no lock: the claims only guarantee that each segment
+    // is scanned by exactly one of the threads sharing the scan id, which relies on
+    // the segment list staying put while they walk it (the EE is suspended).  Async
+    // scans drop the table lock between segments while the EE runs and only one of
+    // them may be in flight per table, so they are never partitioned.
+    _ASSERTE(!scanId || !(flags & HNDGCF_ASYNC));
+
     // fetch the table pointer
     PTR_HandleTable pTable = Table(hTable);
 
@@ -1007,12 +1021,17 @@ void HndScanHandlesForGC(HHANDLETABLE hTable, HANDLESCANPROC scanProc, uintptr_t
 #endif
     }
 
+    // the other threads of a partitioned scan may be walking the segment list
+    if (scanId)
+        pfnSegment = QuickSegmentIterator;
+
     // set up parameters for scan callbacks
     ScanCallbackInfo info;
 
     info.uFlags          = flags;
     info.fEnumUserData   = enumUserData;
     info.dwAgeMask       = BuildAgeMask(condemned, maxgen);
+    info.dwScanId        = scanId;
     info.pCurrentSegment = NULL;
     info.pfnScan         = scanProc;
     info.param1          = param1;
@@ -1040,8 +1059,10 @@ void HndScanHandlesForGC(HHANDLETABLE hTable, HANDLESCANPROC scanProc, uintptr_t
         pfnScanTable(pTable, types, typeCount, pfnSegment, pfnBlock, &info, &ch);
 
 #if defined(_DEBUG) && !defined(DACCESS_COMPILE)
-        // update our scanning statistics for this generation
-        DEBUG_PostGCScanHandler(pTable, types, typeCount, condemned, maxgen, &info);
+        // update our scanning statistics for this generation (the statistics aren't
+        // updated atomically so partitioned scans are left out)
+        if (!scanId)
+            DEBUG_PostGCScanHandler(pTable, types, typeCount, condemned, maxgen, &info);
     #endif
     }
 }
@@ -1075,6 +1096,7 @@ void HndResetAgeMap(HHANDLETABLE hTable, const uint32_t *types, uint32_t typeCou
     info.uFlags          = flags;
     info.fEnumUserData   = FALSE;
     info.dwAgeMask       = BuildAgeMask(condemned, maxgen);
+    info.dwScanId        = 0;
     info.pCurrentSegment = NULL;
     info.pfnScan         = NULL;
     info.param1          = 0;
@@ -1115,6 +1137,7 @@ void HndVerifyTable(HHANDLETABLE hTable, const uint32_t *types, uint32_t typeCou
     info.uFlags          = flags;
     info.fEnumUserData   = FALSE;
     info.dwAgeMask       = BuildAgeMask(condemned, maxgen);
+    info.dwScanId        = 0;
     info.pCurrentSegment = NULL;
     info.pfnScan         = NULL;
     info.param1          = 0;
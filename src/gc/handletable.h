@@ -131,7 +131,8 @@ void            HndScanHandlesForGC(HHANDLETABLE hTable,
                                     uint32_t typeCount,
                                     uint32_t condemned,
                                     uint32_t maxgen,
-                                    uint32_t flags);
+                                    uint32_t flags,
+                                    uint32_t scanId = 0);
 
 void            HndResetAgeMap(HHANDLETABLE hTable, const uint32_t *types, uint32_t typeCount, uint32_t condemned, uint32_t maxgen, uint32_t flags);
 void            HndVerifyTable(HHANDLETABLE hTable, const uint32_t *types, uint32_t typeCount, uint32_t condemned, uint32_t maxgen, uint32_t flags);
@@ -167,6 +167,14 @@ struct _TableSegmentHeader
      */
     uint32_t rgFreeMask[HANDLE_MASKS_PER_SEGMENT];
 
+    /*
+     * Scan Claim
+     *
+     * Id of the last partitioned GC scan that claimed this segment.
+     * Updated with interlocked operations, keep it 32 bit aligned.
+     */
+    uint32_t dwScanClaim;
+
     /*
      * Block Handle Types
      *
@@ -367,6 +375,7 @@ struct ScanCallbackInfo
     uintptr_t        param1;            // callback param 1
     uintptr_t        param2;            // callback param 2
     uint32_t         dwAgeMask;         // generation mask for ephemeral GCs
+    uint32_t         dwScanId;          // id of a partitioned scan, 0 if the scan isn't partitioned
 
 #ifdef _DEBUG
     uint32_t DEBUG_BlocksScanned;
@@ -905,6 +914,15 @@ void TableFreeHandlesToCache(HandleTable *pTable, uint32_t uType, const OBJECTHA
  *
  ****************************************************************************/
 
+/*
+ * SegmentClaimForScan
+ *
+ * Claims a segment for a partitioned scan, returns TRUE if the caller got it.
+ *
+ */
+BOOL SegmentClaimForScan(PTR_TableSegment pSegment, uint32_t dwScanId);
+
+
 /*
  * TableScanHandles
  *
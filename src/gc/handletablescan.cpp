@@ -1703,6 +1703,39 @@ void SegmentScanByTypeMap(PTR_TableSegment pSegment, const BOOL *rgTypeInclusion
 }
 
 
+/*
+ * SegmentClaimForScan
+ *
+ * Claims a segment for a partitioned scan.
+ *
+ * Returns TRUE if the caller is the first to claim the segment for this scan id.
+ *
+ */
+BOOL SegmentClaimForScan(PTR_TableSegment pSegment, uint32_t dwScanId)
+{
+    LIMITED_METHOD_CONTRACT;
+
+#ifndef DACCESS_COMPILE
+    uint32_t dwClaim = pSegment->dwScanClaim;
+    while (dwClaim != dwScanId)
+    {
+        uint32_t dwPrevClaim = Interlocked::CompareExchange(&pSegment->dwScanClaim, dwScanId, dwClaim);
+        if (dwPrevClaim == dwClaim)
+            return TRUE;
+
+        dwClaim = dwPrevClaim;
+    }
+
+    // another thread already has this segment
+    return FALSE;
+#else
+    UNREFERENCED_PARAMETER(pSegment);
+    UNREFERENCED_PARAMETER(dwScanId);
+    return TRUE;
+#endif
+}
+
+
 /*
  * TableScanHandles
  *
@@ -1737,6 +1770,10 @@ void CALLBACK TableScanHandles(PTR_HandleTable pTable,
     PTR_TableSegment pSegment = NULL;
     while ((pSegment = pfnSegmentIterator(pTable, pSegment, pCrstHolder)) != NULL)
     {
+        // partitioned scans only look at the segments they manage to claim
+        if (pInfo->dwScanId && !SegmentClaimForScan(pSegment, pInfo->dwScanId))
+            continue;
+
         // if there are types to scan then enumerate the blocks in this segment
         // (we do this test inside the loop since the iterators should still run...)
         if (uTypeCount >= 1)
@@ -877,6 +877,115 @@ int getSlotNumber(ScanContext* sc)
     return (GCHeap::IsServerHeap() ? sc->thread_number : 0);
 }
 
+/*
+ * Partitioned handle scans
+ *
+ * Under server GC the blocking promotion scans of the mark phase (and of the
+ * final mark of a background GC) are spread across the GC threads: every
+ * thread walks the handle tables of all the slots, starting with its own, and
+ * only scans the segments it claims first (see SegmentClaimForScan).  A thread done with its own tables thus helps the others
+ * with theirs instead of waiting for them at the next join.
+ *
+ * Each kind of scan gets its own id within a pass so that a thread moving on to
+ * the next kind doesn't find the segments already claimed.  The GC only begins,
+ * ends or advances the passes while all its threads are joined.
+ *
+ * Workstation GC has a single slot and a single GC thread, so there is nothing
+ * to spread and its scans are never partitioned.  The concurrent scans of a
+ * background GC aren't either: they run while the EE may create and destroy
+ * handles, walking the segment list under the table lock which they drop between
+ * segments, and a table only supports one such scan at a time.
+ */
+enum PartitionedScanKind
+{
+    PSK_Pinning = 1,
+    PSK_VariablePinning,
+    PSK_Normal,
+    PSK_VariableNormal,
+    PSK_RefCounted,
+    PSK_Dependent,
+
+    PSK_Stride = 8  // ids used by one pass, must be above the kinds
+};
+
+static bool s_fPartitionedScans = false;
+static uint32_t s_dwScanPassBase = 0;
+
+void Ref_BeginPartitionedScans()
+{
+    LIMITED_METHOD_CONTRACT;
+
+    s_dwScanPassBase += PSK_Stride;
+    s_fPartitionedScans = (getNumberOfSlots() > 1);
+}
+
+void Ref_NextPartitionedScanPass()
+{
+    LIMITED_METHOD_CONTRACT;
+
+    s_dwScanPassBase += PSK_Stride;
+}
+
+void Ref_EndPartitionedScans()
+{
+    LIMITED_METHOD_CONTRACT;
+
+    s_fPartitionedScans = false;
+}
+
+// Returns the id to scan with for this kind of scan, 0 if the scan isn't partitioned.
+static uint32_t GetPartitionedScanId(ScanContext* sc, uint32_t kind)
+{
+    LIMITED_METHOD_CONTRACT;
+
+    // concurrent scans walk the segment list under the table lock
+    if (!s_fPartitionedScans || sc->concurrent)
+        return 0;
+
+    return s_dwScanPassBase + kind;
+}
+
+/*
+ * ScanHandleTablesForGC
+ *
+ * Scans the handle tables of the slot of this GC thread, or of all the slots
+ * (own slot first) when the scan is partitioned.
+ */
+static void ScanHandleTablesForGC(ScanContext* sc, uint32_t scanId, HANDLESCANPROC scanProc, uintptr_t param2,
+                                  const uint32_t *types, uint32_t typeCount, uint32_t condemned, uint32_t maxgen, uint32_t flags)
+{
+    WRAPPER_NO_CONTRACT;
+
+    int uSlot = getSlotNumber(sc);
+    int n_slots = getNumberOfSlots();
+    int n_slotsToScan = (scanId ? n_slots : 1);
+
+    for (int n = 0; n < n_slotsToScan; n++)
+    {
+        int uCPUindex = (uSlot + n) % n_slots;
+
+        HandleTableMap *walk = &g_HandleTableMap;
+        while (walk) {
+            for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
+                if (walk->pBuckets[i] != NULL)
+                {
+                    HHANDLETABLE hTable = walk->pBuckets[i]->pTable[uCPUindex];
+                    if (hTable)
+                    {
+#ifdef FEATURE_APPDOMAIN_RESOURCE_MONITORING
+                        if (g_fEnableARM)
+                        {
+                            sc->pCurrentDomain = SystemDomain::GetAppDomainAtIndex(HndGetHandleTableADIndex(hTable));
+                        }
+#endif //FEATURE_APPDOMAIN_RESOURCE_MONITORING
+                        HndScanHandlesForGC(hTable, scanProc, uintptr_t(sc), param2, types, typeCount, condemned, maxgen, flags, scanId);
+                    }
+                }
+            walk = walk->pNext;
+        }
+    }
+}
+
 // <TODO> - reexpress as complete only like hndtable does now!!! -fmh</REVISIT_TODO>
 void Ref_EndSynchronousGC(uint32_t condemned, uint32_t maxgen)
 {
@@ -1045,7 +1154,7 @@ uint32_t CompareExchangeVariableHandleType(OBJECTHANDLE handle, uint32_t oldType
  * Convenience function for tracing variable-strength handles.
  * Wraps HndScanHandlesForGC.
  */
-void TraceVariableHandles(HANDLESCANPROC pfnTrace, uintptr_t lp1, uintptr_t lp2, uint32_t uEnableMask, uint32_t condemned, uint32_t maxgen, uint32_t flags)
+void TraceVariableHandles(HANDLESCANPROC pfnTrace, uintptr_t lp1, uintptr_t lp2, uint32_t uEnableMask, uint32_t condemned, uint32_t maxgen, uint32_t flags, uint32_t scanId = 0)
 {
     WRAPPER_NO_CONTRACT;
 
@@ -1053,27 +1162,8 @@ void TraceVariableHandles(HANDLESCANPROC pfnTrace, uintptr_t lp1, uintptr_t lp2,
     uint32_t               type = HNDTYPE_VARIABLE;
     struct VARSCANINFO info = { (uintptr_t)uEnableMask, pfnTrace, lp2 };
 
-    HandleTableMap *walk = &g_HandleTableMap;
-    while (walk) {
-        for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i++)
-            if (walk->pBuckets[i] != NULL)
-            {
-                HHANDLETABLE hTable = walk->pBuckets[i]->pTable[getSlotNumber((ScanContext*) lp1)];
-                if (hTable)
-                {
-#ifdef FEATURE_APPDOMAIN_RESOURCE_MONITORING
-                    if (g_fEnableARM)
-                    {
-                        ScanContext* sc = (ScanContext *)lp1;
-                        sc->pCurrentDomain = SystemDomain::GetAppDomainAtIndex(HndGetHandleTableADIndex(hTable));
-                    }
-#endif //FEATURE_APPDOMAIN_RESOURCE_MONITORING
-                    HndScanHandlesForGC(hTable, VariableTraceDispatcher,
-                                        lp1, (uintptr_t)&info, &type, 1, condemned, maxgen, HNDGCF_EXTRAINFO | flags);
-                }
-            }
-        walk = walk->pNext;
-    }
+    ScanHandleTablesForGC((ScanContext*) lp1, scanId, VariableTraceDispatcher,
+                          (uintptr_t)&info, &type, 1, condemned, maxgen, HNDGCF_EXTRAINFO | flags);
 }
 
 /*
@@ -1118,28 +1208,11 @@ void Ref_TracePinningRoots(uint32_t condemned, uint32_t maxgen, ScanContext* sc,
     uint32_t types[2] = {HNDTYPE_PINNED, HNDTYPE_ASYNCPINNED};
     uint32_t flags = sc->concurrent ? HNDGCF_ASYNC : HNDGCF_NORMAL;
 
-    HandleTableMap *walk = &g_HandleTableMap;
-    while (walk) {
-        for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
-            if (walk->pBuckets[i] != NULL)
-            {
-                HHANDLETABLE hTable = walk->pBuckets[i]->pTable[getSlotNumber((ScanContext*) sc)];
-                if (hTable)
-                {
-#ifdef FEATURE_APPDOMAIN_RESOURCE_MONITORING
-                    if (g_fEnableARM)
-                    {
-                        sc->pCurrentDomain = SystemDomain::GetAppDomainAtIndex(HndGetHandleTableADIndex(hTable));
-                    }
-#endif //FEATURE_APPDOMAIN_RESOURCE_MONITORING
-                    HndScanHandlesForGC(hTable, PinObject, uintptr_t(sc), uintptr_t(fn), types, _countof(types), condemned, maxgen, flags);
-                }
-            }
-        walk = walk->pNext;
-    }
+    ScanHandleTablesForGC(sc, GetPartitionedScanId(sc, PSK_Pinning), PinObject, uintptr_t(fn), types, _countof(types), condemned, maxgen, flags);
 
     // pin objects pointed to by variable handles whose dynamic type is VHT_PINNED
-    TraceVariableHandles(PinObject, uintptr_t(sc), uintptr_t(fn), VHT_PINNED, condemned, maxgen, flags);
+    TraceVariableHandles(PinObject, uintptr_t(sc), uintptr_t(fn), VHT_PINNED, condemned, maxgen, flags,
+                         GetPartitionedScanId(sc, PSK_VariablePinning));
 }
 
 
@@ -1155,29 +1228,11 @@ void Ref_TraceNormalRoots(uint32_t condemned, uint32_t maxgen, ScanContext* sc,
     uint32_t uTypeCount = (((condemned >= maxgen) && !GCHeap::GetGCHeap()->IsConcurrentGCInProgress()) ? 1 : _countof(types));
     uint32_t flags = (sc->concurrent) ? HNDGCF_ASYNC : HNDGCF_NORMAL;
 
-    HandleTableMap *walk = &g_HandleTableMap;
-    while (walk) {
-        for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
-            if (walk->pBuckets[i] != NULL)
-            {
-                HHANDLETABLE hTable = walk->pBuckets[i]->pTable[getSlotNumber(sc)];
-                if (hTable)
-                {
-#ifdef FEATURE_APPDOMAIN_RESOURCE_MONITORING
-                    if (g_fEnableARM)
-                    {
-                        sc->pCurrentDomain = SystemDomain::GetAppDomainAtIndex(HndGetHandleTableADIndex(hTable));
-                    }
-#endif //FEATURE_APPDOMAIN_RESOURCE_MONITORING
-
-                    HndScanHandlesForGC(hTable, PromoteObject, uintptr_t(sc), uintptr_t(fn), types, uTypeCount, condemned, maxgen, flags);
-                }
-            }
-        walk = walk->pNext;
-    }
+    ScanHandleTablesForGC(sc, GetPartitionedScanId(sc, PSK_Normal), PromoteObject, uintptr_t(fn), types, uTypeCount, condemned, maxgen, flags);
 
     // promote objects pointed to by variable handles whose dynamic type is VHT_STRONG
-    TraceVariableHandles(PromoteObject, uintptr_t(sc), uintptr_t(fn), VHT_STRONG, condemned, maxgen, flags);
+    TraceVariableHandles(PromoteObject, uintptr_t(sc), uintptr_t(fn), VHT_STRONG, condemned, maxgen, flags,
+                         GetPartitionedScanId(sc, PSK_VariableNormal));
 
 #if defined(FEATURE_COMINTEROP) || defined(FEATURE_REDHAWK)
     // don't scan ref-counted handles during concurrent phase as the clean-up of CCWs can race with AD unload and cause AV's
@@ -1186,17 +1241,7 @@ void Ref_TraceNormalRoots(uint32_t condemned, uint32_t maxgen, ScanContext* sc,
         // promote ref-counted handles
         uint32_t type = HNDTYPE_REFCOUNTED;
 
-        walk = &g_HandleTableMap;
-        while (walk) {
-            for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
-                if (walk->pBuckets[i] != NULL)
-                {
-                    HHANDLETABLE hTable = walk->pBuckets[i]->pTable[getSlotNumber(sc)];
-                    if (hTable)
-                        HndScanHandlesForGC(hTable, PromoteRefCounted, uintptr_t(sc), uintptr_t(fn), &type, 1, condemned, maxgen, flags );
-                }
-            walk = walk->pNext;
-        }
+        ScanHandleTablesForGC(sc, GetPartitionedScanId(sc, PSK_RefCounted), PromoteRefCounted, uintptr_t(fn), &type, 1, condemned, maxgen, flags);
     }
 #endif // FEATURE_COMINTEROP || FEATURE_REDHAWK
 }
@@ -1321,6 +1366,9 @@ bool Ref_ScanDependentHandlesForPromotion(DhContext *pDhContext)
     // Note that even once we terminate the GC may call us again (because it has caused more objects to be
     // marked as promoted). But we scan in a loop here anyway because it is cheaper for us to loop than the GC
     // (especially on server GC where each external cycle has to be synchronized between GC worker threads).
+    // A partitioned scan only covers the segments this thread claimed, so it makes a single pass and leaves
+    // the rescans to the GC (which starts a new pass with fresh ids for each of them).
+    uint32_t scanId = GetPartitionedScanId(pDhContext->m_pScanContext, PSK_Dependent);
     do
     {
         // Assume the conditions for re-scanning are both false initially. The scan callback below
@@ -1329,34 +1377,19 @@ bool Ref_ScanDependentHandlesForPromotion(DhContext *pDhContext)
         pDhContext->m_fUnpromotedPrimaries = false;
         pDhContext->m_fPromoted = false;
 
-        HandleTableMap *walk = &g_HandleTableMap;
-        while (walk) 
-        {
-            for (uint32_t i = 0; i < INITIAL_HANDLE_TABLE_ARRAY_SIZE; i ++)
-            {
-                if (walk->pBuckets[i] != NULL)
-                {
-                    HHANDLETABLE hTable = walk->pBuckets[i]->pTable[getSlotNumber(pDhContext->m_pScanContext)];
-                    if (hTable)
-                    {
-                        HndScanHandlesForGC(hTable,
-                                            PromoteDependentHandle,
-                                            uintptr_t(pDhContext->m_pScanContext),
-                                            uintptr_t(pDhContext->m_pfnPromoteFunction),
-                                            &type, 1,
-                                            pDhContext->m_iCondemned,
-                                            pDhContext->m_iMaxGen,
-                                            flags );
-                    }
-                }
-            }
-            walk = walk->pNext;
-        }
+        ScanHandleTablesForGC(pDhContext->m_pScanContext,
+                              scanId,
+                              PromoteDependentHandle,
+                              uintptr_t(pDhContext->m_pfnPromoteFunction),
+                              &type, 1,
+                              pDhContext->m_iCondemned,
+                              pDhContext->m_iMaxGen,
+                              flags);
 
         if (pDhContext->m_fPromoted)
             fAnyPromotions = true;
 
-    } while (pDhContext->m_fUnpromotedPrimaries && pDhContext->m_fPromoted);
+    } while (!scanId && pDhContext->m_fUnpromotedPrimaries && pDhContext->m_fPromoted);
 
     return fAnyPromotions;
 }
@@ -655,6 +655,9 @@ struct DhContext;
 struct ProfilingScanContext;
 void Ref_BeginSynchronousGC   (uint32_t uCondemnedGeneration, uint32_t uMaxGeneration);
 void Ref_EndSynchronousGC     (uint32_t uCondemnedGeneration, uint32_t uMaxGeneration);
+void Ref_BeginPartitionedScans();
+void Ref_NextPartitionedScanPass();
+void Ref_EndPartitionedScans();
 
 typedef void Ref_promote_func(class Object**, ScanContext*, uint32_t);
 
@@ -0,0 +1,1089 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+//
+// GCBench.cpp
+//
+
+//
+//  A benchmark harness for the GC, built on the same standalone GC environment as GCSample.
+//
+//  It runs a configurable allocation workload on a number of mutator threads and reports GC pause
+//  percentiles, allocation throughput and peak working set, so that GC (and arena) changes can be
+//  evaluated without the rest of CoreCLR.
+//
+//  The workload is described by:
+//
+//  * Allocation volume and rate: every mutator allocates -mb megabytes, optionally throttled to
+//    -rate megabytes per second.
+//  * Object sizes: small objects are object arrays with a random length in [-minsize, -maxsize] bytes.
+//  * Object lifetimes: -survive percent of allocations replace a random entry of a per-thread table
+//    of -survivors objects, so the table size controls how long they live. -old per mille of those
+//    are also stored into a table of -oldcount objects that is replaced much more slowly, which
+//    gives the survival curve a long tail into gen2.
+//  * Pinning: -pin percent of surviving objects are also held by a pinning handle.
+//  * LOH: -loh per mille of allocations are byte arrays of -lohsize bytes.
+//  * Finalization: -finalize percent of small objects are finalizable, so every thread keeps
+//    registering objects for finalization. There is no finalizer thread in this environment, each
+//    mutator takes the objects that are ready for finalization off the queue every -finalizedrain
+//    allocations instead.
+//
+//  Runs are reproducible: every mutator has its own random number generator seeded from -seed and
+//  its thread index.
+//
+//  The GC has no stack roots in this environment, so mutators only hold objects in handles (or in
+//  objects reachable from handles) across allocations. Mutators run in cooperative mode, a GC
+//  can only start while they are in an allocation or at the PollGC at the top of their loop.
+//
+//  With -mark the harness measures the mark phase instead: it builds -livemb megabytes of
+//  pointer-chasing data structures (a hash table with chained entries and a binary tree, both
+//  linked in random order), induces -gcs blocking gen2 GCs and reports the live megabytes marked
+//  per second of GC pause. -markprefetch 0 turns off the mark prefetch queue (GCMarkPrefetch), run
+//  it both ways to compare. The live data also includes a few large object arrays that are only
+//  reachable through one small array, so that the mark queue hands them out once the mark stack
+//  is empty and they are marked in several steps from there. Every element is checked after the
+//  GCs, a run that finds a collected element fails.
+//
+
+#include "common.h"
+
+#include "gcenv.h"
+
+#include "gc.h"
+#include "objecthandle.h"
+
+#include "gcdesc.h"
+#include "writebarrier.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//
+// Options
+//
+
+struct BenchOptions
+{
+    const char * scenario;
+    bool server;
+    bool dynamicHeaps;
+    bool concurrent;
+    uint32_t threads;
+    uint32_t allocMB;           // per thread
+    uint32_t rateMB;            // per thread per second, 0 for unthrottled
+    uint32_t minSize;
+    uint32_t maxSize;
+    uint32_t survivePercent;
+    uint32_t survivorCount;
+    uint32_t oldPerMille;
+    uint32_t oldCount;
+    uint32_t pinPercent;
+    uint32_t pinCount;
+    uint32_t lohPerMille;
+    uint32_t lohSize;
+    uint32_t finalizePercent;
+    uint32_t finalizeDrain;
+    uint32_t seed;
+    bool csv;
+    bool mark;
+    uint32_t liveMB;
+    uint32_t gcCount;
+    uint32_t markPrefetch;
+    uint32_t hardLimitMB;
+    uint32_t gradualDecommit;
+};
+
+struct BenchScenario
+{
+    const char * name;
+    const char * description;
+    uint32_t survivePercent;
+    uint32_t survivorCount;
+    uint32_t oldPerMille;
+    uint32_t pinPercent;
+    uint32_t lohPerMille;
+    uint32_t finalizePercent;
+};
+
+static const BenchScenario s_scenarios[] =
+{
+    //  name        description                                       survive  survivors  old  pin  loh  fin
+    { "churn",    "short lived objects only",                           0,      1024,    0,   0,   0,   0 },
+    { "survival", "objects survive a few gen0 GCs",                    20,     65536,    0,   0,   0,   0 },
+    { "aging",    "steady promotion into gen2",                        20,     65536,   50,   0,   0,   0 },
+    { "pinning",  "surviving objects are frequently pinned",           20,     65536,   10,  10,   0,   0 },
+    { "loh",      "large object allocations",                          10,     16384,    0,   0,   5,   0 },
+    { "mixed",    "all of the above",                                  15,     65536,   20,   2,   1,   0 },
+    { "finalize", "short lived finalizable objects from every thread",  5,     16384,    0,   0,   0,  50 },
+};
+
+static void Usage()
+{
+    printf("Usage: gcbench [options]\n");
+    printf("  -scenario <name>   workload preset (default: mixed)\n");
+    for (size_t i = 0; i < sizeof(s_scenarios) / sizeof(s_scenarios[0]); i++)
+        printf("       %-10s      %s\n", s_scenarios[i].name, s_scenarios[i].description);
+    printf("  -server            use server GC\n");
+    printf("  -dynamicheaps      let server GC adapt the number of heaps to the load (GCDynamicHeapCount)\n");
+    printf("  -concurrent        enable background GC\n");
+    printf("  -threads <n>       number of mutator threads (default: 1)\n");
+    printf("  -mb <n>            megabytes allocated by each thread (default: 1024)\n");
+    printf("  -rate <n>          megabytes per second allocated by each thread, 0 for no limit (default: 0)\n");
+    printf("  -minsize <n>       minimum small object size in bytes (default: 32)\n");
+    printf("  -maxsize <n>       maximum small object size in bytes (default: 256)\n");
+    printf("  -survive <pct>     percent of allocations stored in the survivor table\n");
+    printf("  -survivors <n>     entries in each thread's survivor table\n");
+    printf("  -old <permille>    per mille of survivors also stored in the old table\n");
+    printf("  -oldcount <n>      entries in each thread's old table (default: 65536)\n");
+    printf("  -pin <pct>         percent of survivors held by a pinning handle\n");
+    printf("  -pincount <n>      pinning handles per thread (default: 256)\n");
+    printf("  -loh <permille>    per mille of allocations that are large objects\n");
+    printf("  -lohsize <n>       large object size in bytes (default: 100000)\n");
+    printf("  -finalize <pct>    percent of small objects that are finalizable\n");
+    printf("  -finalizedrain <n> allocations between two drains of the finalization queue (default: 1024)\n");
+    printf("  -seed <n>          random seed (default: 1)\n");
+    printf("  -csv               print the results as a single CSV line\n");
+    printf("  -mark              measure mark throughput instead of running the allocation workload\n");
+    printf("  -livemb <n>        megabytes of live objects built for -mark (default: 256)\n");
+    printf("  -gcs <n>           gen2 GCs measured by -mark (default: 10)\n");
+    printf("  -markprefetch <n>  0 to mark without the prefetch queue (default: 1)\n");
+    printf("  -hardlimitmb <n>   most megabytes the GC heap may commit, 0 for no limit (GCHeapHardLimitMB)\n");
+    printf("  -gradualdecommit <n> 0 for server GC to decommit free space right after a GC (default: 1)\n");
+}
+
+static bool ApplyScenario(BenchOptions * pOptions, const char * name)
+{
+    for (size_t i = 0; i < sizeof(s_scenarios) / sizeof(s_scenarios[0]); i++)
+    {
+        const BenchScenario & scenario = s_scenarios[i];
+        if (strcmp(scenario.name, name) == 0)
+        {
+            pOptions->scenario = scenario.name;
+            pOptions->survivePercent = scenario.survivePercent;
+            pOptions->survivorCount = scenario.survivorCount;
+            pOptions->oldPerMille = scenario.oldPerMille;
+            pOptions->pinPercent = scenario.pinPercent;
+            pOptions->lohPerMille = scenario.lohPerMille;
+            pOptions->finalizePercent = scenario.finalizePercent;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchOptions * pOptions)
+{
+    memset(pOptions, 0, sizeof(*pOptions));
+    pOptions->threads = 1;
+    pOptions->allocMB = 1024;
+    pOptions->minSize = 32;
+    pOptions->maxSize = 256;
+    pOptions->oldCount = 65536;
+    pOptions->pinCount = 256;
+    pOptions->lohSize = 100000;
+    pOptions->finalizeDrain = 1024;
+    pOptions->seed = 1;
+    pOptions->liveMB = 256;
+    pOptions->gcCount = 10;
+    pOptions->markPrefetch = 1;
+    pOptions->gradualDecommit = 1;
+    ApplyScenario(pOptions, "mixed");
+
+    // The scenario is applied first so that individual options can override it
+    for (int i = 1; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "-scenario") == 0 && !ApplyScenario(pOptions, argv[i + 1]))
+        {
+            printf("Unknown scenario '%s'\n", argv[i + 1]);
+            return false;
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char * arg = argv[i];
+
+        if (strcmp(arg, "-server") == 0)
+        {
+            pOptions->server = true;
+            continue;
+        }
+        if (strcmp(arg, "-dynamicheaps") == 0)
+        {
+            pOptions->dynamicHeaps = true;
+            continue;
+        }
+        if (strcmp(arg, "-concurrent") == 0)
+        {
+            pOptions->concurrent = true;
+            continue;
+        }
+        if (strcmp(arg, "-csv") == 0)
+        {
+            pOptions->csv = true;
+            continue;
+        }
+        if (strcmp(arg, "-mark") == 0)
+        {
+            pOptions->mark = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return false;
+        const char * value = argv[++i];
+        uint32_t n = (uint32_t)strtoul(value, NULL, 10);
+
+        if (strcmp(arg, "-scenario") == 0)
+            ;
+        else if (strcmp(arg, "-threads") == 0)
+            pOptions->threads = n;
+        else if (strcmp(arg, "-mb") == 0)
+            pOptions->allocMB = n;
+        else if (strcmp(arg, "-rate") == 0)
+            pOptions->rateMB = n;
+        else if (strcmp(arg, "-minsize") == 0)
+            pOptions->minSize = n;
+        else if (strcmp(arg, "-maxsize") == 0)
+            pOptions->maxSize = n;
+        else if (strcmp(arg, "-survive") == 0)
+            pOptions->survivePercent = n;
+        else if (strcmp(arg, "-survivors") == 0)
+            pOptions->survivorCount = n;
+        else if (strcmp(arg, "-old") == 0)
+            pOptions->oldPerMille = n;
+        else if (strcmp(arg, "-oldcount") == 0)
+            pOptions->oldCount = n;
+        else if (strcmp(arg, "-pin") == 0)
+            pOptions->pinPercent = n;
+        else if (strcmp(arg, "-pincount") == 0)
+            pOptions->pinCount = n;
+        else if (strcmp(arg, "-loh") == 0)
+            pOptions->lohPerMille = n;
+        else if (strcmp(arg, "-lohsize") == 0)
+            pOptions->lohSize = n;
+        else if (strcmp(arg, "-finalize") == 0)
+            pOptions->finalizePercent = n;
+        else if (strcmp(arg, "-finalizedrain") == 0)
+            pOptions->finalizeDrain = n;
+        else if (strcmp(arg, "-seed") == 0)
+            pOptions->seed = n;
+        else if (strcmp(arg, "-livemb") == 0)
+            pOptions->liveMB = n;
+        else if (strcmp(arg, "-gcs") == 0)
+            pOptions->gcCount = n;
+        else if (strcmp(arg, "-markprefetch") == 0)
+            pOptions->markPrefetch = n;
+        else if (strcmp(arg, "-hardlimitmb") == 0)
+            pOptions->hardLimitMB = n;
+        else if (strcmp(arg, "-gradualdecommit") == 0)
+            pOptions->gradualDecommit = n;
+        else
+        {
+            printf("Unknown option '%s'\n", arg);
+            return false;
+        }
+    }
+
+    if (pOptions->threads == 0 || pOptions->survivorCount == 0 || pOptions->oldCount == 0 ||
+        pOptions->pinCount == 0 || pOptions->minSize > pOptions->maxSize ||
+        pOptions->liveMB == 0 || pOptions->gcCount == 0 || pOptions->finalizeDrain == 0)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//
+// Types
+//
+
+// Object arrays are used for small objects (so that they can reference each other) and for the
+// survivor tables. Byte arrays are used for large objects.
+static struct ObjectArray_MethodTable
+{
+    // GCDesc
+    CGCDescSeries m_series[1];
+    size_t m_numSeries;
+
+    // The actual methodtable
+    MethodTable m_MT;
+}
+ObjectArray_MethodTable;
+
+// Same layout as ObjectArray_MethodTable, with a finalizer
+static struct ObjectArray_MethodTable FinalizableArray_MethodTable;
+
+static MethodTable ByteArray_MethodTable;
+
+static const uint32_t c_arrayBaseSize = sizeof(ArrayBase) + sizeof(ObjHeader);
+
+static void InitializeMethodTables()
+{
+    ObjectArray_MethodTable.m_MT.m_baseSize = c_arrayBaseSize;
+    ObjectArray_MethodTable.m_MT.m_componentSize = sizeof(Object *);
+    ObjectArray_MethodTable.m_MT.m_flags = MTFlag_ContainsPointers | MTFlag_IsArray;
+
+    // A single series covering all the elements. The GC adds the object size to the series size.
+    ObjectArray_MethodTable.m_numSeries = 1;
+    ObjectArray_MethodTable.m_series[0].SetSeriesOffset(sizeof(ArrayBase));
+    ObjectArray_MethodTable.m_series[0].seriessize = (size_t)0 - (size_t)c_arrayBaseSize;
+
+    FinalizableArray_MethodTable = ObjectArray_MethodTable;
+    FinalizableArray_MethodTable.m_MT.m_flags |= MTFlag_HasFinalizer;
+
+    ByteArray_MethodTable.m_baseSize = c_arrayBaseSize;
+    ByteArray_MethodTable.m_componentSize = 1;
+    ByteArray_MethodTable.m_flags = MTFlag_IsArray;
+}
+
+static Object ** GetArrayData(Object * pArray)
+{
+    return (Object **)((uint8_t *)pArray + sizeof(ArrayBase));
+}
+
+//
+// The allocation fast path, as in GCSample, extended to arrays and the large object heap.
+//
+static Object * AllocateArray(MethodTable * pMT, uint32_t numComponents)
+{
+    size_t size = pMT->GetBaseSize() + (size_t)numComponents * pMT->RawGetComponentSize();
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    uint32_t flags = pMT->ContainsPointers() ? GC_ALLOC_CONTAINS_REF : 0;
+    Object * pObject;
+
+    if (pMT->HasFinalizer())
+    {
+        // Finalizable objects always take the slow path, it registers them for finalization
+        flags |= GC_ALLOC_FINALIZE;
+        if (size >= LARGE_OBJECT_SIZE)
+            pObject = GCHeap::GetGCHeap()->AllocLHeap(size, flags);
+        else
+            pObject = GCHeap::GetGCHeap()->Alloc(GetThread()->GetAllocContext(), size, flags);
+    }
+    else if (size >= LARGE_OBJECT_SIZE)
+    {
+        pObject = GCHeap::GetGCHeap()->AllocLHeap(size, flags);
+    }
+    else
+    {
+        alloc_context * acontext = GetThread()->GetAllocContext();
+
+        uint8_t* result = acontext->alloc_ptr;
+        uint8_t* advance = result + size;
+        if (advance <= acontext->alloc_limit)
+        {
+            acontext->alloc_ptr = advance;
+            pObject = (Object *)result;
+        }
+        else
+        {
+            pObject = GCHeap::GetGCHeap()->Alloc(acontext, size, flags);
+        }
+    }
+
+    if (pObject == NULL)
+        return NULL;
+
+    pObject->RawSetMethodTable(pMT);
+    ((ArrayBase *)pObject)->SetNumComponents(numComponents);
+
+    return pObject;
+}
+
+//
+// Pause recording. RestartEE reports every pause through g_pfnGCPauseCallback, pauses are
+// serialized by the suspension so no locking is needed.
+//
+
+static const uint32_t c_maxPauses = 1024 * 1024;
+static int64_t * s_pauses;
+static uint32_t s_pauseCount;
+static int64_t s_totalPause;
+
+static void RecordPause(int64_t suspendStart, int64_t restartEnd)
+{
+    int64_t pause = restartEnd - suspendStart;
+    s_totalPause += pause;
+    if (s_pauseCount < c_maxPauses)
+        s_pauses[s_pauseCount++] = pause;
+}
+
+static int __cdecl ComparePauses(const void * a, const void * b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static double TicksToMSec(int64_t ticks)
+{
+    return (double)ticks * 1000.0 / (double)GCToOSInterface::QueryPerformanceFrequency();
+}
+
+// Returns the pause at percentile pct of the sorted pauses, in milliseconds
+static double PausePercentile(double pct)
+{
+    if (s_pauseCount == 0)
+        return 0;
+
+    uint32_t index = (uint32_t)(pct / 100.0 * (s_pauseCount - 1) + 0.5);
+    return TicksToMSec(s_pauses[index]);
+}
+
+// The GC keeps the total time spent in each phase of the blocking GC pauses,
+// the benchmarks print the part that accumulated while they ran.
+static void GetPausePhaseTotals(GCHeap * pGCHeap, uint64_t * totals)
+{
+    for (int phase = 0; phase < max_pause_phase; phase++)
+        totals[phase] = pGCHeap->GetPausePhaseHistogram(phase, NULL, 0);
+}
+
+static void PrintPausePhases(GCHeap * pGCHeap, const uint64_t * startTotals)
+{
+    static const char * const s_phaseNames[max_pause_phase] =
+        { "suspend", "roots", "handles", "cards", "plan", "relocate", "compact", "sweep", "resume" };
+
+    uint64_t totals[max_pause_phase];
+    GetPausePhaseTotals(pGCHeap, totals);
+
+    printf("phases (ms):");
+    for (int phase = 0; phase < max_pause_phase; phase++)
+    {
+        printf("%s %s %.3f", (phase == 0) ? "" : ",", s_phaseNames[phase],
+            (double)(totals[phase] - startTotals[phase]) / 1000.0);
+    }
+    printf("\n");
+}
+
+static size_t GetPeakWorkingSet()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+//
+// Mutators
+//
+
+struct MutatorContext
+{
+    const BenchOptions * pOptions;
+    uint32_t index;
+    uint64_t bytesAllocated;
+    uint64_t objectsAllocated;
+    uint64_t objectsFinalized;
+    bool failed;
+};
+
+static int32_t s_runningMutators;
+static CLREventStatic s_mutatorsDone;
+
+// xorshift64*, so that runs do not depend on the C runtime's rand()
+class BenchRandom
+{
+    uint64_t m_state;
+
+public:
+    BenchRandom(uint64_t seed)
+    {
+        m_state = seed * 0x9E3779B97F4A7C15ull + 1;
+    }
+
+    uint32_t Next()
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return (uint32_t)((m_state * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    uint32_t Next(uint32_t limit)
+    {
+        return (uint32_t)(((uint64_t)Next() * limit) >> 32);
+    }
+};
+
+static bool RunMutator(MutatorContext * pContext)
+{
+    const BenchOptions & options = *pContext->pOptions;
+    BenchRandom random(((uint64_t)options.seed << 16) + pContext->index);
+    Thread * pThread = GetThread();
+
+    const uint32_t minElements = (options.minSize > c_arrayBaseSize) ?
+        (options.minSize - c_arrayBaseSize) / sizeof(Object *) : 0;
+    const uint32_t maxElements = (options.maxSize > c_arrayBaseSize) ?
+        (options.maxSize - c_arrayBaseSize) / sizeof(Object *) : 0;
+    const uint32_t c_lohSurvivorCount = 16;
+
+    Object * pSurvivors = AllocateArray(&ObjectArray_MethodTable.m_MT, options.survivorCount);
+    if (pSurvivors == NULL)
+        return false;
+    OBJECTHANDLE hSurvivors = CreateGlobalHandle(pSurvivors);
+
+    Object * pOld = AllocateArray(&ObjectArray_MethodTable.m_MT, options.oldCount);
+    if (pOld == NULL)
+        return false;
+    OBJECTHANDLE hOld = CreateGlobalHandle(pOld);
+
+    Object * pLohSurvivors = AllocateArray(&ObjectArray_MethodTable.m_MT, c_lohSurvivorCount);
+    if (pLohSurvivors == NULL)
+        return false;
+    OBJECTHANDLE hLohSurvivors = CreateGlobalHandle(pLohSurvivors);
+
+    OBJECTHANDLE * pinHandles = new (nothrow) OBJECTHANDLE[options.pinCount];
+    if (pinHandles == NULL || hSurvivors == NULL || hOld == NULL || hLohSurvivors == NULL)
+        return false;
+    for (uint32_t i = 0; i < options.pinCount; i++)
+        pinHandles[i] = CreateGlobalPinningHandle(NULL);
+    uint32_t nextPin = 0;
+
+    const uint64_t bytesToAllocate = (uint64_t)options.allocMB * 1024 * 1024;
+    const int64_t frequency = GCToOSInterface::QueryPerformanceFrequency();
+    const int64_t start = GCToOSInterface::QueryPerformanceCounter();
+    uint64_t nextThrottleCheck = 64 * 1024;
+    uint32_t allocationsBeforeDrain = options.finalizeDrain;
+
+    while (pContext->bytesAllocated < bytesToAllocate)
+    {
+        pThread->PollGC();
+
+        Object * p;
+        size_t size;
+
+        if (options.lohPerMille != 0 && random.Next(1000) < options.lohPerMille)
+        {
+            p = AllocateArray(&ByteArray_MethodTable, options.lohSize);
+            if (p == NULL)
+                return false;
+            size = c_arrayBaseSize + options.lohSize;
+
+            Object ** lohSurvivors = GetArrayData(ObjectFromHandle(hLohSurvivors));
+            WriteBarrier(&lohSurvivors[random.Next(c_lohSurvivorCount)], p);
+        }
+        else
+        {
+            uint32_t numElements = minElements + random.Next(maxElements - minElements + 1);
+            bool finalizable = (options.finalizePercent != 0 && random.Next(100) < options.finalizePercent);
+            p = AllocateArray(finalizable ? &FinalizableArray_MethodTable.m_MT : &ObjectArray_MethodTable.m_MT, numElements);
+            if (p == NULL)
+                return false;
+            size = c_arrayBaseSize + numElements * sizeof(Object *);
+
+            if (random.Next(100) < options.survivePercent)
+            {
+                Object ** survivors = GetArrayData(ObjectFromHandle(hSurvivors));
+
+                // Link the new object to an existing survivor, so that older objects are
+                // referenced from younger ones and the other way around.
+                if (numElements != 0)
+                    WriteBarrier(&GetArrayData(p)[0], survivors[random.Next(options.survivorCount)]);
+
+                WriteBarrier(&survivors[random.Next(options.survivorCount)], p);
+
+                if (options.oldPerMille != 0 && random.Next(1000) < options.oldPerMille)
+                {
+                    Object ** old = GetArrayData(ObjectFromHandle(hOld));
+                    WriteBarrier(&old[random.Next(options.oldCount)], p);
+                }
+
+                if (options.pinPercent != 0 && random.Next(100) < options.pinPercent)
+                {
+                    StoreObjectInHandle(pinHandles[nextPin], p);
+                    nextPin = (nextPin + 1) % options.pinCount;
+                }
+            }
+        }
+
+        pContext->bytesAllocated += size;
+        pContext->objectsAllocated++;
+
+        if (options.finalizePercent != 0 && --allocationsBeforeDrain == 0)
+        {
+            // Stand in for the finalizer thread
+            allocationsBeforeDrain = options.finalizeDrain;
+            while (GCHeap::GetGCHeap()->GetNextFinalizable() != NULL)
+                pContext->objectsFinalized++;
+        }
+
+        if (options.rateMB != 0 && pContext->bytesAllocated >= nextThrottleCheck)
+        {
+            nextThrottleCheck = pContext->bytesAllocated + 64 * 1024;
+
+            int64_t expected = start + (int64_t)((double)pContext->bytesAllocated * frequency / ((double)options.rateMB * 1024 * 1024));
+            int64_t now = GCToOSInterface::QueryPerformanceCounter();
+            if (expected > now)
+            {
+                pThread->EnablePreemptiveGC();
+                GCToOSInterface::Sleep((uint32_t)((expected - now) * 1000 / frequency));
+                pThread->DisablePreemptiveGC();
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < options.pinCount; i++)
+        DestroyGlobalPinningHandle(pinHandles[i]);
+    delete [] pinHandles;
+    DestroyGlobalHandle(hLohSurvivors);
+    DestroyGlobalHandle(hOld);
+    DestroyGlobalHandle(hSurvivors);
+
+    return true;
+}
+
+static void MutatorThread(void * param)
+{
+    MutatorContext * pContext = (MutatorContext *)param;
+
+    ThreadStore::AttachCurrentThread();
+    Thread * pThread = GetThread();
+
+    pThread->DisablePreemptiveGC();
+    pContext->failed = !RunMutator(pContext);
+    pThread->EnablePreemptiveGC();
+
+    if (Interlocked::Decrement(&s_runningMutators) == 0)
+        s_mutatorsDone.Set();
+}
+
+//
+// Mark throughput
+//
+
+static void Shuffle(BenchRandom * pRandom, uint32_t * order, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+        order[i] = i;
+
+    for (uint32_t i = count; i > 1; i--)
+    {
+        uint32_t j = pRandom->Next(i);
+        uint32_t t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = t;
+    }
+}
+
+// Builds the live data for -mark and returns the handle holding it, or NULL when out of memory.
+//
+// Every item is a hash table entry (next, key, value), a key (a byte array, so without
+// references) and a value that is also a binary tree node (left, right). The objects are all
+// allocated first and only linked once they all exist, in random order, so that following a
+// reference almost never leads to a neighbouring object. No allocation happens while linking,
+// so the objects can't move.
+static OBJECTHANDLE BuildMarkGraph(const BenchOptions & options, uint64_t * pLiveBytes)
+{
+    const uint32_t c_keySize = 16;
+    const size_t entrySize = c_arrayBaseSize + 3 * sizeof(Object *);
+    const size_t keySize = (c_arrayBaseSize + c_keySize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    const size_t nodeSize = c_arrayBaseSize + 2 * sizeof(Object *);
+
+    // All the objects are held by one array until they are linked
+    const size_t itemSize = entrySize + keySize + nodeSize + 3 * sizeof(Object *);
+    const uint32_t count = (uint32_t)(((uint64_t)options.liveMB * 1024 * 1024) / itemSize);
+    const uint32_t bucketCount = (count / 4 > 0) ? count / 4 : 1;
+
+    BenchRandom random(options.seed);
+
+    Object * pAll = AllocateArray(&ObjectArray_MethodTable.m_MT, 3 * count);
+    if (pAll == NULL)
+        return NULL;
+    OBJECTHANDLE hAll = CreateGlobalHandle(pAll);
+    if (hAll == NULL)
+        return NULL;
+
+    Object * pRoots = AllocateArray(&ObjectArray_MethodTable.m_MT, 3);
+    if (pRoots == NULL)
+        return NULL;
+    OBJECTHANDLE hRoots = CreateGlobalHandle(pRoots);
+    if (hRoots == NULL)
+        return NULL;
+
+    Object * pBuckets = AllocateArray(&ObjectArray_MethodTable.m_MT, bucketCount);
+    if (pBuckets == NULL)
+        return NULL;
+    WriteBarrier(&GetArrayData(ObjectFromHandle(hRoots))[0], pBuckets);
+
+    for (uint32_t i = 0; i < 3 * count; i++)
+    {
+        Object * p;
+        if (i < count)
+            p = AllocateArray(&ObjectArray_MethodTable.m_MT, 3);
+        else if (i < 2 * count)
+            p = AllocateArray(&ByteArray_MethodTable, c_keySize);
+        else
+            p = AllocateArray(&ObjectArray_MethodTable.m_MT, 2);
+        if (p == NULL)
+            return NULL;
+
+        WriteBarrier(&GetArrayData(ObjectFromHandle(hAll))[i], p);
+    }
+
+    uint32_t * order = new (nothrow) uint32_t[count];
+    if (order == NULL)
+        return NULL;
+
+    Object ** all = GetArrayData(ObjectFromHandle(hAll));
+    Object ** entries = all;
+    Object ** keys = all + count;
+    Object ** nodes = all + 2 * count;
+    Object ** buckets = GetArrayData(GetArrayData(ObjectFromHandle(hRoots))[0]);
+
+    // Chain the entries into random buckets, in random order
+    Shuffle(&random, order, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Object * pEntry = entries[order[i]];
+        Object ** bucket = &buckets[random.Next(bucketCount)];
+        WriteBarrier(&GetArrayData(pEntry)[0], *bucket);
+        WriteBarrier(bucket, pEntry);
+    }
+
+    // Give every entry a random key and a random value
+    Shuffle(&random, order, count);
+    for (uint32_t i = 0; i < count; i++)
+        WriteBarrier(&GetArrayData(entries[i])[1], keys[order[i]]);
+    Shuffle(&random, order, count);
+    for (uint32_t i = 0; i < count; i++)
+        WriteBarrier(&GetArrayData(entries[i])[2], nodes[order[i]]);
+
+    // The values also form a complete binary tree, laid out in random order
+    Shuffle(&random, order, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Object ** children = GetArrayData(nodes[order[i]]);
+        if (2 * (uint64_t)i + 1 < count)
+            WriteBarrier(&children[0], nodes[order[2 * i + 1]]);
+        if (2 * (uint64_t)i + 2 < count)
+            WriteBarrier(&children[1], nodes[order[2 * i + 2]]);
+    }
+    WriteBarrier(&GetArrayData(ObjectFromHandle(hRoots))[1], nodes[order[0]]);
+
+    delete [] order;
+    DestroyGlobalHandle(hAll);
+
+    *pLiveBytes = (uint64_t)count * (entrySize + keySize + nodeSize) +
+        c_arrayBaseSize + (uint64_t)bucketCount * sizeof(Object *);
+    return hRoots;
+}
+
+// The large arrays checked by -mark: c_wideArrays object arrays of c_wideArrayLength elements,
+// far above the size the GC marks in one step, each element a byte array holding a pattern.
+static const uint32_t c_wideArrays = 8;
+static const uint32_t c_wideArrayLength = 4096;
+static const uint32_t c_wideLeafSize = 8;
+
+static uint8_t WideLeafByte(uint32_t array, uint32_t element, uint32_t i)
+{
+    return (uint8_t)(array * 131 + element * 7 + i);
+}
+
+// Hangs the wide arrays off one small array in slot 2 of the roots. Allocations can move the
+// objects, so everything is fetched from the handle again after each one.
+static bool BuildWideArrays(OBJECTHANDLE hRoots, uint64_t * pLiveBytes)
+{
+    const size_t leafSize = (c_arrayBaseSize + c_wideLeafSize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    Object * pHolder = AllocateArray(&ObjectArray_MethodTable.m_MT, c_wideArrays);
+    if (pHolder == NULL)
+        return false;
+    WriteBarrier(&GetArrayData(ObjectFromHandle(hRoots))[2], pHolder);
+
+    for (uint32_t i = 0; i < c_wideArrays; i++)
+    {
+        Object * pWide = AllocateArray(&ObjectArray_MethodTable.m_MT, c_wideArrayLength);
+        if (pWide == NULL)
+            return false;
+        WriteBarrier(&GetArrayData(GetArrayData(ObjectFromHandle(hRoots))[2])[i], pWide);
+
+        for (uint32_t j = 0; j < c_wideArrayLength; j++)
+        {
+            Object * pLeaf = AllocateArray(&ByteArray_MethodTable, c_wideLeafSize);
+            if (pLeaf == NULL)
+                return false;
+
+            uint8_t * bytes = (uint8_t *)GetArrayData(pLeaf);
+            for (uint32_t k = 0; k < c_wideLeafSize; k++)
+                bytes[k] = WideLeafByte(i, j, k);
+
+            Object * pCurrentWide = GetArrayData(GetArrayData(ObjectFromHandle(hRoots))[2])[i];
+            WriteBarrier(&GetArrayData(pCurrentWide)[j], pLeaf);
+        }
+    }
+
+    *pLiveBytes += c_arrayBaseSize + c_wideArrays * sizeof(Object *) +
+        (uint64_t)c_wideArrays * (c_arrayBaseSize + c_wideArrayLength * sizeof(Object *) + c_wideArrayLength * leafSize);
+    return true;
+}
+
+// Returns false if any element of the wide arrays didn't survive the GCs.
+static bool CheckWideArrays(OBJECTHANDLE hRoots)
+{
+    Object ** wide = GetArrayData(GetArrayData(ObjectFromHandle(hRoots))[2]);
+
+    for (uint32_t i = 0; i < c_wideArrays; i++)
+    {
+        Object ** leaves = GetArrayData(wide[i]);
+        for (uint32_t j = 0; j < c_wideArrayLength; j++)
+        {
+            Object * pLeaf = leaves[j];
+            bool ok = (pLeaf != NULL) &&
+                (pLeaf->RawGetMethodTable() == &ByteArray_MethodTable) &&
+                (((ArrayBase *)pLeaf)->GetNumComponents() == c_wideLeafSize);
+
+            uint8_t * bytes = (uint8_t *)GetArrayData(pLeaf);
+            for (uint32_t k = 0; ok && k < c_wideLeafSize; k++)
+                ok = (bytes[k] == WideLeafByte(i, j, k));
+
+            if (!ok)
+            {
+                printf("Wide array %u element %u was not marked\n", i, j);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static int RunMarkBenchmark(const BenchOptions & options, GCHeap * pGCHeap)
+{
+    Thread * pThread = GetThread();
+    pThread->DisablePreemptiveGC();
+
+    uint64_t liveBytes = 0;
+    OBJECTHANDLE hRoots = BuildMarkGraph(options, &liveBytes);
+    if (hRoots == NULL)
+    {
+        printf("Out of memory building %u MB of live objects\n", options.liveMB);
+        return -1;
+    }
+    if (!BuildWideArrays(hRoots, &liveBytes))
+    {
+        printf("Out of memory building the wide arrays\n");
+        return -1;
+    }
+
+    // The first GC promotes everything to gen2 and gets rid of the temporary array
+    pGCHeap->GarbageCollect(2, FALSE, collection_blocking);
+    pGCHeap->GarbageCollect(2, FALSE, collection_blocking);
+
+    s_pauseCount = 0;
+    s_totalPause = 0;
+
+    uint64_t startPhaseTotals[max_pause_phase];
+    GetPausePhaseTotals(pGCHeap, startPhaseTotals);
+
+    for (uint32_t i = 0; i < options.gcCount; i++)
+        pGCHeap->GarbageCollect(2, FALSE, collection_blocking);
+
+    bool marked = CheckWideArrays(hRoots);
+
+    DestroyGlobalHandle(hRoots);
+    pThread->EnablePreemptiveGC();
+
+    qsort(s_pauses, s_pauseCount, sizeof(s_pauses[0]), ComparePauses);
+
+    // Everything is live, so the pauses are dominated by marking
+    double liveMB = (double)liveBytes / (1024 * 1024);
+    double pauseMSec = TicksToMSec(s_totalPause);
+    double markThroughput = liveMB * options.gcCount * 1000.0 / pauseMSec;
+    const char * flavor = options.server ? "svr" : "wks";
+
+    if (options.csv)
+    {
+        printf("gc,mark_prefetch,seed,live_mb,gcs,pause_total_ms,pause_p50_ms,pause_max_ms,mark_mb_s\n");
+        printf("%s,%u,%u,%.1f,%u,%.3f,%.3f,%.3f,%.1f\n",
+            flavor, options.markPrefetch, options.seed, liveMB, options.gcCount,
+            pauseMSec, PausePercentile(50), PausePercentile(100), markThroughput);
+    }
+    else
+    {
+        printf("mark:        gc %s, prefetch %s, seed %u\n", flavor, options.markPrefetch ? "on" : "off", options.seed);
+        printf("live:        %.1f MB\n", liveMB);
+        printf("gen2 gcs:    %u, total pause %.3f ms\n", options.gcCount, pauseMSec);
+        printf("pause (ms):  p50 %.3f, max %.3f\n", PausePercentile(50), PausePercentile(100));
+        PrintPausePhases(pGCHeap, startPhaseTotals);
+        printf("throughput:  %.1f MB/s marked\n", markThroughput);
+    }
+
+    return marked ? 0 : -1;
+}
+
+//
+// Driver
+//
+
+int __cdecl main(int argc, char* argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        Usage();
+        return -1;
+    }
+
+    //
+    // Initialize system info
+    //
+    if (!GCToOSInterface::Initialize())
+    {
+        return -1;
+    }
+
+    static MethodTable freeObjectMT;
+    freeObjectMT.InitializeFreeObject();
+    g_pFreeObjectMethodTable = &freeObjectMT;
+
+    InitializeMethodTables();
+
+    s_pauses = new (nothrow) int64_t[c_maxPauses];
+    if (s_pauses == NULL)
+        return -1;
+    g_pfnGCPauseCallback = RecordPause;
+
+    //
+    // Initialize GC heap in the requested flavor
+    //
+    GCHeap::InitializeHeapType(options.server);
+    g_pConfig->SetGCconcurrent(options.concurrent ? 1 : 0);
+    g_pConfig->SetGCMarkPrefetch(options.markPrefetch ? 1 : 0);
+    g_pConfig->SetGCDynamicHeapCount(options.dynamicHeaps ? 1 : 0);
+    g_pConfig->SetGCHeapHardLimitMB((int)options.hardLimitMB);
+    g_pConfig->SetGCGradualDecommit(options.gradualDecommit ? 1 : 0);
+
+    if (!Ref_Initialize())
+        return -1;
+
+    GCHeap *pGCHeap = GCHeap::CreateGCHeap();
+    if (!pGCHeap)
+        return -1;
+
+    if (FAILED(pGCHeap->Initialize()))
+        return -1;
+
+    ThreadStore::AttachCurrentThread();
+
+    if (options.mark)
+        return RunMarkBenchmark(options, pGCHeap);
+
+    //
+    // Run the mutators
+    //
+    MutatorContext * contexts = new (nothrow) MutatorContext[options.threads];
+    if (contexts == NULL)
+        return -1;
+
+    s_mutatorsDone.CreateOSManualEvent(false);
+    s_runningMutators = (int32_t)options.threads;
+
+    uint64_t startPhaseTotals[max_pause_phase];
+    GetPausePhaseTotals(pGCHeap, startPhaseTotals);
+
+    uint64_t startCommitBytes;
+    uint64_t startDecommitBytes;
+    pGCHeap->GetCommitCounters(&startCommitBytes, &startDecommitBytes);
+
+    int64_t start = GCToOSInterface::QueryPerformanceCounter();
+
+    for (uint32_t i = 0; i < options.threads; i++)
+    {
+        contexts[i].pOptions = &options;
+        contexts[i].index = i;
+        contexts[i].bytesAllocated = 0;
+        contexts[i].objectsAllocated = 0;
+        contexts[i].objectsFinalized = 0;
+        contexts[i].failed = false;
+
+        if (!GCToOSInterface::CreateThread(MutatorThread, &contexts[i], NULL))
+        {
+            printf("Failed to create mutator thread\n");
+            return -1;
+        }
+    }
+
+    s_mutatorsDone.Wait(INFINITE, false);
+
+    int64_t elapsed = GCToOSInterface::QueryPerformanceCounter() - start;
+
+    uint64_t commitBytes;
+    uint64_t decommitBytes;
+    pGCHeap->GetCommitCounters(&commitBytes, &decommitBytes);
+
+    //
+    // Report
+    //
+    uint64_t bytesAllocated = 0;
+    uint64_t objectsAllocated = 0;
+    uint64_t objectsFinalized = 0;
+    for (uint32_t i = 0; i < options.threads; i++)
+    {
+        if (contexts[i].failed)
+        {
+            printf("Mutator %u ran out of memory\n", i);
+            return -1;
+        }
+
+        bytesAllocated += contexts[i].bytesAllocated;
+        objectsAllocated += contexts[i].objectsAllocated;
+        objectsFinalized += contexts[i].objectsFinalized;
+    }
+
+    qsort(s_pauses, s_pauseCount, sizeof(s_pauses[0]), ComparePauses);
+
+    double elapsedMSec = TicksToMSec(elapsed);
+    double allocatedMB = (double)bytesAllocated / (1024 * 1024);
+    double throughput = allocatedMB * 1000.0 / elapsedMSec;
+    double peakMB = (double)GetPeakWorkingSet() / (1024 * 1024);
+    const char * flavor = options.server ? (options.concurrent ? "svr-bgc" : "svr") : (options.concurrent ? "wks-bgc" : "wks");
+
+    if (options.csv)
+    {
+        printf("scenario,gc,threads,seed,elapsed_ms,allocated_mb,throughput_mb_s,gen0,gen1,gen2,pauses,"
+               "pause_total_ms,pause_p50_ms,pause_p90_ms,pause_p99_ms,pause_p999_ms,pause_max_ms,peak_ws_mb\n");
+        printf("%s,%s,%u,%u,%.1f,%.1f,%.1f,%d,%d,%d,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f\n",
+            options.scenario, flavor, options.threads, options.seed,
+            elapsedMSec, allocatedMB, throughput,
+            pGCHeap->CollectionCount(0), pGCHeap->CollectionCount(1), pGCHeap->CollectionCount(2),
+            s_pauseCount, TicksToMSec(s_totalPause),
+            PausePercentile(50), PausePercentile(90), PausePercentile(99), PausePercentile(99.9), PausePercentile(100),
+            peakMB);
+    }
+    else
+    {
+        printf("scenario:    %s (gc %s, %u threads, seed %u)\n", options.scenario, flavor, options.threads, options.seed);
+        printf("elapsed:     %.1f ms\n", elapsedMSec);
+        printf("allocated:   %.1f MB in %llu objects, %.1f MB/s\n", allocatedMB, (unsigned long long)objectsAllocated, throughput);
+        if (options.finalizePercent != 0)
+            printf("finalized:   %llu objects\n", (unsigned long long)objectsFinalized);
+        printf("gcs:         gen0 %d, gen1 %d, gen2 %d\n",
+            pGCHeap->CollectionCount(0), pGCHeap->CollectionCount(1), pGCHeap->CollectionCount(2));
+        printf("pauses:      %u, total %.3f ms (%.1f%% of elapsed)\n",
+            s_pauseCount, TicksToMSec(s_totalPause), TicksToMSec(s_totalPause) * 100.0 / elapsedMSec);
+        printf("pause (ms):  p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+            PausePercentile(50), PausePercentile(90), PausePercentile(99), PausePercentile(99.9), PausePercentile(100));
+        PrintPausePhases(pGCHeap, startPhaseTotals);
+        printf("peak ws:     %.1f MB\n", peakMB);
+        printf("commit:      %.1f MB committed, %.1f MB decommitted\n",
+            (double)(commitBytes - startCommitBytes) / (1024 * 1024),
+            (double)(decommitBytes - startDecommitBytes) / (1024 * 1024));
+    }
+
+    return 0;
+}
@@ -38,6 +38,8 @@
 //  For now, the sample GC environment has some cruft in it to decouple the GC from Windows and rest of CoreCLR. 
 //  It is something we would like to clean up.
 //
+//  GCBench.cpp builds a multi-threaded benchmark harness (the gcbench target) on the same environment.
+//
 
 #include "common.h"
 
@@ -47,6 +49,7 @@
 #include "objecthandle.h"
 
 #include "gcdesc.h"
+#include "writebarrier.h"
 
 //
 // The fast paths for object allocation and write barriers is performance critical. They are often
@@ -78,38 +81,6 @@ Object * AllocateObject(MethodTable * pMT)
     return pObject;
 }
 
-#if defined(BIT64)
-// Card byte shift is different on 64bit.
-#define card_byte_shift     11
-#else
-#define card_byte_shift     10
-#endif
-
-#define card_byte(addr) (((size_t)(addr)) >> card_byte_shift)
-
-inline void ErectWriteBarrier(Object ** dst, Object * ref)
-{
-    // if the dst is outside of the heap (unboxed value classes) then we
-    //      simply exit
-    if (((uint8_t*)dst < g_lowest_address) || ((uint8_t*)dst >= g_highest_address))
-        return;
-        
-    if((uint8_t*)ref >= g_ephemeral_low && (uint8_t*)ref < g_ephemeral_high)
-    {
-        // volatile is used here to prevent fetch of g_card_table from being reordered 
-        // with g_lowest/highest_address check above. See comment in code:gc_heap::grow_brick_card_tables.
-        uint8_t* pCardByte = (uint8_t *)*(volatile uint8_t **)(&g_card_table) + card_byte((uint8_t *)dst);
-        if(*pCardByte != 0xFF)
-            *pCardByte = 0xFF;
-    }
-}
-
-void WriteBarrier(Object ** dst, Object * ref)
-{
-    *dst = ref;
-    ErectWriteBarrier(dst, ref);
-}
-
 int __cdecl main(int argc, char* argv[])
 {
     //
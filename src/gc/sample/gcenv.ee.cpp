@@ -9,7 +9,10 @@
 #include "gcenv.h"
 #include "gc.h"
 
-EEConfig * g_pConfig;
+static EEConfig s_config;
+EEConfig * g_pConfig = &s_config;
+
+GCPauseCallback g_pfnGCPauseCallback;
 
 void CLREventStatic::CreateManualEvent(bool bInitialState)
 {
@@ -99,7 +102,7 @@ Thread * GetThread()
     return pCurrentThread;
 }
 
-Thread * g_pThreadList = NULL;
+Thread * volatile g_pThreadList = NULL;
 
 Thread * ThreadStore::GetThreadList(Thread * pThread)
 {
@@ -111,28 +114,86 @@ Thread * ThreadStore::GetThreadList(Thread * pThread)
 
 void ThreadStore::AttachCurrentThread()
 {
-    // TODO: Locks
-
     Thread * pThread = new Thread();
     pThread->GetAllocContext()->init();
     pCurrentThread = pThread;
 
-    pThread->m_pNext = g_pThreadList;
-    g_pThreadList = pThread;
+    // Threads are never removed from the list, so pushing with a compare exchange is enough to
+    // keep concurrent readers (the GC enumerating alloc contexts) safe.
+    Thread * pHead;
+    do
+    {
+        pHead = g_pThreadList;
+        pThread->m_pNext = pHead;
+    }
+    while (Interlocked::CompareExchangePointer(&g_pThreadList, pThread, pHead) != pHead);
+}
+
+//
+// Suspension is cooperative: SuspendEE raises g_fSuspensionPending and waits until every other
+// thread is in preemptive mode. Threads switching back to cooperative mode block on the restart
+// event until RestartEE runs.
+//
+volatile bool g_fSuspensionPending = false;
+static Thread * g_pSuspendingThread;
+static CLREventStatic g_restartEvent;
+static int64_t g_suspendStart;
+
+void Thread::DisablePreemptiveGC()
+{
+    for (;;)
+    {
+        m_fPreemptiveGCDisabled = true;
+
+        // The store above must be visible before g_fSuspensionPending is read, otherwise SuspendEE
+        // and this thread could both proceed.
+        MemoryBarrier();
+
+        if (!g_fSuspensionPending || g_pSuspendingThread == this)
+            return;
+
+        m_fPreemptiveGCDisabled = false;
+        while (g_fSuspensionPending)
+            g_restartEvent.Wait(INFINITE, false);
+    }
 }
 
 void GCToEEInterface::SuspendEE(GCToEEInterface::SUSPEND_REASON reason)
 {
-    GCHeap::GetGCHeap()->SetGCInProgress(TRUE);
+    g_suspendStart = GCToOSInterface::QueryPerformanceCounter();
+
+    if (!g_restartEvent.IsValid())
+        g_restartEvent.CreateOSManualEvent(false);
+    g_restartEvent.Reset();
+
+    g_pSuspendingThread = GetThread();
+    g_fSuspensionPending = true;
+    MemoryBarrier();
+
+    Thread * pThread = NULL;
+    while ((pThread = ThreadStore::GetThreadList(pThread)) != NULL)
+    {
+        if (pThread == g_pSuspendingThread)
+            continue;
+
+        uint32_t switchCount = 0;
+        while (pThread->PreemptiveGCDisabled())
+            GCToOSInterface::YieldThread(switchCount++);
+    }
 
-    // TODO: Implement
+    GCHeap::GetGCHeap()->SetGCInProgress(TRUE);
 }
 
 void GCToEEInterface::RestartEE(bool bFinishedGC)
 {
-    // TODO: Implement
-
     GCHeap::GetGCHeap()->SetGCInProgress(FALSE);
+
+    g_pSuspendingThread = NULL;
+    g_fSuspensionPending = false;
+    g_restartEvent.Set();
+
+    if (g_pfnGCPauseCallback != NULL)
+        g_pfnGCPauseCallback(g_suspendStart, GCToOSInterface::QueryPerformanceCounter());
 }
 
 void GCToEEInterface::GcScanRoots(promote_func* fn,  int condemned, int max_gen, ScanContext* sc)
@@ -229,16 +290,46 @@ bool FinalizerThread::HaveExtraWorkForFinalizer()
     return false;
 }
 
+struct BackgroundGCThreadStubParam
+{
+    BackgroundCallback Callback;
+    void* CallbackContext;
+};
+
+static void BackgroundGCThreadStub(void* param)
+{
+    BackgroundGCThreadStubParam *stubParam = (BackgroundGCThreadStubParam*)param;
+    BackgroundCallback callback = stubParam->Callback;
+    void* callbackContext = stubParam->CallbackContext;
+
+    delete stubParam;
+
+    callback(callbackContext);
+}
+
 bool REDHAWK_PALAPI PalStartBackgroundGCThread(BackgroundCallback callback, void* pCallbackContext)
 {
-    // TODO: Implement for background GC
-    return false;
+    // Background GC is only used when EEConfig::GetGCconcurrent is enabled (see gcbench -concurrent)
+    BackgroundGCThreadStubParam* stubParam = new (nothrow) BackgroundGCThreadStubParam();
+    if (stubParam == NULL)
+        return false;
+
+    stubParam->Callback = callback;
+    stubParam->CallbackContext = pCallbackContext;
+
+    if (!GCToOSInterface::CreateThread(BackgroundGCThreadStub, stubParam, NULL))
+    {
+        delete stubParam;
+        return false;
+    }
+
+    return true;
 }
 
 bool IsGCSpecialThread()
 {
-    // TODO: Implement for background GC
-    return false;
+    Thread * pThread = GetThread();
+    return (pThread != NULL) && pThread->IsGCSpecial();
 }
 
 void StompWriteBarrierEphemeral()
@@ -263,6 +354,21 @@ uint32_t CLRConfig::GetConfigValue(ConfigDWORDInfo eType)
     case UNSUPPORTED_BGCSpin:
         return 2;
 
+    case UNSUPPORTED_GCMarkPrefetch:
+        return g_pConfig->GetGCMarkPrefetch();
+
+    case UNSUPPORTED_GCDynamicHeapCount:
+        return g_pConfig->GetGCDynamicHeapCount();
+
+    case UNSUPPORTED_GCHeapHardLimitMB:
+        return g_pConfig->GetGCHeapHardLimitMB();
+
+    case UNSUPPORTED_GCHeapHardLimitPercent:
+        return 0;
+
+    case UNSUPPORTED_GCGradualDecommit:
+        return g_pConfig->GetGCGradualDecommit();
+
     case UNSUPPORTED_GCLogEnabled:
     case UNSUPPORTED_GCLogFile:
     case UNSUPPORTED_GCLogFileSize:
@@ -32,16 +32,22 @@
 
 struct alloc_context;
 
+// Set by SuspendEE while the EE is being suspended for a GC. Threads that are in cooperative mode
+// have to switch to preemptive mode (see Thread::PollGC) before the GC can proceed.
+extern volatile bool g_fSuspensionPending;
+
 class Thread
 {
-    uint32_t m_fPreemptiveGCDisabled;
+    volatile uint32_t m_fPreemptiveGCDisabled;
     uintptr_t m_alloc_context[16]; // Reserve enough space to fix allocation context
+    bool m_fGCSpecial;
 
     friend class ThreadStore;
     Thread * m_pNext;
 
 public:
     Thread()
+        : m_fPreemptiveGCDisabled(false), m_fGCSpecial(false), m_pNext(NULL)
     {
     }
 
@@ -55,9 +61,18 @@ public:
         m_fPreemptiveGCDisabled = false;
     }
 
-    void DisablePreemptiveGC()
+    // Switches to cooperative mode, blocking while the EE is suspended
+    void DisablePreemptiveGC();
+
+    // Lets a pending suspension proceed. Threads running in cooperative mode must call this
+    // regularly, it is the only safe point they have.
+    void PollGC()
     {
-        m_fPreemptiveGCDisabled = true;
+        if (g_fSuspensionPending)
+        {
+            EnablePreemptiveGC();
+            DisablePreemptiveGC();
+        }
     }
 
     alloc_context* GetAllocContext()
@@ -67,6 +82,12 @@ public:
 
     void SetGCSpecial(bool fGCSpecial)
     {
+        m_fGCSpecial = fGCSpecial;
+    }
+
+    bool IsGCSpecial()
+    {
+        return m_fGCSpecial;
     }
 
     bool CatchAtSafePoint()
@@ -87,13 +108,33 @@ public:
     static void AttachCurrentThread();
 };
 
+// Called by RestartEE with the performance counter values taken at the start of SuspendEE and at
+// the end of RestartEE, i.e. the bounds of the pause seen by the mutator threads.
+typedef void (*GCPauseCallback)(int64_t suspendStart, int64_t restartEnd);
+extern GCPauseCallback g_pfnGCPauseCallback;
+
 // -----------------------------------------------------------------------------------------------------------
 // Config file enumulation
 //
 
 class EEConfig
 {
+    int     m_iGCconcurrent;
+    int     m_iGCMarkPrefetch;
+    int     m_iGCDynamicHeapCount;
+    int     m_iGCHeapHardLimitMB;
+    int     m_iGCGradualDecommit;
+
 public:
+    EEConfig()
+        : m_iGCconcurrent(0),
+          m_iGCMarkPrefetch(1),
+          m_iGCDynamicHeapCount(0),
+          m_iGCHeapHardLimitMB(0),
+          m_iGCGradualDecommit(1)
+    {
+    }
+
     enum HeapVerifyFlags {
         HEAPVERIFY_NONE = 0,
         HEAPVERIFY_GC = 1,   // Verify the heap at beginning and end of GC
@@ -132,7 +173,16 @@ public:
     bool    IsGCBreakOnOOMEnabled()         const { return false; }
     int     GetGCgen0size()               const { return 0; }
     int     GetSegmentSize()               const { return 0; }
-    int     GetGCconcurrent()               const { return 1; }
+    int     GetGCconcurrent()               const { return m_iGCconcurrent; }
+    void    SetGCconcurrent(int iGCconcurrent)    { m_iGCconcurrent = iGCconcurrent; }
+    int     GetGCMarkPrefetch()             const { return m_iGCMarkPrefetch; }
+    void    SetGCMarkPrefetch(int iGCMarkPrefetch)    { m_iGCMarkPrefetch = iGCMarkPrefetch; }
+    int     GetGCDynamicHeapCount()         const { return m_iGCDynamicHeapCount; }
+    void    SetGCDynamicHeapCount(int iGCDynamicHeapCount)    { m_iGCDynamicHeapCount = iGCDynamicHeapCount; }
+    int     GetGCHeapHardLimitMB()          const { return m_iGCHeapHardLimitMB; }
+    void    SetGCHeapHardLimitMB(int iGCHeapHardLimitMB)    { m_iGCHeapHardLimitMB = iGCHeapHardLimitMB; }
+    int     GetGCGradualDecommit()          const { return m_iGCGradualDecommit; }
+    void    SetGCGradualDecommit(int iGCGradualDecommit)    { m_iGCGradualDecommit = iGCGradualDecommit; }
     int     GetGCLatencyMode()              const { return 1; }
     int     GetGCForceCompact()             const { return 0; }
     int     GetGCRetainVM()                const { return 0; }
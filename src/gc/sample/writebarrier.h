@@ -0,0 +1,46 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+//
+// The write barrier shared by GCSample and GCBench. Include it after gc.h.
+//
+
+#ifndef __WRITEBARRIER_H__
+#define __WRITEBARRIER_H__
+
+// card_byte_shift and card_bundle_byte_shift come from gc.h
+#define card_byte(addr) (((size_t)(addr)) >> card_byte_shift)
+
+inline void ErectWriteBarrier(Object ** dst, Object * ref)
+{
+    // if the dst is outside of the heap (unboxed value classes) then we
+    //      simply exit
+    if (((uint8_t*)dst < g_lowest_address) || ((uint8_t*)dst >= g_highest_address))
+        return;
+
+    if((uint8_t*)ref >= g_ephemeral_low && (uint8_t*)ref < g_ephemeral_high)
+    {
+        // volatile is used here to prevent fetch of g_card_table from being reordered
+        // with g_lowest/highest_address check above. See comment in code:gc_heap::grow_brick_card_tables.
+        uint8_t* pCardByte = (uint8_t *)*(volatile uint8_t **)(&g_card_table) + card_byte((uint8_t *)dst);
+        if(*pCardByte != 0xFF)
+        {
+            *pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+            // Nothing watches the card table, the bundle has to be set as well
+            uint8_t* pCardBundleByte = (uint8_t *)*(volatile uint8_t **)(&g_card_bundle_table) + ((size_t)dst >> card_bundle_byte_shift);
+            if(*pCardBundleByte != 0xFF)
+                *pCardBundleByte = 0xFF;
+#endif
+        }
+    }
+}
+
+inline void WriteBarrier(Object ** dst, Object * ref)
+{
+    *dst = ref;
+    ErectWriteBarrier(dst, ref);
+}
+
+#endif // __WRITEBARRIER_H__
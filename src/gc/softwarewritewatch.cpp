@@ -0,0 +1,200 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "common.h"
+
+#include "gcenv.h"
+#include "gc.h"
+
+#include "softwarewritewatch.h"
+
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+#ifndef DACCESS_COMPILE
+
+extern "C"
+{
+    uint8_t *g_sw_ww_table = nullptr;
+    bool g_sw_ww_enabled_for_gc_heap = false;
+}
+
+#ifdef _DEBUG
+
+void SoftwareWriteWatch::VerifyCreated()
+{
+    assert(g_sw_ww_table != nullptr);
+    assert(g_lowest_address != nullptr);
+    assert(g_highest_address != nullptr);
+}
+
+void SoftwareWriteWatch::VerifyMemoryRegion(void *baseAddress, size_t regionByteSize)
+{
+    VerifyCreated();
+    assert(baseAddress >= g_lowest_address);
+    assert((uint8_t *)baseAddress + regionByteSize <= g_highest_address);
+}
+
+#endif // _DEBUG
+
+void SoftwareWriteWatch::InitializeUntranslatedTable(void *untranslatedTable, void *heapStartAddress)
+{
+    assert(g_sw_ww_table == nullptr);
+    assert(untranslatedTable != nullptr);
+    assert(((size_t)untranslatedTable & (sizeof(size_t) - 1)) == 0);
+    assert(heapStartAddress != nullptr);
+
+    g_sw_ww_table = (uint8_t *)untranslatedTable - GetTableByteIndex(heapStartAddress);
+}
+
+void SoftwareWriteWatch::SetResizedUntranslatedTable(
+    void *untranslatedTable,
+    void *heapStartAddress,
+    void *heapEndAddress)
+{
+    // The runtime needs to be suspended during this call, and background GC threads must be paused or not in the middle of
+    // GetDirty, so that the dirty state copied below is not changed behind our back and no barrier uses the old table
+    // afterwards.
+#ifdef _DEBUG
+    VerifyCreated();
+#endif // _DEBUG
+    assert(untranslatedTable != nullptr);
+    assert(((size_t)untranslatedTable & (sizeof(size_t) - 1)) == 0);
+    assert(heapStartAddress <= g_lowest_address);
+    assert(heapEndAddress >= g_highest_address);
+
+    uint8_t *oldTable = g_sw_ww_table;
+    uint8_t *newTable = (uint8_t *)untranslatedTable - GetTableByteIndex(heapStartAddress);
+
+    // The new table covers the old range, so the entries can be copied at the same translated indices
+    size_t startByteIndex = GetTableByteIndex(g_lowest_address);
+    size_t endByteIndex = GetTableByteIndex(g_highest_address - 1) + 1;
+    memcpy(&newTable[startByteIndex], &oldTable[startByteIndex], endByteIndex - startByteIndex);
+
+    g_sw_ww_table = newTable;
+}
+
+void SoftwareWriteWatch::ClearDirty(void *baseAddress, size_t regionByteSize)
+{
+#ifdef _DEBUG
+    VerifyMemoryRegion(baseAddress, regionByteSize);
+#endif // _DEBUG
+    assert(baseAddress != nullptr);
+    assert(regionByteSize != 0);
+
+    size_t startByteIndex = GetTableByteIndex(baseAddress);
+    size_t endByteIndex = GetTableByteIndex((uint8_t *)baseAddress + regionByteSize - 1) + 1;
+    memset(&g_sw_ww_table[startByteIndex], 0, endByteIndex - startByteIndex);
+}
+
+void SoftwareWriteWatch::GetDirty(
+    void *baseAddress,
+    size_t regionByteSize,
+    void **dirtyPages,
+    size_t *dirtyPageCountRef,
+    bool clearDirty,
+    bool isRuntimeSuspended)
+{
+#ifdef _DEBUG
+    VerifyMemoryRegion(baseAddress, regionByteSize);
+#endif // _DEBUG
+    assert(baseAddress != nullptr);
+    assert(regionByteSize != 0);
+    assert(dirtyPages != nullptr);
+    assert(dirtyPageCountRef != nullptr);
+
+    size_t dirtyPageCount = *dirtyPageCountRef;
+    if (dirtyPageCount == 0)
+    {
+        return;
+    }
+
+    uint8_t *table = g_sw_ww_table;
+    size_t startByteIndex = GetTableByteIndex(baseAddress);
+    size_t endByteIndex = GetTableByteIndex((uint8_t *)baseAddress + regionByteSize - 1) + 1;
+
+    // Scan the table a pointer-sized block at a time so that clean stretches of the heap are skipped quickly. The first
+    // and last blocks may extend past the region, only [startByteIndex, endByteIndex[ is looked at.
+    size_t blockMask = sizeof(size_t) - 1;
+    size_t blockStartByteIndex = startByteIndex - ((size_t)&table[startByteIndex] & blockMask);
+
+    size_t dirtyPageIndex = 0;
+    bool anyCleared = false;
+    for (; blockStartByteIndex < endByteIndex; blockStartByteIndex += sizeof(size_t))
+    {
+        uint8_t *block = &table[blockStartByteIndex];
+        if (*(size_t *)block == 0)
+        {
+            continue;
+        }
+
+        size_t blockStart = blockStartByteIndex < startByteIndex ? startByteIndex - blockStartByteIndex : 0;
+        size_t blockEnd = min(endByteIndex - blockStartByteIndex, sizeof(size_t));
+        anyCleared |= clearDirty;
+        if (!GetDirtyFromBlock(
+                block,
+                (uint8_t *)GetPageAddress(blockStartByteIndex),
+                blockStart,
+                blockEnd,
+                dirtyPages,
+                &dirtyPageIndex,
+                dirtyPageCount,
+                clearDirty))
+        {
+            break;
+        }
+    }
+
+    if (anyCleared && !isRuntimeSuspended)
+    {
+        // The barriers store the reference, then only set the table entry if it is clean. A barrier could have seen the
+        // entry dirty just before it was cleared above while its reference store is still in a store buffer; make those
+        // stores visible before the caller looks at the pages so they can't be missed.
+        GCToOSInterface::FlushProcessWriteBuffers();
+    }
+
+    *dirtyPageCountRef = dirtyPageIndex;
+}
+
+bool SoftwareWriteWatch::GetDirtyFromBlock(
+    uint8_t *block,
+    uint8_t *firstPageAddressInBlock,
+    size_t startByteIndex,
+    size_t endByteIndex,
+    void **dirtyPages,
+    size_t *dirtyPageIndexRef,
+    size_t dirtyPageCount,
+    bool clearDirty)
+{
+    assert(block != nullptr);
+    assert(((size_t)block & (sizeof(size_t) - 1)) == 0);
+    assert(startByteIndex < endByteIndex);
+    assert(endByteIndex <= sizeof(size_t));
+
+    size_t dirtyPageIndex = *dirtyPageIndexRef;
+    for (size_t byteIndex = startByteIndex; byteIndex < endByteIndex; ++byteIndex)
+    {
+        if (block[byteIndex] == 0)
+        {
+            continue;
+        }
+
+        if (dirtyPageIndex == dirtyPageCount)
+        {
+            // Out of room, the caller continues after the last page returned
+            *dirtyPageIndexRef = dirtyPageIndex;
+            return false;
+        }
+
+        dirtyPages[dirtyPageIndex++] = firstPageAddressInBlock + (byteIndex << AddressToTableByteIndexShift);
+        if (clearDirty)
+        {
+            block[byteIndex] = 0;
+        }
+    }
+
+    *dirtyPageIndexRef = dirtyPageIndex;
+    return true;
+}
+
+#endif // !DACCESS_COMPILE
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
@@ -0,0 +1,204 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+//
+// Software write watch
+//
+// The PAL does not implement GetWriteWatch/ResetWriteWatch, so on platforms
+// without OS write watch the GC heap is tracked in software instead. The
+// table has one byte per OS page of [g_lowest_address, g_highest_address[;
+// while background GC is marking, the write barriers set the byte of every
+// page they store a reference into (see JIT_WriteBarrier_WriteWatch_* in
+// amd64/jithelpers_fastwritebarriers.S) and gc_heap::revisit_written_pages
+// reads and clears it through GetDirty.
+//
+// The table lives in the same allocation as the card table and is replaced
+// together with it by gc_heap::grow_brick_card_tables.
+//
+
+#ifndef __SOFTWARE_WRITE_WATCH_H__
+#define __SOFTWARE_WRITE_WATCH_H__
+
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+#ifndef DACCESS_COMPILE
+
+// Implemented by the EE, these patch the JIT write barriers to (not) update
+// the write watch table. The caller states whether the runtime is already
+// suspended so the EE doesn't try to suspend it again.
+extern void SwitchToWriteWatchBarrier(bool isRuntimeSuspended);
+extern void SwitchToNonWriteWatchBarrier(bool isRuntimeSuspended);
+
+// The barriers hard code this shift, keep it in sync with the .S files.
+#define SOFTWARE_WRITE_WATCH_AddressToTableByteIndexShift 0xc
+
+extern "C"
+{
+    // Table containing the dirty state, translated so that it can be indexed
+    // directly with (address >> SOFTWARE_WRITE_WATCH_AddressToTableByteIndexShift).
+    extern uint8_t *g_sw_ww_table;
+
+    // Whether the write barriers currently update g_sw_ww_table.
+    extern bool g_sw_ww_enabled_for_gc_heap;
+}
+
+class SoftwareWriteWatch
+{
+private:
+    static const unsigned int AddressToTableByteIndexShift = SOFTWARE_WRITE_WATCH_AddressToTableByteIndexShift;
+
+#ifdef _DEBUG
+    static void VerifyCreated();
+    static void VerifyMemoryRegion(void *baseAddress, size_t regionByteSize);
+#endif // _DEBUG
+
+public:
+    static uint8_t *GetTable();
+
+    // Number of bytes to reserve for the table covering [heapStartAddress, heapEndAddress[.
+    // The size is pointer aligned so that the data placed after it stays aligned.
+    static size_t GetTableByteSize(void *heapStartAddress, void *heapEndAddress);
+
+    // Offset at which to place the table after byteSizeBeforeTable bytes of
+    // other data, GetDirty reads the table a pointer at a time.
+    static size_t GetTableStartByteOffset(size_t byteSizeBeforeTable);
+
+    // The untranslated table must be zero initialized.
+    static void InitializeUntranslatedTable(void *untranslatedTable, void *heapStartAddress);
+
+    // Copies the dirty state from the current table into the new one and
+    // switches to it. The runtime must be suspended.
+    static void SetResizedUntranslatedTable(void *untranslatedTable, void *heapStartAddress, void *heapEndAddress);
+
+    static bool IsEnabledForGCHeap();
+    static void EnableForGCHeap();
+    static void DisableForGCHeap();
+
+    static void SetDirty(void *address, size_t writeByteSize);
+    static void SetDirtyRegion(void *baseAddress, size_t regionByteSize);
+    static void ClearDirty(void *baseAddress, size_t regionByteSize);
+
+    // Same contract as GetWriteWatch: on input *dirtyPageCountRef is the
+    // capacity of dirtyPages, on output the number of dirty pages found.
+    // When the runtime is not suspended the caller must prevent the table
+    // from being resized for the duration of the call.
+    static void GetDirty(
+        void *baseAddress,
+        size_t regionByteSize,
+        void **dirtyPages,
+        size_t *dirtyPageCountRef,
+        bool clearDirty,
+        bool isRuntimeSuspended);
+
+private:
+    static bool GetDirtyFromBlock(
+        uint8_t *block,
+        uint8_t *firstPageAddressInBlock,
+        size_t startByteIndex,
+        size_t endByteIndex,
+        void **dirtyPages,
+        size_t *dirtyPageIndexRef,
+        size_t dirtyPageCount,
+        bool clearDirty);
+
+    static size_t GetTableByteIndex(void *address);
+    static void *GetPageAddress(size_t tableByteIndex);
+};
+
+inline uint8_t *SoftwareWriteWatch::GetTable()
+{
+    return g_sw_ww_table;
+}
+
+inline size_t SoftwareWriteWatch::GetTableByteSize(void *heapStartAddress, void *heapEndAddress)
+{
+    assert(heapStartAddress != nullptr);
+    assert(heapStartAddress < heapEndAddress);
+
+    size_t tableByteSize =
+        GetTableByteIndex((uint8_t *)heapEndAddress - 1) - GetTableByteIndex(heapStartAddress) + 1;
+    return (tableByteSize + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
+
+inline size_t SoftwareWriteWatch::GetTableStartByteOffset(size_t byteSizeBeforeTable)
+{
+    return (byteSizeBeforeTable + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
+
+inline bool SoftwareWriteWatch::IsEnabledForGCHeap()
+{
+    return g_sw_ww_enabled_for_gc_heap;
+}
+
+inline void SoftwareWriteWatch::EnableForGCHeap()
+{
+    // The runtime must be suspended: a write barrier that has already loaded
+    // the old state would otherwise skip the table after this returns.
+#ifdef _DEBUG
+    VerifyCreated();
+#endif // _DEBUG
+    assert(!IsEnabledForGCHeap());
+
+    g_sw_ww_enabled_for_gc_heap = true;
+    SwitchToWriteWatchBarrier(true);
+}
+
+inline void SoftwareWriteWatch::DisableForGCHeap()
+{
+    // The runtime must be suspended.
+#ifdef _DEBUG
+    VerifyCreated();
+#endif // _DEBUG
+    assert(IsEnabledForGCHeap());
+
+    g_sw_ww_enabled_for_gc_heap = false;
+    SwitchToNonWriteWatchBarrier(true);
+}
+
+inline void SoftwareWriteWatch::SetDirty(void *address, size_t writeByteSize)
+{
+#ifdef _DEBUG
+    VerifyMemoryRegion(address, writeByteSize);
+#endif // _DEBUG
+    assert(address != nullptr);
+    assert(g_sw_ww_table != nullptr);
+
+    // The table is only read by the GC, setting a byte that is already dirty
+    // would just dirty the cache line.
+    uint8_t *entry = &g_sw_ww_table[GetTableByteIndex(address)];
+    if (*entry == 0)
+    {
+        *entry = 0xff;
+    }
+}
+
+inline void SoftwareWriteWatch::SetDirtyRegion(void *baseAddress, size_t regionByteSize)
+{
+#ifdef _DEBUG
+    VerifyMemoryRegion(baseAddress, regionByteSize);
+#endif // _DEBUG
+    assert(baseAddress != nullptr);
+    assert(regionByteSize != 0);
+    assert(g_sw_ww_table != nullptr);
+
+    size_t startByteIndex = GetTableByteIndex(baseAddress);
+    size_t endByteIndex = GetTableByteIndex((uint8_t *)baseAddress + regionByteSize - 1) + 1;
+    memset(&g_sw_ww_table[startByteIndex], ~0, endByteIndex - startByteIndex);
+}
+
+inline size_t SoftwareWriteWatch::GetTableByteIndex(void *address)
+{
+    assert(address != nullptr);
+    return (size_t)address >> AddressToTableByteIndexShift;
+}
+
+inline void *SoftwareWriteWatch::GetPageAddress(size_t tableByteIndex)
+{
+    assert(tableByteIndex != 0);
+    return (void *)(tableByteIndex << AddressToTableByteIndexShift);
+}
+
+#endif // !DACCESS_COMPILE
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
+#endif // __SOFTWARE_WRITE_WATCH_H__
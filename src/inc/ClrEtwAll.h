@@ -505,6 +505,8 @@ EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCSampledObjectAllocationL
 #define GCSampledObjectAllocationLow_value 0x20
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR PinObjectAtGCTime = {0x21, 0x0, 0x0, 0x5, 0x24, 0x1, 0x1};
 #define PinObjectAtGCTime_value 0x21
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR AllocationSample = {0x22, 0x0, 0x0, 0x5, 0x29, 0x1, 0x1};
+#define AllocationSample_value 0x22
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCTriggered = {0x23, 0x0, 0x0, 0x4, 0x23, 0x1, 0x1};
 #define GCTriggered_value 0x23
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCBulkRootCCW = {0x24, 0x0, 0x0, 0x4, 0x26, 0x1, 0x100000};
@@ -513,6 +515,8 @@ EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCBulkRCW = {0x25, 0x0, 0x
 #define GCBulkRCW_value 0x25
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCBulkRootStaticVar = {0x26, 0x0, 0x0, 0x4, 0x28, 0x1, 0x100000};
 #define GCBulkRootStaticVar_value 0x26
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR GCPhaseTimes = {0x27, 0x0, 0x0, 0x4, 0x2a, 0x1, 0x1};
+#define GCPhaseTimes_value 0x27
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR WorkerThreadCreate = {0x28, 0x0, 0x0, 0x4, 0x1, 0x2, 0x10000};
 #define WorkerThreadCreate_value 0x28
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR WorkerThreadTerminate = {0x29, 0x0, 0x0, 0x4, 0x2, 0x2, 0x10000};
@@ -1560,6 +1564,20 @@ Remarks:
         CoTemplate_ppxzh(Microsoft_Windows_DotNETRuntimeHandle, &PinObjectAtGCTime, HandleID, ObjectID, ObjectSize, TypeName, ClrInstanceID)\
         : ERROR_SUCCESS\
 
+//
+// Enablement check macro for AllocationSample
+//
+
+#define EventEnabledAllocationSample() ((Microsoft_Windows_DotNETRuntimeEnableBits[0] & 0x00000002) != 0)
+
+//
+// Event Macro for AllocationSample
+//
+#define FireEtwAllocationSample(TypeID, TypeName, ObjectSize, SampledBytes, ArenaID, Generation, Address, ClrInstanceID)\
+        EventEnabledAllocationSample() ?\
+        CoTemplate_pzxxdqph(Microsoft_Windows_DotNETRuntimeHandle, &AllocationSample, TypeID, TypeName, ObjectSize, SampledBytes, ArenaID, Generation, Address, ClrInstanceID)\
+        : ERROR_SUCCESS\
+
 //
 // Enablement check macro for GCTriggered
 //
@@ -1616,6 +1634,20 @@ Remarks:
         CoTemplate_qxhNR0(Microsoft_Windows_DotNETRuntimeHandle, &GCBulkRootStaticVar, Count, AppDomainID, ClrInstanceID, Values_Len_, Values)\
         : ERROR_SUCCESS\
 
+//
+// Enablement check macro for GCPhaseTimes
+//
+
+#define EventEnabledGCPhaseTimes() ((Microsoft_Windows_DotNETRuntimeEnableBits[0] & 0x00000001) != 0)
+
+//
+// Event Macro for GCPhaseTimes
+//
+#define FireEtwGCPhaseTimes(Count, Depth, Suspend, MarkRoots, MarkHandles, MarkCards, Plan, Relocate, Compact, Sweep, Resume, ClrInstanceID)\
+        EventEnabledGCPhaseTimes() ?\
+        CoTemplate_qqqqqqqqqqqh(Microsoft_Windows_DotNETRuntimeHandle, &GCPhaseTimes, Count, Depth, Suspend, MarkRoots, MarkHandles, MarkCards, Plan, Relocate, Compact, Sweep, Resume, ClrInstanceID)\
+        : ERROR_SUCCESS\
+
 //
 // Enablement check macro for WorkerThreadCreate
 //
@@ -8611,6 +8643,128 @@ MCGEN_CALLOUT(RegHandle,
 }
 #endif
 
+//
+//Template from manifest : AllocationSample
+//
+#ifndef CoTemplate_pzxxdqph_def
+#define CoTemplate_pzxxdqph_def
+ETW_INLINE
+ULONG
+CoTemplate_pzxxdqph(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_opt_ const void *  _Arg0,
+    _In_opt_ PCWSTR  _Arg1,
+    _In_ unsigned __int64  _Arg2,
+    _In_ unsigned __int64  _Arg3,
+    _In_ const signed int  _Arg4,
+    _In_ const unsigned int  _Arg5,
+    _In_opt_ const void *  _Arg6,
+    _In_ const unsigned short  _Arg7
+    )
+{
+#define ARGUMENT_COUNT_pzxxdqph 8
+    ULONG Error = ERROR_SUCCESS;
+
+    EVENT_DATA_DESCRIPTOR EventData[ARGUMENT_COUNT_pzxxdqph];
+
+    EventDataDescCreate(&EventData[0], &_Arg0, sizeof(PVOID)  );
+
+    EventDataDescCreate(&EventData[1], 
+                        (_Arg1 != NULL) ? _Arg1 : L"NULL",
+                        (_Arg1 != NULL) ? (ULONG)((wcslen(_Arg1) + 1) * sizeof(WCHAR)) : (ULONG)sizeof(L"NULL"));
+
+    EventDataDescCreate(&EventData[2], &_Arg2, sizeof(unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[3], &_Arg3, sizeof(unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[4], &_Arg4, sizeof(const signed int)  );
+
+    EventDataDescCreate(&EventData[5], &_Arg5, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[6], &_Arg6, sizeof(PVOID)  );
+
+    EventDataDescCreate(&EventData[7], &_Arg7, sizeof(const unsigned short)  );
+
+    Error = EventWrite(RegHandle, Descriptor, ARGUMENT_COUNT_pzxxdqph, EventData);
+
+#ifdef MCGEN_CALLOUT
+MCGEN_CALLOUT(RegHandle,
+              Descriptor,
+              ARGUMENT_COUNT_pzxxdqph,
+              EventData);
+#endif
+
+    return Error;
+}
+#endif
+
+//
+//Template from manifest : GCPhaseTimes
+//
+#ifndef CoTemplate_qqqqqqqqqqqh_def
+#define CoTemplate_qqqqqqqqqqqh_def
+ETW_INLINE
+ULONG
+CoTemplate_qqqqqqqqqqqh(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned int  _Arg0,
+    _In_ const unsigned int  _Arg1,
+    _In_ const unsigned int  _Arg2,
+    _In_ const unsigned int  _Arg3,
+    _In_ const unsigned int  _Arg4,
+    _In_ const unsigned int  _Arg5,
+    _In_ const unsigned int  _Arg6,
+    _In_ const unsigned int  _Arg7,
+    _In_ const unsigned int  _Arg8,
+    _In_ const unsigned int  _Arg9,
+    _In_ const unsigned int  _Arg10,
+    _In_ const unsigned short  _Arg11
+    )
+{
+#define ARGUMENT_COUNT_qqqqqqqqqqqh 12
+    ULONG Error = ERROR_SUCCESS;
+
+    EVENT_DATA_DESCRIPTOR EventData[ARGUMENT_COUNT_qqqqqqqqqqqh];
+
+    EventDataDescCreate(&EventData[0], &_Arg0, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[1], &_Arg1, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[2], &_Arg2, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[3], &_Arg3, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[4], &_Arg4, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[5], &_Arg5, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[6], &_Arg6, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[7], &_Arg7, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[8], &_Arg8, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[9], &_Arg9, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[10], &_Arg10, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[11], &_Arg11, sizeof(const unsigned short)  );
+
+    Error = EventWrite(RegHandle, Descriptor, ARGUMENT_COUNT_qqqqqqqqqqqh, EventData);
+
+#ifdef MCGEN_CALLOUT
+MCGEN_CALLOUT(RegHandle,
+              Descriptor,
+              ARGUMENT_COUNT_qqqqqqqqqqqh,
+              EventData);
+#endif
+
+    return Error;
+}
+#endif
+
 //
 //Template from manifest : GCBulkRootStaticVar
 //
@@ -12630,6 +12784,8 @@ MCGEN_CALLOUT(RegHandle,
 #define MSG_RuntimePublisher_GCBulkRootCCWOpcodeMessage 0x30010026L
 #define MSG_RuntimePublisher_GCBulkRCWOpcodeMessage 0x30010027L
 #define MSG_RuntimePublisher_GCBulkRootStaticVarOpcodeMessage 0x30010028L
+#define MSG_RuntimePublisher_AllocationSampleOpcodeMessage 0x30010029L
+#define MSG_RuntimePublisher_GCPhaseTimesOpcodeMessage 0x3001002AL
 #define MSG_RuntimePublisher_GCRestartEEEndOpcodeMessage 0x30010084L
 #define MSG_RuntimePublisher_GCHeapStatsOpcodeMessage 0x30010085L
 #define MSG_RuntimePublisher_GCCreateSegmentOpcodeMessage 0x30010086L
@@ -12918,10 +13074,12 @@ MCGEN_CALLOUT(RegHandle,
 #define MSG_RuntimePublisher_DestroyGCHandleEventMessage 0xB000001FL
 #define MSG_RuntimePublisher_GCSampledObjectAllocationLowEventMessage 0xB0000020L
 #define MSG_RuntimePublisher_PinObjectAtGCTimeEventMessage 0xB0000021L
+#define MSG_RuntimePublisher_AllocationSampleEventMessage 0xB0000022L
 #define MSG_RuntimePublisher_GCTriggeredEventMessage 0xB0000023L
 #define MSG_RuntimePublisher_GCBulkRootCCWEventMessage 0xB0000024L
 #define MSG_RuntimePublisher_GCBulkRCWEventMessage 0xB0000025L
 #define MSG_RuntimePublisher_GCBulkRootStaticVarEventMessage 0xB0000026L
+#define MSG_RuntimePublisher_GCPhaseTimesEventMessage 0xB0000027L
 #define MSG_RuntimePublisher_WorkerThreadCreateEventMessage 0xB0000028L
 #define MSG_RuntimePublisher_WorkerThreadTerminateEventMessage 0xB0000029L
 #define MSG_RuntimePublisher_WorkerThreadRetirementRetireThreadEventMessage 0xB000002AL
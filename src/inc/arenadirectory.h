@@ -0,0 +1,68 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+// arenadirectory.h
+//
+// Layout of the arena directory.  The directory lives at a fixed address
+// in the arena address range (right after the buffer table) and holds the
+// arena registry, so that a debugger extension (SOS) can enumerate arenas
+// and their buffers from a dump without symbols for coreclr.
+//
+// The runtime (src/gc/Arena.cpp) and SOS both include this file, so it must
+// not depend on anything but basic Windows/PAL types.
+//
+
+#ifndef _ARENADIRECTORY_H_
+#define _ARENADIRECTORY_H_
+
+// Start of the arena range.  The buffer table (one ArenaId (short) per
+// buffer slot, -1 for recycled and -2 for empty slots) starts here.
+#define ARENA_RANGE_BASE                0x40000000000ULL
+
+// An address is in the arena range if (addr >> ARENA_ADDRESS_SHIFT) == 1
+#define ARENA_ADDRESS_SHIFT             42
+
+// Address space covered by one entry of the buffer table
+#define ARENA_BUFFER_RESERVE_SIZE       (1024 * 1024)
+
+// Offset of the ArenaDirectory from ARENA_RANGE_BASE (the buffer table
+// for a 256GB arena range is 512KB).
+#define ARENA_DIRECTORY_OFFSET          0x80000
+
+#define ARENA_DIRECTORY_SIGNATURE       0x414e5241 // 'ARNA'
+#define ARENA_DIRECTORY_VERSION         1
+
+#define ARENA_DIRECTORY_MAX_ARENAS      4096
+
+// Buffer table entries for slots not owned by an arena
+#define ARENA_SLOT_RECYCLED             ((short)-1)
+#define ARENA_SLOT_EMPTY                ((short)-2)
+
+struct ArenaDirectory
+{
+    // ARENA_DIRECTORY_SIGNATURE once the arena range is initialized
+    DWORD m_signature;
+    DWORD m_version;
+
+    // Usable size of a normal buffer (the rest of the slot is a guard region)
+    ULONG64 m_bufferSize;
+
+    // Buffer table slots [m_firstSlot, m_nextSlot) have been handed out
+    // at least once.  Slots at or past m_nextSlot are unused.
+    LONG m_firstSlot;
+    LONG m_nextSlot;
+
+    // Address of the Arena object for each arena id, 0 if the id is free
+    ULONG64 m_arenaById[ARENA_DIRECTORY_MAX_ARENAS];
+
+    // Number of arena stack entries (on any thread) referencing each arena
+    LONG m_refCount[ARENA_DIRECTORY_MAX_ARENAS];
+
+    // Incremented each time an id is given to a new arena
+    LONG m_generation[ARENA_DIRECTORY_MAX_ARENAS];
+};
+
+#define ARENA_DIRECTORY_ADDRESS         (ARENA_RANGE_BASE + ARENA_DIRECTORY_OFFSET)
+
+#endif // _ARENADIRECTORY_H_
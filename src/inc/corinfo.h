@@ -231,11 +231,11 @@ TODO: Talk about initializing strutures before use
 #if COR_JIT_EE_VERSION > 460
 
 // Update this one
-SELECTANY const GUID JITEEVersionIdentifier = { /* 27626524-7315-4ed0-b74e-a0e4579883bb */
-    0x27626524, 
-    0x7315, 
-    0x4ed0, 
-    { 0xb7, 0x4e, 0xa0, 0xe4, 0x57, 0x98, 0x83, 0xbb }
+SELECTANY const GUID JITEEVersionIdentifier = { /* 3c81f5a2-6e07-4d19-b5c4-9a2e0d73f861 */
+    0x3c81f5a2, 
+    0x6e07, 
+    0x4d19, 
+    { 0xb5, 0xc4, 0x9a, 0x2e, 0x0d, 0x73, 0xf8, 0x61 }
 };
 
 #else
@@ -984,6 +984,20 @@ enum CorInfoIntrinsics
     CORINFO_INTRINSIC_MemoryBarrier,
     CORINFO_INTRINSIC_GetCurrentManagedThread,
     CORINFO_INTRINSIC_GetManagedThreadId,
+#if COR_JIT_EE_VERSION > 460
+    CORINFO_INTRINSIC_PopCount32,           // number of bits set
+    CORINFO_INTRINSIC_PopCount64,
+    CORINFO_INTRINSIC_LeadingZeroCount32,   // number of zero bits above the highest bit set
+    CORINFO_INTRINSIC_LeadingZeroCount64,
+    CORINFO_INTRINSIC_TrailingZeroCount32,  // number of zero bits below the lowest bit set
+    CORINFO_INTRINSIC_TrailingZeroCount64,
+    CORINFO_INTRINSIC_ByteSwap32,           // reverse the order of the bytes
+    CORINFO_INTRINSIC_ByteSwap64,
+    CORINFO_INTRINSIC_ParallelBitDeposit32, // scatter the low bits of a value to the bits set in a mask
+    CORINFO_INTRINSIC_ParallelBitDeposit64,
+    CORINFO_INTRINSIC_ParallelBitExtract32, // gather the bits of a value selected by a mask into the low bits
+    CORINFO_INTRINSIC_ParallelBitExtract64,
+#endif
 
     CORINFO_INTRINSIC_Count,
     CORINFO_INTRINSIC_Illegal = -1,         // Not a true intrinsic,
@@ -1753,6 +1767,17 @@ struct CORINFO_CPU
     DWORD           dwExtendedFeatures;
 };
 
+#if COR_JIT_EE_VERSION > 460
+// Bits of CORINFO_EE_INFO::cpuFeatures
+enum CorInfoCpuFeatures
+{
+    CORINFO_CPU_FEATURE_POPCNT      = 0x00000001,   // popcnt
+    CORINFO_CPU_FEATURE_LZCNT       = 0x00000002,   // lzcnt (ABM)
+    CORINFO_CPU_FEATURE_BMI1        = 0x00000004,   // tzcnt, andn, blsr, ...
+    CORINFO_CPU_FEATURE_BMI2        = 0x00000008,   // pdep, pext, ...
+};
+#endif
+
 // For some highly optimized paths, the JIT must generate code that directly
 // manipulates internal EE data structures. The getEEInfo() helper returns
 // this structure containing the needed offsets and values.
@@ -1793,6 +1818,12 @@ struct CORINFO_EE_INFO
     unsigned    osMajor;
     unsigned    osMinor;
     unsigned    osBuild;
+
+#if COR_JIT_EE_VERSION > 460
+    // Optional instruction set extensions of the machine the code will run on
+    // (CorInfoCpuFeatures). Always 0 when the code is compiled ahead of time.
+    unsigned    cpuFeatures;
+#endif
 };
 
 // This is used to indicate that a finally has been called 
@@ -2054,6 +2085,20 @@ public:
             unsigned*                   offsetAfterIndirection  /* OUT */
             ) = 0;
 
+#if COR_JIT_EE_VERSION > 460
+    // Find the method that a virtual call to "virtualMethod" dispatches to when
+    // the object is known to be an instance of "implementingClass". "ownerType"
+    // is the exact context of the call, which matters for generic interfaces.
+    //
+    // Returns NULL if the target can't be determined, or if it can't be called
+    // directly (e.g. it needs an instantiation argument or an unboxing stub).
+    virtual CORINFO_METHOD_HANDLE resolveVirtualMethod(
+            CORINFO_METHOD_HANDLE       virtualMethod,          /* IN */
+            CORINFO_CLASS_HANDLE        implementingClass,      /* IN */
+            CORINFO_CONTEXT_HANDLE      ownerType               /* IN */
+            ) = 0;
+#endif
+
     // If a method's attributes have (getMethodAttribs) CORINFO_FLG_INTRINSIC set,
     // getIntrinsicID() returns the intrinsic ID.
     // *pMustExpand tells whether or not JIT must expand the intrinsic.
@@ -2292,6 +2337,15 @@ public:
             CORINFO_CLASS_HANDLE        cls
             ) = 0;
 
+#if COR_JIT_EE_VERSION > 460
+    // return the number of bytes an instance of the reference class 'cls'
+    // occupies on the GC heap, starting at its method table pointer (the
+    // object header is not included)
+    virtual unsigned getHeapClassSize (
+            CORINFO_CLASS_HANDLE        cls
+            ) = 0;
+#endif
+
     virtual unsigned getClassAlignmentRequirement (
             CORINFO_CLASS_HANDLE        cls,
             BOOL                        fDoubleAlignHint = FALSE
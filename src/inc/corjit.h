@@ -86,7 +86,7 @@ enum CorJitFlag
     CORJIT_FLG_GCPOLL_CALLS        = 0x00000040, // Emit calls to JIT_POLLGC for thread suspension.
     CORJIT_FLG_MCJIT_BACKGROUND    = 0x00000080, // Calling from multicore JIT background thread, do not call JitComplete
 
-    CORJIT_FLG_UNUSED1             = 0x00000100,
+    CORJIT_FLG_GCPOLL_LOOPS        = 0x00000100, // With GCPOLL_CALLS/GCPOLL_INLINE, only poll on loop back edges (returns rely on hijacking)
 
 #if defined(_TARGET_X86_)
 
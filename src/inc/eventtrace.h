@@ -119,6 +119,11 @@ namespace ETW
         // GCSampledObjectAllocation*Keyword was used)
         static int s_nCustomMsBetweenEvents;
 
+        // Mean number of bytes a thread allocates (in arenas or on the GC heap) between
+        // AllocationSample events, from COMPlus_AllocationSamplingBytes.  0 if sampling
+        // is off.  Like the heap alloc events, this can only be turned on at startup.
+        static SIZE_T s_nAllocationSamplingBytes;
+
     public:
         // This customizes the type logging behavior in LogTypeAndParametersIfNecessary
         enum TypeLogBehavior
@@ -144,6 +149,8 @@ namespace ETW
         static void PostRegistrationInit();
         static BOOL IsHeapAllocEventEnabled();
         static void SendObjectAllocatedEvent(Object * pObject);
+        static BOOL IsAllocationSamplingEnabled();
+        static void SendAllocationSampleEvent(Object * pObject, SIZE_T size, INT32 arenaId);
         static CrstBase * GetHashCrst();
         static VOID LogTypeAndParametersIfNecessary(BulkTypeEventLogger * pBulkTypeEventLogger, ULONGLONG thAsAddr, TypeLogBehavior typeLogBehavior);
         static VOID OnModuleUnload(Module * pModule);
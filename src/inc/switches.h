@@ -267,5 +267,11 @@
 #define FEATURE_STACK_SAMPLING
 #endif // defined (ALLOW_SXS_JIT)
 
+// Methods are jitted with MinOpts first and rejitted with full optimization once they are hot,
+// see code:TieredCompilationManager. Off unless COMPlus_TieredCompilation is set.
+#if defined(FEATURE_CORECLR) && !defined(FEATURE_INTERPRETER)
+#define FEATURE_TIERED_COMPILATION
+#endif // defined(FEATURE_CORECLR) && !defined(FEATURE_INTERPRETER)
+
 #endif // !defined(CROSSGEN_COMPILE)
 
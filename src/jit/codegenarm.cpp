@@ -1912,6 +1912,12 @@ void CodeGen::genProduceReg(GenTree *tree)
             // Store local variable to its home location.
             tree->gtFlags &= ~GTF_REG_VAL;
             inst_TT_RV(ins_Store(tree->gtType), tree, tree->gtRegNum);
+            if (compiler->lvaTable[tree->gtLclVarCommon.gtLclNum].lvEHWriteThru && ((tree->gtFlags & GTF_VAR_DEF) != 0))
+            {
+                // A def of a write-thru variable is stored to its home, but stays live in
+                // the register as well.
+                tree->gtFlags &= ~GTF_SPILL;
+            }
         }
         else
         {
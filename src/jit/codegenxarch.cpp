@@ -1225,6 +1225,69 @@ void CodeGen::genCodeForMulHi(GenTreeOp* treeNode)
     }
 }
 
+// Generate code for the bit manipulation nodes the importer creates for the
+// BitOperations intrinsics: popcnt, lzcnt, tzcnt, bswap, pdep and pext.
+void CodeGen::genCodeForBitIntrinsic(GenTreePtr treeNode)
+{
+    regNumber targetReg  = treeNode->gtRegNum;
+    var_types targetType = treeNode->TypeGet();
+    emitAttr  size       = emitTypeSize(treeNode);
+
+    assert(varTypeIsIntegral(targetType));
+
+    instruction ins;
+    switch (treeNode->OperGet())
+    {
+    case GT_POPCNT: ins = INS_popcnt; break;
+    case GT_LZCNT:  ins = INS_lzcnt;  break;
+    case GT_TZCNT:  ins = INS_tzcnt;  break;
+    case GT_BSWAP:  ins = INS_bswap;  break;
+#ifdef FEATURE_AVX_SUPPORT
+    case GT_PDEP:   ins = INS_pdep;   break;
+    case GT_PEXT:   ins = INS_pext;   break;
+#endif // FEATURE_AVX_SUPPORT
+    default:
+        unreached();
+    }
+
+#ifdef FEATURE_AVX_SUPPORT
+    if (treeNode->OperIsBinary())
+    {
+        // pdep/pext target, value (vvvv), mask (r/m)
+        GenTree* op1 = treeNode->gtGetOp1();
+        GenTree* op2 = treeNode->gtGetOp2();
+        assert(!op1->isContained() && !op2->isContained());
+
+        genConsumeOperands(treeNode->AsOp());
+        getEmitter()->emitIns_R_R_R(ins, size, targetReg, op1->gtRegNum, op2->gtRegNum);
+        return;
+    }
+#endif // FEATURE_AVX_SUPPORT
+
+    GenTreePtr operand = treeNode->gtGetOp1();
+    assert(!operand->isContained());
+    regNumber operandReg = genConsumeReg(operand);
+
+    if (ins == INS_bswap)
+    {
+        if (operandReg != targetReg)
+        {
+            inst_RV_RV(INS_mov, targetReg, operandReg, targetType);
+        }
+        inst_RV(ins, targetReg, targetType);
+    }
+    else
+    {
+        // Some processors don't rename the destination of popcnt/lzcnt/tzcnt and
+        // wait for its previous value; zeroing it first breaks that dependency.
+        if (operandReg != targetReg)
+        {
+            instGen_Set_Reg_To_Zero(EA_4BYTE, targetReg);
+        }
+        inst_RV_RV(ins, targetReg, operandReg, targetType, size);
+    }
+}
+
 // generate code for a DIV or MOD operation
 //
 void CodeGen::genCodeForDivMod(GenTreeOp* treeNode)
@@ -2087,6 +2150,16 @@ CodeGen::genCodeForTreeNode(GenTreePtr treeNode)
         genProduceReg(treeNode);
         break;
 
+    case GT_POPCNT:
+    case GT_LZCNT:
+    case GT_TZCNT:
+    case GT_BSWAP:
+    case GT_PDEP:
+    case GT_PEXT:
+        genCodeForBitIntrinsic(treeNode);
+        genProduceReg(treeNode);
+        break;
+
     case GT_MUL:
         {
             instruction ins;
@@ -5163,6 +5236,12 @@ void CodeGen::genProduceReg(GenTree *tree)
             unsigned varNum = tree->gtLclVarCommon.gtLclNum;
             assert(!compiler->lvaTable[varNum].lvNormalizeOnStore() || (tree->TypeGet() == genActualType(compiler->lvaTable[varNum].TypeGet())));
             inst_TT_RV(ins_Store(tree->gtType, compiler->isSIMDTypeLocalAligned(varNum)), tree, tree->gtRegNum);
+            if (compiler->lvaTable[tree->gtLclVarCommon.gtLclNum].lvEHWriteThru && ((tree->gtFlags & GTF_VAR_DEF) != 0))
+            {
+                // A def of a write-thru variable is stored to its home, but stays live in
+                // the register as well.
+                tree->gtFlags &= ~GTF_SPILL;
+            }
         }
         else
         {
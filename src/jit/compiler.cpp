@@ -1859,6 +1859,18 @@ void Compiler::compSetProcessor()
         }
     }
 #endif
+
+    // COMPlus_EnableBitIntrinsics can be used to keep the BitOperations methods from
+    // being expanded to popcnt, lzcnt, tzcnt, pdep and pext on machines that have them.
+    // The instructions are optional, so code compiled ahead of time can't use them.
+    opts.compCpuFeatures = 0;
+#if COR_JIT_EE_VERSION > 460
+    if (((compileFlags & CORJIT_FLG_PREJIT) == 0) &&
+        (JitConfig.EnableBitIntrinsics() != 0))
+    {
+        opts.compCpuFeatures = eeGetEEInfo()->cpuFeatures;
+    }
+#endif
 #endif //_TARGET_AMD64_
 
 #ifdef _TARGET_X86_
@@ -2901,6 +2913,8 @@ void                Compiler::compInitOptions(CORJIT_FLAGS* jitFlags)
         assert(opts.compGCPollType == GCPOLL_NONE);
         opts.compGCPollType = GCPOLL_INLINE;
     }
+    opts.compGCPollLoopsOnly = (opts.compGCPollType != GCPOLL_NONE) &&
+                               ((opts.eeFlags & CORJIT_FLG_GCPOLL_LOOPS) != 0);
 
 }
 
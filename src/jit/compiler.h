@@ -293,6 +293,8 @@ public:
 #endif
 #ifndef LEGACY_BACKEND
     unsigned char       lvLRACandidate   :1; // Tracked for linear scan register allocation purposes
+    unsigned char       lvEHWriteThru    :1; // Live in or out of a handler, but still enregistered: every def is also
+                                             // stored to the stack home, which is where handlers and continuations read it.
 #endif // !LEGACY_BACKEND
 
 #ifdef FEATURE_SIMD
@@ -303,6 +305,10 @@ public:
 #endif // FEATURE_SIMD
     unsigned char       lvRegStruct      :1;     // This is a reg-sized non-field-addressed struct.
 
+    unsigned char       lvHasILStoreOp         :1; // there is at least one STLOC to this local
+    unsigned char       lvHasMultipleILStoreOp :1; // there is more than one STLOC to this local
+    unsigned char       lvClassIsExact         :1; // lvClassHnd is the exact type of the object this local holds
+
     union 
     {
         unsigned        lvFieldLclStart;     // The index of the local var representing the first field in the promoted struct local.
@@ -617,6 +623,8 @@ public:
 
     typeInfo            lvVerTypeInfo;  // type info needed for verification
 
+    CORINFO_CLASS_HANDLE lvClassHnd;    // class of the object a TYP_REF local holds, if known
+
     BYTE  *             lvGcLayout;     // GC layout info for structs
 
 
@@ -1953,6 +1961,9 @@ public:
 
     GenTreePtr              gtGetThisArg(GenTreePtr call);
 
+    // Get the class of the object a TYP_REF tree evaluates to, if known
+    CORINFO_CLASS_HANDLE    gtGetClassHandle(GenTreePtr tree, bool* isExact);
+
     // Static fields of struct types (and sometimes the types that those are reduced to) are represented by having the 
     // static field contain an object pointer to the boxed struct.  This simplifies the GC implementation...but complicates
     // the JIT somewhat.  This predicate returns "true" iff a node with type "fieldNodeType", representing the given "fldHnd",
@@ -2201,6 +2212,7 @@ public :
     };
 #endif
     void                lvaSetVarDoNotEnregister(unsigned varNum DEBUG_ARG(DoNotEnregisterReason reason));     
+    void                lvaSetVarLiveInOutOfHandler(unsigned varNum);
 
     unsigned            lvaVarargsHandleArg;
 #ifdef _TARGET_X86_
@@ -2460,6 +2472,14 @@ public :
                                             bool unsafeValueClsCheck,
                                             bool setTypeInfo = true);
 
+    // If the local is a TYP_REF, note what is known about the class of the object it holds
+
+    void                 lvaSetClass        (unsigned varNum,
+                                            CORINFO_CLASS_HANDLE clsHnd,
+                                            bool isExact = false);
+    void                 lvaSetClass        (unsigned varNum,
+                                            GenTreePtr tree);
+
 #define MAX_NumOfFieldsInPromotableStruct 4 // Maximum number of fields in promotable struct
 
     // Info about struct fields
@@ -2727,6 +2747,11 @@ protected :
                                           CORINFO_RESOLVED_TOKEN * pConstrainedResolvedToken,
                                           CORINFO_THIS_TRANSFORM transform);
 
+    void                impDevirtualizeCall(GenTreeCall*            call,
+                                            CORINFO_METHOD_HANDLE*  method,
+                                            unsigned*               methodFlags,
+                                            CORINFO_CONTEXT_HANDLE* contextHandle);
+
     //----------------- Manipulating the trees and stmts ----------------------
 
     GenTreePtr          impTreeList;        // Trees for the BB being imported
@@ -4681,6 +4706,13 @@ private:
     static fgWalkPreFn  fgMarkAddrTakenLocalsPreCB;
     static fgWalkPostFn fgMarkAddrTakenLocalsPostCB;
     void                fgMarkAddressExposedLocals();
+
+    bool                fgIsStackAllocLocal(unsigned lclNum);
+    bool                fgIsStackAllocCandidate(GenTreePtr expr);
+    bool                fgIsStackAllocLocalLiveAfter(BasicBlock* block, GenTreeStmt* stmt, unsigned lclNum);
+    static fgWalkPreFn  fgStackAllocEscapeCB;
+    static fgWalkPreFn  fgStackAllocRetypeCB;
+    void                fgStackAllocateObjects();
     bool                fgNodesMayInterfere(GenTree* store, GenTree* load);
 
     // Returns true if the type of tree is of size at least "width", or if "tree" is not a
@@ -4882,6 +4914,15 @@ public :
 
     void                optUnrollLoops  ();    // Unrolls loops (needs to have cost info)
 
+    // Partially unroll the innermost loops whose trip count isn't a (small) constant, keeping
+    // the original loop to run the remaining iterations.
+    void                optPartialUnrollLoops();
+
+    // Partially unroll loop "lnum" of the loop table; returns true if it was unrolled.
+    bool                optPartialUnrollLoop(unsigned lnum);
+
+    static fgWalkPreFn  optFindRangeCheckCB;
+
 protected :
 
     // This enumeration describes what is killed by a call.
@@ -4939,6 +4980,8 @@ public:
 
 #define LPFLG_VAR_INIT      0x0020      // iterator is initialized with a local var (var # found in lpVarInit)
 #define LPFLG_CONST_INIT    0x0040      // iterator is initialized with a constant (found in lpConstInit)
+#define LPFLG_CLONED_FAST   0x0080      // the loop is the fast path of a cloned loop: its limit is non-negative,
+                                        // its arrays are non-null and their range checks have been removed
 
 #define LPFLG_VAR_LIMIT     0x0100      // iterator is compared with a local var (var # found in lpVarLimit)
 #define LPFLG_CONST_LIMIT   0x0200      // iterator is compared with a constant (found in lpConstLimit)
@@ -7295,6 +7338,17 @@ private:
 #endif
     }
 
+    // Whether the generated code can use the instructions of all the given
+    // CorInfoCpuFeatures (POPCNT, LZCNT, BMI1, BMI2)
+    bool                    canUseCpuFeatures(unsigned features) const
+    {
+#ifdef _TARGET_AMD64_
+        return (opts.compCpuFeatures & features) == features;
+#else
+        return false;
+#endif
+    }
+
 /*
 XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -7397,6 +7451,9 @@ public :
 #ifdef FEATURE_AVX_SUPPORT
         bool                compCanUseAVX;  // Allow CodeGen to use AVX 256-bit vectors for SIMD operations
 #endif
+#ifdef _TARGET_AMD64_
+        unsigned            compCpuFeatures; // CorInfoCpuFeatures the generated code can use
+#endif
 #endif
 
         // optimize maximally and/or favor speed over size?
@@ -7590,6 +7647,7 @@ public :
 #endif
 
         GCPollType compGCPollType;
+        bool       compGCPollLoopsOnly; // Only poll on back edges, the EE hijacks returns
     }
         opts;
 
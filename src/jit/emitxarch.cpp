@@ -39,6 +39,22 @@ bool IsSSEOrAVXInstruction(instruction ins)
 #endif // !FEATURE_AVX_SUPPORT
 }
 
+// Returns true for popcnt, lzcnt and tzcnt, which are encoded like the SSE
+// instructions (F3 0F xx /r) but never take a VEX prefix.
+bool IsBitCountInstruction(instruction ins)
+{
+    return (ins == INS_popcnt || ins == INS_lzcnt || ins == INS_tzcnt);
+}
+
+#ifdef FEATURE_AVX_SUPPORT
+// Returns true for the BMI2 instructions, which are VEX encoded but operate on
+// general purpose registers and are available whether or not we use AVX.
+bool IsBMI2Instruction(instruction ins)
+{
+    return (ins == INS_pdep || ins == INS_pext);
+}
+#endif // FEATURE_AVX_SUPPORT
+
 bool emitter::IsAVXInstruction(instruction ins)
 {
 #ifdef FEATURE_AVX_SUPPORT
@@ -97,6 +113,10 @@ bool emitter::IsThreeOperandBinaryAVXInstruction(instruction ins)
             ins == INS_pmuludq  || ins == INS_pxor     ||
             ins == INS_pmaxub   || ins == INS_pminub   ||
             ins == INS_pmaxsw   || ins == INS_pminsw   ||
+            ins == INS_psllw    || ins == INS_pslld    ||
+            ins == INS_psllq    || ins == INS_psrlw    ||
+            ins == INS_psrld    || ins == INS_psrlq    ||
+            ins == INS_psraw    || ins == INS_psrad    ||
             ins == INS_insertps || ins == INS_vinsertf128
 
             );
@@ -3342,7 +3362,10 @@ void                emitter::emitIns_R(instruction ins,
     }
 
     // Vex bytes
-    sz += emitGetVexPrefixAdjustedSize(ins, attr, insEncodeMRreg(ins, reg, attr, insCodeMR(ins)));
+    if (ins != INS_bswap)
+    {
+        sz += emitGetVexPrefixAdjustedSize(ins, attr, insEncodeMRreg(ins, reg, attr, insCodeMR(ins)));
+    }
 
     // REX byte
     if (IsExtendedReg(reg, attr) || TakesRexWPrefix(ins, attr))
@@ -3808,8 +3831,7 @@ void                emitter::emitIns_R_R_R (instruction ins,
                                             regNumber   reg1,
                                             regNumber   reg2)
 {
-    assert(IsSSEOrAVXInstruction(ins));
-    assert(IsThreeOperandAVXInstruction(ins));
+    assert((IsSSEOrAVXInstruction(ins) && IsThreeOperandAVXInstruction(ins)) || IsBMI2Instruction(ins));
     //Currently vex prefix only use three bytes mode. 
     //size = vex + opcode + ModR/M = 3 + 1 + 1 = 5
     //TODO-XArch-CQ: We should create function which can calculate all kinds of AVX instructions size in future
@@ -7098,8 +7120,7 @@ PRINT_CONSTANT:
 
 #ifdef FEATURE_AVX_SUPPORT
     case IF_RWR_RRD_RRD:
-        assert(IsAVXInstruction(ins));
-        assert(IsThreeOperandAVXInstruction(ins));
+        assert((IsAVXInstruction(ins) && IsThreeOperandAVXInstruction(ins)) || IsBMI2Instruction(ins));
         printf("%s, ", emitRegName(id->idReg1(), attr));
         printf("%s, ", emitRegName(id->idReg2(), attr));
         printf("%s", emitRegName(id->idReg3(), attr));
@@ -9045,6 +9066,27 @@ BYTE*               emitter::emitOutputR(BYTE* dst, instrDesc* id)
         }
         break;
 
+    case INS_bswap:
+
+        assert(size == EA_4BYTE || size == EA_8BYTE);
+
+        code = insCodeRR(ins);
+        if (TakesRexWPrefix(ins, size))
+        {
+            code = AddRexWPrefix(ins, code);
+        }
+
+        // Register...
+        {
+            unsigned regcode = insEncodeReg012(ins, reg, size, &code);
+
+            // Output the REX prefix
+            dst += emitOutputRexOrVexPrefixIfNeeded(ins, dst, code);
+
+            dst += emitOutputWord(dst, code | (regcode << 8));
+        }
+        break;
+
     case INS_pop:
     case INS_pop_hide:
     case INS_push:
@@ -9198,7 +9240,7 @@ BYTE*               emitter::emitOutputRR(BYTE* dst, instrDesc* id)
     // Get the 'base' opcode
     code = insCodeRM(ins);
     code = AddVexPrefixIfNeeded(ins, code, size);
-    if (IsSSE2Instruction(ins) || IsAVXInstruction(ins))
+    if (IsSSE2Instruction(ins) || IsAVXInstruction(ins) || IsBitCountInstruction(ins))
     {
         code = insEncodeRMreg(ins, code);
 
@@ -9514,13 +9556,40 @@ BYTE*               emitter::emitOutputRRR(BYTE* dst, instrDesc* id)
     size_t          code;
 
     instruction     ins       = id->idIns();
-    assert(IsAVXInstruction(ins));
-    assert(IsThreeOperandAVXInstruction(ins));
     regNumber       targetReg = id->idReg1();
     regNumber       src1      = id->idReg2();
     regNumber       src2      = id->idReg3();
     emitAttr        size      = id->idOpSize();
 
+    if (IsBMI2Instruction(ins))
+    {
+        // The AVX prefix handling below is for xmm/ymm operands, so the general
+        // purpose register forms are encoded here:
+        //   C4 <R,X,B,m-mmmm=00010> <W,vvvv,L=0,pp> opcode <11,reg,r/m>
+        // with target in reg, src1 in vvvv and src2 in r/m.
+        assert(genIsValidIntReg(targetReg) && genIsValidIntReg(src1) && genIsValidIntReg(src2));
+
+        code = insCodeRM(ins);
+
+        unsigned targetBits = (unsigned)targetReg;
+        unsigned src1Bits   = (unsigned)src1;
+        unsigned src2Bits   = (unsigned)src2;
+        BYTE     pp         = (((code >> 16) & 0xFF) == 0xF2) ? 0x03 : 0x02;
+
+        dst += emitOutputByte(dst, 0xC4);
+        dst += emitOutputByte(dst, ((~targetBits & 0x8) << 4) | 0x40 | ((~src2Bits & 0x8) << 2) | 0x02);
+        dst += emitOutputByte(dst, ((size == EA_8BYTE) ? 0x80 : 0x00) | ((~src1Bits & 0xF) << 3) | pp);
+        dst += emitOutputByte(dst, (code >> 8) & 0xFF);
+        dst += emitOutputByte(dst, 0xC0 | ((targetBits & 0x7) << 3) | (src2Bits & 0x7));
+
+        // The target no longer holds whatever GC ref it may have had
+        emitGCregDeadUpd(targetReg, dst);
+        return dst;
+    }
+
+    assert(IsAVXInstruction(ins));
+    assert(IsThreeOperandAVXInstruction(ins));
+
     code = insCodeRM(ins);
     code = AddVexPrefixIfNeeded(ins, code, size);
     code = insEncodeRMreg(ins, code);
@@ -9614,7 +9683,6 @@ BYTE*               emitter::emitOutputRI(BYTE* dst, instrDesc* id)
     {
         assert(id->idGCref() == GCT_NONE);
         assert(valInByte);
-        assert(ins == INS_psrldq || ins == INS_pslldq);
 
         // Get the 'base' opcode.
         code = insCodeMI(ins);
@@ -9628,14 +9696,41 @@ BYTE*               emitter::emitOutputRI(BYTE* dst, instrDesc* id)
             code = insEncodeReg3456(ins, reg, size, code);        
         }
 
-        // In case of psrldq
-        // Reg/Opcode = 3
-        // R/M = reg1
-        //
-        // In case of pslldq
-        // Reg/Opcode = 7
-        // R/M = reg1
-        regNumber regOpcode = (regNumber) ((ins == INS_psrldq) ? 3 : 7);
+        // The shift instructions share their opcode between the variants and
+        // encode the kind of shift in Reg/Opcode, with R/M = reg1:
+        //    psrlw/psrld/psrlq   Reg/Opcode = 2
+        //    psraw/psrad         Reg/Opcode = 4
+        //    psllw/pslld/psllq   Reg/Opcode = 6
+        //    psrldq              Reg/Opcode = 3
+        //    pslldq              Reg/Opcode = 7
+        regNumber regOpcode;
+        switch (ins)
+        {
+        case INS_psrlw:
+        case INS_psrld:
+        case INS_psrlq:
+            regOpcode = (regNumber) 2;
+            break;
+        case INS_psraw:
+        case INS_psrad:
+            regOpcode = (regNumber) 4;
+            break;
+        case INS_psllw:
+        case INS_pslld:
+        case INS_psllq:
+            regOpcode = (regNumber) 6;
+            break;
+        case INS_psrldq:
+            regOpcode = (regNumber) 3;
+            break;
+        case INS_pslldq:
+            regOpcode = (regNumber) 7;
+            break;
+        default:
+            assert(!"Unexpected SSE instruction with an immediate operand");
+            regOpcode = REG_NA;
+            break;
+        }
         unsigned regcode = (insEncodeReg345(ins, regOpcode, size, &code) | insEncodeReg012(ins, reg, size, &code)) << 8;
 
         // Output the REX prefix
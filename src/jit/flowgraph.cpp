@@ -3566,9 +3566,9 @@ void                Compiler::fgMarkGCPollBlocks()
 
     BasicBlock* block;
 
-    //Return blocks always need GC polls.  In addition, all back edges (including those from switch
-    //statements) need GC polls.  The poll is on the block with the outgoing back edge (or ret), rather than
-    //on the destination or on the edge itself.
+    //Return blocks need GC polls unless the EE hijacks returns (opts.compGCPollLoopsOnly).  In addition,
+    //all back edges (including those from switch statements) need GC polls.  The poll is on the block
+    //with the outgoing back edge (or ret), rather than on the destination or on the edge itself.
     for (block = fgFirstBB; block; block = block->bbNext)
     {
         bool blockNeedsPoll = false;
@@ -3580,7 +3580,7 @@ void                Compiler::fgMarkGCPollBlocks()
             break;
 
         case BBJ_RETURN:
-            blockNeedsPoll = true;
+            blockNeedsPoll = !opts.compGCPollLoopsOnly;
             break;
 
         case BBJ_SWITCH:
@@ -4233,7 +4233,7 @@ void                Compiler::fgMarkJumpTarget(BYTE* jumpTarget, unsigned offs)
  *
  *  Walk the instrs and for any jumps we find set the appropriate entry
  *  in the 'jumpTarget' table.
- *  Also sets lvAddrExposed and lvArgWrite in lvaTable[]
+ *  Also sets lvAddrExposed, lvArgWrite and lvHasILStoreOp in lvaTable[]
  */
 
 #ifdef _PREFAST_
@@ -4563,6 +4563,22 @@ DECODE_OPCODE:
         case CEE_STARG:
         case CEE_STARG_S:     goto ARG_WRITE;
 
+        case CEE_STLOC_0:
+        case CEE_STLOC_1:
+        case CEE_STLOC_2:
+        case CEE_STLOC_3:
+            varNum = (opcode - CEE_STLOC_0);
+            goto LOC_WRITE;
+
+        case CEE_STLOC:
+        case CEE_STLOC_S:
+            noway_assert(sz == sizeof(BYTE) || sz == sizeof(WORD));
+            if (codeAddr > codeEndp - sz)
+                goto TOO_FAR;
+            varNum = (sz == sizeof(BYTE)) ? getU1LittleEndian(codeAddr)
+                                          : getU2LittleEndian(codeAddr);
+            goto LOC_WRITE;
+
         case CEE_LDARGA:
         case CEE_LDARGA_S:
         case CEE_LDLOCA:
@@ -4878,6 +4894,26 @@ ARG_WRITE:
                     lvaTable[varNum].lvArgWrite = 1;
             }
             break;
+
+LOC_WRITE:
+            // In non-inline cases, note locals stored to more than once. The
+            // importer only tracks the exact class of single store locals.
+
+            if (!isInlining)
+            {
+                // This check is only intended to prevent an AV.  Bad varNum values will later
+                // be handled properly by the verifier.
+                if (varNum < info.compMethodInfo->locals.numArgs)
+                {
+                    varNum += info.compArgsCount;
+
+                    if (lvaTable[varNum].lvHasILStoreOp)
+                        lvaTable[varNum].lvHasMultipleILStoreOp = 1;
+                    else
+                        lvaTable[varNum].lvHasILStoreOp = 1;
+                }
+            }
+            break;
         }
 
         /* Skip any operands this opcode may have */
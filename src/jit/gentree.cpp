@@ -6716,6 +6716,60 @@ GenTreePtr Compiler::gtGetThisArg(GenTreePtr call)
     return NULL;
 }
 
+//------------------------------------------------------------------------
+// gtGetClassHandle: find out what is known about the class of the object
+//    a TYP_REF tree evaluates to
+//
+// Arguments:
+//    tree    -- the tree to look at
+//    isExact -- [OUT] true if the object is known to be exactly of the
+//               returned class, false if it may be of a derived class
+//
+// Return Value:
+//    The class handle, or nullptr if nothing is known.
+//
+// Notes:
+//    Locals carry their class in lvClassHnd, set from their declared type,
+//    from newobj, or from the single value stored into them. Fields are of
+//    their declared type.
+
+CORINFO_CLASS_HANDLE Compiler::gtGetClassHandle(GenTreePtr tree, bool* isExact)
+{
+    *isExact = false;
+
+    if (tree->TypeGet() != TYP_REF)
+    {
+        return nullptr;
+    }
+
+    // The value of a comma is its second operand
+    tree = tree->gtEffectiveVal(true);
+
+    switch (tree->OperGet())
+    {
+    case GT_LCL_VAR:
+        {
+            LclVarDsc* varDsc = &lvaTable[tree->gtLclVarCommon.gtLclNum];
+            *isExact = varDsc->lvClassIsExact;
+            return varDsc->lvClassHnd;
+        }
+
+    case GT_FIELD:
+        {
+            CORINFO_CLASS_HANDLE fieldClass = nullptr;
+            CorInfoType fieldCorType = info.compCompHnd->getFieldType(tree->gtField.gtFldHnd, &fieldClass);
+            if (fieldCorType == CORINFO_TYPE_CLASS)
+            {
+                return fieldClass;
+            }
+            return nullptr;
+        }
+
+    default:
+        return nullptr;
+    }
+}
+
 bool                GenTree::gtSetFlags() const
 {
     //
@@ -56,6 +56,11 @@ GTNODE(ARR_LENGTH , "arrLen"        ,0,GTK_UNOP|GTK_EXOP)    // array-length
 
 GTNODE(INTRINSIC  , "intrinsic"     ,0,GTK_BINOP|GTK_EXOP)   // intrinsics
 
+GTNODE(POPCNT     , "popcnt"        ,0,GTK_UNOP)             // number of bits set
+GTNODE(LZCNT      , "lzcnt"         ,0,GTK_UNOP)             // number of zero bits above the highest bit set
+GTNODE(TZCNT      , "tzcnt"         ,0,GTK_UNOP)             // number of zero bits below the lowest bit set
+GTNODE(BSWAP      , "bswap"         ,0,GTK_UNOP)             // reverse the order of the bytes
+
 GTNODE(LOCKADD          , "lockAdd"       ,0,GTK_BINOP)
 GTNODE(XADD             , "XAdd"          ,0,GTK_BINOP)
 GTNODE(XCHG             , "Xchg"          ,0,GTK_BINOP)
@@ -107,6 +112,8 @@ GTNODE(RSZ        , ">>>"        ,0,GTK_BINOP)
 GTNODE(ROL        , "rol"        ,0,GTK_BINOP)
 GTNODE(ROR        , "ror"        ,0,GTK_BINOP)
 GTNODE(MULHI      , "mulhi"      ,1,GTK_BINOP) // returns high bits (top N bits of the 2N bit result of an NxN multiply)
+GTNODE(PDEP       , "pdep"       ,0,GTK_BINOP) // scatter the low bits of op1 to the positions of the bits set in op2
+GTNODE(PEXT       , "pext"       ,0,GTK_BINOP) // gather the bits of op1 at the positions of the bits set in op2
 
 GTNODE(ASG        , "="          ,0,GTK_BINOP|GTK_ASGOP)
 GTNODE(ASG_ADD    , "+="         ,0,GTK_BINOP|GTK_ASGOP)
@@ -2889,6 +2889,10 @@ GenTreePtr      Compiler::impIntrinsic(CORINFO_CLASS_HANDLE     clsHnd,
 #ifndef _TARGET_ARM_
     genTreeOps interlockedOperator;
 #endif
+#if defined(_TARGET_AMD64_) && !defined(LEGACY_BACKEND) && (COR_JIT_EE_VERSION > 460)
+    genTreeOps bitOperator;
+    unsigned   bitCpuFeatures;
+#endif
 
     if (intrinsicID == CORINFO_INTRINSIC_StubHelpers_GetStubContext)
     {
@@ -3173,6 +3177,72 @@ InterlockedBinOpCommon:
         // Call the regular function.
         break;
 
+#if defined(_TARGET_AMD64_) && !defined(LEGACY_BACKEND) && (COR_JIT_EE_VERSION > 460)
+    case CORINFO_INTRINSIC_PopCount32:
+    case CORINFO_INTRINSIC_PopCount64:
+        bitOperator = GT_POPCNT; bitCpuFeatures = CORINFO_CPU_FEATURE_POPCNT; goto BitUnOpCommon;
+    case CORINFO_INTRINSIC_LeadingZeroCount32:
+    case CORINFO_INTRINSIC_LeadingZeroCount64:
+        bitOperator = GT_LZCNT; bitCpuFeatures = CORINFO_CPU_FEATURE_LZCNT; goto BitUnOpCommon;
+    case CORINFO_INTRINSIC_TrailingZeroCount32:
+    case CORINFO_INTRINSIC_TrailingZeroCount64:
+        // bsf leaves its destination undefined for 0, so only expand to tzcnt
+        bitOperator = GT_TZCNT; bitCpuFeatures = CORINFO_CPU_FEATURE_BMI1; goto BitUnOpCommon;
+    case CORINFO_INTRINSIC_ByteSwap32:
+    case CORINFO_INTRINSIC_ByteSwap64:
+        bitOperator = GT_BSWAP; bitCpuFeatures = 0; goto BitUnOpCommon;
+
+BitUnOpCommon:
+        assert(sig->numArgs == 1);
+
+        // Without the instruction, leave the call to the runtime's software implementation
+        if (canUseCpuFeatures(bitCpuFeatures))
+        {
+            bool      is64Bit = ((intrinsicID == CORINFO_INTRINSIC_PopCount64) ||
+                                 (intrinsicID == CORINFO_INTRINSIC_LeadingZeroCount64) ||
+                                 (intrinsicID == CORINFO_INTRINSIC_TrailingZeroCount64) ||
+                                 (intrinsicID == CORINFO_INTRINSIC_ByteSwap64));
+            var_types opType  = is64Bit ? TYP_LONG : TYP_INT;
+
+            op1 = impPopStack().val;
+            assert(genActualType(op1->TypeGet()) == opType);
+
+            op1 = gtNewOperNode(bitOperator, opType, op1);
+
+            // The 64-bit counts return an int
+            if (genActualType(callType) != opType)
+            {
+                assert(genActualType(callType) == TYP_INT);
+                op1 = gtNewCastNode(TYP_INT, op1, TYP_INT);
+            }
+            retNode = op1;
+        }
+        break;
+
+#ifdef FEATURE_AVX_SUPPORT
+    case CORINFO_INTRINSIC_ParallelBitDeposit32:
+    case CORINFO_INTRINSIC_ParallelBitDeposit64:
+        bitOperator = GT_PDEP; goto BitBinOpCommon;
+    case CORINFO_INTRINSIC_ParallelBitExtract32:
+    case CORINFO_INTRINSIC_ParallelBitExtract64:
+        bitOperator = GT_PEXT; goto BitBinOpCommon;
+
+BitBinOpCommon:
+        assert(sig->numArgs == 2);
+
+        if (canUseCpuFeatures(CORINFO_CPU_FEATURE_BMI2))
+        {
+            op2 = impPopStack().val; // mask
+            op1 = impPopStack().val; // value
+            assert(genActualType(op1->TypeGet()) == genActualType(callType));
+            assert(genActualType(op2->TypeGet()) == genActualType(callType));
+
+            retNode = gtNewOperNode(bitOperator, genActualType(callType), op1, op2);
+        }
+        break;
+#endif // FEATURE_AVX_SUPPORT
+#endif // defined(_TARGET_AMD64_) && !defined(LEGACY_BACKEND) && (COR_JIT_EE_VERSION > 460)
+
 #ifndef LEGACY_BACKEND
     case CORINFO_INTRINSIC_Object_GetType:
 
@@ -6511,6 +6581,15 @@ var_types           Compiler::impImportCall (OPCODE         opcode,
 
         call->gtFlags          |= obj->gtFlags & GTF_GLOB_EFFECT;
         call->gtCall.gtCallObjp = obj;
+
+#if COR_JIT_EE_VERSION > 460
+        /* Can we tell where a virtual or interface call goes? */
+
+        if  (call->AsCall()->IsVirtual())
+        {
+            impDevirtualizeCall(call->AsCall(), &methHnd, &mflags, &exactContextHnd);
+        }
+#endif // COR_JIT_EE_VERSION
     }
         
     //-------------------------------------------------------------------------
@@ -9125,6 +9204,16 @@ _PopValue:
 
             impSpillLclRefs(lclNum);
 
+            // A local with a single STLOC holds only values computed here, so
+            // it gets their class (see impDevirtualizeCall)
+
+            if ((lclTyp == TYP_REF) &&
+                lvaTable[lclNum].lvHasILStoreOp && !lvaTable[lclNum].lvHasMultipleILStoreOp &&
+                !lvaTable[lclNum].lvAddrExposed && !lvaTable[lclNum].lvHasLdAddrOp)
+            {
+                lvaSetClass(lclNum, op1);
+            }
+
 #if !FEATURE_X87_DOUBLES 
             // We can generate an assignment to a TYP_FLOAT from a TYP_DOUBLE
             // We insert a cast to the dest 'op2' type
@@ -11424,6 +11513,9 @@ DO_LDFTN:
 
                     impAssignTempGen(lclNum, op1, (unsigned)CHECK_SPILL_NONE);
 
+                    // The temp holds only the new object, so its class is exact
+                    lvaSetClass(lclNum, resolvedToken.hClass, true /* isExact */);
+
                     newObjThisPtr = gtNewLclvNode(lclNum, TYP_REF);
                 }
             }
@@ -15515,6 +15607,24 @@ void Compiler::impMakeDiscretionaryInlineObservations(InlineInfo*   pInlineInfo,
     {
         frequency = InlineCallsiteFrequency::HOT;
     }
+    //Training data, from IBC or from instrumented tier-0 code. A call site that ran more
+    //often than the method was entered is in a loop, one that never ran is rare.
+    else if ((pInlineInfo->iciBlock->bbFlags & BBF_PROF_WEIGHT) &&
+             (impInlineRoot()->fgFirstBB->bbFlags & BBF_PROF_WEIGHT))
+    {
+        if (pInlineInfo->iciBlock->bbWeight == BB_ZERO_WEIGHT)
+        {
+            frequency = InlineCallsiteFrequency::RARE;
+        }
+        else if (pInlineInfo->iciBlock->bbWeight > impInlineRoot()->fgFirstBB->bbWeight)
+        {
+            frequency = InlineCallsiteFrequency::LOOP;
+        }
+        else
+        {
+            frequency = InlineCallsiteFrequency::WARM;
+        }
+    }
     //No training data.  Look for loop-like things.
     //We consider a recursive call loop-like.  Do not give the inlining boost to the method itself.
     //However, give it to things nearby.
@@ -16395,6 +16505,13 @@ GenTreePtr  Compiler::impInlineFetchArg(unsigned lclNum, InlArgInfo *inlArgInfo,
             
             lvaTable[tmpNum].lvType = lclTyp;
             assert(lvaTable[tmpNum].lvAddrExposed == 0);
+
+            // Inlinees don't store to their arguments, so the temp only holds the argument value
+            if (lclTyp == TYP_REF)
+            {
+                lvaSetClass(tmpNum, inlArgInfo[lclNum].argNode);
+            }
+
             if (inlArgInfo[lclNum].argHasLdargaOp)
             {
                 lvaTable[tmpNum].lvHasLdAddrOp = 1;                    
@@ -16722,6 +16839,135 @@ void          Compiler::impMarkInlineCandidate(GenTreePtr callNode, CORINFO_CONT
     inlineResult.SetReported();
 }
 
+#if COR_JIT_EE_VERSION > 460
+
+//------------------------------------------------------------------------
+// impDevirtualizeCall: turn a virtual or interface call into a direct call
+//    when the class of the object it is made on is known
+//
+// Arguments:
+//    call          -- the call, with its "this" already in gtCallObjp
+//    method        -- [IN/OUT] the method the call is to; updated to the
+//                     method found if the call is devirtualized
+//    methodFlags   -- [IN/OUT] attributes of the method, updated likewise
+//    contextHandle -- [IN/OUT] exact context of the call, updated likewise
+//
+// Notes:
+//    The IL for a virtual call names the method that introduced the slot, so
+//    a vtable or stub call is made even when the importer knows where the
+//    object came from: a newobj in this method, a local with a single store,
+//    or a sealed declared class. If that class is exact or final, or the
+//    override it has is final, there is only one method the call can reach.
+//    The EE finds it (resolveVirtualMethod) and the call becomes a direct
+//    call with an explicit null check, which may then be inlined.
+//
+//    Interface calls need an exact or final class: a derived class may
+//    re-implement the interface even where the current method is final.
+
+void Compiler::impDevirtualizeCall(GenTreeCall*            call,
+                                   CORINFO_METHOD_HANDLE*  method,
+                                   unsigned*               methodFlags,
+                                   CORINFO_CONTEXT_HANDLE* contextHandle)
+{
+    assert(call->IsVirtual());
+
+    // Debuggable and minopts code keep the call as written
+    if (opts.compDbgCode || opts.MinOpts())
+    {
+        return;
+    }
+
+    if (JitConfig.JitEnableDevirtualization() == 0)
+    {
+        return;
+    }
+
+    // Ready to run code can't depend on the shape of class hierarchies
+    // that may change underneath it
+    if (opts.IsReadyToRun())
+    {
+        return;
+    }
+
+    // Stub calls that need a runtime lookup are already indirect calls
+    if (call->gtCallType != CT_USER_FUNC)
+    {
+        return;
+    }
+
+    CORINFO_METHOD_HANDLE baseMethod = *method;
+    GenTreePtr            thisObj    = call->gtCallObjp;
+
+    bool                 isExact  = false;
+    CORINFO_CLASS_HANDLE objClass = gtGetClassHandle(thisObj, &isExact);
+
+    if (objClass == nullptr)
+    {
+        return;
+    }
+
+    const unsigned objClassAttribs = info.compCompHnd->getClassAttribs(objClass);
+    const bool     objClassIsFinal = (objClassAttribs & CORINFO_FLG_FINAL) != 0;
+
+    CORINFO_CLASS_HANDLE baseClass       = info.compCompHnd->getMethodClass(baseMethod);
+    const bool           isInterfaceCall = (info.compCompHnd->getClassAttribs(baseClass) & CORINFO_FLG_INTERFACE) != 0;
+
+    if (isInterfaceCall && !isExact && !objClassIsFinal)
+    {
+        return;
+    }
+
+    CORINFO_METHOD_HANDLE derivedMethod = info.compCompHnd->resolveVirtualMethod(baseMethod, objClass, *contextHandle);
+
+    if (derivedMethod == nullptr)
+    {
+        return;
+    }
+
+    const unsigned derivedMethodAttribs = info.compCompHnd->getMethodAttribs(derivedMethod);
+    const bool     derivedMethodIsFinal = ((derivedMethodAttribs & CORINFO_FLG_FINAL) != 0) ||
+                                          ((derivedMethodAttribs & CORINFO_FLG_VIRTUAL) == 0);
+
+    if (!isExact && !objClassIsFinal && !derivedMethodIsFinal)
+    {
+        return;
+    }
+
+#ifdef DEBUG
+    if (verbose)
+    {
+        printf("\nDevirtualizing %s call [%06d] to %s: %s class %s\n",
+               isInterfaceCall ? "interface" : "virtual",
+               dspTreeID(call),
+               eeGetMethodFullName(derivedMethod),
+               isExact ? "exact" : (objClassIsFinal ? "final" : "final method on"),
+               eeGetClassName(objClass));
+    }
+#endif // DEBUG
+
+    // Make the call direct. The vtable load or the stub made the null check
+    // on "this", so the call has to make it now.
+
+    call->gtFlags &= ~GTF_CALL_VIRT_KIND_MASK;
+    call->gtFlags |= GTF_CALL_NULLCHECK;
+    call->gtCallMethHnd = derivedMethod;
+
+    // These share storage with the flag and the field a direct call uses
+    call->gtCallMoreFlags &= ~GTF_CALL_M_VIRTSTUB_REL_INDIRECT;
+    call->gtStubCallStubAddr = nullptr;
+
+    if (impIsThis(thisObj))
+    {
+        call->gtCallMoreFlags |= GTF_CALL_M_NONVIRT_SAME_THIS;
+    }
+
+    *method        = derivedMethod;
+    *methodFlags   = derivedMethodAttribs;
+    *contextHandle = MAKE_METHODCONTEXT(derivedMethod);
+}
+
+#endif // COR_JIT_EE_VERSION
+
 /******************************************************************************/
 // Returns true if the given intrinsic will be implemented by target-specific 
 // instructions
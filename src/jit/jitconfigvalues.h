@@ -160,6 +160,8 @@ CONFIG_INTEGER(EnableAVX, W("EnableAVX"), 1) // Enable AVX instruction set for w
 CONFIG_INTEGER(EnableAVX, W("EnableAVX"), 0) // Enable AVX instruction set for wide operations as default
 #endif // defined(_TARGET_AMD64_)
 
+CONFIG_INTEGER(EnableBitIntrinsics, W("EnableBitIntrinsics"), 1) // Expand the BitOperations methods to popcnt, lzcnt, tzcnt, pdep and pext where the CPU has them
+
 #if (!defined(DEBUG) && !defined(_DEBUG)) || (defined(CROSSGEN_COMPILE) && !defined(FEATURE_CORECLR))
 CONFIG_INTEGER(JitEnableNoWayAssert, W("JitEnableNoWayAssert"), 0)
 #else // (defined(DEBUG) || defined(_DEBUG)) && (!defined(CROSSGEN_COMPILE) || defined(FEATURE_CORECLR))
@@ -168,7 +170,10 @@ CONFIG_INTEGER(JitEnableNoWayAssert, W("JitEnableNoWayAssert"), 1)
 
 CONFIG_INTEGER(JitAggressiveInlining, W("JitAggressiveInlining"), 0) // Aggressive inlining of all methods
 CONFIG_INTEGER(JitELTHookEnabled, W("JitELTHookEnabled"), 0) // On ARM, setting this will emit Enter/Leave/TailCall callbacks
+CONFIG_INTEGER(JitEnableDevirtualization, W("JitEnableDevirtualization"), 1) // Make virtual calls direct when the class of the object is known
+CONFIG_INTEGER(JitEnregEHVars, W("JitEnregEHVars"), 1) // Keep locals live in or out of handlers in registers, storing every def to the stack
 CONFIG_INTEGER(JitInlineSIMDMultiplier, W("JitInlineSIMDMultiplier"), 3)
+CONFIG_INTEGER(JitObjectStackAllocation, W("JitObjectStackAllocation"), 1) // Allocate objects that don't escape the method on the stack
 
 #if defined(FEATURE_ENABLE_NO_RANGE_CHECKS)
 CONFIG_INTEGER(JitNoRngChks, W("JitNoRngChks"), 0) // If 1, don't generate range checks
@@ -407,6 +407,7 @@ void                Compiler::lvaInitThisPtr(InitVarDscInfo *       varDscInfo)
         else
         {
             varDsc->lvType = TYP_REF;
+            lvaSetClass(varDscInfo->varNum, info.compClassHnd);
         }
 
         if (tiVerificationNeeded) 
@@ -1199,6 +1200,17 @@ void                Compiler::lvaInitVarDsc(LclVarDsc *              varDsc,
     {
         varDsc->lvType = type;
     }
+
+    // The declared class of a ref type argument or local holds for every
+    // value stored into it. Only bother looking it up when optimizing.
+    if ((type == TYP_REF) && (varSig != nullptr) && !opts.compDbgCode && !opts.MinOpts())
+    {
+        CORINFO_CLASS_HANDLE clsHnd = info.compCompHnd->getArgClass(varSig, varList);
+        if (clsHnd != nullptr)
+        {
+            lvaSetClass(varNum, clsHnd);
+        }
+    }
     
 #if OPT_BOOL_OPS
     if  (type == TYP_BOOL)
@@ -1914,6 +1926,47 @@ void               Compiler::lvaSetVarDoNotEnregister(unsigned varNum DEBUG_ARG(
 #endif
 }
 
+/*****************************************************************************
+ *
+ *  Record that the local var "varNum" is live in or out of an exception handler.
+ *  Handlers (and the code they return to) can only find the variable in its
+ *  stack home. Where we can, we keep the variable enregistered and have every
+ *  definition also store to the stack home ("write-thru"), so that the home is
+ *  always current; otherwise the variable is not enregistered at all.
+ */
+
+void               Compiler::lvaSetVarLiveInOutOfHandler(unsigned varNum)
+{
+    noway_assert(varNum < lvaCount);
+    LclVarDsc   *   varDsc = &lvaTable[varNum];
+
+#ifndef LEGACY_BACKEND
+    // Parameters and locals live on entry to the method are defined by the prolog,
+    // which doesn't write thru, and GC refs would need to be reported in both
+    // places. Values that need more than one register aren't handled either.
+    if ((JitConfig.JitEnregEHVars() != 0)      &&
+        !opts.MinOpts() && !opts.compDbgCode   &&
+        !varDsc->lvDoNotEnregister             &&
+        !varDsc->lvIsParam                     &&
+        !varDsc->lvIsStructField               &&
+        !varTypeIsGC(varDsc->TypeGet())        &&
+        !varTypeIsStruct(varDsc)               &&
+        !varTypeIsMultiReg(varDsc->TypeGet())  &&
+        varDsc->lvTracked                      &&
+        !VarSetOps::IsMember(this, fgFirstBB->bbLiveIn, varDsc->lvVarIndex))
+    {
+        JITDUMP("Local V%02u is live in/out of a handler, will write thru to its stack home\n", varNum);
+        varDsc->lvEHWriteThru = 1;
+#ifdef DEBUG
+        varDsc->lvLiveInOutOfHndlr = 1;
+#endif
+        return;
+    }
+#endif // !LEGACY_BACKEND
+
+    lvaSetVarDoNotEnregister(varNum DEBUG_ARG(DNER_LiveInOutOfHandler));
+}
+
 /*****************************************************************************
  * Set the lvClass for a local variable of a struct type */
 
@@ -1997,6 +2050,54 @@ void   Compiler::lvaSetStruct(unsigned varNum, CORINFO_CLASS_HANDLE typeHnd, boo
     }
 }
 
+//------------------------------------------------------------------------
+// lvaSetClass: note the class of the objects a TYP_REF local holds
+//
+// Arguments:
+//    varNum  -- the local
+//    clsHnd  -- the class; objects in the local are of this class or one
+//               derived from it
+//    isExact -- true if the objects are known to be exactly of class clsHnd
+//
+// Notes:
+//    The importer uses this to devirtualize calls on the local, so callers
+//    must only set an exact class on a local that holds a single value, or
+//    whose values are all of the same class (see lvHasMultipleILStoreOp).
+
+void   Compiler::lvaSetClass(unsigned varNum, CORINFO_CLASS_HANDLE clsHnd, bool isExact)
+{
+    noway_assert(varNum < lvaCount);
+
+    LclVarDsc *  varDsc = &lvaTable[varNum];
+    assert(varDsc->lvType == TYP_REF);
+
+    varDsc->lvClassHnd     = clsHnd;
+    varDsc->lvClassIsExact = isExact;
+}
+
+//------------------------------------------------------------------------
+// lvaSetClass: note the class of the objects a TYP_REF local holds, from
+//    the tree that computes the value stored into it
+//
+// Arguments:
+//    varNum -- the local
+//    tree   -- the value stored into the local
+//
+// Notes:
+//    Leaves the local alone if nothing is known about the class of the
+//    tree, so that the declared class of the local is kept.
+
+void   Compiler::lvaSetClass(unsigned varNum, GenTreePtr tree)
+{
+    bool                 isExact = false;
+    CORINFO_CLASS_HANDLE clsHnd  = gtGetClassHandle(tree, &isExact);
+
+    if (clsHnd != nullptr)
+    {
+        lvaSetClass(varNum, clsHnd, isExact);
+    }
+}
+
 /*****************************************************************************
  * Returns the array of BYTEs containing the GC layout information
  */
@@ -2687,7 +2687,7 @@ void                Compiler::fgInterBlockLocalVarLiveness()
              VarSetOps::IsMember(this, filterVars, varDsc->lvVarIndex))
         {
             /* Mark the variable appropriately */
-            lvaSetVarDoNotEnregister(varNum DEBUG_ARG(DNER_LiveInOutOfHandler));
+            lvaSetVarLiveInOutOfHandler(varNum);
         }
 
         /* Mark all pointer variables live on exit from a 'finally'
@@ -2696,7 +2696,7 @@ void                Compiler::fgInterBlockLocalVarLiveness()
 
         if  (VarSetOps::IsMember(this, finallyVars, varDsc->lvVarIndex))
         {
-            lvaSetVarDoNotEnregister(varNum DEBUG_ARG(DNER_LiveInOutOfHandler));
+            lvaSetVarLiveInOutOfHandler(varNum);
 
             /* Don't set lvMustInit unless we have a non-arg, GC pointer */
 
@@ -767,6 +767,21 @@ void Lowering::TreeNodeInfoInit(GenTree* stmt)
             info->dstCount = 1;
             break;
 
+        case GT_POPCNT:
+        case GT_LZCNT:
+        case GT_TZCNT:
+        case GT_BSWAP:
+            info->srcCount = 1;
+            info->dstCount = 1;
+            break;
+
+        case GT_PDEP:
+        case GT_PEXT:
+            // The three-operand VEX forms don't tie the target to either source.
+            info->srcCount = 2;
+            info->dstCount = 1;
+            break;
+
         case GT_LSH:
         case GT_RSH:
         case GT_RSZ:
@@ -2131,9 +2146,13 @@ Lowering::TreeNodeInfoInitSIMD(GenTree* tree, LinearScan* lsra)
     case SIMDIntrinsicMax:
         info->srcCount = 2;
 
-        // SSE2 32-bit integer multiplication requires two temp regs
+        // SSE2 32-bit integer multiplication requires two temp regs, and so does the
+        // multiplication of 64-bit and byte integers, which has no instruction at all.
+        // See genSIMDIntrinsicBinOp() for the code sequences generated.
         if (simdTree->gtSIMDIntrinsicID == SIMDIntrinsicMul && 
-            simdTree->gtSIMDBaseType == TYP_INT)
+            (simdTree->gtSIMDBaseType == TYP_INT   || simdTree->gtSIMDBaseType == TYP_UINT  ||
+             simdTree->gtSIMDBaseType == TYP_LONG  || simdTree->gtSIMDBaseType == TYP_ULONG ||
+             simdTree->gtSIMDBaseType == TYP_BYTE  || simdTree->gtSIMDBaseType == TYP_UBYTE))
         {
             info->internalFloatCount = 2;
             info->setInternalCandidates(lsra, lsra->allSIMDRegs());
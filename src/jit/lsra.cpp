@@ -1147,6 +1147,21 @@ LinearScan::setBlockSequence()
         blockInfo[block->bbNum].hasCriticalOutEdge = false;
         blockInfo[block->bbNum].weight = block->bbWeight;
 
+        blockInfo[block->bbNum].hasEHBoundaryIn = (block->bbCatchTyp != BBCT_NONE);
+        for (flowList* pred = block->bbPreds;
+             pred != nullptr;
+             pred = pred->flNext)
+        {
+            BBjumpKinds predJumpKind = pred->flBlock->bbJumpKind;
+            if ((predJumpKind == BBJ_EHFINALLYRET) ||
+                (predJumpKind == BBJ_EHFILTERRET)  ||
+                (predJumpKind == BBJ_EHCATCHRET))
+            {
+                blockInfo[block->bbNum].hasEHBoundaryIn = true;
+                break;
+            }
+        }
+
         if (block->GetUniquePred(compiler) == nullptr)
         {
             for (flowList* pred = block->bbPreds;
@@ -1685,7 +1700,7 @@ LinearScan::identifyCandidatesExceptionDataflow()
         unsigned varNum = compiler->lvaTrackedToVarNum[varIndex];
         LclVarDsc* varDsc = compiler->lvaTable + varNum;
 
-        compiler->lvaSetVarDoNotEnregister(varNum DEBUG_ARG(Compiler::DNER_LiveInOutOfHandler));
+        compiler->lvaSetVarLiveInOutOfHandler(varNum);
 
         if (varTypeIsGC(varDsc))
         {
@@ -1920,6 +1935,11 @@ void LinearScan::identifyCandidates()
         if (varDsc->lvLRACandidate)
             varDsc->lvMustInit = false;
 
+        if (varDsc->lvLRACandidate && varDsc->lvEHWriteThru && (compiler->compHndBBtabCount > 0))
+        {
+            newInt->isWriteThru = true;
+        }
+
         // We maintain two sets of FP vars - those that meet the first threshold of weighted ref Count,
         // and those that meet the second (see the definitions of thresholdFPRefCntWtd and maybeFPRefCntWtd
         // above).
@@ -3770,7 +3790,10 @@ LinearScan::buildIntervals()
                 LclVarDsc *varDsc = compiler->lvaTable + varNum;
                 // Add a dummyDef for any candidate vars that are in the "newLiveIn" set.
                 // If this is the entry block, don't add any incoming parameters (they're handled with ParamDefs).
-                if (isCandidateVar(varDsc) && (predBlock != nullptr || !varDsc->lvIsParam))
+                // A write-thru var is on the stack on entry to a handler or continuation, and is
+                // reloaded at its first use.
+                if (isCandidateVar(varDsc) && (predBlock != nullptr || !varDsc->lvIsParam) &&
+                    !(getIntervalForLocalVar(varNum)->isWriteThru && blockInfo[block->bbNum].hasEHBoundaryIn))
                 {
                     Interval * interval = getIntervalForLocalVar(varNum);
                     RefPosition * pos = newRefPosition(interval, currentLoc, RefTypeDummyDef, nullptr, 
@@ -5593,10 +5616,18 @@ LinearScan::processBlockStartLocations(BasicBlock* currentBlock, bool allocation
         RefPosition* nextRefPosition = interval->getNextRefPosition();
         assert(nextRefPosition != nullptr);
 
+        // Handlers and the code they return to only have the stack home of a write-thru var,
+        // which is always current, so it starts such blocks on the stack.
+        bool writeThruAtEHBoundary = interval->isWriteThru && blockInfo[currentBlock->bbNum].hasEHBoundaryIn;
+
         if (allocationPass)
         {
             targetReg = predVarToRegMap[varIndex];
             INDEBUG(targetReg = rotateBlockStartLocation(interval, targetReg, (~liveRegs | inactiveRegs)));
+            if (writeThruAtEHBoundary)
+            {
+                targetReg = REG_STK;
+            }
             inVarToRegMap[varIndex] = targetReg;
         }
         else // !allocationPass (i.e. resolution/write-back pass)
@@ -5653,9 +5684,10 @@ LinearScan::processBlockStartLocations(BasicBlock* currentBlock, bool allocation
         {
             // This can happen if we are using the locations from a basic block other than the
             // immediately preceding one - where the variable was in a different location.
-            if(targetReg != REG_STK)
+            if(targetReg != REG_STK || writeThruAtEHBoundary)
             {
-                // Unassign it from the register (it will get a new register below).
+                // Unassign it from the register (it will get a new register below, or for a
+                // write-thru var at an EH boundary, be reloaded at its next use).
                 if(interval->assignedReg != nullptr && interval->assignedReg->assignedInterval == interval)
                 {
                     interval->isActive = false;
@@ -6825,6 +6857,13 @@ LinearScan::resolveLocalRef(GenTreePtr treeNode, RefPosition * currentRefPositio
                 }
             }
         }
+        if (interval->isWriteThru && !spillAfter && (currentRefPosition->refType == RefTypeDef) && (treeNode != nullptr))
+        {
+            // Also store the new value to the stack home. Codegen keeps a def of a
+            // write-thru var in its register (see genProduceReg).
+            treeNode->gtFlags |= GTF_SPILL;
+            interval->isSpilled = true;
+        }
         if (spillAfter)
         {
             if (treeNode != nullptr) treeNode->gtFlags |= GTF_SPILL;
@@ -60,6 +60,9 @@ struct LsraBlockInfo
     unsigned int            predBBNum;
     bool                    hasCriticalInEdge;
     bool                    hasCriticalOutEdge;
+    // True for handler entries and for the blocks that handlers return to, where only
+    // the stack homes of the live-in variables are valid.
+    bool                    hasEHBoundaryIn;
 };
 
 // This is sort of a bit mask
@@ -1066,6 +1069,7 @@ public:
         , isSpecialPutArg(false)
         , preferCalleeSave(false)
         , isConstant(false)
+        , isWriteThru(false)
         , physReg(REG_COUNT)
 #ifdef DEBUG
         , intervalIndex(0)
@@ -1135,6 +1139,11 @@ public:
     // able to reuse a constant that's already in a register.
     bool            isConstant : 1;
 
+    // True if this is a lclVar that is live in or out of an exception handler (lvEHWriteThru).
+    // Each def is also stored to the stack home, and the interval is always on the stack on
+    // entry to a block with hasEHBoundaryIn.
+    bool            isWriteThru : 1;
+
     // The register to which it is currently assigned.
     regNumber       physReg;
 
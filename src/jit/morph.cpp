@@ -15063,6 +15063,10 @@ void                Compiler::fgMorph()
     fgDebugCheckBBlist(false, false);
 #endif // DEBUG
 
+    /* Allocate the objects that don't escape on the stack, now that the inlined
+       constructors and methods can be seen */
+    fgStackAllocateObjects();
+
     /* For x64 and ARM64 we need to mark irregular parameters early so that they don't get promoted */
     fgMarkImplicitByRefArgs();
 
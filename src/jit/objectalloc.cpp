@@ -0,0 +1,538 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+//                                    Object Stack Allocation
+//
+// This phase runs in morph, right after inlining, and finds objects allocated by newobj
+// that can't outlive the method that allocates them. Such objects are allocated in a
+// block on the frame instead of on the GC heap.
+//
+// The escape analysis is flow insensitive and conservative. The locals that hold object
+// references are split into groups of locals that are copied to one another. A group
+// escapes if any of its locals is used in any way other than:
+//    - as the object of a field access (but not to take the address of the field)
+//    - as the address of an indirection (e.g. the null check of an inlined "this")
+//    - to be copied to another local of the group
+// or if any of its locals is defined by anything other than a copy from the group or an
+// allocation that can be moved to the stack. The allocations of groups that don't escape
+// are moved to the stack, and the locals of those groups become byrefs.
+//
+// Only objects without GC references are moved, so the frame block never has to be
+// reported to the GC. The byrefs that point to it are reported as usual, and the GC
+// ignores them as they don't point into the heap.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include "jitpch.h"
+#ifdef _MSC_VER
+#pragma hdrstop
+#endif
+
+// Objects larger than this (not counting the object header) stay on the heap
+static const unsigned MAX_STACK_ALLOC_OBJECT_SIZE = 0x100;
+
+struct StackAllocWalkData
+{
+    unsigned    lclCount;   // the number of locals when the analysis started
+    unsigned*   lclGroup;   // union-find forest of the groups of locals
+    bool*       lclEscapes; // whether the local is used in a way that makes its group escape
+    bool*       lclMoved;   // whether the objects of the local's group were moved to the stack
+};
+
+//------------------------------------------------------------------------
+// FindStackAllocGroup: Find the group of a local
+//
+// Arguments:
+//    lclGroup - union-find forest of the groups of locals
+//    lclNum   - the local
+//
+// Return Value:
+//    The local that represents the group
+
+static unsigned FindStackAllocGroup(unsigned* lclGroup, unsigned lclNum)
+{
+    while (lclGroup[lclNum] != lclNum)
+    {
+        lclGroup[lclNum] = lclGroup[lclGroup[lclNum]];
+        lclNum = lclGroup[lclNum];
+    }
+
+    return lclNum;
+}
+
+//------------------------------------------------------------------------
+// fgIsStackAllocLocal: Check whether a local can hold a reference to an
+//    object allocated on the stack
+//
+// Arguments:
+//    lclNum - the local to check
+//
+// Return Value:
+//    true if the local is a TYP_REF local whose every use and definition is
+//    visible in the IR
+
+bool Compiler::fgIsStackAllocLocal(unsigned lclNum)
+{
+    LclVarDsc* varDsc = &lvaTable[lclNum];
+
+    return (varDsc->TypeGet() == TYP_REF) &&
+           !varDsc->lvIsParam             &&
+           !varDsc->lvAddrExposed         &&
+           !varDsc->lvHasLdAddrOp         &&
+           !varDsc->lvPinned;
+}
+
+//------------------------------------------------------------------------
+// fgIsStackAllocCandidate: Check whether a statement allocates an object
+//    that can be moved to the stack if it doesn't escape
+//
+// Arguments:
+//    expr - the root of the statement
+//
+// Return Value:
+//    true if the statement is "lcl = new(cls)", where the class of lcl is
+//    known exactly, the allocation takes the fast helper, and the object has
+//    no GC references and is small.
+
+bool Compiler::fgIsStackAllocCandidate(GenTreePtr expr)
+{
+#if COR_JIT_EE_VERSION > 460
+    if ((expr->gtOper != GT_ASG) || (expr->gtOp.gtOp1->gtOper != GT_LCL_VAR))
+        return false;
+
+    GenTreePtr alloc = expr->gtOp.gtOp2;
+
+    // Objects that need a finalizer, special alignment or allocation tracking,
+    // and large objects, all use the slow helper.
+    if (!alloc->IsHelperCall() || (eeGetHelperNum(alloc->gtCall.gtCallMethHnd) != CORINFO_HELP_NEWSFAST))
+        return false;
+
+    unsigned   lclNum = expr->gtOp.gtOp1->gtLclVarCommon.gtLclNum;
+    LclVarDsc* varDsc = &lvaTable[lclNum];
+
+    if (!fgIsStackAllocLocal(lclNum) || !varDsc->lvClassIsExact || (varDsc->lvClassHnd == NO_CLASS_HANDLE))
+        return false;
+
+    // The only argument is the method table. It becomes the value we store
+    // into the frame block, so it has to be free of side effects (it isn't
+    // when it needs a runtime lookup helper).
+    GenTreeArgList* args = alloc->gtCall.gtCallArgs;
+
+    if ((args == nullptr) || (args->Rest() != nullptr) || (args->Current()->gtFlags & GTF_SIDE_EFFECT))
+        return false;
+
+    CORINFO_CLASS_HANDLE clsHnd = varDsc->lvClassHnd;
+
+    if (info.compCompHnd->getClassAttribs(clsHnd) & CORINFO_FLG_CONTAINS_GC_PTR)
+        return false;
+
+    unsigned objSize = info.compCompHnd->getHeapClassSize(clsHnd);
+
+    return (objSize != 0) && (objSize <= MAX_STACK_ALLOC_OBJECT_SIZE);
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------
+// fgStackAllocEscapeCB: Tree walk callback that records how the locals
+//    that can hold stack objects are used
+//
+// Notes:
+//    The walk has to start at the root of a statement, with computeStack set.
+
+Compiler::fgWalkResult Compiler::fgStackAllocEscapeCB(GenTreePtr* pTree, fgWalkData* data)
+{
+    GenTreePtr tree = *pTree;
+
+    if ((tree->gtOper != GT_LCL_VAR) && (tree->gtOper != GT_LCL_FLD))
+        return WALK_CONTINUE;
+
+    Compiler*           comp      = data->compiler;
+    StackAllocWalkData* allocData = (StackAllocWalkData*)data->pCallbackData;
+    unsigned            lclNum    = tree->gtLclVarCommon.gtLclNum;
+
+    if ((lclNum >= allocData->lclCount) || !comp->fgIsStackAllocLocal(lclNum))
+        return WALK_CONTINUE;
+
+    GenTreeStack* parentStack = data->parentStack;
+    GenTreePtr    parent      = (parentStack->Height() > 1) ? parentStack->Index(1) : nullptr;
+    GenTreePtr    grandParent = (parentStack->Height() > 2) ? parentStack->Index(2) : nullptr;
+    bool          escapes     = true;
+
+    if ((tree->gtOper != GT_LCL_VAR) || (tree->TypeGet() != TYP_REF) || (parent == nullptr))
+    {
+        // Partial accesses and uses as the value of a statement escape
+    }
+    else if (parent->gtOper == GT_ASG)
+    {
+        GenTreePtr dst = parent->gtOp.gtOp1;
+        GenTreePtr src = parent->gtOp.gtOp2;
+
+        if (dst == tree)
+        {
+            if ((src->gtOper == GT_LCL_VAR) &&
+                (src->gtLclVarCommon.gtLclNum < allocData->lclCount) &&
+                comp->fgIsStackAllocLocal(src->gtLclVarCommon.gtLclNum))
+            {
+                unsigned dstGroup = FindStackAllocGroup(allocData->lclGroup, lclNum);
+                unsigned srcGroup = FindStackAllocGroup(allocData->lclGroup, src->gtLclVarCommon.gtLclNum);
+
+                allocData->lclGroup[dstGroup] = srcGroup;
+                escapes = false;
+            }
+            else
+            {
+                // Allocations are only moved when they are statements of their own
+                escapes = (grandParent != nullptr) || !comp->fgIsStackAllocCandidate(parent);
+            }
+        }
+        else
+        {
+            // The copy was already accounted for when the destination was visited
+            escapes = (dst->gtOper != GT_LCL_VAR) ||
+                      (dst->gtLclVarCommon.gtLclNum >= allocData->lclCount) ||
+                      !comp->fgIsStackAllocLocal(dst->gtLclVarCommon.gtLclNum);
+        }
+    }
+    else if (((parent->gtOper == GT_FIELD) && (parent->gtField.gtFldObj == tree)) ||
+             ((parent->gtOper == GT_IND)   && (parent->gtOp.gtOp1 == tree)))
+    {
+        escapes = varTypeIsStruct(parent) || ((grandParent != nullptr) && (grandParent->gtOper == GT_ADDR));
+    }
+
+    if (escapes)
+    {
+        allocData->lclEscapes[lclNum] = true;
+    }
+
+    return WALK_CONTINUE;
+}
+
+//------------------------------------------------------------------------
+// fgStackAllocReadCB: Tree walk callback that looks for a read of a local
+//
+// Notes:
+//    pCallbackData is a StackAllocReadData. The store to the local at the
+//    root of the statement, if any, is not a read.
+
+struct StackAllocReadData
+{
+    unsigned   lclNum; // the local to look for
+    GenTreePtr def;    // the local node stored to by the statement, if it is lclNum
+};
+
+static Compiler::fgWalkResult fgStackAllocReadCB(GenTreePtr* pTree, Compiler::fgWalkData* data)
+{
+    GenTreePtr          tree     = *pTree;
+    StackAllocReadData* readData = (StackAllocReadData*)data->pCallbackData;
+
+    if (((tree->gtOper == GT_LCL_VAR) || (tree->gtOper == GT_LCL_FLD)) &&
+        (tree->gtLclVarCommon.gtLclNum == readData->lclNum) &&
+        (tree != readData->def))
+    {
+        return Compiler::WALK_ABORT;
+    }
+
+    return Compiler::WALK_CONTINUE;
+}
+
+//------------------------------------------------------------------------
+// fgIsStackAllocLocalLiveAfter: Check whether a local may be read after a
+//    statement, before it is assigned again
+//
+// Arguments:
+//    block  - the block of the statement
+//    stmt   - the statement
+//    lclNum - the local
+//
+// Return Value:
+//    true if some path from the end of the statement reads the local before
+//    assigning it, or if the paths can't all be followed
+//
+// Notes:
+//    This runs before the liveness phase, so it follows the flow graph from
+//    the statement itself. Only a statement of the form "lcl = ..." counts as
+//    assigning the local. Exception handlers can read the local too, so a
+//    path that enters a try region is assumed to read it.
+
+bool Compiler::fgIsStackAllocLocalLiveAfter(BasicBlock* block, GenTreeStmt* stmt, unsigned lclNum)
+{
+    ArrayStack<BasicBlock*> pending(this);
+    ArrayStack<BasicBlock*> visited(this);
+    bool                    live = false;
+
+    stmt = stmt->gtNextStmt;
+
+    for (;;)
+    {
+        if (block->hasTryIndex())
+        {
+            live = true;
+            break;
+        }
+
+        bool assigned = false;
+
+        for (; stmt != nullptr; stmt = stmt->gtNextStmt)
+        {
+            GenTreePtr         expr = stmt->gtStmtExpr;
+            StackAllocReadData readData;
+
+            readData.lclNum = lclNum;
+            readData.def    = nullptr;
+
+            if ((expr->gtOper == GT_ASG) &&
+                (expr->gtOp.gtOp1->gtOper == GT_LCL_VAR) &&
+                (expr->gtOp.gtOp1->gtLclVarCommon.gtLclNum == lclNum))
+            {
+                readData.def = expr->gtOp.gtOp1;
+            }
+
+            if (fgWalkTreePre(&stmt->gtStmtExpr, fgStackAllocReadCB, &readData) == WALK_ABORT)
+            {
+                live = true;
+                break;
+            }
+
+            if (readData.def != nullptr)
+            {
+                assigned = true;
+                break;
+            }
+        }
+
+        if (live)
+            break;
+
+        if (!assigned)
+        {
+            for (unsigned i = 0; i < block->NumSucc(this); i++)
+            {
+                BasicBlock* succ = block->GetSucc(i, this);
+
+                if ((succ->bbFlags & BBF_VISITED) == 0)
+                {
+                    succ->bbFlags |= BBF_VISITED;
+                    visited.Push(succ);
+                    pending.Push(succ);
+                }
+            }
+        }
+
+        if (pending.Height() == 0)
+            break;
+
+        block = pending.Pop();
+        stmt  = block->firstStmt();
+    }
+
+    while (visited.Height() != 0)
+    {
+        visited.Pop()->bbFlags &= ~BBF_VISITED;
+    }
+
+    return live;
+}
+
+//------------------------------------------------------------------------
+// fgStackAllocRetypeCB: Tree walk callback that changes the references to
+//    the locals of the moved groups into byrefs
+
+Compiler::fgWalkResult Compiler::fgStackAllocRetypeCB(GenTreePtr* pTree, fgWalkData* data)
+{
+    GenTreePtr          tree      = *pTree;
+    StackAllocWalkData* allocData = (StackAllocWalkData*)data->pCallbackData;
+    GenTreePtr          lcl       = (tree->gtOper == GT_ASG) ? tree->gtOp.gtOp1 : tree;
+
+    if ((lcl->gtOper == GT_LCL_VAR) &&
+        (lcl->gtLclVarCommon.gtLclNum < allocData->lclCount) &&
+        allocData->lclMoved[FindStackAllocGroup(allocData->lclGroup, lcl->gtLclVarCommon.gtLclNum)])
+    {
+        tree->gtType = TYP_BYREF;
+    }
+
+    return WALK_CONTINUE;
+}
+
+//------------------------------------------------------------------------
+// fgStackAllocateObjects: Move the allocations of objects that don't escape
+//    the method to the stack
+//
+// Notes:
+//    Each moved allocation gets a TYP_BLK local laid out like the object
+//    with its header: a zeroed header slot, the method table and the fields.
+//    The allocation statement "lcl = new(cls)" becomes
+//
+//        initblk(&blk, 0, size)
+//        blk[ptrsize] = cls
+//        lcl = &blk + ptrsize
+//
+//    The block is zeroed each time the allocation runs. An allocation in a
+//    loop reuses the same block for every iteration, so an object that a
+//    local of the group may still reference from an earlier iteration would
+//    be clobbered. Groups with an allocation in a loop are therefore only
+//    moved when none of their other locals is live at the allocation.
+
+void Compiler::fgStackAllocateObjects()
+{
+#ifdef DEBUG
+    if  (verbose)
+        printf("*************** In fgStackAllocateObjects()\n");
+#endif // DEBUG
+
+#if COR_JIT_EE_VERSION > 460
+    if (opts.MinOpts() || opts.compDbgCode || opts.IsReadyToRun() || (JitConfig.JitObjectStackAllocation() == 0))
+        return;
+
+    StackAllocWalkData allocData;
+    allocData.lclCount   = lvaCount;
+    allocData.lclGroup   = new (this, CMK_Unknown) unsigned[lvaCount];
+    allocData.lclEscapes = new (this, CMK_Unknown) bool[lvaCount];
+    allocData.lclMoved   = new (this, CMK_Unknown) bool[lvaCount];
+
+    for (unsigned lclNum = 0; lclNum < lvaCount; lclNum++)
+    {
+        allocData.lclGroup[lclNum]   = lclNum;
+        allocData.lclEscapes[lclNum] = false;
+        allocData.lclMoved[lclNum]   = false;
+    }
+
+    ArrayStack<BasicBlock*>  candidateBlocks(this);
+    ArrayStack<GenTreeStmt*> candidateStmts(this);
+
+    for (BasicBlock* block = fgFirstBB; block != nullptr; block = block->bbNext)
+    {
+        for (GenTreeStmt* stmt = block->firstStmt(); stmt != nullptr; stmt = stmt->gtNextStmt)
+        {
+            fgWalkTreePre(&stmt->gtStmtExpr, fgStackAllocEscapeCB, &allocData, false, true);
+
+            if (fgIsStackAllocCandidate(stmt->gtStmtExpr))
+            {
+                candidateBlocks.Push(block);
+                candidateStmts.Push(stmt);
+            }
+        }
+    }
+
+    if (candidateStmts.Height() == 0)
+        return;
+
+    // A group escapes when any of its locals does
+    for (unsigned lclNum = 0; lclNum < allocData.lclCount; lclNum++)
+    {
+        if (allocData.lclEscapes[lclNum])
+        {
+            allocData.lclEscapes[FindStackAllocGroup(allocData.lclGroup, lclNum)] = true;
+        }
+    }
+
+    // A group with an allocation in a loop stays on the heap if another of its
+    // locals is live at the allocation, as it may then still reference the
+    // object of an earlier iteration. The allocation's own local is assigned
+    // by it, so is never live there.
+    for (int i = 0; i < candidateStmts.Height(); i++)
+    {
+        BasicBlock*  block  = candidateBlocks.Index(i);
+        GenTreeStmt* stmt   = candidateStmts.Index(i);
+        unsigned     lclNum = stmt->gtStmtExpr->gtOp.gtOp1->gtLclVarCommon.gtLclNum;
+        unsigned     group  = FindStackAllocGroup(allocData.lclGroup, lclNum);
+
+        if (allocData.lclEscapes[group] || ((block->bbFlags & BBF_BACKWARD_JUMP) == 0))
+            continue;
+
+        for (unsigned otherNum = 0; otherNum < allocData.lclCount; otherNum++)
+        {
+            if ((otherNum != lclNum) &&
+                (FindStackAllocGroup(allocData.lclGroup, otherNum) == group) &&
+                fgIsStackAllocLocalLiveAfter(block, stmt, otherNum))
+            {
+                JITDUMP("V%02u is allocated in a loop where V%02u may still reference it\n", lclNum, otherNum);
+                allocData.lclEscapes[group] = true;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < candidateStmts.Height(); i++)
+    {
+        BasicBlock*  block  = candidateBlocks.Index(i);
+        GenTreeStmt* stmt   = candidateStmts.Index(i);
+        GenTreePtr   asg    = stmt->gtStmtExpr;
+        unsigned     lclNum = asg->gtOp.gtOp1->gtLclVarCommon.gtLclNum;
+        unsigned     group  = FindStackAllocGroup(allocData.lclGroup, lclNum);
+
+        if (allocData.lclEscapes[group])
+            continue;
+
+        CORINFO_CLASS_HANDLE clsHnd  = lvaTable[lclNum].lvClassHnd;
+        unsigned             blkSize = (unsigned)roundUp(TARGET_POINTER_SIZE + info.compCompHnd->getHeapClassSize(clsHnd),
+                                                         TARGET_POINTER_SIZE);
+
+        JITDUMP("Allocating the object stored to V%02u on the stack (%u bytes)\n", lclNum, blkSize);
+
+        unsigned blkNum = lvaGrabTemp(false DEBUGARG("stack allocated object"));
+
+        lvaTable[blkNum].lvType      = TYP_BLK;
+        lvaTable[blkNum].lvExactSize = blkSize;
+        lvaSetVarAddrExposed(blkNum);
+
+        // Zero the block, header included
+        GenTreePtr blkAddr = gtNewOperNode(GT_ADDR, TYP_BYREF, gtNewLclvNode(blkNum, TYP_BLK));
+        GenTreePtr initBlk = gtNewBlkOpNode(GT_INITBLK,
+                                            blkAddr,                // Dest
+                                            gtNewIconNode(0),       // Value
+                                            gtNewIconNode(blkSize), // Size
+                                            false);                 // volatil
+        fgInsertStmtBefore(block, stmt, gtNewStmt(initBlk, stmt->gtStmtILoffsx));
+
+        // Store the method table, which the allocation helper took as its argument
+        GenTreePtr mtField = gtNewLclFldNode(blkNum, TYP_I_IMPL, TARGET_POINTER_SIZE);
+        mtField->gtFlags |= GTF_GLOB_REF;
+
+        GenTreePtr mtStore = gtNewAssignNode(mtField, asg->gtOp.gtOp2->gtCall.gtCallArgs->Current());
+        fgInsertStmtBefore(block, stmt, gtNewStmt(mtStore, stmt->gtStmtILoffsx));
+
+        // The object reference points past the header
+        GenTreePtr objAddr = gtNewOperNode(GT_ADD, TYP_BYREF,
+                                           gtNewOperNode(GT_ADDR, TYP_BYREF, gtNewLclvNode(blkNum, TYP_BLK)),
+                                           gtNewIconNode(TARGET_POINTER_SIZE, TYP_I_IMPL));
+
+        lvaTable[lclNum].lvType = TYP_BYREF;
+        stmt->gtStmtExpr = gtNewTempAssign(lclNum, objAddr);
+
+        allocData.lclMoved[group] = true;
+    }
+
+    // The other locals of the moved groups become byrefs as well
+    bool changed = false;
+
+    for (unsigned lclNum = 0; lclNum < allocData.lclCount; lclNum++)
+    {
+        if (!allocData.lclMoved[FindStackAllocGroup(allocData.lclGroup, lclNum)])
+            continue;
+
+        changed = true;
+
+        if (lvaTable[lclNum].TypeGet() == TYP_REF)
+        {
+            JITDUMP("V%02u now points to an object on the stack\n", lclNum);
+            lvaTable[lclNum].lvType = TYP_BYREF;
+        }
+    }
+
+    if (!changed)
+        return;
+
+    fgWalkAllTreesPre(fgStackAllocRetypeCB, &allocData);
+
+#ifdef DEBUG
+    if (verbose)
+    {
+        printf("\nTrees after stack allocation of objects\n");
+        fgDispBasicBlocks(true);
+    }
+#endif // DEBUG
+#endif // COR_JIT_EE_VERSION
+}
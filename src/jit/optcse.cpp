@@ -2213,6 +2213,10 @@ bool                Compiler::optIsCSEcandidate(GenTreePtr tree)
     case GT_NEG:
     case GT_NOT:
     case GT_CAST:
+    case GT_POPCNT:
+    case GT_LZCNT:
+    case GT_TZCNT:
+    case GT_BSWAP:
         return  true;     // CSE these Unary Operators 
 
     case GT_SUB:
@@ -2227,6 +2231,8 @@ bool                Compiler::optIsCSEcandidate(GenTreePtr tree)
     case GT_RSZ:
     case GT_ROL:
     case GT_ROR:
+    case GT_PDEP:
+    case GT_PEXT:
         return  true;     // CSE these Binary Operators 
 
     case GT_ADD:          // Check for ADDRMODE flag on these Binary Operators 
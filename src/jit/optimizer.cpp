@@ -2701,8 +2701,12 @@ void                Compiler::optUnrollLoops()
     }
 #endif
 
+    // Full unrolling expects the loop heads to still hold the iterator initialization and the
+    // duplicated loop condition, which loop cloning doesn't preserve. Partial unrolling doesn't
+    // depend on the heads, and takes the fast loops that cloning leaves behind.
     if (optCanCloneLoops())
     {
+        optPartialUnrollLoops();
         return;
     }
 
@@ -3159,11 +3163,405 @@ void                Compiler::optUnrollLoops()
 #ifdef  DEBUG
     fgDebugCheckBBlist();
 #endif
+
+    // Now look at the loops whose trip count is too large or not a constant.
+    optPartialUnrollLoops();
 }
 #ifdef _PREFAST_
 #pragma warning(pop)
 #endif
 
+/*****************************************************************************
+ *
+ *  Callback for fgWalkTreePre that aborts the walk at the first range check.
+ */
+
+Compiler::fgWalkResult      Compiler::optFindRangeCheckCB(GenTreePtr *pTree, fgWalkData *data)
+{
+    return ((*pTree)->gtOper == GT_ARR_BOUNDS_CHECK) ? WALK_ABORT : WALK_CONTINUE;
+}
+
+/*****************************************************************************
+ *
+ *  Look for loops whose trip count is too large or not known, and unroll
+ *  them partially.
+ */
+
+void                Compiler::optPartialUnrollLoops()
+{
+    JITDUMP("\n*************** In optPartialUnrollLoops()\n");
+
+    bool change = false;
+
+    for (unsigned lnum = 0; lnum < optLoopCount; lnum++)
+    {
+        if (optPartialUnrollLoop(lnum))
+        {
+            change = true;
+
+            // Looking at the next loop needs the predecessor lists of the new blocks.
+            fgUpdateChangedFlowGraph();
+        }
+    }
+
+#ifdef DEBUG
+    if (change)
+    {
+        if (verbose)
+        {
+            printf("\nAfter partial loop unrolling:\n");
+            fgDispBasicBlocks(/*dumpTrees*/true);
+        }
+        fgDebugCheckBBlist();
+    }
+#endif
+}
+
+//------------------------------------------------------------------------
+// optPartialUnrollLoop: Partially unroll a loop of the loop table.
+//
+// Arguments:
+//    lnum - the index of the loop in the loop table
+//
+// Return Value:
+//    true if the loop was unrolled, false if it isn't a candidate.
+//
+// Notes:
+//    The candidates are innermost "for (i = ...; i < limit; i += stride)" loops, with a
+//    positive constant stride, whose body is a straight line of blocks without calls or
+//    range checks (loop cloning has already removed them on its fast path). The loop
+//
+//        H
+//        T      body(i); i += stride
+//        B  ?-> T  (i < limit)
+//        X
+//
+//    becomes
+//
+//        H
+//        P  ?-> E  (i >= limit - k)
+//        U      body(i); i += stride; ... ('factor' times)
+//           ?-> U  (i < limit - k)
+//        R  ?-> X  (i >= limit)
+//        E
+//        T      body(i); i += stride
+//        B  ?-> T  (i < limit)
+//        X
+//
+//    where k is (factor - 1) * stride, so that U only runs when all of the iterations it
+//    replicates would run. The original loop, entered at T as before, runs the remaining
+//    iterations, and E becomes its head. The factor is chosen from the size of the body
+//    and, when there is profile data, from the number of iterations the loop runs per entry.
+//
+//    Like the slow path of a cloned loop, the unrolled loop isn't added to the loop table.
+//
+bool                Compiler::optPartialUnrollLoop(unsigned lnum)
+{
+    LoopDsc* loop = &optLoopTable[lnum];
+
+    const unsigned requiredFlags = LPFLG_DO_WHILE | LPFLG_ONE_EXIT | LPFLG_ITER;
+
+    if (((loop->lpFlags & requiredFlags) != requiredFlags) ||
+        ((loop->lpFlags & (LPFLG_DONT_UNROLL | LPFLG_REMOVED)) != 0))
+    {
+        return false;
+    }
+
+    BasicBlock* head   = loop->lpHead;
+    BasicBlock* top    = loop->lpTop;
+    BasicBlock* bottom = loop->lpBottom;
+    BasicBlock* exit   = bottom->bbNext;
+
+    // The head must fall into the top of the loop, and the only exit must be at the bottom.
+    if ((loop->lpFirst != top) || (loop->lpEntry != top) || (loop->lpExit != bottom) ||
+        (bottom->bbJumpKind != BBJ_COND) || (bottom->bbJumpDest != top) || (exit == nullptr) ||
+        (head->bbNext != top))
+    {
+        return false;
+    }
+
+    if ((head->bbJumpKind != BBJ_NONE) &&
+        ((head->bbJumpKind != BBJ_COND) || (head->bbJumpDest == top)))
+    {
+        return false;
+    }
+
+    if (!BasicBlock::sameEHRegion(head, top) || bbIsHandlerBeg(exit) || top->isRunRarely())
+    {
+        return false;
+    }
+
+    // The new blocks go before the top, so the loop must not be entered any other way.
+    for (flowList* pred = top->bbPreds; pred != nullptr; pred = pred->flNext)
+    {
+        if ((pred->flBlock != head) && (pred->flBlock != bottom))
+        {
+            return false;
+        }
+    }
+
+    for (unsigned i = 0; i < optLoopCount; i++)
+    {
+        if ((i != lnum) && ((optLoopTable[i].lpFlags & LPFLG_REMOVED) == 0) && (optLoopTable[i].lpFirst == top))
+        {
+            return false;
+        }
+    }
+
+    // The iterator must be an int that only goes up, by a constant, without overflow checks.
+    unsigned   lvar     = loop->lpIterVar();
+    GenTreePtr iterTree = loop->lpIterTree;
+
+    if (lvaTable[lvar].lvAddrExposed || lvaTable[lvar].lvIsStructField)
+    {
+        return false;
+    }
+
+    if (((loop->lpIterOper() != GT_ASG_ADD) && (loop->lpIterOper() != GT_ADD)) ||
+        (loop->lpIterConst() <= 0) ||
+        (loop->lpIterOperType() != TYP_INT) ||
+        iterTree->gtOverflowEx() ||
+        ((iterTree->gtOper == GT_ASG) && iterTree->gtOp.gtOp2->gtOverflowEx()))
+    {
+        return false;
+    }
+
+    // The loop must continue while "i < limit", and that must be the last statement of the bottom.
+    GenTreeStmt* testStmt = bottom->lastStmt();
+
+    if ((loop->lpTestOper() != GT_LT) || ((loop->lpTestTree->gtFlags & GTF_UNSIGNED) != 0) ||
+        (testStmt == nullptr) || (testStmt->gtStmtExpr->gtOper != GT_JTRUE) ||
+        (testStmt->gtStmtExpr->gtOp.gtOp1 != loop->lpTestTree))
+    {
+        return false;
+    }
+
+    // The limit is evaluated ahead of the iterations that the unrolled loop replicates,
+    // so it must not change in the loop, and evaluating it must not throw. Loop cloning
+    // checks that the array of an array length limit isn't null.
+    GenTreePtr limit  = loop->lpLimit();
+    bool       cloned = (loop->lpFlags & LPFLG_CLONED_FAST) != 0;
+
+    if (loop->lpFlags & LPFLG_VAR_LIMIT)
+    {
+        if (lvaTable[loop->lpVarLimit()].lvAddrExposed)
+        {
+            return false;
+        }
+    }
+    else if (loop->lpFlags & LPFLG_ARRLEN_LIMIT)
+    {
+        GenTreePtr arrRef = limit->gtArrLen.ArrRef();
+
+        if (!cloned || (arrRef->gtOper != GT_LCL_VAR) || lvaTable[arrRef->gtLclVarCommon.gtLclNum].lvAddrExposed ||
+            optIsVarAssigned(top, bottom, nullptr, arrRef->gtLclVarCommon.gtLclNum))
+        {
+            return false;
+        }
+    }
+    else if ((loop->lpFlags & LPFLG_CONST_LIMIT) == 0)
+    {
+        return false;
+    }
+
+    // The body must be a straight line of blocks, and we don't unroll around calls and range checks.
+    unsigned loopCostSz = 0;
+    unsigned bodyFlags  = 0;
+
+    for (BasicBlock* block = top; ; block = block->bbNext)
+    {
+        if (((block != bottom) && (block->bbJumpKind != BBJ_NONE)) || !BasicBlock::sameEHRegion(block, top) ||
+            ((block != top) && (bbIsTryBeg(block) || bbIsHandlerBeg(block))))
+        {
+            return false;
+        }
+
+        for (GenTreeStmt* stmt = block->firstStmt(); (stmt != nullptr) && (stmt != testStmt); stmt = stmt->gtNextStmt)
+        {
+            if (((stmt->gtStmtExpr->gtFlags & GTF_CALL) != 0) ||
+                (fgWalkTreePre(&stmt->gtStmtExpr, optFindRangeCheckCB) == WALK_ABORT))
+            {
+                loop->lpFlags |= LPFLG_DONT_UNROLL;
+                return false;
+            }
+
+            gtSetStmtInfo(stmt);
+            loopCostSz += stmt->gtCostSz;
+        }
+
+        bodyFlags |= block->bbFlags;
+
+        if (block == bottom)
+        {
+            break;
+        }
+    }
+
+    /* Pick the unrolling factor from the size of the body */
+
+    static const unsigned PARTIAL_UNROLL_LIMIT_SZ[COUNT_OPT_CODE + 1] =
+    {
+        60,  // BLENDED_CODE
+        0,   // SMALL_CODE
+        120, // FAST_CODE
+        0    // COUNT_OPT_CODE
+    };
+
+    noway_assert(PARTIAL_UNROLL_LIMIT_SZ[    SMALL_CODE] == 0);
+    noway_assert(PARTIAL_UNROLL_LIMIT_SZ[COUNT_OPT_CODE] == 0);
+
+    unsigned unrollLimitSz = PARTIAL_UNROLL_LIMIT_SZ[compCodeOpt()];
+
+#ifdef DEBUG
+    if (compStressCompile(STRESS_UNROLL_LOOPS, 50))
+        unrollLimitSz *= 10;
+#endif
+
+    unsigned factor = 4;
+
+    while ((factor > 1) && (loopCostSz * (factor - 1) > unrollLimitSz))
+    {
+        factor /= 2;
+    }
+
+    // With profile data, don't replicate the body more times than the loop usually runs
+    // for each time it is entered.
+    if (((top->bbFlags & BBF_PROF_WEIGHT) != 0) && ((head->bbFlags & BBF_PROF_WEIGHT) != 0))
+    {
+        unsigned itersPerEntry = top->bbWeight / max(head->bbWeight, 1);
+
+        while ((factor > 1) && (itersPerEntry < 2 * factor))
+        {
+            factor /= 2;
+        }
+    }
+
+    if (factor < 2)
+    {
+        loop->lpFlags |= LPFLG_DONT_UNROLL;
+        return false;
+    }
+
+    __int64 k = (__int64)(factor - 1) * loop->lpIterConst();
+
+    if (k > INT_MAX)
+    {
+        return false;
+    }
+
+    /* Build "i < limit - k", the test of the unrolled loop */
+
+    GenTreePtr unrolledCond;
+
+    if (loop->lpFlags & LPFLG_CONST_LIMIT)
+    {
+        __int64 constLimit = (__int64)loop->lpConstLimit() - k;
+
+        if (constLimit < INT_MIN)
+        {
+            return false;
+        }
+
+        unrolledCond = gtNewOperNode(GT_LT, TYP_INT,
+                                     gtNewLclvNode(lvar, TYP_INT),
+                                     gtNewIconNode((ssize_t)constLimit));
+    }
+    else if (cloned)
+    {
+        // Loop cloning checks that the limit isn't negative, so "limit - k" can't overflow.
+        unrolledCond = gtNewOperNode(GT_LT, TYP_INT,
+                                     gtNewLclvNode(lvar, TYP_INT),
+                                     gtNewOperNode(GT_SUB, TYP_INT, gtCloneExpr(limit), gtNewIconNode((ssize_t)k)));
+    }
+    else
+    {
+        // "limit - k" could overflow, so compare "i + k" and "limit" as longs.
+        GenTreePtr iterPlusK = gtNewOperNode(GT_ADD, TYP_LONG,
+                                             gtNewCastNode(TYP_LONG, gtNewLclvNode(lvar, TYP_INT), TYP_LONG),
+                                             gtNewLconNode(k));
+
+        unrolledCond = gtNewOperNode(GT_LT, TYP_INT,
+                                     iterPlusK,
+                                     gtNewCastNode(TYP_LONG, gtCloneExpr(limit), TYP_LONG));
+    }
+
+    JITDUMP("\nPartially unrolling loop L%02u (BB%02u..BB%02u) %u times, loopCostSz = %u\n",
+            lnum, top->bbNum, bottom->bbNum, factor, loopCostSz);
+
+    /* Create the new blocks, see the picture above */
+
+    BasicBlock* preBlock      = fgNewBBafter(BBJ_COND, head,          /*extendRegion*/true);
+    BasicBlock* unrolledBlock = fgNewBBafter(BBJ_COND, preBlock,      /*extendRegion*/true);
+    BasicBlock* remBlock      = fgNewBBafter(BBJ_COND, unrolledBlock, /*extendRegion*/true);
+    BasicBlock* newHead       = fgNewBBafter(BBJ_NONE, remBlock,      /*extendRegion*/true);
+
+    preBlock->inheritWeight(head);
+    remBlock->inheritWeight(head);
+    newHead->inheritWeight(head);
+    unrolledBlock->inheritWeight(top);
+
+    unrolledBlock->bbFlags |= (bodyFlags & BBF_COMPACT_UPD) | (top->bbFlags & BBF_LOOP_HEAD);
+
+    // These are all in the scope of the surrounding loop, if one exists.
+    preBlock->bbNatLoopNum      = loop->lpParent;
+    unrolledBlock->bbNatLoopNum = loop->lpParent;
+    remBlock->bbNatLoopNum      = loop->lpParent;
+    newHead->bbNatLoopNum       = loop->lpParent;
+
+    preBlock->bbJumpDest      = newHead;
+    unrolledBlock->bbJumpDest = unrolledBlock;
+    remBlock->bbJumpDest      = exit;
+
+    // Replicate the body, increments included, ahead of the test of the unrolled loop.
+    for (unsigned copy = 0; copy < factor; copy++)
+    {
+        for (BasicBlock* block = top; ; block = block->bbNext)
+        {
+            for (GenTreeStmt* stmt = block->firstStmt(); (stmt != nullptr) && (stmt != testStmt); stmt = stmt->gtNextStmt)
+            {
+                fgInsertStmtAtEnd(unrolledBlock, fgNewStmtFromTree(gtCloneExpr(stmt->gtStmtExpr), stmt->gtStmtILoffsx));
+            }
+
+            if (block == bottom)
+            {
+                break;
+            }
+        }
+    }
+
+    GenTreePtr preCond = gtReverseCond(gtCloneExpr(unrolledCond));
+    GenTreePtr remCond = gtNewOperNode(GT_GE, TYP_INT, gtNewLclvNode(lvar, TYP_INT), gtCloneExpr(limit));
+
+    GenTreePtr preStmt      = fgNewStmtFromTree(gtNewOperNode(GT_JTRUE, TYP_VOID, preCond));
+    GenTreePtr unrolledStmt = fgNewStmtFromTree(gtNewOperNode(GT_JTRUE, TYP_VOID, unrolledCond));
+    GenTreePtr remStmt      = fgNewStmtFromTree(gtNewOperNode(GT_JTRUE, TYP_VOID, remCond));
+
+    fgInsertStmtAtEnd(preBlock,      preStmt);
+    fgInsertStmtAtEnd(unrolledBlock, unrolledStmt);
+    fgInsertStmtAtEnd(remBlock,      remStmt);
+
+    fgMorphBlockStmt(preBlock,      preStmt      DEBUGARG("Partial unrolling entry test"));
+    fgMorphBlockStmt(unrolledBlock, unrolledStmt DEBUGARG("Partial unrolling loop test"));
+    fgMorphBlockStmt(remBlock,      remStmt      DEBUGARG("Partial unrolling remainder test"));
+
+    // The original loop now only runs the remaining iterations.
+    for (BasicBlock* block = top; ; block = block->bbNext)
+    {
+        block->modifyBBWeight(block->bbWeight / BB_LOOP_WEIGHT);
+
+        if (block == bottom)
+        {
+            break;
+        }
+    }
+
+    optUpdateLoopHead(lnum, head, newHead);
+    loop->lpFlags &= ~LPFLG_HAS_PREHEAD;
+    loop->lpFlags |= LPFLG_DONT_UNROLL;
+
+    return true;
+}
+
 /*****************************************************************************
  *
  *  Return non-zero if there is a code path from 'topBB' to 'botBB' that will
@@ -4222,6 +4620,14 @@ bool                Compiler::optIsLoopClonable(unsigned loopInd)
         return false;
     }
 
+    // If the profile data says the loop never ran, cloning it would only grow the code.
+    BasicBlock* entry = optLoopTable[loopInd].lpEntry;
+    if ((entry->bbFlags & BBF_PROF_WEIGHT) && entry->isRunRarely())
+    {
+        JITDUMP("Loop cloning: rejecting loop %d because the profile data says its entry block never ran.\n", loopInd);
+        return false;
+    }
+
     // We've previously made a decision whether to have separate return epilogs, or branch to one.
     // There's a GCInfo limitation in the x86 case, so that there can be no more than 4 separate epilogs.
     // (I thought this was x86-specific, but it's not if-d.  On other architectures, the decision should be made as a heuristic tradeoff; 
@@ -4334,6 +4740,10 @@ void                Compiler::optCloneLoops()
             context.OptimizeConditions(i DEBUGARG(verbose));
             context.OptimizeBlockConditions(i DEBUGARG(verbose));
             optCloneLoop(i, &context);
+
+            // The loop left in the loop table is the fast path; partial unrolling relies on its
+            // cloning conditions holding.
+            optLoopTable[i].lpFlags |= LPFLG_CLONED_FAST;
         }
     }
 
@@ -2278,17 +2278,6 @@ GenTreePtr Compiler::impSIMDIntrinsic(OPCODE                   opcode,
             // to some bug, assert in chk/dbg will fire.
             if (!varTypeIsFloating(baseType))
             {
-                if (simdIntrinsicID == SIMDIntrinsicMul)
-                {
-                    if ((baseType != TYP_INT) && (baseType != TYP_SHORT))
-                    {
-                        // TODO-CQ: implement mul on these integer vectors.
-                        // Note that SSE2 has no direct support for these vectors.
-                        assert(!"Mul not supported on long/ulong/uint/small int vectors\n");
-                        return nullptr;
-                    }
-                }
-                
                 // common to all integer type vectors
                 if (simdIntrinsicID == SIMDIntrinsicDiv)
                 {
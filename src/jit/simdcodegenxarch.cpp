@@ -186,13 +186,13 @@ CodeGen::getOpForSIMDIntrinsic(SIMDIntrinsicID intrinsicId,
             {
                 result = INS_mulpd;
             }
-            else if (baseType == TYP_SHORT)
+            else if (baseType == TYP_CHAR || baseType == TYP_SHORT)
             {
                 result = INS_pmullw;
             }
             else if (compiler->canUseAVX())
             {
-                if (baseType == TYP_INT)
+                if (baseType == TYP_INT || baseType == TYP_UINT)
                 {
                     result = INS_pmulld;
                 }
@@ -864,7 +864,7 @@ CodeGen::genSIMDIntrinsicBinOp(GenTreeSIMD* simdNode)
     // whereas SSE4.1 does (pmulld).  This is special cased and computed
     // as follows.
     if (simdNode->gtSIMDIntrinsicID == SIMDIntrinsicMul && 
-        baseType == TYP_INT &&
+        (baseType == TYP_INT || baseType == TYP_UINT) &&
         iset == InstructionSet_SSE2)
     {
         // We need a temporary register that is NOT the same as the target,
@@ -977,6 +977,106 @@ CodeGen::genSIMDIntrinsicBinOp(GenTreeSIMD* simdNode)
         // pack the results into a single vector
         inst_RV_RV(INS_punpckldq, targetReg, tmpReg, targetType, emitActualTypeSize(targetType));
     }
+    else if (simdNode->gtSIMDIntrinsicID == SIMDIntrinsicMul &&
+             (varTypeIsLong(baseType) || varTypeIsByte(baseType)))
+    {
+        // Vector<Long>.Mul and Vector<Byte>.Mul:
+        // Neither SSE2 nor AVX2 has an instruction to perform these operations directly,
+        // so they are computed from the partial products of the multiplications that we
+        // do have, as follows.  None of the instructions used cross the 128-bit lanes, so
+        // the same sequences work for 32-byte vectors.
+        //
+        // We need a temporary register that is NOT the same as the target, and another
+        // one that may be.  The register allocator guarantees that neither of them is the
+        // same as op1Reg or op2Reg, which we never modify unless they are the targetReg.
+        assert(simdNode->gtRsvdRegs != RBM_NONE);
+        assert(genCountBits(simdNode->gtRsvdRegs) == 2);
+
+        regMaskTP tmpRegsMask = simdNode->gtRsvdRegs;
+        regMaskTP tmpReg1Mask = genFindLowestBit(tmpRegsMask);
+        tmpRegsMask &= ~tmpReg1Mask;
+        regNumber tmpReg = genRegNumFromMask(tmpReg1Mask);
+        regNumber tmpReg2 = genRegNumFromMask(tmpRegsMask);
+        if (tmpReg == targetReg)
+        {
+            tmpReg = tmpReg2;
+            tmpReg2 = targetReg;
+        }
+        assert((tmpReg != targetReg) && (tmpReg != op1Reg) && (tmpReg != op2Reg));
+        assert((tmpReg2 != op1Reg) && (tmpReg2 != op2Reg));
+
+        emitAttr attr = emitActualTypeSize(targetType);
+        instruction mulIns;
+
+        if (varTypeIsLong(baseType))
+        {
+            // op1 * op2 = lo(op1) * lo(op2) + ((hi(op1) * lo(op2) + lo(op1) * hi(op2)) << 32)
+            // where lo() and hi() are the lower and upper 32-bits of each element, and pmuludq
+            // computes the 64-bit products of the lower 32-bits of each element.
+
+            // tmpReg = hi(op1) * lo(op2)
+            inst_RV_RV(INS_movaps, tmpReg, op1Reg, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psrlq, attr, tmpReg, 32);
+            inst_RV_RV(INS_pmuludq, tmpReg, op2Reg, targetType, attr);
+
+            // tmpReg2 = lo(op1) * hi(op2)
+            inst_RV_RV(INS_movaps, tmpReg2, op2Reg, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psrlq, attr, tmpReg2, 32);
+            inst_RV_RV(INS_pmuludq, tmpReg2, op1Reg, targetType, attr);
+
+            // tmpReg = (tmpReg + tmpReg2) << 32
+            inst_RV_RV(INS_paddq, tmpReg, tmpReg2, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psllq, attr, tmpReg, 32);
+
+            mulIns = INS_pmuludq;
+        }
+        else
+        {
+            // pmullw computes the lower 16-bits of the products of 16-bit elements, whose lower
+            // 8-bits are the products of the bytes at even positions.  We get the products of
+            // the bytes at odd positions by shifting those down to the even positions first.
+
+            // tmpReg = (odd bytes of op1 * odd bytes of op2) << 8
+            inst_RV_RV(INS_movaps, tmpReg, op1Reg, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psrlw, attr, tmpReg, 8);
+            inst_RV_RV(INS_movaps, tmpReg2, op2Reg, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psrlw, attr, tmpReg2, 8);
+            inst_RV_RV(INS_pmullw, tmpReg, tmpReg2, targetType, attr);
+            getEmitter()->emitIns_R_I(INS_psllw, attr, tmpReg, 8);
+
+            mulIns = INS_pmullw;
+        }
+
+        // targetReg = op1 * op2 using mulIns.
+        // tmpReg2 is no longer needed, so it doesn't matter if it is the targetReg.
+        if (op1Reg == targetReg)
+        {
+            inst_RV_RV(mulIns, targetReg, op2Reg, targetType, attr);
+        }
+        else if (op2Reg == targetReg)
+        {
+            inst_RV_RV(mulIns, targetReg, op1Reg, targetType, attr);
+        }
+        else
+        {
+            inst_RV_RV(INS_movaps, targetReg, op1Reg, targetType, attr);
+            inst_RV_RV(mulIns, targetReg, op2Reg, targetType, attr);
+        }
+
+        if (varTypeIsLong(baseType))
+        {
+            // targetReg = lo(op1) * lo(op2) + tmpReg
+            inst_RV_RV(INS_paddq, targetReg, tmpReg, targetType, attr);
+        }
+        else
+        {
+            // Clear the upper 8-bits of each 16-bit element of targetReg, which leaves the
+            // products of the even bytes, and combine them with the products of the odd bytes.
+            getEmitter()->emitIns_R_I(INS_psllw, attr, targetReg, 8);
+            getEmitter()->emitIns_R_I(INS_psrlw, attr, targetReg, 8);
+            inst_RV_RV(INS_por, targetReg, tmpReg, targetType, attr);
+        }
+    }
     else
     {
         instruction ins = getOpForSIMDIntrinsic(simdNode->gtSIMDIntrinsicID, baseType);
@@ -1986,6 +1986,14 @@ bool ValueNumStore::CanEvalForConstantArgs(VNFunc vnf)
         case GT_MULHI:
             // should be rare, not worth the complexity and risk of getting it wrong
             return false;
+        case GT_POPCNT:
+        case GT_LZCNT:
+        case GT_TZCNT:
+        case GT_BSWAP:
+        case GT_PDEP:
+        case GT_PEXT:
+            // EvalOp doesn't know these; their constant operands are left to the instruction
+            return false;
         default:
             return true;
         }
@@ -61,6 +61,23 @@ namespace System {
         NotApplicable = 4
     }
 
+    // !!!!!!!!!!!!!!!!!!!!!!!
+    // make sure you change the def in gc\gc.h 
+    // if you change this!
+    [Serializable]
+    public enum GCPausePhase
+    {
+        Suspend = 0,
+        MarkRoots = 1,
+        MarkHandles = 2,
+        MarkCards = 3,
+        Plan = 4,
+        Relocate = 5,
+        Compact = 6,
+        Sweep = 7,
+        Resume = 8
+    }
+
     public static class GC 
     {
         [System.Security.SecurityCritical]  // auto-generated
@@ -116,6 +133,116 @@ namespace System {
         [MethodImplAttribute(MethodImplOptions.InternalCall)]
         internal static extern bool IsServerGC();
 
+        // Arena flow support for ExecutionContext: a token for the arena this
+        // thread allocates from (-1 for the GC heap), and a push/pop pair that
+        // makes a captured arena the allocator for the current thread.
+        [System.Security.SecurityCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal static extern int _GetArenaToken();
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal static extern void _PushArena(int arenaToken);
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        internal static extern void _PopArena();
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [DllImport(JitHelpers.QCall, CharSet = CharSet.Unicode), SuppressUnmanagedCodeSecurity]
+        private static extern void _PushNewArena();
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [DllImport(JitHelpers.QCall, CharSet = CharSet.Unicode), SuppressUnmanagedCodeSecurity]
+        private static extern void _PushGCHeap();
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [DllImport(JitHelpers.QCall, CharSet = CharSet.Unicode), SuppressUnmanagedCodeSecurity]
+        private static extern void _ResetArenas();
+
+        // Arenas are heaps that a thread can allocate from instead of the GC
+        // heap, and that are freed as a whole.  Every thread has a stack of
+        // allocators: PushNewArena and PushGCHeap push one, PopArena goes back
+        // to the one below, and ResetArenas empties the stack.  An arena is
+        // freed once it is no longer on any thread's stack.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static void PushNewArena()
+        {
+            _PushNewArena();
+        }
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static void PushGCHeap()
+        {
+            _PushGCHeap();
+        }
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static void PopArena()
+        {
+            _PopArena();
+        }
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static void ResetArenas()
+        {
+            _ResetArenas();
+        }
+
+        // Returns the id of the arena the current thread allocates from, or -1
+        // if it allocates from the GC heap.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int GetCurrentArenaId();
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        private static extern byte[] _AllocatePinnedByteArray(int length);
+
+        // Allocates a byte array on the pinned object heap. The GC never moves
+        // it, so it can be pinned for asynchronous I/O for as long as needed
+        // without getting in the way of compacting the younger generations.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static byte[] AllocatePinnedByteArray(int length)
+        {
+            if (length < 0)
+            {
+                throw new ArgumentOutOfRangeException("length", 
+                        Environment.GetResourceString("ArgumentOutOfRange_NeedNonNegNum"));
+            }
+            Contract.EndContractBlock();
+
+            return _AllocatePinnedByteArray(length);
+        }
+
+        [System.Security.SecurityCritical]  // auto-generated
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        private static extern long _GetPausePhaseHistogram(int phase, long[] buckets);
+
+        // Returns the total time blocking GCs have spent in a phase of their
+        // pause, in microseconds, and fills buckets with how many of them took
+        // a time in each power of two range of microseconds: buckets[0] counts
+        // the times under 2us and buckets[i] the times in [2^i, 2^(i+1)[. The
+        // runtime keeps 24 buckets, the last one also counts everything longer.
+        // A GC only counts in the phases it went through: one that doesn't
+        // compact has no Relocate or Compact time, for example.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        public static long GetPausePhaseHistogram(GCPausePhase phase, long[] buckets)
+        {
+            if ((phase < GCPausePhase.Suspend) || (phase > GCPausePhase.Resume))
+            {
+                throw new ArgumentOutOfRangeException("phase", Environment.GetResourceString("ArgumentOutOfRange_Enum"));
+            }
+
+            if (buckets == null)
+            {
+                throw new ArgumentNullException("buckets");
+            }
+            Contract.EndContractBlock();
+
+            return _GetPausePhaseHistogram((int)phase, buckets);
+        }
+
         [System.Security.SecurityCritical]  // auto-generated
         [DllImport(JitHelpers.QCall, CharSet = CharSet.Unicode), SuppressUnmanagedCodeSecurity]
         private static extern void _AddMemoryPressure(UInt64 bytesAllocated);
@@ -0,0 +1,108 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+/*============================================================
+**
+**
+**
+** Purpose: Bit counting and bit manipulation operations on
+**          unsigned integers
+**
+**
+===========================================================*/
+namespace System.Numerics {
+
+    using System;
+    using System.Runtime;
+    using System.Runtime.CompilerServices;
+    using System.Runtime.ConstrainedExecution;
+
+    // The JIT expands these to the corresponding x64 instructions (popcnt,
+    // lzcnt, tzcnt, bswap, pdep and pext) when the processor supports them,
+    // otherwise they call the runtime's software implementations.
+    public static class BitOperations {
+
+        // Returns the number of bits set in value.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int PopCount(uint value);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int PopCount(ulong value);
+
+        // Returns the number of zero bits above the highest bit set in value,
+        // 32 (or 64) when value is 0.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int LeadingZeroCount(uint value);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int LeadingZeroCount(ulong value);
+
+        // Returns the number of zero bits below the lowest bit set in value,
+        // 32 (or 64) when value is 0.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int TrailingZeroCount(uint value);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern int TrailingZeroCount(ulong value);
+
+        // Returns value with the order of its bytes reversed.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern uint ByteSwap(uint value);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern ulong ByteSwap(ulong value);
+
+        // Returns the low bits of value, in order, moved to the positions of
+        // the bits set in mask. The other bits of the result are 0.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern uint ParallelBitDeposit(uint value, uint mask);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern ulong ParallelBitDeposit(ulong value, ulong mask);
+
+        // Returns the bits of value at the positions of the bits set in mask,
+        // in order, packed into the low bits of the result.
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern uint ParallelBitExtract(uint value, uint mask);
+
+        [System.Security.SecuritySafeCritical]  // auto-generated
+        [CLSCompliant(false)]
+        [ReliabilityContract(Consistency.WillNotCorruptState, Cer.Success)]
+        [MethodImplAttribute(MethodImplOptions.InternalCall)]
+        public static extern ulong ParallelBitExtract(ulong value, ulong mask);
+    }
+}
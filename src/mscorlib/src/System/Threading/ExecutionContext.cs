@@ -64,22 +64,60 @@ namespace System.Threading
         private readonly Dictionary<IAsyncLocal, object> m_localValues;
         private readonly IAsyncLocal[] m_localChangeNotifications;
 
+        // The arena the capturing thread was allocating from (see GC._GetArenaToken),
+        // or -1 for the GC heap.  Run makes it the allocator while the callback runs,
+        // so request-scoped allocations keep going to the arena across awaits.
+        private readonly int m_arenaToken;
+
+        private const int NoArenaToken = -1;
+
         private ExecutionContext()
         {
             m_localValues = new Dictionary<IAsyncLocal, object>();
             m_localChangeNotifications = Array.Empty<IAsyncLocal>();
+            m_arenaToken = NoArenaToken;
         }
 
-        private ExecutionContext(Dictionary<IAsyncLocal, object> localValues, IAsyncLocal[] localChangeNotifications)
+        private ExecutionContext(Dictionary<IAsyncLocal, object> localValues, IAsyncLocal[] localChangeNotifications, int arenaToken)
         {
             m_localValues = localValues;
             m_localChangeNotifications = localChangeNotifications;
+            m_arenaToken = arenaToken;
         }
 
         [SecuritySafeCritical]
         public static ExecutionContext Capture()
         {
-            return t_currentMaybeNull ?? ExecutionContext.Default;
+            ExecutionContext current = t_currentMaybeNull ?? ExecutionContext.Default;
+
+            int arenaToken = GC._GetArenaToken();
+            if (arenaToken == current.m_arenaToken)
+                return current;
+
+            // Back on the GC heap with no locals: hand out the preallocated Default
+            // context (and drop the stale arena-bound copy), so that the
+            // IsPreAllocatedDefault fast paths in Task, ThreadPool and Timer still apply.
+            if (arenaToken == NoArenaToken && current.m_localValues.Count == 0)
+            {
+                t_currentMaybeNull = null;
+                return ExecutionContext.Default;
+            }
+
+            // Remember the arena-bound copy so that further captures in the same
+            // arena scope (one per await) don't allocate again.  The copy outlives
+            // the arena (it is cached here and stored in Tasks), so it has to come
+            // from the GC heap.
+            GC._PushArena(NoArenaToken);
+            try
+            {
+                current = new ExecutionContext(current.m_localValues, current.m_localChangeNotifications, arenaToken);
+            }
+            finally
+            {
+                GC._PopArena();
+            }
+            t_currentMaybeNull = current;
+            return current;
         }
 
         [SecurityCritical]
@@ -87,11 +125,21 @@ namespace System.Threading
         public static void Run(ExecutionContext executionContext, ContextCallback callback, Object state)
         {
             ExecutionContextSwitcher ecsw = default(ExecutionContextSwitcher);
+            bool arenaPushed = false;
             try
             {
                 EstablishCopyOnWriteScope(ref ecsw);
 
                 ExecutionContext.Restore(executionContext);
+
+                // A context captured on the GC heap leaves the allocator alone.
+                if (executionContext.m_arenaToken != NoArenaToken &&
+                    executionContext.m_arenaToken != GC._GetArenaToken())
+                {
+                    GC._PushArena(executionContext.m_arenaToken);
+                    arenaPushed = true;
+                }
+
                 callback(state);
             }
             catch
@@ -100,9 +148,13 @@ namespace System.Threading
                 // to stop the first pass of EH here.  That way we can restore the previous
                 // context before any of our callers' EH filters run.  That means we need to 
                 // end the scope separately in the non-exceptional case below.
+                if (arenaPushed)
+                    GC._PopArena();
                 ecsw.Undo();
                 throw;
             }
+            if (arenaPushed)
+                GC._PopArena();
             ecsw.Undo();
         }
 
@@ -122,7 +174,7 @@ namespace System.Threading
         [SecurityCritical]
         static internal void EstablishCopyOnWriteScope(ref ExecutionContextSwitcher ecsw)
         {
-            ecsw.m_ec = Capture();
+            ecsw.m_ec = t_currentMaybeNull ?? ExecutionContext.Default;
             ecsw.m_sc = SynchronizationContext.CurrentNoFlow;
         }
 
@@ -195,35 +247,47 @@ namespace System.Threading
                 return;
 
             //
-            // Allocate a new Dictionary containing a copy of the old values, plus the new value.  We have to do this manually to 
-            // minimize allocations of IEnumerators, etc.
+            // The new context is the thread's current one and flows with every later capture, so it can
+            // outlive the arena the thread is allocating from; build it on the GC heap.
             //
-            Dictionary<IAsyncLocal, object> newValues = new Dictionary<IAsyncLocal, object>(current.m_localValues.Count + (hadPreviousValue ? 0 : 1));
+            GC._PushArena(NoArenaToken);
+            try
+            {
+                //
+                // Allocate a new Dictionary containing a copy of the old values, plus the new value.  We have to do this manually to 
+                // minimize allocations of IEnumerators, etc.
+                //
+                Dictionary<IAsyncLocal, object> newValues = new Dictionary<IAsyncLocal, object>(current.m_localValues.Count + (hadPreviousValue ? 0 : 1));
 
-            foreach (KeyValuePair<IAsyncLocal, object> pair in current.m_localValues)
-                newValues.Add(pair.Key, pair.Value);
+                foreach (KeyValuePair<IAsyncLocal, object> pair in current.m_localValues)
+                    newValues.Add(pair.Key, pair.Value);
 
-            newValues[local] = newValue;
+                newValues[local] = newValue;
 
-            //
-            // Either copy the change notification array, or create a new one, depending on whether we need to add a new item.
-            //
-            IAsyncLocal[] newChangeNotifications = current.m_localChangeNotifications;
-            if (needChangeNotifications)
-            {
-                if (hadPreviousValue)
-                {
-                    Contract.Assert(Array.IndexOf(newChangeNotifications, local) >= 0);
-                }
-                else
+                //
+                // Either copy the change notification array, or create a new one, depending on whether we need to add a new item.
+                //
+                IAsyncLocal[] newChangeNotifications = current.m_localChangeNotifications;
+                if (needChangeNotifications)
                 {
-                    int newNotificationIndex = newChangeNotifications.Length;
-                    Array.Resize(ref newChangeNotifications, newNotificationIndex + 1);
-                    newChangeNotifications[newNotificationIndex] = local;
+                    if (hadPreviousValue)
+                    {
+                        Contract.Assert(Array.IndexOf(newChangeNotifications, local) >= 0);
+                    }
+                    else
+                    {
+                        int newNotificationIndex = newChangeNotifications.Length;
+                        Array.Resize(ref newChangeNotifications, newNotificationIndex + 1);
+                        newChangeNotifications[newNotificationIndex] = local;
+                    }
                 }
-            }
 
-            t_currentMaybeNull = new ExecutionContext(newValues, newChangeNotifications);
+                t_currentMaybeNull = new ExecutionContext(newValues, newChangeNotifications, current.m_arenaToken);
+            }
+            finally
+            {
+                GC._PopArena();
+            }
 
             if (needChangeNotifications)
             {
@@ -76,6 +76,17 @@ Function :
 --*/
 void MsgBoxCleanup( void );
 
+/*++
+Function :
+    CGroupInitialize
+
+    Finds the memory and cpu cgroups of the process so that their limits
+    can be read by PAL_GetRestrictedPhysicalMemoryLimit, PAL_GetCpuLimit
+    and GlobalMemoryStatusEx.
+
+--*/
+void CGroupInitialize( void );
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
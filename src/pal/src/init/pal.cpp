@@ -255,6 +255,10 @@ Initialize(
             goto CLEANUP0;
         }
 
+        // Find the cgroups of the process before anything sizes itself
+        // from the memory or processor count.
+        CGroupInitialize();
+
 #if _DEBUG
         // Verify that our page size is what we think it is. If it's
         // different, we can't run.
@@ -0,0 +1,640 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+/*++
+
+
+
+Module Name:
+
+    cgroup.cpp
+
+Abstract:
+
+    Reads the memory and CPU limits imposed on the process by Linux
+    control groups (cgroup v1 and v2), so that the runtime sizes itself
+    to the container it runs in rather than to the host.
+
+
+
+--*/
+
+#include "pal/palinternal.h"
+#include "pal/dbgmsg.h"
+#include "pal/misc.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+SET_DEFAULT_DEBUG_CHANNEL(MISC);
+
+// The PAL tests set this to a directory laid out like /proc (with
+// self/mountinfo and self/cgroup) to run against a fake cgroup tree.
+#define PAL_CGROUP_PROC_ROOT_VAR    "PAL_CGROUP_PROC_ROOT"
+#define PROC_ROOT                   "/proc"
+#define PROC_MOUNTINFO_FILENAME     "/self/mountinfo"
+#define PROC_CGROUP_FILENAME        "/self/cgroup"
+#define PROC_STATM_FILENAME         "/self/statm"
+
+#define CGROUP1_MEMORY_LIMIT_FILENAME   "/memory.limit_in_bytes"
+#define CGROUP1_MEMORY_USAGE_FILENAME   "/memory.usage_in_bytes"
+#define CGROUP1_MEMORY_INACTIVE_FILE    "total_inactive_file"
+#define CGROUP1_CFS_QUOTA_FILENAME      "/cpu.cfs_quota_us"
+#define CGROUP1_CFS_PERIOD_FILENAME     "/cpu.cfs_period_us"
+
+#define CGROUP2_MEMORY_LIMIT_FILENAME   "/memory.max"
+#define CGROUP2_MEMORY_USAGE_FILENAME   "/memory.current"
+#define CGROUP2_MEMORY_INACTIVE_FILE    "inactive_file"
+#define CGROUP2_CPU_MAX_FILENAME        "/cpu.max"
+
+#define CGROUP_MEMORY_STAT_FILENAME     "/memory.stat"
+
+#define CGROUP2_CONTROLLERS_FILENAME    "/cgroup.controllers"
+
+class CGroup
+{
+    enum CGroupVersion
+    {
+        CGROUP_NONE = 0,
+        CGROUP_V1   = 1,
+        CGROUP_V2   = 2,
+    };
+
+    static CGroupVersion s_version;
+
+    // Directories of the memory and cpu cgroups of this process. They are
+    // found once and kept for the lifetime of the process.
+    static char *s_memory_cgroup_path;
+    static char *s_cpu_cgroup_path;
+
+    static char s_proc_root[MAX_PATH];
+
+public:
+    static void Initialize()
+    {
+        const char *procRoot = ::getenv(PAL_CGROUP_PROC_ROOT_VAR);
+        if (procRoot == nullptr || strlen(procRoot) >= sizeof(s_proc_root))
+        {
+            procRoot = PROC_ROOT;
+        }
+        strcpy(s_proc_root, procRoot);
+
+        s_version = FindVersion();
+        if (s_version == CGROUP_NONE)
+        {
+            return;
+        }
+
+        s_memory_cgroup_path = FindCGroupPath(IsMemorySubsystem);
+        s_cpu_cgroup_path = FindCGroupPath(IsCpuSubsystem);
+
+        TRACE("cgroup v%d, memory cgroup '%s', cpu cgroup '%s'\n",
+              s_version,
+              s_memory_cgroup_path != nullptr ? s_memory_cgroup_path : "",
+              s_cpu_cgroup_path != nullptr ? s_cpu_cgroup_path : "");
+    }
+
+    static bool GetPhysicalMemoryLimit(size_t *val)
+    {
+        if (s_memory_cgroup_path == nullptr)
+            return false;
+
+        // "max" (v2) fails to parse, v1 reports a huge value when there is
+        // no limit, which the caller compares with the physical memory.
+        return ReadMemoryValueFromFile(
+            s_version == CGROUP_V2 ? CGROUP2_MEMORY_LIMIT_FILENAME : CGROUP1_MEMORY_LIMIT_FILENAME,
+            val);
+    }
+
+    static bool GetPhysicalMemoryUsage(size_t *val)
+    {
+        if (s_memory_cgroup_path == nullptr)
+            return false;
+
+        size_t usage;
+        if (!ReadMemoryValueFromFile(
+                s_version == CGROUP_V2 ? CGROUP2_MEMORY_USAGE_FILENAME : CGROUP1_MEMORY_USAGE_FILENAME,
+                &usage))
+        {
+            return false;
+        }
+
+        // The usage includes the page cache, inactive file pages are the
+        // first thing the kernel reclaims so don't count them.
+        size_t inactiveFile;
+        if (ReadMemoryStatValue(
+                s_version == CGROUP_V2 ? CGROUP2_MEMORY_INACTIVE_FILE : CGROUP1_MEMORY_INACTIVE_FILE,
+                &inactiveFile) &&
+            inactiveFile < usage)
+        {
+            usage -= inactiveFile;
+        }
+
+        *val = usage;
+        return true;
+    }
+
+    static bool GetCpuLimit(UINT *val)
+    {
+        if (s_cpu_cgroup_path == nullptr)
+            return false;
+
+        long long quota;
+        long long period;
+
+        if (s_version == CGROUP_V2)
+        {
+            // "<quota> <period>", with "max" as the quota when unlimited
+            char *line = ReadFirstLine(s_cpu_cgroup_path, CGROUP2_CPU_MAX_FILENAME);
+            if (line == nullptr)
+                return false;
+
+            int fields = sscanf(line, "%lld %lld", &quota, &period);
+            free(line);
+            if (fields != 2)
+                return false;
+        }
+        else
+        {
+            if (!ReadLongLongValueFromFile(s_cpu_cgroup_path, CGROUP1_CFS_QUOTA_FILENAME, &quota) ||
+                !ReadLongLongValueFromFile(s_cpu_cgroup_path, CGROUP1_CFS_PERIOD_FILENAME, &period))
+            {
+                return false;
+            }
+        }
+
+        // A quota of -1 (v1) means no limit
+        if (quota <= 0 || period <= 0)
+            return false;
+
+        // Round up, a quota of 1.5 CPUs can keep 2 threads busy part of the time
+        long long cpuCount = (quota + period - 1) / period;
+        if (cpuCount > UINT_MAX)
+            return false;
+
+        *val = (UINT)cpuCount;
+        return true;
+    }
+
+    static bool GetResidentSetSize(size_t *val)
+    {
+        char *line = ReadFirstLine(s_proc_root, PROC_STATM_FILENAME);
+        if (line == nullptr)
+            return false;
+
+        // The second field is the resident set size in pages
+        unsigned long long residentPages;
+        int fields = sscanf(line, "%*s %llu", &residentPages);
+        free(line);
+        if (fields != 1)
+            return false;
+
+        *val = (size_t)(residentPages * sysconf(_SC_PAGE_SIZE));
+        return true;
+    }
+
+private:
+    static CGroupVersion FindVersion()
+    {
+        // cgroup v1 controllers are mounted as "cgroup", the unified v2
+        // hierarchy as "cgroup2". Hybrid systems mount both, a controller
+        // is only in one of them. Use v2 there if the memory controller
+        // has been moved to it, v1 otherwise.
+        bool foundV1 = false;
+        char *v2MountPoint = nullptr;
+        CGroupVersion version = CGROUP_NONE;
+
+        char *line = nullptr;
+        size_t lineLen = 0;
+        FILE *mountInfo = OpenProcFile(PROC_MOUNTINFO_FILENAME);
+        if (mountInfo == nullptr)
+            return CGROUP_NONE;
+
+        while (getline(&line, &lineLen, mountInfo) != -1)
+        {
+            char *mountPoint;
+            char *fsType;
+            if (!ParseMountInfoLine(line, nullptr, &mountPoint, &fsType, nullptr))
+                continue;
+
+            if (strcmp(fsType, "cgroup") == 0)
+            {
+                foundV1 = true;
+            }
+            else if (strcmp(fsType, "cgroup2") == 0 && v2MountPoint == nullptr)
+            {
+                v2MountPoint = strdup(mountPoint);
+            }
+        }
+
+        free(line);
+        fclose(mountInfo);
+
+        if (v2MountPoint != nullptr)
+        {
+            if (!foundV1 || V2HasController(v2MountPoint, IsMemorySubsystem))
+                version = CGROUP_V2;
+            free(v2MountPoint);
+        }
+
+        if (version == CGROUP_NONE && foundV1)
+            version = CGROUP_V1;
+
+        return version;
+    }
+
+    // Returns true if the space separated list of controllers in the
+    // cgroup.controllers file of the v2 hierarchy contains the subsystem.
+    static bool V2HasController(const char *mountPoint, bool (*isSubsystem)(const char *))
+    {
+        char *controllers = ReadFirstLine(mountPoint, CGROUP2_CONTROLLERS_FILENAME);
+        if (controllers == nullptr)
+            return false;
+
+        bool found = false;
+        char *context = nullptr;
+        for (char *token = strtok_r(controllers, " \n", &context); !found && token != nullptr; token = strtok_r(nullptr, " \n", &context))
+        {
+            found = isSubsystem(token);
+        }
+
+        free(controllers);
+        return found;
+    }
+
+    static bool IsMemorySubsystem(const char *subsystem)
+    {
+        return strcmp(subsystem, "memory") == 0;
+    }
+
+    static bool IsCpuSubsystem(const char *subsystem)
+    {
+        return strcmp(subsystem, "cpu") == 0;
+    }
+
+    // Returns true if the comma separated list contains a subsystem matching isSubsystem.
+    static bool ListContainsSubsystem(char *list, bool (*isSubsystem)(const char *))
+    {
+        char *context = nullptr;
+        for (char *token = strtok_r(list, ",", &context); token != nullptr; token = strtok_r(nullptr, ",", &context))
+        {
+            if (isSubsystem(token))
+                return true;
+        }
+
+        return false;
+    }
+
+    // Splits a line of /proc/self/mountinfo in place:
+    //   36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+    //   (1)(2)(3)   (4)   (5)      (6)      (7)   (8) (9)   (10)         (11)
+    // root is field 4, the mount point field 5, the file system type field 9
+    // and the super options field 11. The optional fields (7) end with "-".
+    static bool ParseMountInfoLine(char *line, char **root, char **mountPoint, char **fsType, char **superOptions)
+    {
+        char *context = nullptr;
+        char *field = strtok_r(line, " \n", &context);
+        for (int i = 1; field != nullptr && i < 4; i++)
+        {
+            field = strtok_r(nullptr, " \n", &context);
+        }
+        if (field == nullptr)
+            return false;
+        if (root != nullptr)
+            *root = field;
+
+        field = strtok_r(nullptr, " \n", &context);
+        if (field == nullptr)
+            return false;
+        if (mountPoint != nullptr)
+            *mountPoint = field;
+
+        do
+        {
+            field = strtok_r(nullptr, " \n", &context);
+        }
+        while (field != nullptr && strcmp(field, "-") != 0);
+
+        field = strtok_r(nullptr, " \n", &context);
+        if (field == nullptr)
+            return false;
+        *fsType = field;
+
+        // skip the mount source
+        if (strtok_r(nullptr, " \n", &context) == nullptr)
+            return false;
+
+        field = strtok_r(nullptr, " \n", &context);
+        if (field == nullptr)
+            return false;
+        if (superOptions != nullptr)
+            *superOptions = field;
+
+        return true;
+    }
+
+    // Finds where the hierarchy containing the subsystem is mounted, returns
+    // the mount point and the root of the mount within the hierarchy.
+    static bool FindHierarchyMount(bool (*isSubsystem)(const char *), char **mountPointRef, char **mountRootRef)
+    {
+        bool found = false;
+        char *line = nullptr;
+        size_t lineLen = 0;
+        FILE *mountInfo = OpenProcFile(PROC_MOUNTINFO_FILENAME);
+        if (mountInfo == nullptr)
+            return false;
+
+        while (!found && getline(&line, &lineLen, mountInfo) != -1)
+        {
+            char *root;
+            char *mountPoint;
+            char *fsType;
+            char *superOptions;
+            if (!ParseMountInfoLine(line, &root, &mountPoint, &fsType, &superOptions))
+                continue;
+
+            if (s_version == CGROUP_V2)
+            {
+                // All the controllers share the unified hierarchy
+                found = strcmp(fsType, "cgroup2") == 0;
+            }
+            else
+            {
+                found = strcmp(fsType, "cgroup") == 0 && ListContainsSubsystem(superOptions, isSubsystem);
+            }
+
+            if (found)
+            {
+                *mountPointRef = strdup(mountPoint);
+                *mountRootRef = strdup(root);
+                if (*mountPointRef == nullptr || *mountRootRef == nullptr)
+                {
+                    free(*mountPointRef);
+                    free(*mountRootRef);
+                    found = false;
+                    break;
+                }
+            }
+        }
+
+        free(line);
+        fclose(mountInfo);
+        return found;
+    }
+
+    // Finds the path of the cgroup of this process within the hierarchy
+    // containing the subsystem, from /proc/self/cgroup:
+    //   v1: 4:memory:/docker/1234     v2: 0::/user.slice/foo.scope
+    static char *FindCGroupPathInHierarchy(bool (*isSubsystem)(const char *))
+    {
+        char *result = nullptr;
+        char *line = nullptr;
+        size_t lineLen = 0;
+        FILE *cgroupFile = OpenProcFile(PROC_CGROUP_FILENAME);
+        if (cgroupFile == nullptr)
+            return nullptr;
+
+        while (result == nullptr && getline(&line, &lineLen, cgroupFile) != -1)
+        {
+            char *subsystems = strchr(line, ':');
+            if (subsystems == nullptr)
+                continue;
+            subsystems++;
+
+            char *path = strchr(subsystems, ':');
+            if (path == nullptr)
+                continue;
+            *path++ = '\0';
+
+            char *newline = strchr(path, '\n');
+            if (newline != nullptr)
+                *newline = '\0';
+
+            bool matches = (s_version == CGROUP_V2) ?
+                (line[0] == '0' && *subsystems == '\0') :
+                ListContainsSubsystem(subsystems, isSubsystem);
+            if (matches)
+            {
+                result = strdup(path);
+            }
+        }
+
+        free(line);
+        fclose(cgroupFile);
+        return result;
+    }
+
+    static char *FindCGroupPath(bool (*isSubsystem)(const char *))
+    {
+        char *mountPoint = nullptr;
+        char *mountRoot = nullptr;
+        char *cgroupPath = nullptr;
+        char *result = nullptr;
+
+        if (!FindHierarchyMount(isSubsystem, &mountPoint, &mountRoot))
+            goto done;
+
+        cgroupPath = FindCGroupPathInHierarchy(isSubsystem);
+        if (cgroupPath == nullptr)
+            goto done;
+
+        {
+            // Inside a container the hierarchy is usually mounted at the
+            // cgroup of the container, so the part of the cgroup path that
+            // is the mount root must not be appended again.
+            const char *relativePath = cgroupPath;
+            size_t mountRootLen = strlen(mountRoot);
+            if (strcmp(mountRoot, "/") != 0 &&
+                strncmp(cgroupPath, mountRoot, mountRootLen) == 0 &&
+                (cgroupPath[mountRootLen] == '/' || cgroupPath[mountRootLen] == '\0'))
+            {
+                relativePath = cgroupPath + mountRootLen;
+            }
+            if (strcmp(relativePath, "/") == 0)
+            {
+                relativePath = "";
+            }
+
+            size_t len = strlen(mountPoint) + strlen(relativePath) + 1;
+            result = (char *)malloc(len);
+            if (result != nullptr)
+            {
+                strcpy(result, mountPoint);
+                strcat(result, relativePath);
+            }
+        }
+
+    done:
+        free(mountPoint);
+        free(mountRoot);
+        free(cgroupPath);
+        return result;
+    }
+
+    static FILE *OpenProcFile(const char *filename)
+    {
+        char path[MAX_PATH];
+        if (snprintf(path, sizeof(path), "%s%s", s_proc_root, filename) >= (int)sizeof(path))
+            return nullptr;
+
+        return fopen(path, "r");
+    }
+
+    // Returns the first line of directory/filename, to be freed by the caller.
+    static char *ReadFirstLine(const char *directory, const char *filename)
+    {
+        char path[MAX_PATH];
+        if (snprintf(path, sizeof(path), "%s%s", directory, filename) >= (int)sizeof(path))
+            return nullptr;
+
+        FILE *file = fopen(path, "r");
+        if (file == nullptr)
+            return nullptr;
+
+        char *line = nullptr;
+        size_t lineLen = 0;
+        if (getline(&line, &lineLen, file) == -1)
+        {
+            free(line);
+            line = nullptr;
+        }
+
+        fclose(file);
+        return line;
+    }
+
+    static bool ReadLongLongValueFromFile(const char *directory, const char *filename, long long *val)
+    {
+        char *line = ReadFirstLine(directory, filename);
+        if (line == nullptr)
+            return false;
+
+        int fields = sscanf(line, "%lld", val);
+        free(line);
+        return fields == 1;
+    }
+
+    static bool ReadMemoryValueFromFile(const char *filename, size_t *val)
+    {
+        char *line = ReadFirstLine(s_memory_cgroup_path, filename);
+        if (line == nullptr)
+            return false;
+
+        unsigned long long value;
+        int fields = sscanf(line, "%llu", &value);
+        free(line);
+        if (fields != 1)
+            return false;
+
+        *val = (size_t)value;
+        return true;
+    }
+
+    // Reads a "<name> <value>" line of memory.stat
+    static bool ReadMemoryStatValue(const char *name, size_t *val)
+    {
+        char path[MAX_PATH];
+        if (snprintf(path, sizeof(path), "%s%s", s_memory_cgroup_path, CGROUP_MEMORY_STAT_FILENAME) >= (int)sizeof(path))
+            return false;
+
+        FILE *file = fopen(path, "r");
+        if (file == nullptr)
+            return false;
+
+        bool found = false;
+        size_t nameLen = strlen(name);
+        char *line = nullptr;
+        size_t lineLen = 0;
+        while (!found && getline(&line, &lineLen, file) != -1)
+        {
+            unsigned long long value;
+            if (strncmp(line, name, nameLen) == 0 && line[nameLen] == ' ' &&
+                sscanf(line + nameLen + 1, "%llu", &value) == 1)
+            {
+                *val = (size_t)value;
+                found = true;
+            }
+        }
+
+        free(line);
+        fclose(file);
+        return found;
+    }
+};
+
+CGroup::CGroupVersion CGroup::s_version = CGroup::CGROUP_NONE;
+char *CGroup::s_memory_cgroup_path = nullptr;
+char *CGroup::s_cpu_cgroup_path = nullptr;
+char CGroup::s_proc_root[MAX_PATH];
+
+void CGroupInitialize()
+{
+    CGroup::Initialize();
+}
+
+/*++
+Function:
+  PAL_GetRestrictedPhysicalMemoryLimit
+
+Returns the memory limit of the cgroup of the process, or 0 if there is no
+limit or it is not smaller than the physical memory of the machine.
+--*/
+size_t
+PALAPI
+PAL_GetRestrictedPhysicalMemoryLimit()
+{
+    size_t physicalMemoryLimit;
+    if (!CGroup::GetPhysicalMemoryLimit(&physicalMemoryLimit))
+        return 0;
+
+    // cgroup v1 reports a value close to the maximum when there is no limit
+    unsigned long long physicalMemory = (unsigned long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGE_SIZE);
+    if (physicalMemoryLimit >= physicalMemory)
+        return 0;
+
+    return physicalMemoryLimit;
+}
+
+/*++
+Function:
+  PAL_GetPhysicalMemoryUsed
+
+Returns the memory used by the cgroup of the process, or the resident set
+size of the process when it is not in a memory cgroup.
+--*/
+BOOL
+PALAPI
+PAL_GetPhysicalMemoryUsed(size_t* val)
+{
+    if (val == nullptr)
+    {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    if (CGroup::GetPhysicalMemoryUsage(val))
+        return TRUE;
+
+    return CGroup::GetResidentSetSize(val);
+}
+
+/*++
+Function:
+  PAL_GetCpuLimit
+
+Returns the number of CPUs the CFS quota of the cgroup of the process
+allows it to keep busy, rounded up. Returns FALSE if there is no quota.
+--*/
+BOOL
+PALAPI
+PAL_GetCpuLimit(UINT* val)
+{
+    if (val == nullptr)
+    {
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    return CGroup::GetCpuLimit(val);
+}
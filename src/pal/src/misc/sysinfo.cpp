@@ -294,6 +294,26 @@ GlobalMemoryStatusEx(
 #endif // __APPLE__
     }
 
+    // When the process is in a memory cgroup (ie, a container), the limit of
+    // the cgroup is the physical memory it can use.
+    size_t physical_memory_limit = PAL_GetRestrictedPhysicalMemoryLimit();
+    if (physical_memory_limit != 0 && physical_memory_limit < lpBuffer->ullTotalPhys)
+    {
+        lpBuffer->ullTotalPhys = physical_memory_limit;
+
+        size_t used_memory;
+        if (PAL_GetPhysicalMemoryUsed(&used_memory))
+        {
+            used_memory = min(used_memory, physical_memory_limit);
+            lpBuffer->ullAvailPhys = physical_memory_limit - used_memory;
+            lpBuffer->dwMemoryLoad = (DWORD)(((UINT64)used_memory * 100) / physical_memory_limit);
+        }
+        else
+        {
+            lpBuffer->ullAvailPhys = min(lpBuffer->ullAvailPhys, (DWORDLONG)physical_memory_limit);
+        }
+    }
+
     // There is no API to get the total virtual address space size on 
     // Unix, so we use a constant value representing 128TB, which is 
     // the approximate size of total user virtual address space on
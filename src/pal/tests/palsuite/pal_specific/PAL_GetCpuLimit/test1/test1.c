@@ -0,0 +1,381 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+/*=============================================================
+**
+** Source: test1.c
+**
+** Purpose: Positive test for the cgroup limits read by the PAL.
+**          Builds a fake cgroup v1 tree, a fake cgroup v2 tree and
+**          a hybrid tree with the controllers on v2, then starts
+**          this test again with PAL_CGROUP_PROC_ROOT
+**          pointing at each of them and checks, in the child, that
+**          PAL_GetCpuLimit, PAL_GetRestrictedPhysicalMemoryLimit,
+**          PAL_GetPhysicalMemoryUsed and GlobalMemoryStatusEx
+**          report the limits of the fake cgroups.
+**
+** Dependencies: PAL_Initialize
+**               PAL_Terminate
+**               GetCurrentDirectoryA
+**               CreateDirectoryA
+**               RemoveDirectoryA
+**               DeleteFileA
+**               SetEnvironmentVariableA
+**               CreateProcessA
+**               WaitForSingleObject
+**               GetExitCodeProcess
+**
+**============================================================*/
+#include <palsuite.h>
+
+#define MEMORY_LIMIT        (100 * 1024 * 1024)
+#define MEMORY_USAGE        (50 * 1024 * 1024)
+#define MEMORY_INACTIVE     (10 * 1024 * 1024)
+#define EXPECTED_USED       (MEMORY_USAGE - MEMORY_INACTIVE)
+#define EXPECTED_LOAD       ((EXPECTED_USED * 100) / MEMORY_LIMIT)
+
+// 1.5 CPUs worth of quota, rounded up
+#define CPU_QUOTA           150000
+#define CPU_PERIOD          100000
+#define EXPECTED_CPU_LIMIT  2
+
+#define MAX_CREATED         64
+
+static char createdPaths[MAX_CREATED][_MAX_PATH];
+static BOOL createdIsDirectory[MAX_CREATED];
+static int createdCount = 0;
+
+static void Cleanup()
+{
+    while (createdCount > 0)
+    {
+        createdCount--;
+        if (createdIsDirectory[createdCount])
+        {
+            RemoveDirectoryA(createdPaths[createdCount]);
+        }
+        else
+        {
+            DeleteFileA(createdPaths[createdCount]);
+        }
+    }
+}
+
+static void Remember(const char *path, BOOL isDirectory)
+{
+    if (createdCount == MAX_CREATED)
+    {
+        Cleanup();
+        Fail("ERROR: too many files in the fake cgroup tree\n");
+    }
+
+    strcpy(createdPaths[createdCount], path);
+    createdIsDirectory[createdCount] = isDirectory;
+    createdCount++;
+}
+
+static void MakeDirectory(const char *path)
+{
+    if (!CreateDirectoryA(path, NULL))
+    {
+        DWORD dwError = GetLastError();
+        Cleanup();
+        Fail("ERROR: CreateDirectoryA(%s) failed with error %u\n", path, dwError);
+    }
+
+    Remember(path, TRUE);
+}
+
+static void MakeFile(const char *path, const char *contents)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        Cleanup();
+        Fail("ERROR: could not create %s\n", path);
+    }
+
+    Remember(path, FALSE);
+
+    fprintf(file, "%s", contents);
+    fclose(file);
+}
+
+// Runs this test with "child" as argument and the fake /proc as PAL_CGROUP_PROC_ROOT.
+static void RunChild(const char *exePath, const char *procRoot)
+{
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    DWORD dwExitCode;
+    char commandLine[_MAX_PATH * 2];
+
+    if (!SetEnvironmentVariableA("PAL_CGROUP_PROC_ROOT", procRoot))
+    {
+        Cleanup();
+        Fail("ERROR: SetEnvironmentVariableA failed with error %u\n", GetLastError());
+    }
+
+    sprintf(commandLine, "%s child", exePath);
+
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    ZeroMemory(&pi, sizeof(pi));
+
+    if (!CreateProcessA(NULL, commandLine, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi))
+    {
+        DWORD dwError = GetLastError();
+        Cleanup();
+        Fail("ERROR: CreateProcessA(%s) failed with error %u\n", commandLine, dwError);
+    }
+
+    WaitForSingleObject(pi.hProcess, INFINITE);
+
+    if (!GetExitCodeProcess(pi.hProcess, &dwExitCode))
+    {
+        dwExitCode = FAIL;
+    }
+
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+
+    if (dwExitCode != PASS)
+    {
+        Cleanup();
+        Fail("ERROR: the child process failed with the fake cgroups in %s\n", procRoot);
+    }
+}
+
+// Checks the limits of the fake cgroups, runs in the child process.
+static int CheckLimits()
+{
+    UINT cpuLimit = 0;
+    size_t memoryLimit;
+    size_t memoryUsed = 0;
+    MEMORYSTATUSEX memoryStatus;
+
+    if (!PAL_GetCpuLimit(&cpuLimit) || cpuLimit != EXPECTED_CPU_LIMIT)
+    {
+        Trace("ERROR: PAL_GetCpuLimit returned %u, expected %u\n", cpuLimit, EXPECTED_CPU_LIMIT);
+        return FAIL;
+    }
+
+    memoryLimit = PAL_GetRestrictedPhysicalMemoryLimit();
+    if (memoryLimit != MEMORY_LIMIT)
+    {
+        Trace("ERROR: PAL_GetRestrictedPhysicalMemoryLimit returned %llu, expected %u\n",
+              (unsigned long long)memoryLimit, MEMORY_LIMIT);
+        return FAIL;
+    }
+
+    if (!PAL_GetPhysicalMemoryUsed(&memoryUsed) || memoryUsed != EXPECTED_USED)
+    {
+        Trace("ERROR: PAL_GetPhysicalMemoryUsed returned %llu, expected %u\n",
+              (unsigned long long)memoryUsed, EXPECTED_USED);
+        return FAIL;
+    }
+
+    memoryStatus.dwLength = sizeof(memoryStatus);
+    if (!GlobalMemoryStatusEx(&memoryStatus))
+    {
+        Trace("ERROR: GlobalMemoryStatusEx failed\n");
+        return FAIL;
+    }
+
+    if (memoryStatus.ullTotalPhys != MEMORY_LIMIT ||
+        memoryStatus.ullAvailPhys != MEMORY_LIMIT - EXPECTED_USED ||
+        memoryStatus.dwMemoryLoad != EXPECTED_LOAD)
+    {
+        Trace("ERROR: GlobalMemoryStatusEx returned total %llu, available %llu, load %u\n",
+              memoryStatus.ullTotalPhys, memoryStatus.ullAvailPhys, memoryStatus.dwMemoryLoad);
+        return FAIL;
+    }
+
+    return PASS;
+}
+
+static void TestCGroupV1(const char *exePath, const char *baseDir)
+{
+    char root[_MAX_PATH];
+    char path[_MAX_PATH];
+    char contents[_MAX_PATH * 3];
+
+    sprintf(root, "%s/cgroup_v1", baseDir);
+    MakeDirectory(root);
+
+    sprintf(path, "%s/proc", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/proc/self", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/proc/self/mountinfo", root);
+    sprintf(contents,
+            "25 1 8:1 / / rw,relatime - ext4 /dev/sda1 rw\n"
+            "30 25 0:26 / %s/memory rw,nosuid shared:12 - cgroup cgroup rw,memory\n"
+            "31 25 0:27 / %s/cpu rw,nosuid shared:13 - cgroup cgroup rw,cpu,cpuacct\n",
+            root, root);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc/self/cgroup", root);
+    MakeFile(path, "4:memory:/test\n3:cpu,cpuacct:/test\n1:name=systemd:/test\n");
+
+    sprintf(path, "%s/memory", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/memory/test", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/memory/test/memory.limit_in_bytes", root);
+    sprintf(contents, "%u\n", MEMORY_LIMIT);
+    MakeFile(path, contents);
+    sprintf(path, "%s/memory/test/memory.usage_in_bytes", root);
+    sprintf(contents, "%u\n", MEMORY_USAGE);
+    MakeFile(path, contents);
+    sprintf(path, "%s/memory/test/memory.stat", root);
+    sprintf(contents, "cache 0\ninactive_file 1\ntotal_inactive_file %u\n", MEMORY_INACTIVE);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/cpu", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/cpu/test", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/cpu/test/cpu.cfs_quota_us", root);
+    sprintf(contents, "%u\n", CPU_QUOTA);
+    MakeFile(path, contents);
+    sprintf(path, "%s/cpu/test/cpu.cfs_period_us", root);
+    sprintf(contents, "%u\n", CPU_PERIOD);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc", root);
+    RunChild(exePath, path);
+}
+
+static void TestCGroupV2(const char *exePath, const char *baseDir)
+{
+    char root[_MAX_PATH];
+    char path[_MAX_PATH];
+    char contents[_MAX_PATH * 3];
+
+    sprintf(root, "%s/cgroup_v2", baseDir);
+    MakeDirectory(root);
+
+    sprintf(path, "%s/proc", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/proc/self", root);
+    MakeDirectory(path);
+
+    // The unified hierarchy is mounted at the cgroup of the container
+    sprintf(path, "%s/proc/self/mountinfo", root);
+    sprintf(contents,
+            "25 1 8:1 / / rw,relatime - ext4 /dev/sda1 rw\n"
+            "30 25 0:26 /test %s/unified rw,nosuid shared:4 - cgroup2 cgroup2 rw,nsdelegate\n",
+            root);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc/self/cgroup", root);
+    MakeFile(path, "0::/test\n");
+
+    sprintf(path, "%s/unified", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/unified/memory.max", root);
+    sprintf(contents, "%u\n", MEMORY_LIMIT);
+    MakeFile(path, contents);
+    sprintf(path, "%s/unified/memory.current", root);
+    sprintf(contents, "%u\n", MEMORY_USAGE);
+    MakeFile(path, contents);
+    sprintf(path, "%s/unified/memory.stat", root);
+    sprintf(contents, "anon 0\nfile 0\ninactive_file %u\n", MEMORY_INACTIVE);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/unified/cpu.max", root);
+    sprintf(contents, "%u %u\n", CPU_QUOTA, CPU_PERIOD);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc", root);
+    RunChild(exePath, path);
+}
+
+// A hybrid system mounts both versions. The memory and cpu controllers
+// have been moved to the unified hierarchy, only the systemd hierarchy is
+// left on v1, so the limits are read from v2.
+static void TestCGroupHybrid(const char *exePath, const char *baseDir)
+{
+    char root[_MAX_PATH];
+    char path[_MAX_PATH];
+    char contents[_MAX_PATH * 3];
+
+    sprintf(root, "%s/cgroup_hybrid", baseDir);
+    MakeDirectory(root);
+
+    sprintf(path, "%s/proc", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/proc/self", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/proc/self/mountinfo", root);
+    sprintf(contents,
+            "25 1 8:1 / / rw,relatime - ext4 /dev/sda1 rw\n"
+            "29 25 0:25 / %s/systemd rw,nosuid shared:3 - cgroup cgroup rw,xattr,name=systemd\n"
+            "30 25 0:26 / %s/unified rw,nosuid shared:4 - cgroup2 cgroup2 rw,nsdelegate\n",
+            root, root);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc/self/cgroup", root);
+    MakeFile(path, "1:name=systemd:/test\n0::/test\n");
+
+    sprintf(path, "%s/unified", root);
+    MakeDirectory(path);
+    sprintf(path, "%s/unified/cgroup.controllers", root);
+    MakeFile(path, "cpu io memory pids\n");
+    sprintf(path, "%s/unified/test", root);
+    MakeDirectory(path);
+
+    sprintf(path, "%s/unified/test/memory.max", root);
+    sprintf(contents, "%u\n", MEMORY_LIMIT);
+    MakeFile(path, contents);
+    sprintf(path, "%s/unified/test/memory.current", root);
+    sprintf(contents, "%u\n", MEMORY_USAGE);
+    MakeFile(path, contents);
+    sprintf(path, "%s/unified/test/memory.stat", root);
+    sprintf(contents, "anon 0\nfile 0\ninactive_file %u\n", MEMORY_INACTIVE);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/unified/test/cpu.max", root);
+    sprintf(contents, "%u %u\n", CPU_QUOTA, CPU_PERIOD);
+    MakeFile(path, contents);
+
+    sprintf(path, "%s/proc", root);
+    RunChild(exePath, path);
+}
+
+int __cdecl main(int argc, char *argv[])
+{
+    char baseDir[_MAX_PATH];
+
+    if (0 != PAL_Initialize(argc, argv))
+    {
+        return FAIL;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "child") == 0)
+    {
+        int result = CheckLimits();
+        PAL_Terminate();
+        return result;
+    }
+
+    if (GetCurrentDirectoryA(_MAX_PATH, baseDir) == 0)
+    {
+        Fail("ERROR: GetCurrentDirectoryA failed with error %u\n", GetLastError());
+    }
+
+    TestCGroupV1(argv[0], baseDir);
+    TestCGroupV2(argv[0], baseDir);
+    TestCGroupHybrid(argv[0], baseDir);
+
+    Cleanup();
+
+    PAL_Terminate();
+    return PASS;
+}
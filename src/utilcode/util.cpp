@@ -1242,8 +1242,18 @@ int GetCurrentProcessCpuCount()
 
     SYSTEM_INFO sysInfo;
     ::GetSystemInfo(&sysInfo);
-    cCPUs = sysInfo.dwNumberOfProcessors;
-    return sysInfo.dwNumberOfProcessors;
+    int count = sysInfo.dwNumberOfProcessors;
+
+#ifdef FEATURE_PAL
+    // The CPU quota of the cgroup (ie, of the container) caps how many
+    // processors the process can keep busy.
+    UINT cpuLimit;
+    if (PAL_GetCpuLimit(&cpuLimit) && cpuLimit < (UINT)count)
+        count = cpuLimit;
+#endif // FEATURE_PAL
+
+    cCPUs = count;
+    return count;
 
 #endif // !FEATURE_CORESYSTEM
 }
@@ -54,6 +54,12 @@ ASMCONSTANTS_C_ASSERT(ASM_ELEMENT_TYPE_R8 == ELEMENT_TYPE_R8);
 ASMCONSTANTS_C_ASSERT(ASM_CLRTASKHOSTED   == CLRTASKHOSTED);
 #endif
 
+// Same default as card_byte_shift in gc/gc.h, the write barriers shift the
+// destination address by it to find the card byte.
+#ifndef GC_CARD_BYTE_SHIFT
+#define               GC_CARD_BYTE_SHIFT      0xB
+#endif
+
 #define METHODDESC_REGNUM                    10
 #define METHODDESC_REGISTER                 r10
 
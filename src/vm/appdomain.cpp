@@ -5099,6 +5099,10 @@ void AppDomain::Init()
 
 	m_dwIndex = SystemDomain::GetNewAppDomainIndex(this);
 
+#ifdef FEATURE_TIERED_COMPILATION
+	m_tieredCompilationManager.Init(GetId());
+#endif
+
 #ifndef CROSSGEN_COMPILE
 	PerAppDomainTPCountList::SetAppDomainId(m_tpIndex, m_dwId);
 
@@ -5320,6 +5324,10 @@ void AppDomain::Stop()
 	GetMulticoreJitManager().StopProfile(true);
 #endif
 
+#ifdef FEATURE_TIERED_COMPILATION
+	GetTieredCompilationManager()->OnAppDomainShutdown();
+#endif
+
 	// Set the unloaded flag before notifying the debugger
 	GetLoaderAllocator()->SetIsUnloaded();
 
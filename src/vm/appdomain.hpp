@@ -39,6 +39,11 @@
 #include "multicorejit.h"
 #endif
 
+#ifdef FEATURE_TIERED_COMPILATION
+#include "tieredcompilation.h"
+#include "callcounter.h"
+#endif
+
 #ifdef FEATURE_COMINTEROP
 #include "clrprivbinderwinrt.h"
 #ifndef FEATURE_CORECLR
@@ -3927,6 +3932,27 @@ public:
 
 #endif
 
+#ifdef FEATURE_TIERED_COMPILATION
+
+private:
+    TieredCompilationManager m_tieredCompilationManager;
+    CallCounter m_callCounter;
+
+public:
+    TieredCompilationManager * GetTieredCompilationManager()
+    {
+        LIMITED_METHOD_CONTRACT;
+        return &m_tieredCompilationManager;
+    }
+
+    CallCounter * GetCallCounter()
+    {
+        LIMITED_METHOD_CONTRACT;
+        return &m_callCounter;
+    }
+
+#endif // FEATURE_TIERED_COMPILATION
+
 #ifdef FEATURE_COMINTEROP
 
 private:
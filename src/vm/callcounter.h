@@ -0,0 +1,83 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+// ===========================================================================
+// File: CallCounter.h
+//
+// ===========================================================================
+
+
+#ifndef CALL_COUNTER_H
+#define CALL_COUNTER_H
+
+#ifdef FEATURE_TIERED_COMPILATION
+
+// One entry in our dictionary mapping methods to the number of times they
+// have been invoked
+struct CallCounterEntry
+{
+    CallCounterEntry() {}
+    CallCounterEntry(const MethodDesc* m, const int c)
+        : pMethod(m), callCount(c) {}
+
+    const MethodDesc* pMethod;
+    int callCount;
+};
+
+class CallCounterEntryHashTraits : public DefaultSHashTraits<CallCounterEntry>
+{
+public:
+    typedef typename DefaultSHashTraits<CallCounterEntry>::element_t element_t;
+    typedef typename DefaultSHashTraits<CallCounterEntry>::count_t count_t;
+
+    typedef const MethodDesc* key_t;
+
+    static key_t GetKey(element_t e)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return e.pMethod;
+    }
+    static BOOL Equals(key_t k1, key_t k2)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return k1 == k2;
+    }
+    static count_t Hash(key_t k)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return (count_t)(size_t)k;
+    }
+
+    static const element_t Null() { LIMITED_METHOD_CONTRACT; return element_t(NULL, 0); }
+    static bool IsNull(const element_t &e) { LIMITED_METHOD_CONTRACT; return e.pMethod == NULL; }
+};
+
+typedef SHash<NoRemoveSHashTraits<CallCounterEntryHashTraits> > CallCounterHash;
+
+
+// CallCounter is the tier-0 half of tiered compilation. Methods eligible for
+// tiering (see code:MethodDesc::IsEligibleForTieredCompilation) keep their
+// precode pointed at the prestub while they run tier-0 code, so that every call
+// is counted here. Once a method is hot the counter hands it to the
+// code:TieredCompilationManager and lets the prestub backpatch the precode.
+class CallCounter
+{
+public:
+#if defined(DACCESS_COMPILE) || defined(CROSSGEN_COMPILE)
+    CallCounter() {}
+#else
+    CallCounter();
+#endif
+
+    BOOL OnMethodCalled(MethodDesc* pMethodDesc);
+
+private:
+
+    // fields protected by lock
+    SpinLock m_lock;
+    CallCounterHash m_methodToCallCount;
+};
+
+#endif // FEATURE_TIERED_COMPILATION
+
+#endif // CALL_COUNTER_H
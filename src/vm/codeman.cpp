@@ -1173,6 +1173,7 @@ EEJitManager::EEJitManager()
 #endif
 
     m_dwCPUCompileFlags = 0;
+    m_dwCPUFeatures = 0;
 
     m_cleanupList = NULL;
 }
@@ -1227,6 +1228,7 @@ void EEJitManager::SetCpuInfo()
     //
 
     DWORD dwCPUCompileFlags = 0;
+    DWORD dwCPUFeatures = 0;
 
 #if defined(_TARGET_X86_)
     // NOTE: if you're adding any flags here, you probably should also be doing it
@@ -1274,7 +1276,16 @@ void EEJitManager::SetCpuInfo()
         //    AVX2 - EBX bit 5     (buffer[4]  & 0x20)
         // CORJIT_FLG_USE_AVX_512 is not currently set, but defined so that it can be used in future without
         // synchronously updating VM and JIT.
+        // We will also set the following bits of the CPU features reported by getEEInfo:
+        // CORINFO_CPU_FEATURE_POPCNT if POPCNT - ECX bit 23 is set (input EAX of 1) (buffer[10] & 0x80)
+        // CORINFO_CPU_FEATURE_LZCNT  if ABM - ECX bit 5 is set (input EAX of 0x80000001) (buffer[8] & 0x20)
+        // CORINFO_CPU_FEATURE_BMI1   if BMI1 - EBX bit 3 is set (input EAX of 0x07 and input ECX of 0) (buffer[4] & 0x08)
+        // CORINFO_CPU_FEATURE_BMI2   if BMI2 - EBX bit 8 is set (input EAX of 0x07 and input ECX of 0) (buffer[5] & 0x01)
         (void) getcpuid(1, buffer);
+        if ((buffer[10] & 0x80) != 0)               // POPCNT
+        {
+            dwCPUFeatures |= CORINFO_CPU_FEATURE_POPCNT;
+        }
         // If SSE2 is not enabled, there is no point in checking the rest.
         // SSE2 is bit 26 of EDX   (buffer[15] & 0x04)
         // TODO: Determine whether we should break out the various SSE options further.
@@ -1311,10 +1322,36 @@ void EEJitManager::SetCpuInfo()
                 dwCPUCompileFlags |= CORJIT_FLG_FEATURE_SIMD;
             }
         }
+
+        // The general purpose register extensions don't depend on the OS saving any
+        // extended state, so they are checked independently of SSE and AVX.
+        if (maxCpuId >= 0x07)
+        {
+            (void) getcpuid(0x07, buffer);
+            if ((buffer[4] & 0x08) != 0)            // BMI1
+            {
+                dwCPUFeatures |= CORINFO_CPU_FEATURE_BMI1;
+            }
+            if ((buffer[5] & 0x01) != 0)            // BMI2
+            {
+                dwCPUFeatures |= CORINFO_CPU_FEATURE_BMI2;
+            }
+        }
+
+        DWORD maxExtendedCpuId = getcpuid(0x80000000, buffer);
+        if (maxExtendedCpuId >= 0x80000001)
+        {
+            (void) getcpuid(0x80000001, buffer);
+            if ((buffer[8] & 0x20) != 0)            // ABM (LZCNT)
+            {
+                dwCPUFeatures |= CORINFO_CPU_FEATURE_LZCNT;
+            }
+        }
     }
 #endif // defined(_TARGET_AMD64_)
 
     m_dwCPUCompileFlags = dwCPUCompileFlags;
+    m_dwCPUFeatures = dwCPUFeatures;
 }
 
 // Define some data that we can use to get a better idea of what happened when we get a Watson dump that indicates the JIT failed to load.
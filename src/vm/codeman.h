@@ -1110,6 +1110,7 @@ public:
 
 private:
     DWORD               m_dwCPUCompileFlags;
+    DWORD               m_dwCPUFeatures;        // CorInfoCpuFeatures
 
 #if !defined CROSSGEN_COMPILE && !defined DACCESS_COMPILE
     void SetCpuInfo();
@@ -1122,6 +1123,12 @@ public:
         return m_dwCPUCompileFlags;
     }
 
+    inline DWORD GetCPUFeatures()
+    {
+        LIMITED_METHOD_CONTRACT;
+        return m_dwCPUFeatures;
+    }
+
 private :
     PTR_HostCodeHeap    m_cleanupList;
     //When EH Clauses are resolved we need to atomically update the TypeHandle
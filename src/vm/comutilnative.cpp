@@ -1759,11 +1759,6 @@ FCIMPL2(int, GCInterface::CollectionCount, INT32 generation, INT32 getSpecialGCC
 {
 	FCALL_CONTRACT;
 
-	if (generation == 99)
-	{
-		return ::ArenaManager::GetArenaId();
-	}
-
 	//We've already checked this in GC.cs, so we'll just assert it here.
 	_ASSERTE(generation >= 0);
 
@@ -1914,6 +1909,154 @@ FCIMPL0(int, GCInterface::GetMaxGeneration)
 FCIMPLEND
 
 
+/*==============================GetCurrentArenaId===============================
+**Action: Returns the id of the arena this thread allocates from
+**Returns: The arena id, or -1 if this thread allocates from the GC heap
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+FCIMPL0(int, GCInterface::GetCurrentArenaId)
+{
+	FCALL_CONTRACT;
+
+	return ::ArenaManager::GetArenaId();
+}
+FCIMPLEND
+
+/*================================PushNewArena==================================
+**Action: Creates a new arena and makes it the allocator for this thread until
+**        the matching PopArena
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+void QCALLTYPE GCInterface::PushNewArena()
+{
+	QCALL_CONTRACT;
+
+	BEGIN_QCALL;
+	::ArenaManager::PushNewArena();
+	END_QCALL;
+}
+
+/*=================================PushGCHeap===================================
+**Action: Makes the GC heap the allocator for this thread until the matching
+**        PopArena
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+void QCALLTYPE GCInterface::PushGCHeap()
+{
+	QCALL_CONTRACT;
+
+	BEGIN_QCALL;
+	::ArenaManager::PushGC();
+	END_QCALL;
+}
+
+/*================================ResetArenas===================================
+**Action: Pops every allocator pushed on this thread, so that it allocates from
+**        the GC heap again
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+void QCALLTYPE GCInterface::ResetArenas()
+{
+	QCALL_CONTRACT;
+
+	BEGIN_QCALL;
+	::ArenaManager::ResetArenas();
+	END_QCALL;
+}
+
+/*================================GetArenaToken=================================
+**Action: Returns a token identifying the arena currently used for allocation
+**        by this thread, so that it can flow with the ExecutionContext
+**Returns: The arena token, or -1 if this thread allocates from the GC heap
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+FCIMPL0(int, GCInterface::GetArenaToken)
+{
+	FCALL_CONTRACT;
+
+	return ::ArenaManager::GetArenaToken();
+}
+FCIMPLEND
+
+/*==================================PushArena===================================
+**Action: Makes the arena identified by token (as returned by GetArenaToken on
+**        any thread) the allocator for this thread, or the GC heap if the token
+**        is -1 or the arena no longer exists.
+**Arguments: token -- The arena token
+**Exceptions: None
+==============================================================================*/
+FCIMPL1(void, GCInterface::PushArena, INT32 token)
+{
+	FCALL_CONTRACT;
+
+	::ArenaManager::PushArenaToken(token);
+}
+FCIMPLEND
+
+/*===================================PopArena===================================
+**Action: Restores the allocator in use before the matching PushArena
+**Arguments: None
+**Exceptions: None
+==============================================================================*/
+FCIMPL0(void, GCInterface::PopArena)
+{
+	FCALL_CONTRACT;
+
+	::ArenaManager::Pop();
+}
+FCIMPLEND
+
+/*===========================AllocatePinnedByteArray============================
+**Action: Allocates a byte array on the pinned object heap. The GC never moves
+**        it, so it can stay pinned for I/O without blocking compaction.
+**Returns: The new array
+**Arguments: length -- The number of elements, checked by the caller
+**Exceptions: OutOfMemoryException
+==============================================================================*/
+FCIMPL1(Object*, GCInterface::AllocatePinnedByteArray, INT32 length)
+{
+	FCALL_CONTRACT;
+
+	// Checked by the caller
+	_ASSERTE(length >= 0);
+
+	OBJECTREF array = NULL;
+
+	HELPER_METHOD_FRAME_BEGIN_RET_1(array);
+	array = AllocatePinnedPrimitiveArray(ELEMENT_TYPE_U1, (DWORD)length);
+	HELPER_METHOD_FRAME_END();
+
+	return OBJECTREFToObject(array);
+}
+FCIMPLEND
+
+/*============================GetPausePhaseHistogram============================
+**Action: Copies the histogram of the time blocking GCs spent in a pause phase
+**Returns: The total time spent in the phase, in microseconds
+**Arguments: phase -- A gc_pause_phase, checked by the caller
+**           bucketsUNSAFE -- Receives as many buckets as it has room for
+**Exceptions: None
+==============================================================================*/
+FCIMPL2(INT64, GCInterface::GetPausePhaseHistogram, INT32 phase, I8Array* bucketsUNSAFE)
+{
+	FCALL_CONTRACT;
+
+	// Checked by the caller
+	_ASSERTE((phase >= 0) && (phase < max_pause_phase));
+	_ASSERTE(bucketsUNSAFE != NULL);
+
+	// Nothing here can trigger a GC, the array can't move
+	uint64_t* buckets = (uint64_t*)bucketsUNSAFE->GetDirectPointerToNonObjectElements();
+	return (INT64)GCHeap::GetGCHeap()->GetPausePhaseHistogram(phase, buckets, (int)bucketsUNSAFE->GetNumComponents());
+}
+FCIMPLEND
+
+
 /*==============================SuppressFinalize================================
 **Action: Indicate that an object's finalizer should not be run by the system
 **Arguments: Object of interest
@@ -1999,14 +2142,12 @@ FORCEINLINE UINT64 GCInterface::InterlockedSub(UINT64 *pMinuend, UINT64 subtrahe
 
 void QCALLTYPE GCInterface::_AddMemoryPressure(UINT64 bytesAllocated)
 {
-	// Hack- overloading an exiting API for a completely new purpose
-	::ArenaManager::SetAllocator((int)bytesAllocated);
-	//QCALL_CONTRACT;
+	QCALL_CONTRACT;
 
-	//// AddMemoryPressure could cause a GC, so we need a frame 
-	//BEGIN_QCALL;
-	//AddMemoryPressure(bytesAllocated);
-	//END_QCALL;
+	// AddMemoryPressure could cause a GC, so we need a frame 
+	BEGIN_QCALL;
+	AddMemoryPressure(bytesAllocated);
+	END_QCALL;
 }
 
 void GCInterface::AddMemoryPressure(UINT64 bytesAllocated)
@@ -2578,6 +2719,189 @@ FCIMPLEND
 
 #include <optdefault.h>
 
+//
+// BitOperationsNative
+//
+
+static inline INT32 PopCount(UINT64 value)
+{
+	LIMITED_METHOD_CONTRACT;
+
+	value = value - ((value >> 1) & UI64(0x5555555555555555));
+	value = (value & UI64(0x3333333333333333)) + ((value >> 2) & UI64(0x3333333333333333));
+	value = (value + (value >> 4)) & UI64(0x0F0F0F0F0F0F0F0F);
+	return (INT32)((value * UI64(0x0101010101010101)) >> 56);
+}
+
+static inline INT32 LeadingZeroCount(UINT32 value)
+{
+	LIMITED_METHOD_CONTRACT;
+
+	if (value == 0)
+	{
+		return 32;
+	}
+
+	INT32 count = 0;
+	if ((value & 0xFFFF0000) == 0) { count += 16; value <<= 16; }
+	if ((value & 0xFF000000) == 0) { count += 8;  value <<= 8;  }
+	if ((value & 0xF0000000) == 0) { count += 4;  value <<= 4;  }
+	if ((value & 0xC0000000) == 0) { count += 2;  value <<= 2;  }
+	if ((value & 0x80000000) == 0) { count += 1; }
+	return count;
+}
+
+static inline UINT64 ParallelBitDeposit(UINT64 value, UINT64 mask)
+{
+	LIMITED_METHOD_CONTRACT;
+
+	// Move the low bits of value, in order, to the positions of the bits set in mask
+	UINT64 result = 0;
+	for (UINT64 bit = 1; mask != 0; bit <<= 1)
+	{
+		if ((value & bit) != 0)
+		{
+			result |= mask & (~mask + 1);
+		}
+		mask &= mask - 1;
+	}
+	return result;
+}
+
+static inline UINT64 ParallelBitExtract(UINT64 value, UINT64 mask)
+{
+	LIMITED_METHOD_CONTRACT;
+
+	// Pack the bits of value at the positions of the bits set in mask, in order, into the low bits
+	UINT64 result = 0;
+	for (UINT64 bit = 1; mask != 0; bit <<= 1)
+	{
+		if ((value & mask & (~mask + 1)) != 0)
+		{
+			result |= bit;
+		}
+		mask &= mask - 1;
+	}
+	return result;
+}
+
+FCIMPL1(INT32, BitOperationsNative::PopCount32, UINT32 value)
+{
+	FCALL_CONTRACT;
+
+	return PopCount(value);
+}
+FCIMPLEND
+
+FCIMPL1_V(INT32, BitOperationsNative::PopCount64, UINT64 value)
+{
+	FCALL_CONTRACT;
+
+	return PopCount(value);
+}
+FCIMPLEND
+
+FCIMPL1(INT32, BitOperationsNative::LeadingZeroCount32, UINT32 value)
+{
+	FCALL_CONTRACT;
+
+	return LeadingZeroCount(value);
+}
+FCIMPLEND
+
+FCIMPL1_V(INT32, BitOperationsNative::LeadingZeroCount64, UINT64 value)
+{
+	FCALL_CONTRACT;
+
+	UINT32 high = (UINT32)(value >> 32);
+	if (high != 0)
+	{
+		return LeadingZeroCount(high);
+	}
+	return 32 + LeadingZeroCount((UINT32)value);
+}
+FCIMPLEND
+
+FCIMPL1(INT32, BitOperationsNative::TrailingZeroCount32, UINT32 value)
+{
+	FCALL_CONTRACT;
+
+	if (value == 0)
+	{
+		return 32;
+	}
+
+	// The bits below the lowest bit set
+	return PopCount((value & (~value + 1)) - 1);
+}
+FCIMPLEND
+
+FCIMPL1_V(INT32, BitOperationsNative::TrailingZeroCount64, UINT64 value)
+{
+	FCALL_CONTRACT;
+
+	if (value == 0)
+	{
+		return 64;
+	}
+
+	return PopCount((value & (~value + 1)) - 1);
+}
+FCIMPLEND
+
+FCIMPL1(UINT32, BitOperationsNative::ByteSwap32, UINT32 value)
+{
+	FCALL_CONTRACT;
+
+	return (value >> 24) |
+	       ((value >> 8) & 0x0000FF00) |
+	       ((value << 8) & 0x00FF0000) |
+	       (value << 24);
+}
+FCIMPLEND
+
+FCIMPL1_V(UINT64, BitOperationsNative::ByteSwap64, UINT64 value)
+{
+	FCALL_CONTRACT;
+
+	value = ((value >> 8) & UI64(0x00FF00FF00FF00FF)) | ((value & UI64(0x00FF00FF00FF00FF)) << 8);
+	value = ((value >> 16) & UI64(0x0000FFFF0000FFFF)) | ((value & UI64(0x0000FFFF0000FFFF)) << 16);
+	return (value >> 32) | (value << 32);
+}
+FCIMPLEND
+
+FCIMPL2(UINT32, BitOperationsNative::ParallelBitDeposit32, UINT32 value, UINT32 mask)
+{
+	FCALL_CONTRACT;
+
+	return (UINT32)ParallelBitDeposit(value, mask);
+}
+FCIMPLEND
+
+FCIMPL2_VV(UINT64, BitOperationsNative::ParallelBitDeposit64, UINT64 value, UINT64 mask)
+{
+	FCALL_CONTRACT;
+
+	return ParallelBitDeposit(value, mask);
+}
+FCIMPLEND
+
+FCIMPL2(UINT32, BitOperationsNative::ParallelBitExtract32, UINT32 value, UINT32 mask)
+{
+	FCALL_CONTRACT;
+
+	return (UINT32)ParallelBitExtract(value, mask);
+}
+FCIMPLEND
+
+FCIMPL2_VV(UINT64, BitOperationsNative::ParallelBitExtract64, UINT64 value, UINT64 mask)
+{
+	FCALL_CONTRACT;
+
+	return ParallelBitExtract(value, mask);
+}
+FCIMPLEND
+
 
 
 FCIMPL6(INT32, ManagedLoggingHelper::GetRegistryLoggingValues, CLR_BOOL* bLoggingEnabled, CLR_BOOL* bLogToConsole, INT32 *iLogLevel, CLR_BOOL* bPerfWarnings, CLR_BOOL* bCorrectnessWarnings, CLR_BOOL* bSafeHandleStackTraces)
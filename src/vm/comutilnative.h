@@ -178,11 +178,26 @@ public:
     static
     void QCALLTYPE WaitForPendingFinalizers();
 
+    static
+    void QCALLTYPE PushNewArena();
+
+    static
+    void QCALLTYPE PushGCHeap();
+
+    static
+    void QCALLTYPE ResetArenas();
+
     static FCDECL0(int,     GetMaxGeneration);
     static FCDECL1(void,    KeepAlive, Object *obj);
     static FCDECL1(void,    SuppressFinalize, Object *obj);
     static FCDECL1(void,    ReRegisterForFinalize, Object *obj);
     static FCDECL2(int,     CollectionCount, INT32 generation, INT32 getSpecialGCCount);
+    static FCDECL0(int,     GetCurrentArenaId);
+    static FCDECL0(int,     GetArenaToken);
+    static FCDECL1(void,    PushArena, INT32 token);
+    static FCDECL0(void,    PopArena);
+    static FCDECL1(Object*, AllocatePinnedByteArray, INT32 length);
+    static FCDECL2(INT64,   GetPausePhaseHistogram, INT32 phase, I8Array* bucketsUNSAFE);
     
     static 
     int QCALLTYPE StartNoGCRegion(INT64 totalSize, BOOL lohSizeKnown, INT64 lohSize, BOOL disallowFullBlockingGC);
@@ -233,6 +248,25 @@ public:
         static FCDECL3_VVI(void, CompareExchangeGeneric, FC_TypedByRef location, FC_TypedByRef value, LPVOID comparand);
 };
 
+// Software implementations of the System.Numerics.BitOperations intrinsics, called
+// when the JIT doesn't expand them (no hardware support, MinOpts, other targets).
+class BitOperationsNative
+{
+public:
+    static FCDECL1(INT32, PopCount32, UINT32 value);
+    static FCDECL1_V(INT32, PopCount64, UINT64 value);
+    static FCDECL1(INT32, LeadingZeroCount32, UINT32 value);
+    static FCDECL1_V(INT32, LeadingZeroCount64, UINT64 value);
+    static FCDECL1(INT32, TrailingZeroCount32, UINT32 value);
+    static FCDECL1_V(INT32, TrailingZeroCount64, UINT64 value);
+    static FCDECL1(UINT32, ByteSwap32, UINT32 value);
+    static FCDECL1_V(UINT64, ByteSwap64, UINT64 value);
+    static FCDECL2(UINT32, ParallelBitDeposit32, UINT32 value, UINT32 mask);
+    static FCDECL2_VV(UINT64, ParallelBitDeposit64, UINT64 value, UINT64 mask);
+    static FCDECL2(UINT32, ParallelBitExtract32, UINT32 value, UINT32 mask);
+    static FCDECL2_VV(UINT64, ParallelBitExtract64, UINT64 value, UINT64 mask);
+};
+
 class ManagedLoggingHelper {
 
 public:
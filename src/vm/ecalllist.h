@@ -1264,6 +1264,21 @@ FCFuncStart(gMathFuncs)
     FCFuncElement("SplitFractionDouble", COMDouble::ModFDouble)
 FCFuncEnd()
 
+FCFuncStart(gBitOperationsFuncs)
+    FCIntrinsicSig("PopCount", &gsig_SM_UInt_RetInt, BitOperationsNative::PopCount32, CORINFO_INTRINSIC_PopCount32)
+    FCIntrinsicSig("PopCount", &gsig_SM_ULong_RetInt, BitOperationsNative::PopCount64, CORINFO_INTRINSIC_PopCount64)
+    FCIntrinsicSig("LeadingZeroCount", &gsig_SM_UInt_RetInt, BitOperationsNative::LeadingZeroCount32, CORINFO_INTRINSIC_LeadingZeroCount32)
+    FCIntrinsicSig("LeadingZeroCount", &gsig_SM_ULong_RetInt, BitOperationsNative::LeadingZeroCount64, CORINFO_INTRINSIC_LeadingZeroCount64)
+    FCIntrinsicSig("TrailingZeroCount", &gsig_SM_UInt_RetInt, BitOperationsNative::TrailingZeroCount32, CORINFO_INTRINSIC_TrailingZeroCount32)
+    FCIntrinsicSig("TrailingZeroCount", &gsig_SM_ULong_RetInt, BitOperationsNative::TrailingZeroCount64, CORINFO_INTRINSIC_TrailingZeroCount64)
+    FCIntrinsicSig("ByteSwap", &gsig_SM_UInt_RetUInt, BitOperationsNative::ByteSwap32, CORINFO_INTRINSIC_ByteSwap32)
+    FCIntrinsicSig("ByteSwap", &gsig_SM_ULong_RetULong, BitOperationsNative::ByteSwap64, CORINFO_INTRINSIC_ByteSwap64)
+    FCIntrinsicSig("ParallelBitDeposit", &gsig_SM_UInt_UInt_RetUInt, BitOperationsNative::ParallelBitDeposit32, CORINFO_INTRINSIC_ParallelBitDeposit32)
+    FCIntrinsicSig("ParallelBitDeposit", &gsig_SM_ULong_ULong_RetULong, BitOperationsNative::ParallelBitDeposit64, CORINFO_INTRINSIC_ParallelBitDeposit64)
+    FCIntrinsicSig("ParallelBitExtract", &gsig_SM_UInt_UInt_RetUInt, BitOperationsNative::ParallelBitExtract32, CORINFO_INTRINSIC_ParallelBitExtract32)
+    FCIntrinsicSig("ParallelBitExtract", &gsig_SM_ULong_ULong_RetULong, BitOperationsNative::ParallelBitExtract64, CORINFO_INTRINSIC_ParallelBitExtract64)
+FCFuncEnd()
+
 FCFuncStart(gThreadFuncs)
     FCDynamic("InternalGetCurrentThread", CORINFO_INTRINSIC_Illegal, ECall::InternalGetCurrentThread)
     FCFuncElement("StartInternal", ThreadNative::Start)
@@ -1582,6 +1597,16 @@ FCFuncStart(gGCInterfaceFuncs)
 
     FCFuncElement("_SuppressFinalize", GCInterface::SuppressFinalize)
     FCFuncElement("_ReRegisterForFinalize", GCInterface::ReRegisterForFinalize)
+
+    FCFuncElement("GetCurrentArenaId", GCInterface::GetCurrentArenaId)
+    QCFuncElement("_PushNewArena", GCInterface::PushNewArena)
+    QCFuncElement("_PushGCHeap", GCInterface::PushGCHeap)
+    QCFuncElement("_ResetArenas", GCInterface::ResetArenas)
+    FCFuncElement("_GetArenaToken", GCInterface::GetArenaToken)
+    FCFuncElement("_PushArena", GCInterface::PushArena)
+    FCFuncElement("_PopArena", GCInterface::PopArena)
+    FCFuncElement("_AllocatePinnedByteArray", GCInterface::AllocatePinnedByteArray)
+    FCFuncElement("_GetPausePhaseHistogram", GCInterface::GetPausePhaseHistogram)
     
 FCFuncEnd()
 
@@ -2176,6 +2201,7 @@ FCClassElement("BCLDebug", "System", gBCLDebugFuncs)
 #ifndef FEATURE_CORECLR
 FCClassElement("BaseConfigHandler", "System", gConfigHelper)
 #endif // FEATURE_CORECLR
+FCClassElement("BitOperations", "System.Numerics", gBitOperationsFuncs)
 FCClassElement("Buffer", "System", gBufferFuncs)
 #ifndef FEATURE_CORECLR
 // Since the 2nd letter of the classname is capital, we need to sort this before all class names
@@ -407,6 +407,12 @@ HRESULT EEConfig::Init()
 
     iGCPollType = GCPOLL_TYPE_DEFAULT;
 
+#ifdef FEATURE_TIERED_COMPILATION
+    fTieredCompilation = false;
+    dwTier1CallCountThreshold = 30;
+    fTieredPGO = false;
+#endif
+
 #ifdef _DEBUG
     fGenerateStubForHost = FALSE;
     fShouldInjectFault = 0;
@@ -1357,12 +1363,24 @@ HRESULT EEConfig::sync()
     _ASSERTE(EEConfig::GCPOLL_TYPE_HIJACK != iGCPollTypeOverride);
     if (EEConfig::GCPOLL_TYPE_HIJACK == iGCPollTypeOverride)
         iGCPollTypeOverride = EEConfig::GCPOLL_TYPE_DEFAULT;
+
+    // Nor can they leave the returns to hijacking.
+    if (EEConfig::GCPOLL_TYPE_INLINE_LOOPS == iGCPollTypeOverride)
+        iGCPollTypeOverride = EEConfig::GCPOLL_TYPE_INLINE;
 #endif
 
     _ASSERTE(iGCPollTypeOverride < GCPOLL_TYPE_COUNT);
     if (iGCPollTypeOverride < GCPOLL_TYPE_COUNT)
         iGCPollType = GCPollType(iGCPollTypeOverride);
 
+#ifdef FEATURE_TIERED_COMPILATION
+    fTieredCompilation = (CLRConfig::GetConfigValue(CLRConfig::EXTERNAL_TieredCompilation) != 0);
+    dwTier1CallCountThreshold = CLRConfig::GetConfigValue(CLRConfig::EXTERNAL_TieredCompilation_Tier1CallCountThreshold);
+    if (dwTier1CallCountThreshold == 0)
+        dwTier1CallCountThreshold = 1;
+    fTieredPGO = fTieredCompilation && (CLRConfig::GetConfigValue(CLRConfig::EXTERNAL_TieredPGO) != 0);
+#endif
+
 #if defined(_DEBUG) && defined(WIN64EXCEPTIONS)
     fSuppressLockViolationsOnReentryFromOS = (CLRConfig::GetConfigValue(CLRConfig::INTERNAL_SuppressLockViolationsOnReentryFromOS) != 0);
 #endif
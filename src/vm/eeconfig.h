@@ -858,10 +858,17 @@ public:
         GCPOLL_TYPE_HIJACK,     // Depend on thread hijacking for gc suspension
         GCPOLL_TYPE_POLL,       // Emit function calls to a helper for GC Poll
         GCPOLL_TYPE_INLINE,     // Emit inlined tests to the helper for GC Poll
+        GCPOLL_TYPE_INLINE_LOOPS, // Emit inlined tests on loop back edges only, hijack for returns
         GCPOLL_TYPE_COUNT
     };
     GCPollType GetGCPollType() { LIMITED_METHOD_CONTRACT; return iGCPollType; }
 
+#ifdef FEATURE_TIERED_COMPILATION
+    bool TieredCompilation(void)                const {LIMITED_METHOD_CONTRACT;  return fTieredCompilation; }
+    DWORD TieredCompilation_Tier1CallCountThreshold() const {LIMITED_METHOD_CONTRACT; return dwTier1CallCountThreshold; }
+    bool TieredPGO(void)                        const {LIMITED_METHOD_CONTRACT;  return fTieredPGO; }
+#endif
+
 #ifdef _DEBUG
     BOOL ShouldGenerateStubForHost() const {LIMITED_METHOD_CONTRACT; return fGenerateStubForHost;}
     void DisableGenerateStubForHost() {LIMITED_METHOD_CONTRACT; fGenerateStubForHost = FALSE;}
@@ -1183,6 +1190,12 @@ private: //----------------------------------------------------------------
 
     GCPollType iGCPollType;
 
+#ifdef FEATURE_TIERED_COMPILATION
+    bool fTieredCompilation;
+    DWORD dwTier1CallCountThreshold;
+    bool fTieredPGO;
+#endif
+
 #ifdef _DEBUG
     BOOL fGenerateStubForHost;
     DWORD fShouldInjectFault;
@@ -2855,6 +2855,7 @@ BOOL ETW::TypeSystemLog::s_fHeapAllocEventEnabledOnStartup = FALSE;
 BOOL ETW::TypeSystemLog::s_fHeapAllocHighEventEnabledNow = FALSE;
 BOOL ETW::TypeSystemLog::s_fHeapAllocLowEventEnabledNow = FALSE;
 int ETW::TypeSystemLog::s_nCustomMsBetweenEvents = 0;
+SIZE_T ETW::TypeSystemLog::s_nAllocationSamplingBytes = 0;
 
 
 //---------------------------------------------------------------------------------------
@@ -2895,6 +2896,11 @@ void ETW::TypeSystemLog::PostRegistrationInit()
 {
     LIMITED_METHOD_CONTRACT;
 
+    // Allocation sampling is driven by config rather than by a keyword, since (like the
+    // sampled object allocation events below) it needs the slow alloc JIT helpers, which
+    // are chosen once on startup.
+    s_nAllocationSamplingBytes = CLRConfig::GetConfigValue(CLRConfig::UNSUPPORTED_AllocationSamplingBytes);
+
     // Initialize our "current state" BOOLs that remember if low or high allocation
     // sampling is turned on
     s_fHeapAllocLowEventEnabledNow = ETW_TRACING_CATEGORY_ENABLED(MICROSOFT_WINDOWS_DOTNETRUNTIME_PROVIDER_Context, TRACE_LEVEL_INFORMATION, CLR_GCHEAPALLOCLOW_KEYWORD);
@@ -3028,6 +3034,23 @@ BOOL ETW::TypeSystemLog::IsHeapAllocEventEnabled()
         (s_fHeapAllocHighEventEnabledNow || s_fHeapAllocLowEventEnabledNow);
 }
 
+//---------------------------------------------------------------------------------------
+//
+// Use this to decide whether allocations should be charged against the allocating
+// thread's sampling budget (see code:ETW::TypeSystemLog::SendAllocationSampleEvent)
+//
+// Return Value:
+//      nonzero iff COMPlus_AllocationSamplingBytes was set on startup.
+//
+
+// static
+BOOL ETW::TypeSystemLog::IsAllocationSamplingEnabled()
+{
+    LIMITED_METHOD_CONTRACT;
+
+    return s_nAllocationSamplingBytes != 0;
+}
+
 //---------------------------------------------------------------------------------------
 //
 // Helper that adds (or updates) the TypeLoggingInfo inside the inner hash table passed
@@ -3224,6 +3247,83 @@ void ETW::TypeSystemLog::SendObjectAllocatedEvent(Object * pObject)
     }
 }
 
+//---------------------------------------------------------------------------------------
+//
+// Called once an allocation uses up the allocating thread's sampling budget.  Fires the
+// AllocationSample event for the allocation and draws the next budget.
+//
+// Budgets are drawn from an exponential distribution whose mean is
+// COMPlus_AllocationSamplingBytes, so every byte allocated has the same chance of being
+// sampled and the samples don't lock step with allocation patterns that repeat every N
+// bytes.  The event carries the number of bytes the thread allocated since its previous
+// sample, which is what a consumer should weight the sample by.  The stack comes with the
+// event through the usual ClrStackWalk event.
+//
+// Arguments:
+//      * pObject - Object just allocated.  Its MethodTable may not be set yet; the type
+//          comes from code:Thread::GetTHAllocContextObj, as for GCAllocationTick.
+//      * size - Size of the allocation in bytes
+//      * arenaId - Arena the object was allocated in, or -1 for the GC heap
+//
+
+// static
+void ETW::TypeSystemLog::SendAllocationSampleEvent(Object * pObject, SIZE_T size, INT32 arenaId)
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_NOTRIGGER;
+        MODE_COOPERATIVE;
+    }
+    CONTRACTL_END;
+
+    Thread * pThread = GetThread();
+
+    // A thread starts out with no budget, so its first allocation only draws one.
+    BOOL fFirstSample = (pThread->m_allocSampleInterval == 0);
+    SIZE_T nSampledBytes = pThread->m_allocSampleInterval - pThread->m_allocSampleBytesLeft + size;
+
+    // NextDouble is in [0, 1), so 1 - u is never 0.  Cap the budget so a single unlucky
+    // draw can't switch sampling off for a thread.
+    double u = pThread->GetRandom()->NextDouble();
+    double flInterval = -log(1.0 - u) * (double)s_nAllocationSamplingBytes;
+    flInterval = min(max(flInterval, 1.0), 64.0 * (double)s_nAllocationSamplingBytes);
+    pThread->m_allocSampleInterval = (SIZE_T)flInterval;
+    pThread->m_allocSampleBytesLeft = pThread->m_allocSampleInterval;
+
+    if (fFirstSample || !ETW_EVENT_ENABLED(MICROSOFT_WINDOWS_DOTNETRUNTIME_PROVIDER_Context, AllocationSample))
+        return;
+
+    TypeHandle th = pThread->GetTHAllocContextObj();
+    if (th.IsNull())
+        return;
+
+    // Arena objects don't belong to a generation; report them as -1 (0xffffffff).
+    UINT32 generation = (UINT32)-1;
+    if (arenaId < 0)
+        generation = GCHeap::GetGCHeap()->WhichGeneration(pObject);
+
+    EX_TRY
+    {
+        InlineSString<MAX_CLASSNAME_LENGTH> strTypeName;
+        th.GetName(strTypeName);
+
+        FireEtwAllocationSample(
+            (LPVOID) th.AsTAddr(),
+            strTypeName.GetUnicode(),
+            size,
+            nSampledBytes,
+            arenaId,
+            generation,
+            pObject,
+            GetClrInstanceId());
+    }
+    EX_CATCH
+    {
+    }
+    EX_END_CATCH(SwallowAllExceptions);
+}
+
 //---------------------------------------------------------------------------------------
 //
 // Accessor for global hash table crst
@@ -377,7 +377,8 @@ uint64_t GCToOSInterface::GetRestrictedPhysicalMemoryLimit()
     LIMITED_METHOD_CONTRACT;
 
 #ifdef FEATURE_PAL
-    return 0;
+    // The memory limit of the cgroup the process runs in, if any
+    return PAL_GetRestrictedPhysicalMemoryLimit();
 #else
     size_t job_physical_memory_limit = (size_t)MAX_PTR;
     BOOL in_job_p = FALSE;
@@ -507,6 +508,10 @@ size_t GCToOSInterface::GetCurrentPhysicalMemory()
     PROCESS_MEMORY_COUNTERS pmc;
     if (GCGetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
         return pmc.WorkingSetSize;
+#else
+    size_t used;
+    if (PAL_GetPhysicalMemoryUsed(&used))
+        return used;
 #endif 
 
     return 0;
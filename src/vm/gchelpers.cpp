@@ -19,6 +19,7 @@
 #include "eeconfig.h"
 #include "gc.h"
 #include "..\gc\Arena.h"
+#include "..\gc\softwarewritewatch.h"
 #include "corhost.h"
 #include "threads.h"
 #include "fieldmarshaler.h"
@@ -61,6 +62,31 @@ inline alloc_context* GetThreadAllocContext()
 	return &GetThread()->m_alloc_context;
 }
 
+// Charges an allocation against the allocating thread's sampling budget, firing the
+// AllocationSample event once the budget is used up (see
+// code:ETW::TypeSystemLog::SendAllocationSampleEvent). Arena allocations return from the
+// Alloc helpers below before the GC ever sees them, so this is the one place both arena
+// and GC heap allocations can be sampled.
+inline void SampleAllocation(Object *pObject, size_t size)
+{
+	LIMITED_METHOD_CONTRACT;
+
+#ifdef FEATURE_EVENT_TRACE
+	if (pObject == NULL || !ETW::TypeSystemLog::IsAllocationSamplingEnabled())
+		return;
+
+	Thread *pThread = GetThread();
+	if (size < pThread->m_allocSampleBytesLeft)
+	{
+		pThread->m_allocSampleBytesLeft -= size;
+		return;
+	}
+
+	INT32 arenaId = ::ArenaManager::IsArenaAddress(pObject) ? ::ArenaManager::GetArenaId(pObject) : -1;
+	ETW::TypeSystemLog::SendAllocationSampleEvent(pObject, size, arenaId);
+#endif // FEATURE_EVENT_TRACE
+}
+
 
 // There are only three ways to get into allocate an object.
 //     * Call optimized helpers that were generated on the fly. This is how JIT compiled code does most
@@ -102,6 +128,7 @@ inline Object* Alloc(size_t size, BOOL bFinalize, BOOL bContainsPointers)
 	retVal = (Object *)::ArenaManager::Allocate(size, flags);
 	if (retVal != nullptr)
 	{
+		SampleAllocation(retVal, size);
 		return retVal;
 	}
 
@@ -114,6 +141,7 @@ inline Object* Alloc(size_t size, BOOL bFinalize, BOOL bContainsPointers)
 		retVal = GCHeap::GetGCHeap()->Alloc(size, flags);
 	END_INTERIOR_STACK_PROBE;
 	::ArenaManager::RegisterAddress(retVal);
+	SampleAllocation(retVal, size);
 	return retVal;
 }
 
@@ -138,6 +166,7 @@ inline Object* AllocAlign8(size_t size, BOOL bFinalize, BOOL bContainsPointers,
 	{
 
 		::ArenaManager::Log("AllocateObject arena2", retVal, size);
+		SampleAllocation(retVal, size);
 		return retVal;
 	}
 
@@ -152,6 +181,7 @@ inline Object* AllocAlign8(size_t size, BOOL bFinalize, BOOL bContainsPointers,
 	END_INTERIOR_STACK_PROBE;
 	::ArenaManager::RegisterAddress(retVal);
 	::ArenaManager::Log("AllocateObject GC2", retVal, size);
+	SampleAllocation(retVal, size);
 	return retVal;
 }
 #endif // FEATURE_64BIT_ALIGNMENT
@@ -190,6 +220,7 @@ inline Object* AllocLHeap(size_t size, BOOL bFinalize, BOOL bContainsPointers)
 	{
 
 		::ArenaManager::Log("AllocateObject arena3", (size_t)retVal, size);
+		SampleAllocation(retVal, size);
 		return retVal;
 	}
 
@@ -201,6 +232,42 @@ inline Object* AllocLHeap(size_t size, BOOL bFinalize, BOOL bContainsPointers)
 	END_INTERIOR_STACK_PROBE;
 	::ArenaManager::Log("AllocateObject GC3", (size_t)retVal, size);
 	::ArenaManager::RegisterAddress(retVal);
+	SampleAllocation(retVal, size);
+	return retVal;
+}
+
+// This variation allocates on the pinned object heap whatever the size, see GC_ALLOC_PINNED_OBJECT_HEAP. The
+// object is never moved by the GC so it can stay pinned (e.g. for async I/O) without blocking compaction. It
+// never comes from an arena: the buffers that want this outlive the I/O that pins them, not a request.
+inline Object* AllocPinnedHeap(size_t size, BOOL bContainsPointers)
+{
+	CONTRACTL{
+		THROWS;
+	GC_TRIGGERS;
+	MODE_COOPERATIVE; // returns an objref without pinning it => cooperative
+	} CONTRACTL_END;
+
+	_ASSERTE(!NingenEnabled() && "You cannot allocate managed objects inside the ngen compilation process.");
+
+#ifdef _DEBUG
+	if (g_pConfig->ShouldInjectFault(INJECTFAULT_GCHEAP))
+	{
+		char *a = new char;
+		delete a;
+	}
+#endif
+
+	DWORD flags = ((bContainsPointers ? GC_ALLOC_CONTAINS_REF : 0) | GC_ALLOC_PINNED_OBJECT_HEAP);
+
+	Object *retVal = NULL;
+
+	// We don't want to throw an SO during the GC, so make sure we have plenty
+	// of stack before calling in.
+	INTERIOR_STACK_PROBE_FOR(GetThread(), static_cast<unsigned>(DEFAULT_ENTRY_PROBE_AMOUNT * 1.5));
+	retVal = GCHeap::GetGCHeap()->AllocLHeap(size, flags);
+	END_INTERIOR_STACK_PROBE;
+	::ArenaManager::RegisterAddress(retVal);
+	SampleAllocation(retVal, size);
 	return retVal;
 }
 
@@ -588,7 +655,7 @@ OBJECTREF   AllocatePrimitiveArray(CorElementType type, DWORD cElements, BOOL bA
 * Allocates a single dimensional array of primitive types.
 */
 
-OBJECTREF   FastAllocatePrimitiveArray(MethodTable* pMT, DWORD cElements, BOOL bAllocateInLargeHeap)
+OBJECTREF   FastAllocatePrimitiveArray(MethodTable* pMT, DWORD cElements, BOOL bAllocateInLargeHeap, BOOL bAllocateInPinnedHeap)
 {
 	CONTRACTL{
 		THROWS;
@@ -627,7 +694,13 @@ OBJECTREF   FastAllocatePrimitiveArray(MethodTable* pMT, DWORD cElements, BOOL b
 
 	ArrayBase* orObject;
 
-	if (bAllocateInLargeHeap)
+	if (bAllocateInPinnedHeap)
+	{
+		// The pinned object heap lives on large object segments, publish it like a large object.
+		orObject = (ArrayBase*)AllocPinnedHeap(totalSize, FALSE);
+		bPublish = TRUE;
+	}
+	else if (bAllocateInLargeHeap)
 	{
 		orObject = (ArrayBase*)AllocLHeap(totalSize, FALSE, FALSE);
 
@@ -753,6 +826,32 @@ OBJECTREF   DupArrayForCloning(BASEARRAYREF pRef, BOOL bAllocateInLargeHeap)
 	return AllocateArrayEx(TypeHandle(&arrayType), args, numArgs, bAllocateInLargeHeap DEBUG_ARG(FALSE));
 }
 
+/*
+* Allocates a single dimensional array of primitive types on the pinned object heap.
+*/
+OBJECTREF AllocatePinnedPrimitiveArray(CorElementType type, DWORD cElements)
+{
+	CONTRACTL
+	{
+		THROWS;
+	GC_TRIGGERS;
+	INJECT_FAULT(COMPlusThrowOM());
+	MODE_COOPERATIVE;  // returns an objref without pinning it => cooperative
+	}
+		CONTRACTL_END
+
+	_ASSERTE(CorTypeInfo::IsPrimitiveType(type));
+
+	// Fetch the proper array type
+	if (g_pPredefinedArrayTypes[type] == NULL)
+	{
+		TypeHandle elemType = TypeHandle(MscorlibBinder::GetElementType(type));
+		TypeHandle typHnd = ClassLoader::LoadArrayTypeThrowing(elemType, ELEMENT_TYPE_SZARRAY, 0);
+		g_pPredefinedArrayTypes[type] = typHnd.AsArray();
+	}
+	return FastAllocatePrimitiveArray(g_pPredefinedArrayTypes[type]->GetMethodTable(), cElements, FALSE, TRUE);
+}
+
 #if defined(_TARGET_X86_)
 
 // The fast version always allocates in the normal heap
@@ -1082,15 +1181,31 @@ OBJECTREF AllocateObject(MethodTable *pMT
 //========================================================================
 
 
+// card_byte_shift comes from gc.h, it is smaller with finer grained cards.
+#define card_byte(addr) (((size_t)(addr)) >> card_byte_shift)
+#define card_bit(addr)  (1 << ((((size_t)(addr)) >> (card_byte_shift - 3)) & 7))
+
+#if !(defined(_TARGET_AMD64_) && defined(FEATURE_PAL))
+// The other assembly barriers hard code the default card size
 #if defined(_WIN64)
-// Card byte shift is different on 64bit.
-#define card_byte_shift     11
+static_assert_no_msg(card_byte_shift == 11);
 #else
-#define card_byte_shift     10
+static_assert_no_msg(card_byte_shift == 10);
 #endif
+#endif // !(_TARGET_AMD64_ && FEATURE_PAL)
 
-#define card_byte(addr) (((size_t)(addr)) >> card_byte_shift)
-#define card_bit(addr)  (1 << ((((size_t)(addr)) >> (card_byte_shift - 3)) & 7))
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+#define card_bundle_byte(addr) (((size_t)(addr)) >> card_bundle_byte_shift)
+
+// Called after dirtying the card of dst, nothing else tells the GC that
+// the bundle of that card needs to be looked at.
+FORCEINLINE void SetCardBundleByte(BYTE* dst)
+{
+    BYTE* pCardBundleByte = (BYTE *)VolatileLoadWithoutBarrier(&g_card_bundle_table) + card_bundle_byte(dst);
+    if (*pCardBundleByte != 0xFF)
+        *pCardBundleByte = 0xFF;
+}
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 
 
 #ifdef FEATURE_USE_ASM_GC_WRITE_BARRIERS
@@ -1216,6 +1331,13 @@ extern "C" HCIMPL2_RAW(VOID, JIT_CheckedWriteBarrier, Object **dst, Object *ref)
 	updateGCShadow(dst, ref);     // support debugging write barrier
 #endif
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+	if (SoftwareWriteWatch::IsEnabledForGCHeap())
+	{
+		SoftwareWriteWatch::SetDirty(dst, sizeof(*dst));
+	}
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 #ifdef FEATURE_COUNT_GC_WRITE_BARRIERS
 	if ((BYTE*)dst >= g_ephemeral_low && (BYTE*)dst < g_ephemeral_high)
 	{
@@ -1236,6 +1358,9 @@ extern "C" HCIMPL2_RAW(VOID, JIT_CheckedWriteBarrier, Object **dst, Object *ref)
 			CheckedAfterAlreadyDirtyFilter++;
 #endif
 			*pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+			SetCardBundleByte((BYTE*)dst);
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 		}
 	}
 }
@@ -1266,6 +1391,13 @@ extern "C" HCIMPL2_RAW(VOID, JIT_WriteBarrier, Object **dst, Object *ref)
 	updateGCShadow(dst, ref);     // support debugging write barrier
 #endif
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+	if (SoftwareWriteWatch::IsEnabledForGCHeap())
+	{
+		SoftwareWriteWatch::SetDirty(dst, sizeof(*dst));
+	}
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 #ifdef FEATURE_COUNT_GC_WRITE_BARRIERS
 	if ((BYTE*)dst >= g_ephemeral_low && (BYTE*)dst < g_ephemeral_high)
 	{
@@ -1284,6 +1416,9 @@ extern "C" HCIMPL2_RAW(VOID, JIT_WriteBarrier, Object **dst, Object *ref)
 			UncheckedAfterAlreadyDirtyFilter++;
 #endif
 			*pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+			SetCardBundleByte((BYTE*)dst);
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 		}
 	}
 }
@@ -1327,13 +1462,25 @@ void ErectWriteBarrier(OBJECTREF *dst, OBJECTREF ref)
 	updateGCShadow((Object**)dst, OBJECTREFToObject(ref));     // support debugging write barrier
 #endif
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+	if (SoftwareWriteWatch::IsEnabledForGCHeap())
+	{
+		SoftwareWriteWatch::SetDirty(dst, sizeof(*dst));
+	}
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 	if ((BYTE*)OBJECTREFToObject(ref) >= g_ephemeral_low && (BYTE*)OBJECTREFToObject(ref) < g_ephemeral_high)
 	{
 		// VolatileLoadWithoutBarrier() is used here to prevent fetch of g_card_table from being reordered 
 		// with g_lowest/highest_address check above. See comment in code:gc_heap::grow_brick_card_tables.
 		BYTE* pCardByte = (BYTE *)VolatileLoadWithoutBarrier(&g_card_table) + card_byte((BYTE *)dst);
 		if (*pCardByte != 0xFF)
+		{
 			*pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+			SetCardBundleByte((BYTE*)dst);
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+		}
 	}
 }
 #include <optdefault.h>
@@ -1353,6 +1500,13 @@ void ErectWriteBarrierForMT(MethodTable **dst, MethodTable *ref)
 
 	if (ref->Collectible())
 	{
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+		if (SoftwareWriteWatch::IsEnabledForGCHeap())
+		{
+			SoftwareWriteWatch::SetDirty(dst, sizeof(*dst));
+		}
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 		BYTE *refObject = *(BYTE **)((MethodTable*)ref)->GetLoaderAllocatorObjectHandle();
 		if ((BYTE*)refObject >= g_ephemeral_low && (BYTE*)refObject < g_ephemeral_high)
 		{
@@ -1361,6 +1515,9 @@ void ErectWriteBarrierForMT(MethodTable **dst, MethodTable *ref)
 			if (!((*pCardByte) & card_bit((BYTE *)dst)))
 			{
 				*pCardByte = 0xFF;
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+				SetCardBundleByte((BYTE*)dst);
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 			}
 		}
 	}
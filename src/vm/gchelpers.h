@@ -26,7 +26,11 @@ OBJECTREF AllocateValueSzArray(TypeHandle elementType, INT32 length);
 OBJECTREF AllocateArrayEx(TypeHandle arrayClass, INT32 *pArgs, DWORD dwNumArgs, BOOL bAllocateInLargeHeap = FALSE
                           DEBUG_ARG(BOOL bDontSetAppDomain = FALSE));
     // Optimized verion of above
-OBJECTREF FastAllocatePrimitiveArray(MethodTable* arrayType, DWORD cElements, BOOL bAllocateInLargeHeap = FALSE);
+OBJECTREF FastAllocatePrimitiveArray(MethodTable* arrayType, DWORD cElements, BOOL bAllocateInLargeHeap = FALSE,
+                                     BOOL bAllocateInPinnedHeap = FALSE);
+
+    // Create a SD array of primitive types on the pinned object heap, it is never moved
+OBJECTREF AllocatePinnedPrimitiveArray(CorElementType type, DWORD cElements);
 
 
 #if defined(_TARGET_X86_)
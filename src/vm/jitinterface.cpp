@@ -1984,6 +1984,37 @@ CEEInfo::getClassSize(
     return result;
 }
 
+//---------------------------------------------------------------------------------------
+// 
+unsigned 
+CEEInfo::getHeapClassSize(
+    CORINFO_CLASS_HANDLE clsHnd)
+{
+    CONTRACTL {
+        SO_TOLERANT;
+        NOTHROW;
+        GC_NOTRIGGER;
+        MODE_PREEMPTIVE;
+    } CONTRACTL_END;
+
+    unsigned result = 0;
+
+    JIT_TO_EE_TRANSITION_LEAF();
+
+    TypeHandle VMClsHnd(clsHnd);
+    _ASSERTE(!VMClsHnd.IsTypeDesc());
+
+    MethodTable* pMT = VMClsHnd.AsMethodTable();
+    _ASSERTE(!pMT->IsValueType() && !pMT->IsStringOrArray());
+
+    // The base size counts the object header that precedes the method table pointer
+    result = pMT->GetBaseSize() - sizeof(ObjHeader);
+
+    EE_TO_JIT_TRANSITION_LEAF();
+
+    return result;
+}
+
 unsigned CEEInfo::getClassAlignmentRequirement(CORINFO_CLASS_HANDLE type, BOOL fDoubleAlignHint)
 {
     CONTRACTL {
@@ -5660,10 +5691,10 @@ unsigned CEEInfo::getClassDomainID (CORINFO_CLASS_HANDLE clsHnd,
 //    Normally, a profiler would just directly call the inline helper to determine
 //    whether the profiler set the relevant event flag (e.g.,
 //    CORProfilerTrackAllocationsEnabled). However, this wrapper also asks whether we're
-//    running for IBC instrumentation or enabling the object allocated ETW event. If so,
-//    we treat that the same as if the profiler requested allocation information, so that
-//    the JIT will still use the profiling-friendly object allocation jit helper, so the
-//    allocations can be tracked.
+//    running for IBC instrumentation, enabling the object allocated ETW event or sampling
+//    allocations. If so, we treat that the same as if the profiler requested allocation
+//    information, so that the JIT will still use the profiling-friendly object allocation
+//    jit helper, so the allocations can be tracked.
 //
 
 bool __stdcall TrackAllocationsEnabled()
@@ -5683,6 +5714,7 @@ bool __stdcall TrackAllocationsEnabled()
 #endif // PROFILING_SUPPORTED
 #ifdef FEATURE_EVENT_TRACE
         || ETW::TypeSystemLog::IsHeapAllocEventEnabled()
+        || ETW::TypeSystemLog::IsAllocationSamplingEnabled()
 #endif // FEATURE_EVENT_TRACE
         );
 }
@@ -8405,6 +8437,123 @@ void CEEInfo::getMethodVTableOffset (CORINFO_METHOD_HANDLE methodHnd,
     EE_TO_JIT_TRANSITION_LEAF();
 }
 
+/*********************************************************************/
+static MethodDesc* ResolveVirtualMethodOnClass(MethodDesc*            pBaseMD,
+                                               TypeHandle             implementingType,
+                                               CORINFO_CONTEXT_HANDLE ownerType)
+{
+    STANDARD_VM_CONTRACT;
+
+    // Generic virtual methods are dispatched through a lookup keyed by the
+    // method instantiation, leave those alone.
+    if (!pBaseMD->IsVirtual() || pBaseMD->HasMethodInstantiation())
+    {
+        return NULL;
+    }
+
+    if (implementingType.IsNull() || implementingType.IsTypeDesc())
+    {
+        return NULL;
+    }
+
+    MethodTable* pBaseMT = pBaseMD->GetMethodTable();
+    MethodTable* pImplMT = implementingType.AsMethodTable();
+
+    // The JIT only knows the class of the object reference; shared canonical
+    // classes stand for many classes, arrays dispatch their generic interfaces
+    // specially, and value classes would need an unboxing stub.
+    if (pImplMT->IsInterface() || pImplMT->IsValueType() || pImplMT->IsArray() ||
+        pImplMT->IsSharedByGenericInstantiations())
+    {
+        return NULL;
+    }
+
+    // Calls on these may be intercepted by a proxy or routed through COM
+    if (pImplMT->IsMarshaledByRef() || pImplMT->IsComObjectType())
+    {
+        return NULL;
+    }
+
+    MethodDesc* pDevirtMD = NULL;
+
+    if (pBaseMT->IsInterface())
+    {
+        TypeHandle ownerTH = (ownerType != NULL) ? GetTypeFromContext(ownerType) : TypeHandle(pBaseMT);
+        if (ownerTH.IsNull() || ownerTH.IsTypeDesc())
+        {
+            return NULL;
+        }
+
+        MethodTable* pOwnerMT = ownerTH.AsMethodTable();
+        if (!pOwnerMT->IsInterface() || !pOwnerMT->HasSameTypeDefAs(pBaseMT) ||
+            pOwnerMT->IsSharedByGenericInstantiations())
+        {
+            return NULL;
+        }
+
+        // Variant and equivalent interfaces are resolved at run time
+        if (!pImplMT->ImplementsInterface(pOwnerMT))
+        {
+            return NULL;
+        }
+
+        DispatchSlot slot(pImplMT->FindDispatchSlotForInterfaceMD(ownerTH, pBaseMD));
+        if (slot.IsNull())
+        {
+            return NULL;
+        }
+
+        pDevirtMD = slot.GetMethodDesc();
+    }
+    else
+    {
+        MethodTable* pCheckMT = pImplMT;
+        while ((pCheckMT != NULL) && !pCheckMT->HasSameTypeDefAs(pBaseMT))
+        {
+            pCheckMT = pCheckMT->GetParentMethodTable();
+        }
+
+        if (pCheckMT == NULL)
+        {
+            return NULL;
+        }
+
+        pDevirtMD = pImplMT->GetMethodDescForSlot(pBaseMD->GetSlot());
+    }
+
+    // The JIT turns the call into a plain direct call with the same arguments
+    if ((pDevirtMD == NULL) || pDevirtMD->IsAbstract() || pDevirtMD->RequiresInstArg() ||
+        pDevirtMD->IsUnboxingStub() || pDevirtMD->GetMethodTable()->IsValueType())
+    {
+        return NULL;
+    }
+
+    return pDevirtMD;
+}
+
+/*********************************************************************/
+CORINFO_METHOD_HANDLE CEEInfo::resolveVirtualMethod(CORINFO_METHOD_HANDLE  baseMethodHnd,
+                                                    CORINFO_CLASS_HANDLE   implementingClassHnd,
+                                                    CORINFO_CONTEXT_HANDLE ownerType)
+{
+    CONTRACTL {
+        SO_TOLERANT;
+        THROWS;
+        GC_TRIGGERS;
+        MODE_PREEMPTIVE;
+    } CONTRACTL_END;
+
+    MethodDesc* result = NULL;
+
+    JIT_TO_EE_TRANSITION();
+
+    result = ResolveVirtualMethodOnClass(GetMethod(baseMethodHnd), TypeHandle(implementingClassHnd), ownerType);
+
+    EE_TO_JIT_TRANSITION();
+
+    return (CORINFO_METHOD_HANDLE) result;
+}
+
 /*********************************************************************/
 void CEEInfo::getFunctionEntryPoint(CORINFO_METHOD_HANDLE  ftnHnd,
                                     CORINFO_CONST_LOOKUP * pResult,
@@ -9454,6 +9603,13 @@ void CEEInfo::getEEInfo(CORINFO_EE_INFO *pEEInfoOut)
     pEEInfoOut->osMinor = sVerInfo.dwMinorVersion;
     pEEInfoOut->osBuild = sVerInfo.dwBuildNumber;
 
+#ifndef CROSSGEN_COMPILE
+    pEEInfoOut->cpuFeatures = ExecutionManager::GetEEJitManager()->GetCPUFeatures();
+#else
+    // Native images can run on any machine of the target architecture
+    pEEInfoOut->cpuFeatures = 0;
+#endif
+
     EE_TO_JIT_TRANSITION();
 }
 
@@ -11012,39 +11168,50 @@ HRESULT CEEJitInfo::allocBBProfileBuffer (
 
     JIT_TO_EE_TRANSITION();
 
-#ifdef FEATURE_PREJIT
-
-    // We need to know the code size. Typically we can get the code size
-    // from m_ILHeader. For dynamic methods, m_ILHeader will be NULL, so
-    // for that case we need to use DynamicResolver to get the code size.
-
-    unsigned codeSize = 0; 
-    if (m_pMethodBeingCompiled->IsDynamicMethod())
+#ifdef FEATURE_TIERED_COMPILATION
+    // Instrumented tier-0 code, see code:TieredCompilationManager
+    if (g_pConfig->TieredPGO() && m_pMethodBeingCompiled->IsEligibleForTieredCompilation())
     {
-        unsigned stackSize, ehSize;
-        CorInfoOptions options;
-        DynamicResolver * pResolver = m_pMethodBeingCompiled->AsDynamicMethodDesc()->GetResolver();        
-        pResolver->GetCodeInfo(&codeSize, &stackSize, &options, &ehSize);
+        *profileBuffer = GetAppDomain()->GetTieredCompilationManager()->AllocMethodProfileBuffer(m_pMethodBeingCompiled, count);
+        hr = S_OK;
     }
     else
+#endif // FEATURE_TIERED_COMPILATION
     {
-        codeSize = m_ILHeader->GetCodeSize();    
-    }
-    
-    *profileBuffer = m_pMethodBeingCompiled->GetLoaderModule()->AllocateProfileBuffer(m_pMethodBeingCompiled->GetMemberDef(), count, codeSize);
-    hr = (*profileBuffer ? S_OK : E_OUTOFMEMORY);
+#ifdef FEATURE_PREJIT
+
+        // We need to know the code size. Typically we can get the code size
+        // from m_ILHeader. For dynamic methods, m_ILHeader will be NULL, so
+        // for that case we need to use DynamicResolver to get the code size.
+
+        unsigned codeSize = 0; 
+        if (m_pMethodBeingCompiled->IsDynamicMethod())
+        {
+            unsigned stackSize, ehSize;
+            CorInfoOptions options;
+            DynamicResolver * pResolver = m_pMethodBeingCompiled->AsDynamicMethodDesc()->GetResolver();        
+            pResolver->GetCodeInfo(&codeSize, &stackSize, &options, &ehSize);
+        }
+        else
+        {
+            codeSize = m_ILHeader->GetCodeSize();    
+        }
+
+        *profileBuffer = m_pMethodBeingCompiled->GetLoaderModule()->AllocateProfileBuffer(m_pMethodBeingCompiled->GetMemberDef(), count, codeSize);
+        hr = (*profileBuffer ? S_OK : E_OUTOFMEMORY);
 #else // FEATURE_PREJIT
-    _ASSERTE(!"allocBBProfileBuffer not implemented on CEEJitInfo!");
-    hr = E_NOTIMPL;
+        _ASSERTE(!"allocBBProfileBuffer not implemented on CEEJitInfo!");
+        hr = E_NOTIMPL;
 #endif // !FEATURE_PREJIT
+    }
 
     EE_TO_JIT_TRANSITION();
     
     return hr;
 }
 
-// Consider implementing getBBProfileData on CEEJitInfo.  This will allow us
-// to use profile info in codegen for non zapped images.
+// Only the block counts recorded by instrumented tier-0 code are available
+// here, profile data of zapped images is read by ZapInfo.
 HRESULT CEEJitInfo::getBBProfileData (
     CORINFO_METHOD_HANDLE         ftnHnd,
     ULONG *                       size,
@@ -11052,9 +11219,33 @@ HRESULT CEEJitInfo::getBBProfileData (
     ULONG *                       numRuns
     )
 {
-    LIMITED_METHOD_CONTRACT;
+    CONTRACTL {
+        SO_TOLERANT;
+        NOTHROW;
+        GC_NOTRIGGER;
+        MODE_PREEMPTIVE;
+    } CONTRACTL_END;
+
+    HRESULT hr = E_NOTIMPL;
+
+#ifdef FEATURE_TIERED_COMPILATION
+    MethodDesc* pMD = GetMethod(ftnHnd);
+    if (g_pConfig->TieredPGO() && pMD->IsEligibleForTieredCompilation())
+    {
+        hr = E_FAIL;
+        *profileBuffer = NULL;
+        if (GetAppDomain()->GetTieredCompilationManager()->GetMethodProfileBuffer(pMD, size, profileBuffer))
+        {
+            // The counts come from a single process, there is one run
+            *numRuns = 1;
+            hr = S_OK;
+        }
+    }
+#else // FEATURE_TIERED_COMPILATION
     _ASSERTE(!"getBBProfileData not implemented on CEEJitInfo!");
-    return E_NOTIMPL;
+#endif // FEATURE_TIERED_COMPILATION
+
+    return hr;
 }
 
 void CEEJitInfo::allocMem (
@@ -11640,6 +11831,8 @@ CorJitResult CallCompileMethodWithSEHWrapper(EEJitManager *jitMgr,
         flags |= CORJIT_FLG_GCPOLL_CALLS;
     else if (EEConfig::GCPOLL_TYPE_INLINE == pollType)
         flags |= CORJIT_FLG_GCPOLL_INLINE;
+    else if (EEConfig::GCPOLL_TYPE_INLINE_LOOPS == pollType)
+        flags |= CORJIT_FLG_GCPOLL_INLINE | CORJIT_FLG_GCPOLL_LOOPS;
 #endif //FEATURE_ENABLE_GCPOLL
 
     // Set flags based on method's ImplFlags.
@@ -273,6 +273,11 @@ public:
         WRITE_BARRIER_SVR32         = 5,
         WRITE_BARRIER_SVR64         = 6,
         WRITE_BARRIER_BUFFER        = 7,
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+        WRITE_BARRIER_WRITE_WATCH_PREGROW64  = 8,
+        WRITE_BARRIER_WRITE_WATCH_POSTGROW64 = 9,
+        WRITE_BARRIER_WRITE_WATCH_SVR64      = 10,
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
     };
 
     WriteBarrierManager();
@@ -281,12 +286,17 @@ public:
     void UpdateEphemeralBounds();
     void UpdateCardTableLocation(BOOL bReqUpperBoundsCheck);
 
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    void SwitchToWriteWatchBarrier(bool isRuntimeSuspended);
+    void SwitchToNonWriteWatchBarrier(bool isRuntimeSuspended);
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+
 protected:
     size_t GetCurrentWriteBarrierSize();
     size_t GetSpecificWriteBarrierSize(WriteBarrierType writeBarrier);
     PBYTE  CalculatePatchLocation(LPVOID base, LPVOID label, int offset);
     PCODE  GetCurrentWriteBarrierCode();
-    void   ChangeWriteBarrierTo(WriteBarrierType newWriteBarrier);
+    void   ChangeWriteBarrierTo(WriteBarrierType newWriteBarrier, bool isRuntimeSuspended = false);
     bool   NeedDifferentWriteBarrier(BOOL bReqUpperBoundsCheck, WriteBarrierType* pNewWriteBarrierType);
 
 private:    
@@ -298,6 +308,12 @@ private:
     PBYTE   m_pCardTableImmediate;      // PREGROW32 | PREGROW64 | POSTGROW32 | POSTGROW64 | SVR32 |
     PBYTE   m_pUpperBoundImmediate;     //           |           | POSTGROW32 | POSTGROW64 |       |
     PBYTE   m_pCardTableImmediate2;     // PREGROW32 |           | POSTGROW32 |            | SVR32 |
+#ifdef FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+    PBYTE   m_pWriteWatchTableImmediate; // WRITE_WATCH_* only
+#endif // FEATURE_USE_SOFTWARE_WRITE_WATCH_FOR_GC_HEAP
+#ifdef FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
+    PBYTE   m_pCardBundleTableImmediate; // all 64-bit variants
+#endif // FEATURE_MANUALLY_MANAGED_CARD_BUNDLES
 };
 
 #endif // _TARGET_AMD64_
@@ -495,6 +511,7 @@ public:
     BOOL isStructRequiringStackAllocRetBuf(CORINFO_CLASS_HANDLE cls);
 
     unsigned getClassSize (CORINFO_CLASS_HANDLE cls);
+    unsigned getHeapClassSize (CORINFO_CLASS_HANDLE cls);
     unsigned getClassAlignmentRequirement(CORINFO_CLASS_HANDLE cls, BOOL fDoubleAlignHint);
     static unsigned getClassAlignmentRequirementStatic(TypeHandle clsHnd);
 
@@ -746,6 +763,12 @@ public:
             unsigned * pOffsetAfterIndirection
             );
 
+    CORINFO_METHOD_HANDLE resolveVirtualMethod(
+            CORINFO_METHOD_HANDLE virtualMethod,
+            CORINFO_CLASS_HANDLE implementingClass,
+            CORINFO_CONTEXT_HANDLE ownerType
+            );
+
     CorInfoIntrinsics getIntrinsicID(CORINFO_METHOD_HANDLE method,
                                      bool * pMustExpand = NULL);
 
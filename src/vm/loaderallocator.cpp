@@ -504,6 +504,10 @@ void LoaderAllocator::GCLoaderAllocators(AppDomain * pAppDomain)
         // Fire ETW event
         ETW::LoaderLog::CollectibleLoaderAllocatorUnload((AssemblyLoaderAllocator *)pDomainLoaderAllocatorDestroyIterator);
 
+#ifdef FEATURE_TIERED_COMPILATION
+        pAppDomain->GetTieredCompilationManager()->OnLoaderAllocatorUnloaded(pDomainLoaderAllocatorDestroyIterator);
+#endif
+
         // Set the unloaded flag before notifying the debugger
         pDomainLoaderAllocatorDestroyIterator->SetIsUnloaded();
 
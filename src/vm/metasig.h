@@ -237,6 +237,12 @@ DEFINE_METASIG(SM(Obj_Int_RetVoid, j i,v))
 
 DEFINE_METASIG(SM(Flt_RetFlt, f, f))
 DEFINE_METASIG(SM(Dbl_RetDbl, d, d))
+DEFINE_METASIG(SM(UInt_RetInt, K, i))
+DEFINE_METASIG(SM(ULong_RetInt, L, i))
+DEFINE_METASIG(SM(UInt_RetUInt, K, K))
+DEFINE_METASIG(SM(ULong_RetULong, L, L))
+DEFINE_METASIG(SM(UInt_UInt_RetUInt, K K, K))
+DEFINE_METASIG(SM(ULong_ULong_RetULong, L L, L))
 DEFINE_METASIG(SM(RefDbl_Dbl_RetDbl, r(d) d, d))
 DEFINE_METASIG(SM(RefDbl_Dbl_Dbl_RetDbl, r(d) d d, d))
 DEFINE_METASIG(SM(RefLong_Long_RetLong, r(l) l, l))
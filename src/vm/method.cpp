@@ -2333,6 +2333,12 @@ PCODE MethodDesc::TryGetMultiCallableAddrOfCode(CORINFO_ACCESS_FLAGS accessFlags
     if (IsEnCMethod())
         return GetStableEntryPoint();
 
+#ifdef FEATURE_TIERED_COMPILATION
+    // Same for tiered compilation, the tier-0 code must not be handed out
+    if (IsEligibleForTieredCompilation())
+        return GetStableEntryPoint();
+#endif
+
     // If the method has already been jitted, we can give out the direct address
     // Note that we may have previously created a FuncPtrStubEntry, but
     // GetMultiCallableAddrOfCode() does not need to be idempotent.
@@ -2792,6 +2798,36 @@ BOOL MethodDesc::RequiresMethodDescCallingConvention(BOOL fEstimateForChunk /*=F
     return FALSE;
 }
 
+#ifdef FEATURE_TIERED_COMPILATION
+//*******************************************************************************
+BOOL MethodDesc::IsEligibleForTieredCompilation()
+{
+    WRAPPER_NO_CONTRACT;
+
+    // The native code slot holds the current code of the method. It is only allocated
+    // for the eligible methods, see code:MethodTableBuilder::NeedsNativeCodeSlot
+    if (!g_pConfig->TieredCompilation() || !HasNativeCodeSlot())
+        return FALSE;
+
+    if (GetClassification() != mcIL && GetClassification() != mcInstantiated)
+        return FALSE;
+
+    if (IsWrapperStub() || IsEnCMethod() || IsZapped())
+        return FALSE;
+
+    // Debuggable code is never optimized
+    if (CORDisableJITOptimizations(GetModule()->GetDebuggerInfoBits()))
+        return FALSE;
+
+    // ReJIT jump-stamps the code of the method, which would race with the tier-1 code
+    // being installed
+    if (ReJitManager::IsReJITEnabled())
+        return FALSE;
+
+    return TRUE;
+}
+#endif // FEATURE_TIERED_COMPILATION
+
 //*******************************************************************************
 BOOL MethodDesc::RequiresStableEntryPoint(BOOL fEstimateForChunk /*=FALSE*/)
 {
@@ -2801,6 +2837,12 @@ BOOL MethodDesc::RequiresStableEntryPoint(BOOL fEstimateForChunk /*=FALSE*/)
     if (IsEnCMethod() || IsEnCAddedMethod())
         return TRUE;
 
+#ifdef FEATURE_TIERED_COMPILATION
+    // Calls are counted and the code is replaced through the precode
+    if (IsEligibleForTieredCompilation())
+        return TRUE;
+#endif
+
     // Precreate precodes for LCG methods so we do not leak memory when the method descs are recycled
     if (IsLCGMethod())
         return TRUE;
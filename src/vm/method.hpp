@@ -734,6 +734,13 @@ public:
         return pModule->IsEditAndContinueEnabled();
     }
 
+#ifdef FEATURE_TIERED_COMPILATION
+    // Is this method allowed to start with tier-0 code and be rejitted with full
+    // optimization once it is hot? Like EnC methods, such methods are always called
+    // through their precode so the code can be replaced.
+    BOOL IsEligibleForTieredCompilation();
+#endif
+
     inline BOOL IsNotInline()
     {
         LIMITED_METHOD_CONTRACT;
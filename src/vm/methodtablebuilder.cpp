@@ -7198,6 +7198,19 @@ MethodTableBuilder::NeedsNativeCodeSlot(bmtMDMethod * pMDMethod)
     }
 #endif
 
+#ifdef FEATURE_TIERED_COMPILATION
+    // Approximation of code:MethodDesc::IsEligibleForTieredCompilation, the native code slot
+    // holds the tier-0 code and then the tier-1 code
+    if (g_pConfig->TieredCompilation() &&
+        !IsCompilationProcess() &&
+        pMDMethod->GetMethodType() == METHOD_TYPE_NORMAL &&
+        !IsMdAbstract(pMDMethod->GetDeclAttrs()) &&
+        !IsMiNoOptimization(pMDMethod->GetImplAttrs()))
+    {
+        return TRUE;
+    }
+#endif
+
     return GetModule()->IsEditAndContinueEnabled();
 }
 
@@ -256,7 +256,9 @@ public:
     void Init(PrecodeType t, MethodDesc* pMD, LoaderAllocator *pLoaderAllocator);
 
 #ifndef DACCESS_COMPILE
-    BOOL SetTargetInterlocked(PCODE target);
+    // Only a precode that points to the prestub is redirected unless fOnlyRedirectFromPrestub
+    // is FALSE, which tiered compilation uses to replace tier-0 code
+    BOOL SetTargetInterlocked(PCODE target, BOOL fOnlyRedirectFromPrestub = TRUE);
 
     // Reset precode to point to prestub
     void Reset();
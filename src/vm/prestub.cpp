@@ -1244,6 +1244,27 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
         pMT->CheckRunClassInitThrowing();
     }
 
+    /**************************   CALL COUNTING   ************************/
+    // The precode of a method that runs tier-0 code keeps pointing to the prestub
+    // until the method has been called often enough, so that every call is counted.
+    // Calls made before that run the current code without backpatching anything.
+    BOOL fCanBackpatchPrestub = TRUE;
+#ifdef FEATURE_TIERED_COMPILATION
+    BOOL fEligibleForTieredCompilation = IsEligibleForTieredCompilation();
+    if (fEligibleForTieredCompilation)
+    {
+        fCanBackpatchPrestub = GetAppDomain()->GetCallCounter()->OnMethodCalled(this);
+        if (!fCanBackpatchPrestub)
+        {
+            pCode = GetNativeCode();
+            if (pCode != NULL)
+            {
+                RETURN pCode;
+            }
+        }
+    }
+#endif // FEATURE_TIERED_COMPILATION
+
     /**************************   BACKPATCHING   *************************/
     // See if the addr of code has changed from the pre-stub
 #ifdef FEATURE_INTERPRETER
@@ -1375,7 +1396,18 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
             {
                 pCode = pModule->GetReadyToRunInfo()->GetEntryPoint(this);
                 if (pCode != NULL)
+                {
                     fReportCompilationFinished = TRUE;
+
+#ifdef FEATURE_TIERED_COMPILATION
+                    // The ReadyToRun code is the tier-0 code. Record it in the native code
+                    // slot so that later calls find it without looking it up again.
+                    if (fEligibleForTieredCompilation && !SetNativeCodeInterlocked(pCode))
+                    {
+                        pCode = GetNativeCode();
+                    }
+#endif // FEATURE_TIERED_COMPILATION
+                }
             }
         }
 #endif // FEATURE_READYTORUN
@@ -1452,7 +1484,21 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
             // Mark the code as hot in case the method ends up in the native image
             g_IBCLogger.LogMethodCodeAccess(this);
 
-            pCode = MakeJitWorker(pHeader, 0, 0);
+            DWORD dwJitFlags = 0;
+#ifdef FEATURE_TIERED_COMPILATION
+            // Tier-0 code is jitted quickly, the method is optimized once it is hot.
+            // With TieredPGO it also counts its blocks for the optimized jitting.
+            if (fEligibleForTieredCompilation)
+            {
+                dwJitFlags |= CORJIT_FLG_MIN_OPT;
+                if (g_pConfig->TieredPGO())
+                {
+                    dwJitFlags |= CORJIT_FLG_BBINSTR;
+                }
+            }
+#endif // FEATURE_TIERED_COMPILATION
+
+            pCode = MakeJitWorker(pHeader, dwJitFlags, 0);
 
 #ifdef FEATURE_INTERPRETER
             if ((pCode != NULL) && !HasStableEntryPoint())
@@ -1525,7 +1571,12 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
 
     /**************************   POSTJIT *************************/
 #ifndef FEATURE_INTERPRETER
+#ifdef FEATURE_TIERED_COMPILATION
+    // The tier-1 code may have been installed in the meantime
+    _ASSERTE(pCode == NULL || GetNativeCode() == NULL || pCode == GetNativeCode() || fEligibleForTieredCompilation);
+#else
     _ASSERTE(pCode == NULL || GetNativeCode() == NULL || pCode == GetNativeCode());
+#endif // FEATURE_TIERED_COMPILATION
 #else // FEATURE_INTERPRETER
     // Interpreter adds a new possiblity == someone else beat us to installing an intepreter stub.
     _ASSERTE(pCode == NULL || GetNativeCode() == NULL || pCode == GetNativeCode()
@@ -1580,7 +1631,11 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
     if (pCode != NULL)
     {
         if (HasPrecode())
-            GetPrecode()->SetTargetInterlocked(pCode);
+        {
+            // A precode that still counts calls must keep pointing to the prestub
+            if (fCanBackpatchPrestub)
+                GetPrecode()->SetTargetInterlocked(pCode);
+        }
         else
         if (!HasStableEntryPoint())
         {
@@ -1615,13 +1670,20 @@ PCODE MethodDesc::DoPrestub(MethodTable *pDispatchingMT)
 #ifdef FEATURE_INTERPRETER
     _ASSERTE(!IsReallyPointingToPrestub());
 #else // FEATURE_INTERPRETER
-    _ASSERTE(!IsPointingToPrestub());
+    _ASSERTE(!IsPointingToPrestub() || !fCanBackpatchPrestub);
     _ASSERTE(HasStableEntryPoint());
 #endif // FEATURE_INTERPRETER
 
     if (fReportCompilationFinished)
         DACNotifyCompilationFinished(this);
 
+    if (!fCanBackpatchPrestub)
+    {
+        // The stable entry point is the precode, which points to the prestub
+        _ASSERTE(pCode != NULL);
+        RETURN pCode;
+    }
+
     RETURN DoBackpatch(pMT, pDispatchingMT, FALSE);
 }
 
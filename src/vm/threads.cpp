@@ -2234,6 +2234,9 @@ Thread::Thread()
 #ifdef FEATURE_UNIX_AMD64_STRUCT_PASSING
     m_pHijackReturnTypeClass = NULL;
 #endif
+
+    m_allocSampleBytesLeft = 0;
+    m_allocSampleInterval = 0;
 }
 
 
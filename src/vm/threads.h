@@ -5601,6 +5601,11 @@ public:
 public:
 	ArenaStack m_arenaStack;
 
+	// Allocation sampling budget (see code:ETW::TypeSystemLog::SendAllocationSampleEvent).
+	// Kept after m_arenaStack so the offset the arena assembly helpers use doesn't move.
+	SIZE_T m_allocSampleBytesLeft;
+	SIZE_T m_allocSampleInterval;
+
 };
 
 // End of class Thread
@@ -7912,9 +7912,11 @@ BOOL Thread::HandledJITCase(BOOL ForTaskSwitchIn)
             // On platforms that support both hijacking and GC polling
             // decide whether to hijack based on a configuration value.  
             // COMPlus_GCPollType = 1 is the setting that enables hijacking
-            // in GCPOLL enabled builds.
+            // in GCPOLL enabled builds.  COMPlus_GCPollType = 4 only polls on
+            // loop back edges and relies on hijacking the returns as well.
             EEConfig::GCPollType pollType = g_pConfig->GetGCPollType();
-            if (EEConfig::GCPOLL_TYPE_HIJACK == pollType || EEConfig::GCPOLL_TYPE_DEFAULT == pollType)
+            if (EEConfig::GCPOLL_TYPE_HIJACK == pollType || EEConfig::GCPOLL_TYPE_DEFAULT == pollType ||
+                EEConfig::GCPOLL_TYPE_INLINE_LOOPS == pollType)
 #endif // FEATURE_ENABLE_GCPOLL
             {
                 HijackThread(pvHijackAddr, &esb);
@@ -0,0 +1,490 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+// ===========================================================================
+// File: TieredCompilation.CPP
+//
+// ===========================================================================
+
+
+
+#include "common.h"
+#include "excep.h"
+#include "log.h"
+#include "win32threadpool.h"
+#include "tieredcompilation.h"
+#include "eventtrace.h"
+#include "perfmap.h"
+
+// TieredCompilationManager determines which methods should be recompiled and
+// how they should be recompiled to best optimize the running code. It then
+// handles logistics of getting new code created and installed.
+//
+//
+// # Current feature state
+//
+// Methods that are eligible (see code:MethodDesc::IsEligibleForTieredCompilation)
+// start with tier-0 code: their ReadyToRun code if the module has some, or else
+// code jitted with MinOpts. Calls to a method are counted by code:CallCounter
+// while it runs tier-0 code. When the count reaches the threshold the method is
+// queued here and a thread pool work item jits it again with full optimization
+// (tier-1). The tier-1 code then replaces the tier-0 code in the native code slot
+// and in the precode. Only the two tiers exist.
+//
+// With TieredPGO the tier-0 code is also instrumented with a counter per basic
+// block (CORJIT_FLG_BBINSTR). The counters live in a buffer allocated here, see
+// AllocMethodProfileBuffer(), and the tier-1 jitting asks for them back
+// (CORJIT_FLG_BBOPT) so that block weights, and through them layout, loop
+// cloning and inlining, follow what the method actually did while it was cold.
+//
+//
+// # Important entrypoints in this code:
+//
+//
+// a) .ctor and Init(...) -  called once during AppDomain initialization
+// b) OnMethodCalled(...) -  called when a method is being invoked. When a method
+//                           has been called enough times this is currently the only
+//                           trigger that initiates re-compilation.
+// c) OnAppDomainShutdown() - called during AppDomain::Stop() to begin the process
+//                            of stopping tiered compilation. After this point no more
+//                            background optimization work will be initiated but any
+//                            work already in progress is still allowed to finish.
+//
+// # Overall workflow
+//
+// Methods initially call into code:MethodDesc::DoPrestub and produce tier-0 code
+// normally. While their call count is below the threshold DoPrestub returns the
+// tier-0 code without backpatching the precode, so the next call comes back to
+// the prestub and is counted again. When the threshold is reached
+// OnMethodCalled() queues the method and DoPrestub backpatches the precode to
+// the tier-0 code. The background thread dequeues the method, jits it and calls
+// InstallMethodCode() to point the precode at the tier-1 code. Code that calls
+// the method through the precode (or the slots backpatched with it) then runs
+// the tier-1 code. The tier-0 code stays allocated, threads may still be
+// running it.
+//
+// Tier-1 code is never replaced, so unlike code:ReJitManager nothing needs to
+// be jump-stamped or reverted. The precode is the only patch point.
+
+#ifdef FEATURE_TIERED_COMPILATION
+
+// Called at AppDomain construction
+TieredCompilationManager::TieredCompilationManager() :
+    m_isAppDomainShuttingDown(FALSE),
+    m_countOptimizationThreadsRunning(0),
+    m_callCountOptimizationThreshold(30)
+{
+    LIMITED_METHOD_CONTRACT;
+    m_lock.Init(LOCK_TYPE_DEFAULT);
+}
+
+// Called at AppDomain Init
+void TieredCompilationManager::Init(ADID appDomainId)
+{
+    CONTRACTL
+    {
+        THROWS;
+        GC_NOTRIGGER;
+        CAN_TAKE_LOCK;
+        MODE_ANY;
+    }
+    CONTRACTL_END;
+
+    m_profileLock.Init(CrstLeafLock, CRST_UNSAFE_ANYMODE);
+
+    SpinLockHolder holder(&m_lock);
+    m_domainId = appDomainId;
+    m_callCountOptimizationThreshold = g_pConfig->TieredCompilation_Tier1CallCountThreshold();
+}
+
+// Called each time code in this AppDomain has been run. This is our sole entrypoint to begin
+// tiered compilation for now. Returns TRUE if no more notifications are necessary, but
+// more notifications may come anyways.
+//
+// currentCallCount is pre-incremented, that is to say the value is 1 on first call for a given
+//      method.
+BOOL TieredCompilationManager::OnMethodCalled(MethodDesc* pMethodDesc, DWORD currentCallCount)
+{
+    STANDARD_VM_CONTRACT;
+
+    if (currentCallCount < m_callCountOptimizationThreshold)
+    {
+        return FALSE; // continue notifications for this method
+    }
+    else if (currentCallCount > m_callCountOptimizationThreshold)
+    {
+        return TRUE; // stop notifications for this method
+    }
+
+    // Insert the method into the optimization queue and trigger a thread to service
+    // the queue if needed.
+    //
+    // Terminal exceptions escape as exceptions, but all other errors should gracefully
+    // return to the caller. Non-terminal error conditions should be rare (ie OOM,
+    // OS failure to create thread) and we consider it reasonable for some methods
+    // to go unoptimized or have their optimization arbitrarily delayed under these
+    // circumstances. Note an error here could affect concurrent threads running this
+    // code. Those threads will observe m_countOptimizationThreadsRunning > 0 and return,
+    // then QueueUserWorkItem fails on this thread lowering the count and leaves them
+    // unserviced. Synchronous retries appear unlikely to offer any material improvement
+    // and complicating the code to narrow an already rare error case isn't desirable.
+    {
+        SListElem<MethodDesc*>* pMethodListItem = new (nothrow) SListElem<MethodDesc*>(pMethodDesc);
+        SpinLockHolder holder(&m_lock);
+        if (pMethodListItem != NULL)
+        {
+            m_methodsToOptimize.InsertTail(pMethodListItem);
+        }
+
+        if (0 == m_countOptimizationThreadsRunning && !m_isAppDomainShuttingDown)
+        {
+            // Our current policy throttles at 1 thread, but in the future we
+            // could experiment with more parallelism.
+            m_countOptimizationThreadsRunning++;
+        }
+        else
+        {
+            return TRUE; // stop notifications for this method
+        }
+    }
+
+    EX_TRY
+    {
+        if (!ThreadpoolMgr::QueueUserWorkItem(StaticOptimizeMethodsCallback, this, QUEUE_ONLY, TRUE))
+        {
+            SpinLockHolder holder(&m_lock);
+            m_countOptimizationThreadsRunning--;
+            STRESS_LOG1(LF_JIT, LL_WARNING, "TieredCompilationManager::OnMethodCalled: "
+                "ThreadpoolMgr::QueueUserWorkItem returned FALSE (no thread will run), method=%pM\n",
+                pMethodDesc);
+        }
+    }
+    EX_CATCH
+    {
+        SpinLockHolder holder(&m_lock);
+        m_countOptimizationThreadsRunning--;
+        STRESS_LOG2(LF_JIT, LL_WARNING, "TieredCompilationManager::OnMethodCalled: "
+            "Exception queuing work item to threadpool, hr=0x%x, method=%pM\n",
+            GET_EXCEPTION()->GetHR(), pMethodDesc);
+    }
+    EX_END_CATCH(RethrowTerminalExceptions);
+
+    return TRUE; // stop notifications for this method
+}
+
+void TieredCompilationManager::OnAppDomainShutdown()
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_NOTRIGGER;
+        MODE_ANY;
+        CAN_TAKE_LOCK;
+    }
+    CONTRACTL_END
+
+    SpinLockHolder holder(&m_lock);
+    m_isAppDomainShuttingDown = TRUE;
+}
+
+// Called by the JIT while it instruments the tier-0 code of a method. Returns a
+// zeroed buffer of blockCount counters that lives as long as the method's loader
+// allocator, or the buffer already allocated for the method if another thread
+// jitted it first; the block count only depends on the IL, so it is the same.
+ICorJitInfo::ProfileBuffer* TieredCompilationManager::AllocMethodProfileBuffer(MethodDesc* pMethodDesc, ULONG blockCount)
+{
+    STANDARD_VM_CONTRACT;
+
+    _ASSERTE(pMethodDesc->IsEligibleForTieredCompilation());
+
+    ULONG existingBlockCount;
+    ICorJitInfo::ProfileBuffer* pBlocks;
+    if (GetMethodProfileBuffer(pMethodDesc, &existingBlockCount, &pBlocks))
+    {
+        _ASSERTE(existingBlockCount == blockCount);
+        return pBlocks;
+    }
+
+    // The loader heap is not allocated from under the lock. If we lose the race
+    // with another thread the buffer is wasted, which only happens if the method is
+    // jitted twice concurrently.
+    LoaderAllocator* pLoaderAllocator = pMethodDesc->GetLoaderAllocator();
+    pBlocks = (ICorJitInfo::ProfileBuffer*)(void*)pLoaderAllocator->GetHighFrequencyHeap()->AllocMem(
+        S_SIZE_T(blockCount) * S_SIZE_T(sizeof(ICorJitInfo::ProfileBuffer)));
+
+    CrstHolder holder(&m_profileLock);
+    const MethodProfileEntry* pEntry = m_methodToProfile.LookupPtr(pMethodDesc);
+    if (pEntry != NULL)
+    {
+        return pEntry->pBlocks;
+    }
+    m_methodToProfile.Add(MethodProfileEntry(pMethodDesc, pLoaderAllocator, blockCount, pBlocks));
+    return pBlocks;
+}
+
+// Returns TRUE and the block counters of the tier-0 code of a method, if it was
+// instrumented. The counters keep changing while threads run the tier-0 code, the
+// JIT only needs them to be roughly right.
+BOOL TieredCompilationManager::GetMethodProfileBuffer(MethodDesc* pMethodDesc, ULONG* pBlockCount, ICorJitInfo::ProfileBuffer** ppBlocks)
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_NOTRIGGER;
+        CAN_TAKE_LOCK;
+        MODE_ANY;
+    }
+    CONTRACTL_END;
+
+    CrstHolder holder(&m_profileLock);
+    const MethodProfileEntry* pEntry = m_methodToProfile.LookupPtr(pMethodDesc);
+    if (pEntry == NULL)
+    {
+        return FALSE;
+    }
+    *pBlockCount = pEntry->blockCount;
+    *ppBlocks = pEntry->pBlocks;
+    return TRUE;
+}
+
+// Called when a collectible loader allocator is unloaded, before its MethodDescs
+// and heaps are freed. Forgets the counters of its methods so that a method later
+// allocated at the same address doesn't find them.
+void TieredCompilationManager::OnLoaderAllocatorUnloaded(LoaderAllocator* pLoaderAllocator)
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_NOTRIGGER;
+        CAN_TAKE_LOCK;
+        MODE_ANY;
+    }
+    CONTRACTL_END;
+
+    CrstHolder holder(&m_profileLock);
+    for (MethodProfileHash::Iterator it = m_methodToProfile.Begin(); it != m_methodToProfile.End(); it++)
+    {
+        if (it->pLoaderAllocator == pLoaderAllocator)
+        {
+            m_methodToProfile.Remove(it);
+        }
+    }
+}
+
+// This is the initial entrypoint for the background thread, called by
+// the threadpool.
+DWORD WINAPI TieredCompilationManager::StaticOptimizeMethodsCallback(void *args)
+{
+    STANDARD_VM_CONTRACT;
+
+    TieredCompilationManager * pTieredCompilationManager = (TieredCompilationManager *)args;
+    pTieredCompilationManager->OptimizeMethodsCallback();
+
+    return 0;
+}
+
+// This method will process one or more methods from optimization queue
+// on a background thread. Each such method will be jitted with code
+// optimizations enabled and then installed as the active implementation
+// of the method entrypoint.
+//
+// We need to be careful not to work for too long in a single invocation
+// of this method or we could starve the threadpool and force
+// it to create unnecessary additional threads.
+void TieredCompilationManager::OptimizeMethodsCallback()
+{
+    STANDARD_VM_CONTRACT;
+
+    // This app domain shutdown check isn't required for correctness
+    // but it should reduce some unneeded exceptions trying
+    // to enter a closed AppDomain
+    {
+        SpinLockHolder holder(&m_lock);
+        if (m_isAppDomainShuttingDown)
+        {
+            m_countOptimizationThreadsRunning--;
+            return;
+        }
+    }
+
+    ULONGLONG startTickCount = CLRGetTickCount64();
+    MethodDesc* pMethod = NULL;
+    EX_TRY
+    {
+        ENTER_DOMAIN_ID(m_domainId);
+        {
+            GCX_PREEMP();
+            while (true)
+            {
+                {
+                    SpinLockHolder holder(&m_lock);
+                    pMethod = GetNextMethodToOptimize();
+                    if (pMethod == NULL ||
+                        m_isAppDomainShuttingDown)
+                    {
+                        m_countOptimizationThreadsRunning--;
+                        break;
+                    }
+
+                }
+                OptimizeMethod(pMethod);
+
+                // If we have been running for too long return the thread to the threadpool and queue another event
+                // This gives the threadpool a chance to service other requests on this thread before returning to
+                // this work.
+                ULONGLONG currentTickCount = CLRGetTickCount64();
+                if (currentTickCount >= startTickCount + s_optimizationQuantumMs)
+                {
+                    if (!ThreadpoolMgr::QueueUserWorkItem(StaticOptimizeMethodsCallback, this, QUEUE_ONLY, TRUE))
+                    {
+                        SpinLockHolder holder(&m_lock);
+                        m_countOptimizationThreadsRunning--;
+                        STRESS_LOG0(LF_JIT, LL_WARNING, "TieredCompilationManager::OptimizeMethodsCallback: "
+                            "ThreadpoolMgr::QueueUserWorkItem returned FALSE (no thread will run)\n");
+                    }
+                    break;
+                }
+            }
+        }
+        END_DOMAIN_TRANSITION;
+    }
+    EX_CATCH
+    {
+        STRESS_LOG2(LF_JIT, LL_ERROR, "TieredCompilationManager::OptimizeMethodsCallback: "
+            "Unhandled exception during method optimization, hr=0x%x, last method=%pM\n",
+            GET_EXCEPTION()->GetHR(), pMethod);
+    }
+    EX_END_CATCH(RethrowTerminalExceptions);
+}
+
+// Jit compiles and installs new optimized code for a method.
+// Called on a background thread.
+void TieredCompilationManager::OptimizeMethod(MethodDesc* pMethod)
+{
+    STANDARD_VM_CONTRACT;
+
+    _ASSERTE(pMethod->IsEligibleForTieredCompilation());
+
+    SString namespaceOrClassName, methodName, methodSignature;
+    ETW::MethodLog::MethodJitting(pMethod, &namespaceOrClassName, &methodName, &methodSignature);
+
+    ULONG sizeOfCode = 0;
+    PCODE pCode = CompileMethod(pMethod, &sizeOfCode);
+    if (pCode == NULL)
+    {
+        // The method keeps running its tier-0 code
+        return;
+    }
+
+    ETW::MethodLog::MethodJitted(pMethod, &namespaceOrClassName, &methodName, &methodSignature, pCode, 0 /* ReJITID */);
+
+#ifdef FEATURE_PERFMAP
+    // Save the JIT'd method information so that perf can resolve JIT'd call frames.
+    PerfMap::LogJITCompiledMethod(pMethod, pCode, sizeOfCode);
+#endif
+
+#ifdef DEBUGGING_SUPPORTED
+    // Notify the debugger of the jitted function
+    if (g_pDebugInterface != NULL)
+    {
+        g_pDebugInterface->JITComplete(pMethod, pCode);
+    }
+#endif
+
+    InstallMethodCode(pMethod, pCode);
+}
+
+// Takes a method from the optimization queue and returns it.
+// Returns NULL if the queue is empty.
+// Callers are required to lock m_lock prior to calling this method.
+MethodDesc* TieredCompilationManager::GetNextMethodToOptimize()
+{
+    CONTRACTL
+    {
+        NOTHROW;
+        GC_NOTRIGGER;
+        MODE_ANY;
+    }
+    CONTRACTL_END;
+
+    SListElem<MethodDesc*>* pElem = m_methodsToOptimize.RemoveHead();
+    if (pElem != NULL)
+    {
+        MethodDesc* pMD = pElem->GetValue();
+        delete pElem;
+        return pMD;
+    }
+    return NULL;
+}
+
+// Returns the tier-1 code for the method, or NULL if the JIT failed. The flags
+// are the ones any other jitting of the method would use, GetCompileFlags turns
+// optimizations back on since CORJIT_FLG_MIN_OPT is not passed. If the tier-0
+// code counted its blocks the JIT is also asked to optimize with the counts.
+PCODE TieredCompilationManager::CompileMethod(MethodDesc* pMethod, ULONG* pSizeOfCode)
+{
+    STANDARD_VM_CONTRACT;
+
+    DWORD dwJitFlags = 0;
+    ULONG blockCount;
+    ICorJitInfo::ProfileBuffer* pBlocks;
+    if (GetMethodProfileBuffer(pMethod, &blockCount, &pBlocks))
+    {
+        dwJitFlags |= CORJIT_FLG_BBOPT;
+    }
+
+    PCODE pCode = NULL;
+    EX_TRY
+    {
+        COR_ILMETHOD_DECODER::DecoderStatus status;
+        NewHolder<COR_ILMETHOD_DECODER> pHeader(
+            new COR_ILMETHOD_DECODER(pMethod->GetILHeader(), pMethod->GetMDImport(), &status));
+
+        pCode = UnsafeJitFunction(pMethod, pHeader, dwJitFlags, 0, pSizeOfCode);
+    }
+    EX_CATCH
+    {
+        // Failing to jit tier-1 code leaves the method running its tier-0 code, there is
+        // no need to surface the failure.
+        STRESS_LOG2(LF_JIT, LL_WARNING, "TieredCompilationManager::CompileMethod: "
+            "Method %pM failed to jit, hr=0x%x\n",
+            pMethod, GET_EXCEPTION()->GetHR());
+    }
+    EX_END_CATCH(RethrowTerminalExceptions)
+
+    return pCode;
+}
+
+// Updates the MethodDesc and precode so that future invocations of a method will
+// execute the native code pointed to by pCode.
+// Called on a background thread.
+void TieredCompilationManager::InstallMethodCode(MethodDesc* pMethod, PCODE pCode)
+{
+    STANDARD_VM_CONTRACT;
+
+    _ASSERTE(pMethod->HasNativeCodeSlot());
+    _ASSERTE(pMethod->HasPrecode());
+
+    // Only the prestub stores tier-0 code and only this thread stores tier-1 code, so
+    // the native code slot can't change under us here.
+    PCODE pExistingCode = pMethod->GetNativeCode();
+    _ASSERTE(pExistingCode != NULL);
+    if (!pMethod->SetNativeCodeInterlocked(pCode, pExistingCode))
+    {
+        STRESS_LOG2(LF_JIT, LL_WARNING, "TieredCompilationManager::InstallMethodCode: "
+            "Native code slot of method %pM changed while installing code %p\n",
+            pMethod, pCode);
+        return;
+    }
+
+    // The precode points either at the prestub, if the calling thread that reached the
+    // threshold has not backpatched it yet, or at the tier-0 code. The prestub only
+    // backpatches a precode that still points at it, so this can lose the race at most
+    // once.
+    Precode* pPrecode = pMethod->GetPrecode();
+    while (!pPrecode->SetTargetInterlocked(pCode, FALSE))
+    {
+    }
+}
+
+#endif // FEATURE_TIERED_COMPILATION
@@ -0,0 +1,109 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+// ===========================================================================
+// File: TieredCompilation.h
+//
+// ===========================================================================
+
+
+#ifndef TIERED_COMPILATION_H
+#define TIERED_COMPILATION_H
+
+#ifdef FEATURE_TIERED_COMPILATION
+
+// One entry in our dictionary mapping methods to the block counts their
+// instrumented tier-0 code records. The counters are allocated on the heap of
+// the method's loader allocator.
+struct MethodProfileEntry
+{
+    MethodProfileEntry() {}
+    MethodProfileEntry(const MethodDesc* m, LoaderAllocator* a, ULONG c, ICorJitInfo::ProfileBuffer* b)
+        : pMethod(m), pLoaderAllocator(a), blockCount(c), pBlocks(b) {}
+
+    const MethodDesc* pMethod;
+    LoaderAllocator* pLoaderAllocator;
+    ULONG blockCount;
+    ICorJitInfo::ProfileBuffer* pBlocks;
+};
+
+class MethodProfileEntryHashTraits : public DefaultSHashTraits<MethodProfileEntry>
+{
+public:
+    typedef typename DefaultSHashTraits<MethodProfileEntry>::element_t element_t;
+    typedef typename DefaultSHashTraits<MethodProfileEntry>::count_t count_t;
+
+    typedef const MethodDesc* key_t;
+
+    static key_t GetKey(element_t e)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return e.pMethod;
+    }
+    static BOOL Equals(key_t k1, key_t k2)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return k1 == k2;
+    }
+    static count_t Hash(key_t k)
+    {
+        LIMITED_METHOD_CONTRACT;
+        return (count_t)(size_t)k;
+    }
+
+    static const element_t Null() { LIMITED_METHOD_CONTRACT; return element_t(NULL, NULL, 0, NULL); }
+    static bool IsNull(const element_t &e) { LIMITED_METHOD_CONTRACT; return e.pMethod == NULL; }
+    static const element_t Deleted() { LIMITED_METHOD_CONTRACT; return element_t((const MethodDesc*)-1, NULL, 0, NULL); }
+    static bool IsDeleted(const element_t &e) { LIMITED_METHOD_CONTRACT; return e.pMethod == (const MethodDesc*)-1; }
+};
+
+typedef SHash<MethodProfileEntryHashTraits> MethodProfileHash;
+
+// TieredCompilationManager determines which methods should be recompiled and
+// how they should be recompiled to best optimize the running code. It then
+// handles logistics of getting new code created and installed.
+class TieredCompilationManager
+{
+public:
+#if defined(DACCESS_COMPILE) || defined(CROSSGEN_COMPILE)
+    TieredCompilationManager() {}
+#else
+    TieredCompilationManager();
+#endif
+
+    void Init(ADID appDomainId);
+    BOOL OnMethodCalled(MethodDesc* pMethodDesc, DWORD currentCallCount);
+    void OnAppDomainShutdown();
+
+    ICorJitInfo::ProfileBuffer* AllocMethodProfileBuffer(MethodDesc* pMethodDesc, ULONG blockCount);
+    BOOL GetMethodProfileBuffer(MethodDesc* pMethodDesc, ULONG* pBlockCount, ICorJitInfo::ProfileBuffer** ppBlocks);
+    void OnLoaderAllocatorUnloaded(LoaderAllocator* pLoaderAllocator);
+
+private:
+
+    static DWORD WINAPI StaticOptimizeMethodsCallback(void* args);
+    void OptimizeMethodsCallback();
+    void OptimizeMethod(MethodDesc* pMethod);
+    MethodDesc* GetNextMethodToOptimize();
+    PCODE CompileMethod(MethodDesc* pMethod, ULONG* pSizeOfCode);
+    void InstallMethodCode(MethodDesc* pMethod, PCODE pCode);
+
+    // Time a worker spends optimizing methods before it gives its thread back
+    // to the thread pool and queues another work item for the rest
+    static const DWORD s_optimizationQuantumMs = 50;
+
+    SpinLock m_lock;
+    SList<SListElem<MethodDesc*> > m_methodsToOptimize;
+
+    // Adding to the hash allocates, so it has its own lock rather than m_lock
+    CrstExplicitInit m_profileLock;
+    MethodProfileHash m_methodToProfile;
+    ADID m_domainId;
+    BOOL m_isAppDomainShuttingDown;
+    DWORD m_countOptimizationThreadsRunning;
+    DWORD m_callCountOptimizationThreshold;
+};
+
+#endif // FEATURE_TIERED_COMPILATION
+
+#endif // TIERED_COMPILATION_H
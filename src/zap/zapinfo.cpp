@@ -3282,6 +3282,16 @@ unsigned ZapInfo::getClassSize(CORINFO_CLASS_HANDLE cls)
     return size;
 }
 
+unsigned ZapInfo::getHeapClassSize(CORINFO_CLASS_HANDLE cls)
+{
+    // The layout of classes from other version bubbles can change after the
+    // image is built, so ready-to-run code can't depend on their heap size
+    if (IsReadyToRunCompilation())
+        return 0;
+
+    return m_pEEJitInfo->getHeapClassSize(cls);
+}
+
 unsigned ZapInfo::getClassAlignmentRequirement(CORINFO_CLASS_HANDLE cls, BOOL fDoubleAlignHint)
 {
     return m_pEEJitInfo->getClassAlignmentRequirement(cls, fDoubleAlignHint);
@@ -3650,6 +3660,18 @@ void ZapInfo::getMethodVTableOffset(CORINFO_METHOD_HANDLE method,
     m_pEEJitInfo->getMethodVTableOffset(method, pOffsetOfIndirection, pOffsetAfterIndirection);
 }
 
+CORINFO_METHOD_HANDLE ZapInfo::resolveVirtualMethod(CORINFO_METHOD_HANDLE virtualMethod,
+                                                    CORINFO_CLASS_HANDLE implementingClass,
+                                                    CORINFO_CONTEXT_HANDLE ownerType)
+{
+    // A direct call would bake the current shape of the class hierarchy into
+    // the image, which version resilient code must not depend on
+    if (IsReadyToRunCompilation())
+        return NULL;
+
+    return m_pEEJitInfo->resolveVirtualMethod(virtualMethod, implementingClass, ownerType);
+}
+
 CorInfoIntrinsics ZapInfo::getIntrinsicID(CORINFO_METHOD_HANDLE method,
                                           bool * pMustExpand)
 {
@@ -0,0 +1,225 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+// Tests GC.AllocatePinnedByteArray: the arrays it returns live on the pinned
+// object heap, so they keep their address across compacting gen2 GCs (LOH
+// compaction included) and are still reclaimed once unreachable.
+
+using System;
+using System.Runtime;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+public class AllocatePinnedByteArrayTest
+{
+    private const int Rounds = 10;
+
+    private static int s_numTests = 0;
+
+    private static IntPtr AddressOf(byte[] array)
+    {
+        GCHandle handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+        IntPtr address = handle.AddrOfPinnedObject();
+        handle.Free();
+        return address;
+    }
+
+    private static void CompactingCollect()
+    {
+        GCSettings.LargeObjectHeapCompactionMode = GCLargeObjectHeapCompactionMode.CompactOnce;
+        GC.Collect(2, GCCollectionMode.Forced, true, true);
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private static WeakReference AllocateUnreachable()
+    {
+        return new WeakReference(GC.AllocatePinnedByteArray(10000));
+    }
+
+
+    private bool allocateTest()
+    {
+        s_numTests++;
+
+        foreach (int length in new int[] { 1, 100, 4096, 100000 })
+        {
+            byte[] array = GC.AllocatePinnedByteArray(length);
+            if (array == null || array.Length != length)
+            {
+                Console.WriteLine("AllocatePinnedByteArray({0}) returned a wrong array", length);
+                Console.WriteLine("allocateTest Failed!");
+                return false;
+            }
+
+            for (int i = 0; i < length; i++)
+            {
+                if (array[i] != 0)
+                {
+                    Console.WriteLine("AllocatePinnedByteArray({0}) returned a dirty array", length);
+                    Console.WriteLine("allocateTest Failed!");
+                    return false;
+                }
+                array[i] = (byte)i;
+            }
+        }
+
+        Console.WriteLine("allocateTest Passed!");
+        return true;
+    }
+
+
+    private bool lengthTest()
+    {
+        s_numTests++;
+
+        byte[] empty = GC.AllocatePinnedByteArray(0);
+        if (empty == null || empty.Length != 0)
+        {
+            Console.WriteLine("AllocatePinnedByteArray(0) didn't return an empty array");
+            Console.WriteLine("lengthTest Failed!");
+            return false;
+        }
+
+        foreach (int length in new int[] { -1, Int32.MinValue })
+        {
+            try
+            {
+                GC.AllocatePinnedByteArray(length);
+                Console.WriteLine("AllocatePinnedByteArray({0}) didn't throw", length);
+                Console.WriteLine("lengthTest Failed!");
+                return false;
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine("Unexpected exception thrown:");
+                Console.WriteLine(e);
+                Console.WriteLine("lengthTest Failed!");
+                return false;
+            }
+        }
+
+        Console.WriteLine("lengthTest Passed!");
+        return true;
+    }
+
+
+    private bool noMoveTest()
+    {
+        s_numTests++;
+
+        // Dead pinned arrays and small objects on both sides of the live arrays,
+        // so that compacting the heaps would have somewhere to slide them to.
+        byte[][] live = new byte[8][];
+        object[] garbage = new object[live.Length];
+        for (int i = 0; i < live.Length; i++)
+        {
+            garbage[i] = GC.AllocatePinnedByteArray(1000 * (i + 1));
+            live[i] = GC.AllocatePinnedByteArray(1000 * (i + 1));
+            for (int j = 0; j < live[i].Length; j++)
+            {
+                live[i][j] = (byte)(i + j);
+            }
+            garbage[i] = new byte[500];
+        }
+        garbage = null;
+
+        IntPtr[] addresses = new IntPtr[live.Length];
+        for (int i = 0; i < live.Length; i++)
+        {
+            addresses[i] = AddressOf(live[i]);
+        }
+
+        for (int round = 0; round < Rounds; round++)
+        {
+            CompactingCollect();
+
+            for (int i = 0; i < live.Length; i++)
+            {
+                if (AddressOf(live[i]) != addresses[i])
+                {
+                    Console.WriteLine("Pinned array {0} moved in round {1}", i, round);
+                    Console.WriteLine("noMoveTest Failed!");
+                    return false;
+                }
+                for (int j = 0; j < live[i].Length; j++)
+                {
+                    if (live[i][j] != (byte)(i + j))
+                    {
+                        Console.WriteLine("Pinned array {0} was corrupted in round {1}", i, round);
+                        Console.WriteLine("noMoveTest Failed!");
+                        return false;
+                    }
+                }
+            }
+        }
+
+        GC.KeepAlive(live);
+        Console.WriteLine("noMoveTest Passed!");
+        return true;
+    }
+
+
+    private bool reclaimTest()
+    {
+        s_numTests++;
+
+        WeakReference weak = AllocateUnreachable();
+        CompactingCollect();
+
+        if (weak.IsAlive)
+        {
+            Console.WriteLine("An unreachable pinned array wasn't reclaimed");
+            Console.WriteLine("reclaimTest Failed!");
+            return false;
+        }
+
+        Console.WriteLine("reclaimTest Passed!");
+        return true;
+    }
+
+
+    public bool RunTests()
+    {
+        int numPassed = 0;
+
+        if (allocateTest())
+            numPassed++;
+
+        if (lengthTest())
+            numPassed++;
+
+        if (noMoveTest())
+            numPassed++;
+
+        if (reclaimTest())
+            numPassed++;
+
+
+        Console.WriteLine();
+        if (s_numTests == numPassed)
+            return true;
+
+        return false;
+    }
+
+
+
+    public static int Main()
+    {
+        AllocatePinnedByteArrayTest t = new AllocatePinnedByteArrayTest();
+
+        if (t.RunTests())
+        {
+            Console.WriteLine("Test for AllocatePinnedByteArray() passed!");
+            return 100;
+        }
+
+
+        Console.WriteLine("Test for AllocatePinnedByteArray() FAILED!");
+        return 1;
+    }
+}
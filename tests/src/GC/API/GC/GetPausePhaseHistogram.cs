@@ -0,0 +1,258 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+// Tests GC.GetPausePhaseHistogram: every blocking GC adds one count to the
+// histogram of each phase it went through, the buckets array is filled with as
+// many of the runtime's buckets as it has room for, and invalid arguments throw.
+
+using System;
+
+public class GetPausePhaseHistogramTest
+{
+    // the number of buckets the runtime keeps
+    private const int Buckets = 24;
+    private const int Collections = 5;
+
+    private static int s_numTests = 0;
+
+    private static long Count(GCPausePhase phase, out long total)
+    {
+        long[] buckets = new long[Buckets];
+        total = GC.GetPausePhaseHistogram(phase, buckets);
+
+        long count = 0;
+        for (int i = 0; i < buckets.Length; i++)
+        {
+            count += buckets[i];
+        }
+        return count;
+    }
+
+    private static long Count(GCPausePhase phase)
+    {
+        long total;
+        return Count(phase, out total);
+    }
+
+    private static void Collect(bool compacting)
+    {
+        // A GC is recorded after it restarts the EE, so with server GC the last one
+        // may not show up yet when this thread wakes up.
+        for (int i = 0; i < Collections + 1; i++)
+        {
+            GC.Collect(2, GCCollectionMode.Forced, true, compacting);
+        }
+    }
+
+
+    private bool countTest()
+    {
+        s_numTests++;
+
+        GCPausePhase[] phases = { GCPausePhase.Suspend, GCPausePhase.MarkRoots, GCPausePhase.Resume };
+        long[] counts = new long[phases.Length];
+        long[] totals = new long[phases.Length];
+
+        for (int i = 0; i < phases.Length; i++)
+        {
+            counts[i] = Count(phases[i], out totals[i]);
+        }
+
+        Collect(false);
+
+        for (int i = 0; i < phases.Length; i++)
+        {
+            long total;
+            long count = Count(phases[i], out total);
+            if (count < counts[i] + Collections)
+            {
+                Console.WriteLine("{0}: {1} GCs counted, expected at least {2}", phases[i], count - counts[i], Collections);
+                Console.WriteLine("countTest Failed!");
+                return false;
+            }
+            if (total < totals[i])
+            {
+                Console.WriteLine("{0}: the total time went down from {1} to {2}", phases[i], totals[i], total);
+                Console.WriteLine("countTest Failed!");
+                return false;
+            }
+        }
+
+        Console.WriteLine("countTest Passed!");
+        return true;
+    }
+
+
+    private bool skippedPhaseTest()
+    {
+        s_numTests++;
+
+        // A GC either compacts or sweeps, so together the two phases can't have
+        // been counted more often than there were GCs.
+        int gcs = GC.CollectionCount(0);
+        long compacts = Count(GCPausePhase.Compact);
+        long sweeps = Count(GCPausePhase.Sweep);
+
+        Collect(true);
+
+        gcs = GC.CollectionCount(0) - gcs;
+        compacts = Count(GCPausePhase.Compact) - compacts;
+        sweeps = Count(GCPausePhase.Sweep) - sweeps;
+
+        if (compacts < Collections)
+        {
+            Console.WriteLine("{0} compacting GCs counted, expected at least {1}", compacts, Collections);
+            Console.WriteLine("skippedPhaseTest Failed!");
+            return false;
+        }
+        if (compacts + sweeps > gcs)
+        {
+            Console.WriteLine("{0} compacts and {1} sweeps counted for {2} GCs", compacts, sweeps, gcs);
+            Console.WriteLine("skippedPhaseTest Failed!");
+            return false;
+        }
+
+        Console.WriteLine("skippedPhaseTest Passed!");
+        return true;
+    }
+
+
+    private bool partialFillTest()
+    {
+        s_numTests++;
+
+        GC.Collect(2, GCCollectionMode.Forced, true);
+
+        // The counts only grow, so the short array read first can't be ahead of the full one.
+        long[] small = new long[] { -1, -1, -1 };
+        long[] full = new long[Buckets + 4];
+        for (int i = 0; i < full.Length; i++)
+        {
+            full[i] = -1;
+        }
+
+        GC.GetPausePhaseHistogram(GCPausePhase.MarkRoots, small);
+        GC.GetPausePhaseHistogram(GCPausePhase.MarkRoots, full);
+
+        for (int i = 0; i < small.Length; i++)
+        {
+            if (small[i] < 0 || small[i] > full[i])
+            {
+                Console.WriteLine("Short array: bucket {0} is {1}, full array has {2}", i, small[i], full[i]);
+                Console.WriteLine("partialFillTest Failed!");
+                return false;
+            }
+        }
+        for (int i = 0; i < full.Length; i++)
+        {
+            if ((i < Buckets) ? (full[i] < 0) : (full[i] != -1))
+            {
+                Console.WriteLine("Long array: bucket {0} is {1}", i, full[i]);
+                Console.WriteLine("partialFillTest Failed!");
+                return false;
+            }
+        }
+
+        // An empty array only gets the total.
+        if (GC.GetPausePhaseHistogram(GCPausePhase.MarkRoots, new long[0]) < 0)
+        {
+            Console.WriteLine("Empty array: negative total");
+            Console.WriteLine("partialFillTest Failed!");
+            return false;
+        }
+
+        Console.WriteLine("partialFillTest Passed!");
+        return true;
+    }
+
+
+    private bool argumentTest()
+    {
+        s_numTests++;
+
+        foreach (GCPausePhase phase in new GCPausePhase[] { (GCPausePhase)(GCPausePhase.Suspend - 1), (GCPausePhase)(GCPausePhase.Resume + 1) })
+        {
+            try
+            {
+                GC.GetPausePhaseHistogram(phase, new long[Buckets]);
+                Console.WriteLine("Invalid phase {0} didn't throw", (int)phase);
+                Console.WriteLine("argumentTest Failed!");
+                return false;
+            }
+            catch (ArgumentOutOfRangeException)
+            {
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine("Unexpected exception thrown:");
+                Console.WriteLine(e);
+                Console.WriteLine("argumentTest Failed!");
+                return false;
+            }
+        }
+
+        try
+        {
+            GC.GetPausePhaseHistogram(GCPausePhase.Suspend, null);
+            Console.WriteLine("Null buckets didn't throw");
+            Console.WriteLine("argumentTest Failed!");
+            return false;
+        }
+        catch (ArgumentNullException)
+        {
+        }
+        catch (Exception e)
+        {
+            Console.WriteLine("Unexpected exception thrown:");
+            Console.WriteLine(e);
+            Console.WriteLine("argumentTest Failed!");
+            return false;
+        }
+
+        Console.WriteLine("argumentTest Passed!");
+        return true;
+    }
+
+
+    public bool RunTests()
+    {
+        int numPassed = 0;
+
+        if (countTest())
+            numPassed++;
+
+        if (skippedPhaseTest())
+            numPassed++;
+
+        if (partialFillTest())
+            numPassed++;
+
+        if (argumentTest())
+            numPassed++;
+
+
+        Console.WriteLine();
+        if (s_numTests == numPassed)
+            return true;
+
+        return false;
+    }
+
+
+
+    public static int Main()
+    {
+        GetPausePhaseHistogramTest t = new GetPausePhaseHistogramTest();
+
+        if (t.RunTests())
+        {
+            Console.WriteLine("Test for GetPausePhaseHistogram() passed!");
+            return 100;
+        }
+
+
+        Console.WriteLine("Test for GetPausePhaseHistogram() FAILED!");
+        return 1;
+    }
+}
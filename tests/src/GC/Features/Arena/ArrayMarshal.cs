@@ -0,0 +1,226 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+// Tests Array.Copy between an arena and the GC heap, which marshals every element
+// into the destination's heap.  Marshaling into the GC heap allocates, so this
+// copies arrays of object graphs and of structs with references while another
+// thread keeps forcing compacting collections, and checks every cloned element.
+// Run it under GCStress as well to get a GC at every allocation of the marshal.
+
+using System;
+using System.Threading;
+
+public class ArrayMarshalTest
+{
+    private const int Length = 5000;
+    private const int Rounds = 20;
+
+    private class Node
+    {
+        public string Name;
+        public int[] Values;
+        public Node Next;
+    }
+
+    private struct Entry
+    {
+        public string Key;
+        public long Value;
+        public Node Node;
+    }
+
+    private static int s_numTests = 0;
+    private static volatile bool s_done;
+
+    private static Node MakeNode(int i)
+    {
+        Node node = new Node();
+        node.Name = "node" + i;
+        node.Values = new int[i % 17 + 1];
+        for (int j = 0; j < node.Values.Length; j++)
+        {
+            node.Values[j] = i * 31 + j;
+        }
+        node.Next = new Node();
+        node.Next.Name = "next" + i;
+        return node;
+    }
+
+    private static bool CheckNode(Node node, int i)
+    {
+        if (node == null || node.Name != "node" + i || node.Values.Length != i % 17 + 1)
+            return false;
+        for (int j = 0; j < node.Values.Length; j++)
+        {
+            if (node.Values[j] != i * 31 + j)
+                return false;
+        }
+        return node.Next != null && node.Next.Name == "next" + i && node.Next.Next == null;
+    }
+
+    private static void Fill(Node[] nodes, Entry[] entries)
+    {
+        for (int i = 0; i < Length; i++)
+        {
+            // Leave some null elements, which are copied without marshaling.
+            nodes[i] = (i % 10 == 9) ? null : MakeNode(i);
+            entries[i].Key = "key" + i;
+            entries[i].Value = (long)i << 33;
+            entries[i].Node = MakeNode(i);
+        }
+    }
+
+    private static bool Check(string what, Node[] nodes, Entry[] entries)
+    {
+        for (int i = 0; i < Length; i++)
+        {
+            bool ok = (i % 10 == 9) ? nodes[i] == null : CheckNode(nodes[i], i);
+            ok &= entries[i].Key == "key" + i && entries[i].Value == (long)i << 33 && CheckNode(entries[i].Node, i);
+            if (!ok)
+            {
+                Console.WriteLine("{0}: element {1} is wrong", what, i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private static void Collector()
+    {
+        while (!s_done)
+        {
+            GC.Collect(2, GCCollectionMode.Forced, true, true);
+            Thread.Sleep(1);
+        }
+    }
+
+    private static bool Round()
+    {
+        // Garbage between the copies, so that the compactions move the clones.
+        object[] garbage = new object[100];
+
+        GC.PushNewArena();
+        Node[] arenaNodes = new Node[Length];
+        Entry[] arenaEntries = new Entry[Length];
+        Fill(arenaNodes, arenaEntries);
+        GC.PopArena();
+
+        // Arena to GC heap: every clone is a GC allocation.
+        Node[] gcNodes = new Node[Length];
+        Entry[] gcEntries = new Entry[Length];
+        for (int i = 0; i < garbage.Length; i++)
+        {
+            garbage[i] = new byte[1000];
+        }
+        Array.Copy(arenaNodes, gcNodes, Length);
+        Array.Copy(arenaEntries, gcEntries, Length);
+        garbage = null;
+        if (!Check("arena to GC heap", gcNodes, gcEntries))
+            return false;
+
+        // GC heap to arena.
+        GC.PushNewArena();
+        Node[] arenaCopy = new Node[Length];
+        Entry[] arenaEntryCopy = new Entry[Length];
+        Array.Copy(gcNodes, arenaCopy, Length);
+        Array.Copy(gcEntries, arenaEntryCopy, Length);
+        GC.PopArena();
+        return Check("GC heap to arena", arenaCopy, arenaEntryCopy);
+    }
+
+
+    private bool marshalUnderGCTest()
+    {
+        s_numTests++;
+
+        Thread collector = new Thread(Collector);
+        collector.Start();
+
+        bool passed = true;
+        for (int i = 0; i < Rounds && passed; i++)
+        {
+            passed = Round();
+        }
+
+        s_done = true;
+        collector.Join();
+
+        Console.WriteLine(passed ? "marshalUnderGCTest Passed!" : "marshalUnderGCTest Failed!");
+        return passed;
+    }
+
+
+    private bool constrainedCopyTest()
+    {
+        s_numTests++;
+
+        // Marshaling allocates and so can fail partway, which ConstrainedCopy
+        // must never do; it refuses to copy references between heaps instead.
+        GC.PushNewArena();
+        Node[] arenaNodes = new Node[] { MakeNode(0), MakeNode(1) };
+        GC.PopArena();
+        Node[] gcNodes = new Node[arenaNodes.Length];
+
+        try
+        {
+            Array.ConstrainedCopy(arenaNodes, 0, gcNodes, 0, arenaNodes.Length);
+        }
+        catch (ArrayTypeMismatchException)
+        {
+            if (gcNodes[0] == null && gcNodes[1] == null)
+            {
+                Console.WriteLine("constrainedCopyTest Passed!");
+                return true;
+            }
+
+            Console.WriteLine("ConstrainedCopy threw after copying elements");
+            Console.WriteLine("constrainedCopyTest Failed!");
+            return false;
+        }
+        catch (Exception e)
+        {
+            Console.WriteLine("Unexpected exception thrown:");
+            Console.WriteLine(e);
+        }
+
+        Console.WriteLine("constrainedCopyTest Failed!");
+        return false;
+    }
+
+
+    public bool RunTests()
+    {
+        int numPassed = 0;
+
+        if (marshalUnderGCTest())
+            numPassed++;
+
+        if (constrainedCopyTest())
+            numPassed++;
+
+
+        Console.WriteLine();
+        if (s_numTests == numPassed)
+            return true;
+
+        return false;
+    }
+
+
+
+    public static int Main()
+    {
+        ArrayMarshalTest t = new ArrayMarshalTest();
+
+        if (t.RunTests())
+        {
+            Console.WriteLine("Test for arena array marshaling passed!");
+            return 100;
+        }
+
+
+        Console.WriteLine("Test for arena array marshaling FAILED!");
+        return 1;
+    }
+}
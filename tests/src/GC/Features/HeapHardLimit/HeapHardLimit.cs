@@ -0,0 +1,152 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+// Tests GCHeapHardLimitMB: with the limit set to 100MB (see the csproj),
+// holding on to more than that in either the small or the large object heap
+// throws OutOfMemoryException, and the memory can be allocated again once it
+// is released.
+
+using System;
+using System.Collections.Generic;
+
+public class HeapHardLimitTest
+{
+    private const long HardLimit = 100 * 1024 * 1024;
+
+    // Below and above the large object threshold
+    private const int SmallArraySize = 8 * 1024;
+    private const int LargeArraySize = 1024 * 1024;
+
+    private static int s_numTests = 0;
+
+    // Holds on to arrays of arraySize bytes until an allocation fails, or until
+    // twice the limit is held. Returns how many bytes were held.
+    private static long FillHeap(int arraySize, out bool outOfMemory)
+    {
+        List<byte[]> held = new List<byte[]>();
+        long heldBytes = 0;
+        outOfMemory = false;
+
+        try
+        {
+            while (heldBytes < 2 * HardLimit)
+            {
+                held.Add(new byte[arraySize]);
+                heldBytes += arraySize;
+            }
+        }
+        catch (OutOfMemoryException)
+        {
+            outOfMemory = true;
+        }
+
+        held = null;
+        GC.Collect();
+        return heldBytes;
+    }
+
+    private static bool CheckLimit(string name, int arraySize)
+    {
+        bool outOfMemory;
+        long heldBytes = FillHeap(arraySize, out outOfMemory);
+
+        if (!outOfMemory)
+        {
+            Console.WriteLine("Held {0} bytes without running out of memory", heldBytes);
+            Console.WriteLine("{0} Failed!", name);
+            return false;
+        }
+
+        if (heldBytes > HardLimit)
+        {
+            Console.WriteLine("Held {0} bytes, more than the limit", heldBytes);
+            Console.WriteLine("{0} Failed!", name);
+            return false;
+        }
+
+        Console.WriteLine("{0} Passed!", name);
+        return true;
+    }
+
+
+    private bool smallObjectTest()
+    {
+        s_numTests++;
+        return CheckLimit("smallObjectTest", SmallArraySize);
+    }
+
+
+    private bool largeObjectTest()
+    {
+        s_numTests++;
+        return CheckLimit("largeObjectTest", LargeArraySize);
+    }
+
+
+    private bool recoverTest()
+    {
+        s_numTests++;
+
+        // The earlier tests ran out of memory and released it all again, so
+        // half the limit has to fit.
+        List<byte[]> held = new List<byte[]>();
+
+        try
+        {
+            for (long heldBytes = 0; heldBytes < HardLimit / 2; heldBytes += LargeArraySize)
+            {
+                held.Add(new byte[LargeArraySize]);
+            }
+        }
+        catch (OutOfMemoryException)
+        {
+            Console.WriteLine("Ran out of memory holding {0} arrays", held.Count);
+            Console.WriteLine("recoverTest Failed!");
+            return false;
+        }
+
+        GC.KeepAlive(held);
+        Console.WriteLine("recoverTest Passed!");
+        return true;
+    }
+
+
+    public bool RunTests()
+    {
+        int numPassed = 0;
+
+        if (smallObjectTest())
+            numPassed++;
+
+        if (largeObjectTest())
+            numPassed++;
+
+        if (recoverTest())
+            numPassed++;
+
+
+        Console.WriteLine();
+        if (s_numTests == numPassed)
+            return true;
+
+        return false;
+    }
+
+
+
+    public static int Main()
+    {
+        HeapHardLimitTest t = new HeapHardLimitTest();
+
+        if (t.RunTests())
+        {
+            Console.WriteLine("Test for GCHeapHardLimitMB passed!");
+            return 100;
+        }
+
+
+        Console.WriteLine("Test for GCHeapHardLimitMB FAILED!");
+        return 1;
+    }
+}
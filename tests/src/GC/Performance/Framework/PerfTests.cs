@@ -14,6 +14,7 @@ namespace GCPerfTestFramework
     {
         const string ConcurrentGC = "COMPLUS_gcConcurrent";
         const string ServerGC = "COMPLUS_gcServer";
+        const string GCPollType = "COMPLUS_GCPollType";
 
         [Benchmark]
         public void ClientSimulator_Concurrent()
@@ -265,5 +266,37 @@ namespace GCPerfTestFramework
                 }
             }
         }
+
+        [Benchmark]
+        public void SuspendLatency()
+        {
+            var exe = ProcessFactory.ProbeForFile("SuspendLatency.exe");
+            foreach (var iteration in Benchmark.Iterations)
+            {
+                using (iteration.StartMeasurement())
+                {
+                    ProcessFactory.LaunchProcess(exe);
+                }
+            }
+        }
+
+        [Benchmark]
+        public void SuspendLatency_LoopPolls()
+        {
+            var exe = ProcessFactory.ProbeForFile("SuspendLatency.exe");
+            var env = new Dictionary<string, string>()
+            {
+                // GCPOLL_TYPE_INLINE_LOOPS
+                [GCPollType] = "4"
+            };
+
+            foreach (var iteration in Benchmark.Iterations)
+            {
+                using (iteration.StartMeasurement())
+                {
+                    ProcessFactory.LaunchProcess(exe, environmentVariables: env);
+                }
+            }
+        }
     }
 }
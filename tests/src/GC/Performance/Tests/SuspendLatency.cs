@@ -0,0 +1,165 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+using System;
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+// Measures how long it takes to suspend threads that spin in loops without calls.
+// Such threads can only be stopped by interrupting them or by a GC poll on the loop
+// back edge (COMPlus_GCPollType=4), so each gen0 GC here is dominated by the time
+// it takes to bring them to a safe point.
+//
+// The recursive mutator runs deep call chains with no loops in them instead, which
+// the loop back edge polls never see: those threads have to be stopped by hijacking
+// their returns, which COMPlus_GCPollType=4 must keep doing.
+class SuspendLatency
+{
+    const int RecursionDepth = 2000;
+
+    static volatile bool s_stop;
+    static long[] s_sums;
+
+    // No calls in either loop, the inner one is long enough that a GC usually
+    // finds the thread in it.
+    static void Spin(object state)
+    {
+        int index = (int)state;
+        int[] data = new int[4096];
+        for (int i = 0; i < data.Length; i++)
+        {
+            data[i] = i;
+        }
+
+        long sum = 0;
+        while (!s_stop)
+        {
+            for (int i = 0; i < data.Length; i++)
+            {
+                sum += data[i] ^ i;
+            }
+        }
+
+        s_sums[index] = sum;
+    }
+
+    // No loops; the result is used after the call so it can't become a tail call.
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long Recurse(int depth, long acc)
+    {
+        if (depth == 0)
+            return acc;
+
+        long result = Recurse(depth - 1, acc * 31 + depth);
+        return result ^ depth;
+    }
+
+    // Only the outer loop has a back edge, and it's taken once per RecursionDepth calls.
+    static void RecurseDeep(object state)
+    {
+        int index = (int)state;
+
+        long sum = 0;
+        while (!s_stop)
+        {
+            sum += Recurse(RecursionDepth, index);
+        }
+
+        s_sums[index] = sum;
+    }
+
+    static void Usage()
+    {
+        Console.WriteLine("Usage: SuspendLatency.exe <num collections> <num threads> <ms between collections> [loop|recursive|both]");
+    }
+
+    public static int Main(string[] args)
+    {
+        int collectionCount = 1000;
+        int threadCount = Math.Max(1, Environment.ProcessorCount - 1);
+        int intervalMs = 2;
+        string mutator = "both";
+
+        if (args.Length > 0)
+        {
+            if (((args.Length != 3) && (args.Length != 4)) ||
+                !int.TryParse(args[0], out collectionCount) ||
+                !int.TryParse(args[1], out threadCount) ||
+                !int.TryParse(args[2], out intervalMs) ||
+                (collectionCount <= 0) || (threadCount <= 0) || (intervalMs < 0))
+            {
+                Usage();
+                return 1;
+            }
+
+            if (args.Length == 4)
+            {
+                mutator = args[3];
+                if ((mutator != "loop") && (mutator != "recursive") && (mutator != "both"))
+                {
+                    Usage();
+                    return 1;
+                }
+            }
+        }
+
+        // With both mutators the threads alternate between them
+        s_sums = new long[threadCount];
+        Thread[] threads = new Thread[threadCount];
+        for (int i = 0; i < threads.Length; i++)
+        {
+            bool recursive = (mutator == "recursive") || ((mutator == "both") && (i % 2 == 1));
+            threads[i] = new Thread(recursive ? (ParameterizedThreadStart)RecurseDeep : Spin);
+            threads[i].Start(i);
+        }
+
+        // Let the spinners get into their loops
+        Thread.Sleep(100);
+
+        double[] pauses = new double[collectionCount];
+        Stopwatch stopwatch = new Stopwatch();
+        for (int i = 0; i < collectionCount; i++)
+        {
+            stopwatch.Restart();
+            GC.Collect(0);
+            stopwatch.Stop();
+            pauses[i] = stopwatch.Elapsed.TotalMilliseconds;
+
+            if (intervalMs > 0)
+            {
+                Thread.Sleep(intervalMs);
+            }
+        }
+
+        s_stop = true;
+        for (int i = 0; i < threads.Length; i++)
+        {
+            threads[i].Join();
+        }
+
+        Array.Sort(pauses);
+        double total = 0;
+        for (int i = 0; i < pauses.Length; i++)
+        {
+            total += pauses[i];
+        }
+
+        Console.WriteLine("{0} gen0 collections with {1} threads running the {2} mutator", collectionCount, threadCount, mutator);
+        Console.WriteLine("mean {0:F3} ms, p50 {1:F3} ms, p99 {2:F3} ms, p99.9 {3:F3} ms, max {4:F3} ms",
+            total / pauses.Length,
+            Percentile(pauses, 50.0),
+            Percentile(pauses, 99.0),
+            Percentile(pauses, 99.9),
+            pauses[pauses.Length - 1]);
+
+        return 100;
+    }
+
+    static double Percentile(double[] sorted, double percent)
+    {
+        int index = (int)Math.Ceiling(sorted.Length * percent / 100.0) - 1;
+        return sorted[Math.Max(0, Math.Min(index, sorted.Length - 1))];
+    }
+}
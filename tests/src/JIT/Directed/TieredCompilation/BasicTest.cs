@@ -0,0 +1,114 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Runs with COMPlus_TieredCompilation=1. Calls methods of the shapes that take
+// part in tiered compilation (static, virtual, generic, through a delegate) well
+// past the call count threshold, so that they run their tier-0 code, are rejitted
+// in the background and then run their tier-1 code, and checks that the results
+// do not change along the way.
+
+using System;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+class Base
+{
+    public virtual int Compute(int x)
+    {
+        return x + 1;
+    }
+}
+
+class Derived : Base
+{
+    public override int Compute(int x)
+    {
+        return base.Compute(x) * 2;
+    }
+}
+
+class BasicTest
+{
+    const int Iterations = 1000;
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int Sum(int[] values)
+    {
+        int sum = 0;
+        for (int i = 0; i < values.Length; i++)
+        {
+            sum += values[i];
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static T Pick<T>(bool first, T a, T b)
+    {
+        return first ? a : b;
+    }
+
+    static bool Run()
+    {
+        int[] values = new int[100];
+        for (int i = 0; i < values.Length; i++)
+        {
+            values[i] = i;
+        }
+
+        Base b = new Base();
+        Base d = new Derived();
+        Func<int, int> square = x => x * x;
+
+        for (int i = 0; i < Iterations; i++)
+        {
+            if (Sum(values) != 4950)
+            {
+                Console.WriteLine("FAIL: Sum, iteration {0}", i);
+                return false;
+            }
+
+            if (b.Compute(i) != i + 1 || d.Compute(i) != (i + 1) * 2)
+            {
+                Console.WriteLine("FAIL: Compute, iteration {0}", i);
+                return false;
+            }
+
+            if (Pick(true, i, -1) != i || Pick(false, "a", "b") != "b")
+            {
+                Console.WriteLine("FAIL: Pick, iteration {0}", i);
+                return false;
+            }
+
+            if (square(i) != i * i)
+            {
+                Console.WriteLine("FAIL: square, iteration {0}", i);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    public static int Main()
+    {
+        // The first round crosses the threshold, the second one runs once the
+        // background thread has had time to install the tier-1 code.
+        if (!Run())
+        {
+            return 101;
+        }
+
+        Thread.Sleep(500);
+
+        if (!Run())
+        {
+            return 102;
+        }
+
+        Console.WriteLine("PASS");
+        return 100;
+    }
+}
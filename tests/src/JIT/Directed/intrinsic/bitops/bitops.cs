@@ -0,0 +1,149 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Checks the BitOperations methods, which the jit expands to popcnt, lzcnt,
+// tzcnt, bswap, pdep and pext where the processor has them, against simple
+// loops over the bits.
+
+using System;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+internal class BitOps
+{
+    static int PopCountRef(ulong value)
+    {
+        int count = 0;
+        for (; value != 0; value >>= 1)
+        {
+            count += (int)(value & 1);
+        }
+        return count;
+    }
+
+    static int LeadingZeroCountRef(ulong value, int bits)
+    {
+        int count = 0;
+        for (int i = bits - 1; i >= 0 && ((value >> i) & 1) == 0; i--)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    static int TrailingZeroCountRef(ulong value, int bits)
+    {
+        int count = 0;
+        for (int i = 0; i < bits && ((value >> i) & 1) == 0; i++)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    static ulong ByteSwapRef(ulong value, int bytes)
+    {
+        ulong result = 0;
+        for (int i = 0; i < bytes; i++)
+        {
+            result = (result << 8) | ((value >> (8 * i)) & 0xFF);
+        }
+        return result;
+    }
+
+    static ulong DepositRef(ulong value, ulong mask)
+    {
+        ulong result = 0;
+        for (int i = 0; i < 64; i++)
+        {
+            if (((mask >> i) & 1) != 0)
+            {
+                result |= (value & 1) << i;
+                value >>= 1;
+            }
+        }
+        return result;
+    }
+
+    static ulong ExtractRef(ulong value, ulong mask)
+    {
+        ulong result = 0;
+        int k = 0;
+        for (int i = 0; i < 64; i++)
+        {
+            if (((mask >> i) & 1) != 0)
+            {
+                result |= ((value >> i) & 1) << k;
+                k++;
+            }
+        }
+        return result;
+    }
+
+    static bool Check(string name, ulong value, ulong mask, ulong actual, ulong expected)
+    {
+        if (actual != expected)
+        {
+            Console.WriteLine("value: 0x{0:X}, mask: 0x{1:X}, {2}: 0x{3:X}, expected: 0x{4:X}", value, mask, name, actual, expected);
+            return false;
+        }
+        return true;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool Test32(uint value, uint mask)
+    {
+        bool pass = true;
+        pass &= Check("PopCount32", value, mask, (ulong)BitOperations.PopCount(value), (ulong)PopCountRef(value));
+        pass &= Check("LeadingZeroCount32", value, mask, (ulong)BitOperations.LeadingZeroCount(value), (ulong)LeadingZeroCountRef(value, 32));
+        pass &= Check("TrailingZeroCount32", value, mask, (ulong)BitOperations.TrailingZeroCount(value), (ulong)TrailingZeroCountRef(value, 32));
+        pass &= Check("ByteSwap32", value, mask, BitOperations.ByteSwap(value), ByteSwapRef(value, 4));
+        pass &= Check("ParallelBitDeposit32", value, mask, BitOperations.ParallelBitDeposit(value, mask), DepositRef(value, mask));
+        pass &= Check("ParallelBitExtract32", value, mask, BitOperations.ParallelBitExtract(value, mask), ExtractRef(value, mask));
+        return pass;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool Test64(ulong value, ulong mask)
+    {
+        bool pass = true;
+        pass &= Check("PopCount64", value, mask, (ulong)BitOperations.PopCount(value), (ulong)PopCountRef(value));
+        pass &= Check("LeadingZeroCount64", value, mask, (ulong)BitOperations.LeadingZeroCount(value), (ulong)LeadingZeroCountRef(value, 64));
+        pass &= Check("TrailingZeroCount64", value, mask, (ulong)BitOperations.TrailingZeroCount(value), (ulong)TrailingZeroCountRef(value, 64));
+        pass &= Check("ByteSwap64", value, mask, BitOperations.ByteSwap(value), ByteSwapRef(value, 8));
+        pass &= Check("ParallelBitDeposit64", value, mask, BitOperations.ParallelBitDeposit(value, mask), DepositRef(value, mask));
+        pass &= Check("ParallelBitExtract64", value, mask, BitOperations.ParallelBitExtract(value, mask), ExtractRef(value, mask));
+        return pass;
+    }
+
+    public static int Main()
+    {
+        bool pass = true;
+
+        ulong[] values = { 0, 1, 0x80, 0xFF00, 0x12345678, 0x80000000, 0xFFFFFFFF,
+                           0x100000000, 0x8000000000000000, 0xFEDCBA9876543210, ulong.MaxValue };
+        ulong[] masks = { 0, 1, 0xF0F0F0F0F0F0F0F0, 0x5555555555555555, 0x8000000000000001, ulong.MaxValue };
+
+        foreach (ulong value in values)
+        {
+            foreach (ulong mask in masks)
+            {
+                pass &= Test32((uint)value, (uint)mask);
+                pass &= Test64(value, mask);
+            }
+        }
+
+        if (pass)
+        {
+            Console.WriteLine("PASSED");
+            return 100;
+        }
+        else
+        {
+            Console.WriteLine("FAILED");
+            return 1;
+        }
+    }
+}
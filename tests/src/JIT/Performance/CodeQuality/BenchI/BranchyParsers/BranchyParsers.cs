@@ -0,0 +1,205 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Runs with COMPlus_TieredCompilation=1 and COMPlus_TieredPGO=1. Parses and
+// classifies the characters of a generated text of "f0=12,f1=-3,..." records.
+// The parsers are all branches, most of which are taken rarely or never for
+// this input (signs, comments, malformed records), so the tier-1 code benefits
+// from the block counts of the tier-0 code.
+
+using Microsoft.Xunit.Performance;
+using System;
+using System.Runtime.CompilerServices;
+using System.Text;
+using Xunit;
+
+[assembly: OptimizeForBenchmarks]
+[assembly: MeasureInstructionsRetired]
+
+public static class BranchyParsers
+{
+
+#if DEBUG
+    public const int Iterations = 1;
+#else
+    public const int Iterations = 2000;
+#endif
+
+    const int Lines = 1000;
+    const int Fields = 4;
+
+    const int Letter = 0;
+    const int Digit = 1;
+    const int Punctuation = 2;
+    const int Sign = 3;
+    const int Newline = 4;
+    const int Other = 5;
+    const int Kinds = 6;
+
+    static string s_text;
+    static long s_expectedSum;
+    static int s_expectedRecords;
+    static int s_expectedLines;
+    static int s_expectedSigns;
+
+    static int ParseInt(string s, ref int pos) {
+        bool negative = false;
+        if (s[pos] == '-') {
+            negative = true;
+            pos++;
+        }
+        else if (s[pos] == '+') {
+            pos++;
+        }
+
+        int value = 0;
+        while (true) {
+            char c = s[pos];
+            if (c < '0' || c > '9') {
+                break;
+            }
+            value = value * 10 + (c - '0');
+            pos++;
+        }
+        return negative ? -value : value;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long ParseRecords(string text, out int records) {
+        long sum = 0;
+        int pos = 0;
+        records = 0;
+        while (pos < text.Length) {
+            if (text[pos] == '#') {
+                while (text[pos] != '\n') {
+                    pos++;
+                }
+                pos++;
+                continue;
+            }
+
+            while (text[pos] != '=') {
+                pos++;
+            }
+            pos++;
+            sum += ParseInt(text, ref pos);
+
+            char c = text[pos++];
+            if (c == '\n') {
+                records++;
+            }
+            else if (c != ',') {
+                return -1;
+            }
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void Classify(string text, int[] counts) {
+        for (int i = 0; i < text.Length; i++) {
+            char c = text[i];
+            if (c >= '0' && c <= '9') {
+                counts[Digit]++;
+            }
+            else if (c >= 'a' && c <= 'z') {
+                counts[Letter]++;
+            }
+            else {
+                switch (c) {
+                    case '=':
+                    case ',':
+                        counts[Punctuation]++;
+                        break;
+                    case '-':
+                    case '+':
+                        counts[Sign]++;
+                        break;
+                    case '\n':
+                        counts[Newline]++;
+                        break;
+                    default:
+                        counts[Other]++;
+                        break;
+                }
+            }
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool Bench() {
+        bool result = true;
+
+        int records;
+        result &= (ParseRecords(s_text, out records) == s_expectedSum);
+        result &= (records == s_expectedRecords);
+
+        int[] counts = new int[Kinds];
+        Classify(s_text, counts);
+        result &= (counts[Punctuation] == s_expectedRecords * (2 * Fields - 1));
+        result &= (counts[Sign] == s_expectedSigns);
+        result &= (counts[Newline] == s_expectedLines);
+
+        return result;
+    }
+
+    static void Setup() {
+        StringBuilder sb = new StringBuilder();
+        s_expectedSum = 0;
+        s_expectedRecords = 0;
+        s_expectedSigns = 0;
+        for (int i = 0; i < Lines; i++) {
+            if (i % 50 == 49) {
+                sb.Append("# comment\n");
+                continue;
+            }
+            for (int j = 0; j < Fields; j++) {
+                int value = (i * 7 + j * 13) % 1000;
+                if (i % 97 == 0 && value != 0) {
+                    value = -value;
+                    s_expectedSigns++;
+                }
+                if (j > 0) {
+                    sb.Append(',');
+                }
+                sb.Append('f');
+                sb.Append(j);
+                sb.Append('=');
+                sb.Append(value);
+                s_expectedSum += value;
+            }
+            sb.Append('\n');
+            s_expectedRecords++;
+        }
+        s_expectedLines = Lines;
+        s_text = sb.ToString();
+    }
+
+    [Benchmark]
+    public static void Test() {
+        Setup();
+        foreach (var iteration in Benchmark.Iterations) {
+            using (iteration.StartMeasurement()) {
+                for (int i = 0; i < Iterations; i++) {
+                    Bench();
+                }
+            }
+        }
+    }
+
+    static bool TestBase() {
+        Setup();
+        bool result = true;
+        for (int i = 0; i < Iterations; i++) {
+            result &= Bench();
+        }
+        return result;
+    }
+
+    public static int Main() {
+        bool result = TestBase();
+        return (result ? 100 : -1);
+    }
+}
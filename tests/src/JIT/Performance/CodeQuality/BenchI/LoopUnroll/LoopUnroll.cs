@@ -0,0 +1,149 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Tight array loops whose trip counts are only known at run time: sums and
+// copies bounded by the array length or by a parameter, and a linear search.
+// The lengths aren't multiples of the unrolling factors, so the remainder
+// loops run too.
+
+using Microsoft.Xunit.Performance;
+using System;
+using System.Runtime.CompilerServices;
+using Xunit;
+
+[assembly: OptimizeForBenchmarks]
+[assembly: MeasureInstructionsRetired]
+
+public static class LoopUnroll
+{
+
+#if DEBUG
+    public const int Iterations = 1;
+#else
+    public const int Iterations = 20000;
+#endif
+
+    const int Size = 1003;
+
+    static int[] s_ints;
+    static long[] s_longs;
+    static double[] s_doubles;
+    static int[] s_copy;
+
+    static long s_expectedIntSum;
+    static long s_expectedLongSum;
+    static long s_expectedHalfLongSum;
+    static double s_expectedDoubleSum;
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long SumInts(int[] a) {
+        long sum = 0;
+        for (int i = 0; i < a.Length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long SumLongs(long[] a, int n) {
+        long sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static double SumDoubles(double[] a) {
+        double sum = 0;
+        for (int i = 0; i < a.Length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void Copy(int[] src, int[] dst, int n) {
+        for (int i = 0; i < n; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int Search(int[] a, int value) {
+        for (int i = 0; i < a.Length; i++) {
+            if (a[i] == value) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool Bench() {
+        bool result = true;
+
+        result &= (SumInts(s_ints) == s_expectedIntSum);
+        result &= (SumLongs(s_longs, Size) == s_expectedLongSum);
+        result &= (SumLongs(s_longs, Size / 2) == s_expectedHalfLongSum);
+        result &= (SumDoubles(s_doubles) == s_expectedDoubleSum);
+
+        Copy(s_ints, s_copy, Size);
+        result &= (s_copy[0] == s_ints[0]) && (s_copy[Size - 1] == s_ints[Size - 1]);
+
+        result &= (Search(s_ints, s_ints[Size - 1]) == Size - 1);
+        result &= (Search(s_ints, -1) == -1);
+
+        return result;
+    }
+
+    static void Setup() {
+        s_ints = new int[Size];
+        s_longs = new long[Size];
+        s_doubles = new double[Size];
+        s_copy = new int[Size];
+        s_expectedIntSum = 0;
+        s_expectedLongSum = 0;
+        s_expectedHalfLongSum = 0;
+        s_expectedDoubleSum = 0;
+        for (int i = 0; i < Size; i++) {
+            s_ints[i] = i * 7 + 3;
+            s_longs[i] = 2 * i;
+            s_doubles[i] = i * 0.5;
+            s_expectedIntSum += s_ints[i];
+            s_expectedLongSum += s_longs[i];
+            if (i < Size / 2) {
+                s_expectedHalfLongSum += s_longs[i];
+            }
+            s_expectedDoubleSum += s_doubles[i];
+        }
+    }
+
+    [Benchmark]
+    public static void Test() {
+        Setup();
+        foreach (var iteration in Benchmark.Iterations) {
+            using (iteration.StartMeasurement()) {
+                for (int i = 0; i < Iterations; i++) {
+                    Bench();
+                }
+            }
+        }
+    }
+
+    static bool TestBase() {
+        Setup();
+        bool result = true;
+        for (int i = 0; i < Iterations; i++) {
+            result &= Bench();
+        }
+        return result;
+    }
+
+    public static int Main() {
+        bool result = TestBase();
+        return (result ? 100 : -1);
+    }
+}
@@ -0,0 +1,136 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Hot loops inside try regions, whose induction variables and accumulators
+// are live into the handlers or after them, so the jit has to keep their
+// stack homes up to date while it runs the loops in registers.
+
+using Microsoft.Xunit.Performance;
+using System;
+using System.Runtime.CompilerServices;
+using Xunit;
+
+[assembly: OptimizeForBenchmarks]
+[assembly: MeasureInstructionsRetired]
+
+public static class TryFinallyLoops
+{
+
+#if DEBUG
+    public const int Iterations = 1;
+#else
+    public const int Iterations = 20000;
+#endif
+
+    const int Size = 1000;
+
+    static int[] s_array;
+    static int s_last;
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int SumInTryFinally(int[] a) {
+        int sum = 0;
+        int i = 0;
+        try {
+            for (i = 0; i < a.Length; i++) {
+                sum += a[i];
+            }
+        }
+        finally {
+            s_last = i;
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long CountInTryCatch(int n) {
+        long total = 0;
+        int count = 0;
+        try {
+            for (int i = 0; i < n; i++) {
+                total += i * 3;
+                count++;
+            }
+            if (count == n) {
+                throw new InvalidOperationException();
+            }
+        }
+        catch (InvalidOperationException) {
+            total += count;
+        }
+        return total;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int NestedTryFinally(int[] a) {
+        int sum = 0;
+        int j = 0;
+        try {
+            try {
+                for (j = 0; j < a.Length; j += 2) {
+                    sum += a[j];
+                }
+            }
+            finally {
+                s_last = j;
+            }
+            for (j = 1; j < a.Length; j += 2) {
+                sum -= a[j];
+            }
+        }
+        finally {
+            s_last += j;
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static bool Bench() {
+        bool result = true;
+
+        result &= (SumInTryFinally(s_array) == Size * (Size - 1) / 2);
+        result &= (s_last == Size);
+
+        result &= (CountInTryCatch(Size) == 3L * Size * (Size - 1) / 2 + Size);
+
+        result &= (NestedTryFinally(s_array) == -(Size / 2));
+        result &= (s_last == 2 * Size + 1);
+
+        return result;
+    }
+
+    static void Setup() {
+        s_array = new int[Size];
+        for (int i = 0; i < Size; i++) {
+            s_array[i] = i;
+        }
+    }
+
+    [Benchmark]
+    public static void Test() {
+        Setup();
+        foreach (var iteration in Benchmark.Iterations) {
+            using (iteration.StartMeasurement()) {
+                for (int i = 0; i < Iterations; i++) {
+                    Bench();
+                }
+            }
+        }
+    }
+
+    static bool TestBase() {
+        Setup();
+        bool result = true;
+        for (int i = 0; i < Iterations; i++) {
+            result &= Bench();
+        }
+        return result;
+    }
+
+    public static int Main() {
+        bool result = TestBase();
+        return (result ? 100 : -1);
+    }
+}
@@ -0,0 +1,232 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Element-wise Vector<T> operations over arrays, for every element type: the
+// multiplication (which SSE2 and AVX2 only have for some of the widths, the
+// others are emulated), the conditional select of the greater elements, and
+// the dot product of float and double vectors.
+
+using Microsoft.Xunit.Performance;
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using Xunit;
+
+[assembly: OptimizeForBenchmarks]
+[assembly: MeasureInstructionsRetired]
+
+public static class VectorOps
+{
+
+#if DEBUG
+    public const int Iterations = 1;
+#else
+    public const int Iterations = 2000;
+#endif
+
+    const int Size = 4096;
+
+    static int A(int i) {
+        return i * 37 + 11;
+    }
+
+    static int B(int i) {
+        return i * 91 + 5;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void Multiply<T>(T[] a, T[] b, T[] c) where T : struct {
+        for (int i = 0; i < a.Length; i += Vector<T>.Count) {
+            (new Vector<T>(a, i) * new Vector<T>(b, i)).CopyTo(c, i);
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void SelectGreater<T>(T[] a, T[] b, T[] c) where T : struct {
+        for (int i = 0; i < a.Length; i += Vector<T>.Count) {
+            Vector<T> va = new Vector<T>(a, i);
+            Vector<T> vb = new Vector<T>(b, i);
+            Vector.ConditionalSelect(Vector.GreaterThan(va, vb), va, vb).CopyTo(c, i);
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static T Dot<T>(T[] a, T[] b) where T : struct {
+        Vector<T> sum = Vector<T>.Zero;
+        for (int i = 0; i < a.Length; i += Vector<T>.Count) {
+            sum += new Vector<T>(a, i) * new Vector<T>(b, i);
+        }
+        return Vector.Dot(sum, Vector<T>.One);
+    }
+
+    // The arrays and expected results of the operations on one element type.
+    sealed class Ops<T> where T : struct
+    {
+        T[] _a = new T[Size];
+        T[] _b = new T[Size];
+        T[] _product = new T[Size];
+        T[] _greater = new T[Size];
+        T[] _c = new T[Size];
+
+        public Ops(Func<int, T> a, Func<int, T> b, Func<int, T> product, Func<int, T> greater) {
+            for (int i = 0; i < Size; i++) {
+                _a[i] = a(i);
+                _b[i] = b(i);
+                _product[i] = product(i);
+                _greater[i] = greater(i);
+            }
+        }
+
+        public void Multiply() {
+            VectorOps.Multiply(_a, _b, _c);
+        }
+
+        public void SelectGreater() {
+            VectorOps.SelectGreater(_a, _b, _c);
+        }
+
+        public T Dot() {
+            return VectorOps.Dot(_a, _b);
+        }
+
+        static bool Check(T[] actual, T[] expected) {
+            for (int i = 0; i < Size; i++) {
+                if (!EqualityComparer<T>.Default.Equals(actual[i], expected[i])) {
+                    Console.WriteLine("{0}[{1}] = {2}, expected {3}", typeof(T).Name, i, actual[i], expected[i]);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        public bool Verify() {
+            bool result = true;
+            VectorOps.Multiply(_a, _b, _c);
+            result &= Check(_c, _product);
+            VectorOps.SelectGreater(_a, _b, _c);
+            result &= Check(_c, _greater);
+            return result;
+        }
+    }
+
+    static Ops<byte> s_byte;
+    static Ops<sbyte> s_sbyte;
+    static Ops<ushort> s_ushort;
+    static Ops<short> s_short;
+    static Ops<uint> s_uint;
+    static Ops<int> s_int;
+    static Ops<ulong> s_ulong;
+    static Ops<long> s_long;
+    static Ops<float> s_float;
+    static Ops<double> s_double;
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static void Bench() {
+        s_byte.Multiply();
+        s_sbyte.Multiply();
+        s_ushort.Multiply();
+        s_short.Multiply();
+        s_uint.Multiply();
+        s_int.Multiply();
+        s_ulong.Multiply();
+        s_long.Multiply();
+        s_float.Multiply();
+        s_double.Multiply();
+
+        s_byte.SelectGreater();
+        s_sbyte.SelectGreater();
+        s_ushort.SelectGreater();
+        s_short.SelectGreater();
+        s_uint.SelectGreater();
+        s_int.SelectGreater();
+        s_ulong.SelectGreater();
+        s_long.SelectGreater();
+        s_float.SelectGreater();
+        s_double.SelectGreater();
+
+        s_float.Dot();
+        s_double.Dot();
+    }
+
+    static bool Verify() {
+        bool result = true;
+        result &= s_byte.Verify();
+        result &= s_sbyte.Verify();
+        result &= s_ushort.Verify();
+        result &= s_short.Verify();
+        result &= s_uint.Verify();
+        result &= s_int.Verify();
+        result &= s_ulong.Verify();
+        result &= s_long.Verify();
+        result &= s_float.Verify();
+        result &= s_double.Verify();
+
+        // The elements are small integers, so the sums are exact in any order.
+        float floatDot = 0;
+        double doubleDot = 0;
+        for (int i = 0; i < Size; i++) {
+            floatDot += (float)(A(i) % 64) * (float)(B(i) % 64);
+            doubleDot += (double)(A(i) % 64) * (double)(B(i) % 64);
+        }
+        result &= (s_float.Dot() == floatDot);
+        result &= (s_double.Dot() == doubleDot);
+
+        return result;
+    }
+
+    static void Setup() {
+        // The 64-bit elements have bits set in both halves, so that every partial
+        // product of the emulated multiplication contributes to the results.
+        s_byte = new Ops<byte>(i => (byte)A(i), i => (byte)B(i),
+                               i => (byte)(A(i) * B(i)), i => Math.Max((byte)A(i), (byte)B(i)));
+        s_sbyte = new Ops<sbyte>(i => (sbyte)A(i), i => (sbyte)B(i),
+                                 i => (sbyte)(A(i) * B(i)), i => Math.Max((sbyte)A(i), (sbyte)B(i)));
+        s_ushort = new Ops<ushort>(i => (ushort)A(i), i => (ushort)B(i),
+                                   i => (ushort)(A(i) * B(i)), i => Math.Max((ushort)A(i), (ushort)B(i)));
+        s_short = new Ops<short>(i => (short)A(i), i => (short)B(i),
+                                 i => (short)(A(i) * B(i)), i => Math.Max((short)A(i), (short)B(i)));
+        s_uint = new Ops<uint>(i => (uint)A(i) * 40503u, i => (uint)B(i) * 2654435761u,
+                               i => (uint)A(i) * 40503u * ((uint)B(i) * 2654435761u),
+                               i => Math.Max((uint)A(i) * 40503u, (uint)B(i) * 2654435761u));
+        s_int = new Ops<int>(i => A(i) - 1000, i => B(i) - 100000,
+                             i => (A(i) - 1000) * (B(i) - 100000), i => Math.Max(A(i) - 1000, B(i) - 100000));
+        s_ulong = new Ops<ulong>(i => (ulong)A(i) * 0x9E3779B97F4A7C15UL, i => (ulong)B(i) << 35 | (ulong)A(i),
+                                 i => (ulong)A(i) * 0x9E3779B97F4A7C15UL * ((ulong)B(i) << 35 | (ulong)A(i)),
+                                 i => Math.Max((ulong)A(i) * 0x9E3779B97F4A7C15UL, (ulong)B(i) << 35 | (ulong)A(i)));
+        s_long = new Ops<long>(i => (long)A(i) << 33 | (long)B(i), i => -(long)B(i) * 0x10001L,
+                               i => ((long)A(i) << 33 | (long)B(i)) * (-(long)B(i) * 0x10001L),
+                               i => Math.Max((long)A(i) << 33 | (long)B(i), -(long)B(i) * 0x10001L));
+        s_float = new Ops<float>(i => (float)(A(i) % 64), i => (float)(B(i) % 64),
+                                 i => (float)(A(i) % 64) * (float)(B(i) % 64), i => (float)Math.Max(A(i) % 64, B(i) % 64));
+        s_double = new Ops<double>(i => (double)(A(i) % 64), i => (double)(B(i) % 64),
+                                   i => (double)(A(i) % 64) * (double)(B(i) % 64), i => (double)Math.Max(A(i) % 64, B(i) % 64));
+    }
+
+    [Benchmark]
+    public static void Test() {
+        Setup();
+        foreach (var iteration in Benchmark.Iterations) {
+            using (iteration.StartMeasurement()) {
+                for (int i = 0; i < Iterations; i++) {
+                    Bench();
+                }
+            }
+        }
+    }
+
+    static bool TestBase() {
+        Setup();
+        for (int i = 0; i < Iterations; i++) {
+            Bench();
+        }
+        return Verify();
+    }
+
+    public static int Main() {
+        bool result = TestBase();
+        return (result ? 100 : -1);
+    }
+}
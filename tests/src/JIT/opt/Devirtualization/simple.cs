@@ -0,0 +1,145 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Virtual and interface calls on objects whose class the jit can work out:
+// a newobj in the same method, a local stored to once, a sealed class and a
+// final override. Also calls it must leave virtual: a local stored to more
+// than once and an interface call on a class that isn't sealed. Checks that
+// each call still reaches the right method, and that null receivers throw.
+
+using System;
+using System.Runtime.CompilerServices;
+
+interface IValue
+{
+    int GetValue();
+}
+
+class B : IValue
+{
+    public virtual int GetValue() { return 1; }
+    public virtual int Other() { return 10; }
+}
+
+class D : B
+{
+    public override int GetValue() { return 2; }
+    public sealed override int Other() { return 20; }
+}
+
+sealed class E : D
+{
+    public override int GetValue() { return 3; }
+}
+
+class F : D
+{
+    public override int GetValue() { return 4; }
+}
+
+// Re-implements the interface on top of a final override
+class G : D, IValue
+{
+    int IValue.GetValue() { return 5; }
+}
+
+class Test
+{
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static B MakeB(int kind)
+    {
+        switch (kind)
+        {
+            case 0: return new B();
+            case 1: return new D();
+            case 2: return new E();
+            default: return new F();
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int FromSealed(E e)
+    {
+        return e.GetValue();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int FromFinalOverride(D d)
+    {
+        return d.Other();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int FromInterfaceOnD(D d)
+    {
+        return ((IValue)d).GetValue();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int FromMultipleStores(int kind)
+    {
+        B b = new B();
+        if (kind != 0)
+        {
+            b = MakeB(kind);
+        }
+        return b.GetValue();
+    }
+
+    static bool Check(string what, int actual, int expected)
+    {
+        if (actual != expected)
+        {
+            Console.WriteLine("FAIL: {0}: got {1}, expected {2}", what, actual, expected);
+            return false;
+        }
+        return true;
+    }
+
+    public static int Main()
+    {
+        bool ok = true;
+
+        ok &= Check("newobj", new D().GetValue(), 2);
+        ok &= Check("newobj interface", ((IValue)new E()).GetValue(), 3);
+
+        B single = new F();
+        ok &= Check("single store", single.GetValue(), 4);
+
+        ok &= Check("sealed", FromSealed(new E()), 3);
+        ok &= Check("final override", FromFinalOverride(new F()), 20);
+        ok &= Check("interface on non-sealed", FromInterfaceOnD(new G()), 5);
+        ok &= Check("multiple stores 0", FromMultipleStores(0), 1);
+        ok &= Check("multiple stores 2", FromMultipleStores(2), 3);
+
+        try
+        {
+            FromSealed(null);
+            Console.WriteLine("FAIL: no exception for a null sealed receiver");
+            ok = false;
+        }
+        catch (NullReferenceException)
+        {
+        }
+
+        try
+        {
+            FromFinalOverride(null);
+            Console.WriteLine("FAIL: no exception for a null final override receiver");
+            ok = false;
+        }
+        catch (NullReferenceException)
+        {
+        }
+
+        if (!ok)
+        {
+            return 101;
+        }
+
+        Console.WriteLine("PASS");
+        return 100;
+    }
+}
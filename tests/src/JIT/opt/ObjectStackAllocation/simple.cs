@@ -0,0 +1,191 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+//
+
+// Objects the jit can allocate on the stack: small objects without GC
+// references that are only used through their fields, in straight-line code,
+// in a loop, after being copied to another local, and copied to another local
+// inside a loop that doesn't use it in the next iteration. Also objects it
+// must leave on the heap: returned, stored to a static, passed to a method
+// that isn't inlined, and copied to a local inside a loop that still refers to
+// it when the next one is allocated. Checks that the results are the same
+// either way, and that the loops that allocate on the stack don't collect.
+
+using System;
+using System.Runtime.CompilerServices;
+
+class Point
+{
+    public int X;
+    public int Y;
+
+    public Point(int x, int y)
+    {
+        X = x;
+        Y = y;
+    }
+
+    public int Sum()
+    {
+        return X + Y;
+    }
+}
+
+class Accumulator
+{
+    public long Total;
+    public int Count;
+
+    public void Add(int value)
+    {
+        Total += value;
+        Count++;
+    }
+}
+
+class Test
+{
+    static Point s_point;
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int Consume(Point p)
+    {
+        return p.X * p.Y;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int Local(int x, int y)
+    {
+        Point p = new Point(x, y);
+        return p.Sum();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long InLoop(int n)
+    {
+        long total = 0;
+        for (int i = 0; i < n; i++)
+        {
+            Accumulator a = new Accumulator();
+            a.Add(i);
+            a.Add(i);
+            total += a.Total + a.Count;
+        }
+        return total;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static long CopiedInLoopNotLive(int n)
+    {
+        // "copy" is assigned before it is used in every iteration, so it never
+        // refers to the object of an earlier one
+        long total = 0;
+        for (int i = 0; i < n; i++)
+        {
+            Point p = new Point(i, i + 1);
+            Point copy = p;
+            total += copy.Sum() - p.Y;
+        }
+        return total;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int Copied(bool first)
+    {
+        Point a = new Point(1, 2);
+        Point b = new Point(3, 4);
+        Point c = first ? a : b;
+        c.X += 10;
+        return a.Sum() * 100 + b.Sum() * 10 + c.X;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int CopiedInLoop(int n)
+    {
+        // "previous" still refers to the object of the last iteration when the
+        // next one is allocated, so the objects can't share a stack slot
+        Point previous = new Point(0, 0);
+        int sum = 0;
+        for (int i = 1; i <= n; i++)
+        {
+            Point current = new Point(i, i);
+            sum += previous.X + current.Y;
+            previous = current;
+        }
+        return sum;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static Point Returned(int x)
+    {
+        Point p = new Point(x, x);
+        return p;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int StoredToStatic(int x)
+    {
+        Point p = new Point(x, 1);
+        s_point = p;
+        return p.Sum();
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    static int PassedToCall(int x)
+    {
+        Point p = new Point(x, 3);
+        return Consume(p);
+    }
+
+    // Enough iterations to fill gen0 many times over if the objects of the
+    // loops were allocated on the heap
+    const int LoopCount = 10000000;
+
+    static bool Check(string what, long actual, long expected)
+    {
+        if (actual != expected)
+        {
+            Console.WriteLine("FAIL: {0}: got {1}, expected {2}", what, actual, expected);
+            return false;
+        }
+        return true;
+    }
+
+    public static int Main()
+    {
+        bool ok = true;
+
+        ok &= Check("local", Local(3, 4), 7);
+        ok &= Check("in loop", InLoop(100), 2 * 4950 + 200);
+
+        int collections = GC.CollectionCount(0);
+        ok &= Check("in loop", InLoop(LoopCount), (long)LoopCount * (LoopCount + 1));
+        ok &= Check("in loop collections", GC.CollectionCount(0) - collections, 0);
+
+        collections = GC.CollectionCount(0);
+        ok &= Check("copied in loop, not live", CopiedInLoopNotLive(LoopCount), (long)LoopCount * (LoopCount - 1) / 2);
+        ok &= Check("copied in loop, not live collections", GC.CollectionCount(0) - collections, 0);
+        ok &= Check("copied first", Copied(true), 13 * 100 + 7 * 10 + 11);
+        ok &= Check("copied second", Copied(false), 3 * 100 + 17 * 10 + 13);
+        ok &= Check("copied in loop", CopiedInLoop(10), 45 + 55);
+
+        Point r = Returned(5);
+        GC.Collect();
+        ok &= Check("returned", r.Sum(), 10);
+
+        ok &= Check("stored to static", StoredToStatic(6), 7);
+        GC.Collect();
+        ok &= Check("static", s_point.Sum(), 7);
+
+        ok &= Check("passed to call", PassedToCall(5), 15);
+
+        if (!ok)
+        {
+            return 101;
+        }
+
+        Console.WriteLine("PASS");
+        return 100;
+    }
+}
@@ -0,0 +1,204 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+// Tests that the arena a thread allocates from flows with the ExecutionContext
+// into Task.Run, await continuations and ThreadPool.QueueUserWorkItem callbacks,
+// that it doesn't flow once the arena scope has ended or through
+// UnsafeQueueUserWorkItem, and that capturing outside of any arena still hands out
+// the default context.
+
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+
+public class ArenaFlowTest
+{
+    private const int GCHeapId = -1;
+
+    private static int s_numTests = 0;
+
+    private static int OnThreadPool(bool flow)
+    {
+        int id = int.MinValue;
+        using (ManualResetEvent done = new ManualResetEvent(false))
+        {
+            WaitCallback callback = state => { id = GC.GetCurrentArenaId(); done.Set(); };
+            if (flow)
+                ThreadPool.QueueUserWorkItem(callback);
+            else
+                ThreadPool.UnsafeQueueUserWorkItem(callback, null);
+            done.WaitOne();
+        }
+        return id;
+    }
+
+    private static async Task<int> AfterAwait()
+    {
+        await Task.Yield();
+        return GC.GetCurrentArenaId();
+    }
+
+    private static bool Check(string what, int actual, int expected)
+    {
+        if (actual == expected)
+            return true;
+
+        Console.WriteLine("{0}: arena {1}, expected {2}", what, actual, expected);
+        return false;
+    }
+
+
+    private bool flowTest()
+    {
+        s_numTests++;
+
+        GC.PushNewArena();
+        int arena = GC.GetCurrentArenaId();
+        bool passed = arena != GCHeapId;
+        if (!passed)
+            Console.WriteLine("Could not push an arena");
+
+        passed &= Check("Task.Run", Task.Run(() => GC.GetCurrentArenaId()).Result, arena);
+        passed &= Check("await", AfterAwait().Result, arena);
+        passed &= Check("QueueUserWorkItem", OnThreadPool(true), arena);
+        passed &= Check("UnsafeQueueUserWorkItem", OnThreadPool(false), GCHeapId);
+
+        GC.PopArena();
+        passed &= Check("PopArena", GC.GetCurrentArenaId(), GCHeapId);
+
+        Console.WriteLine(passed ? "flowTest Passed!" : "flowTest Failed!");
+        return passed;
+    }
+
+
+    private bool noFlowTest()
+    {
+        s_numTests++;
+
+        bool passed = Check("Task.Run", Task.Run(() => GC.GetCurrentArenaId()).Result, GCHeapId);
+        passed &= Check("await", AfterAwait().Result, GCHeapId);
+        passed &= Check("QueueUserWorkItem", OnThreadPool(true), GCHeapId);
+
+        Console.WriteLine(passed ? "noFlowTest Passed!" : "noFlowTest Failed!");
+        return passed;
+    }
+
+
+    private bool gcHeapInArenaTest()
+    {
+        s_numTests++;
+
+        // A context captured with the GC heap pushed on top of an arena doesn't
+        // take the callback out of the arena it runs in.
+        GC.PushNewArena();
+        int arena = GC.GetCurrentArenaId();
+        GC.PushGCHeap();
+        Task<int> task = new Task<int>(() => GC.GetCurrentArenaId());
+        GC.PopArena();
+        task.RunSynchronously();
+        bool passed = Check("PushGCHeap", task.Result, arena);
+        GC.PopArena();
+
+        Console.WriteLine(passed ? "gcHeapInArenaTest Passed!" : "gcHeapInArenaTest Failed!");
+        return passed;
+    }
+
+
+    private bool defaultContextTest()
+    {
+        s_numTests++;
+
+        ExecutionContext outside = ExecutionContext.Capture();
+
+        GC.PushNewArena();
+        ExecutionContext inside = ExecutionContext.Capture();
+        GC.PopArena();
+
+        if (inside == outside)
+        {
+            Console.WriteLine("Capture in an arena returned the context captured outside of it");
+            Console.WriteLine("defaultContextTest Failed!");
+            return false;
+        }
+
+        if (ExecutionContext.Capture() != outside)
+        {
+            Console.WriteLine("Capture after the arena scope didn't return the default context");
+            Console.WriteLine("defaultContextTest Failed!");
+            return false;
+        }
+
+        Console.WriteLine("defaultContextTest Passed!");
+        return true;
+    }
+
+
+    private bool contextOutlivesArenaTest()
+    {
+        s_numTests++;
+
+        // The captured context is cached by the thread and stored in Tasks, so it
+        // must still be usable once its arena is gone; running it then allocates
+        // from the GC heap.
+        GC.PushNewArena();
+        ExecutionContext inside = ExecutionContext.Capture();
+        GC.PopArena();
+
+        GC.Collect();
+        GC.WaitForPendingFinalizers();
+
+        int id = int.MinValue;
+        ExecutionContext.Run(inside, state => { id = GC.GetCurrentArenaId(); }, null);
+        bool passed = Check("Run", id, GCHeapId);
+        passed &= Check("after Run", GC.GetCurrentArenaId(), GCHeapId);
+
+        Console.WriteLine(passed ? "contextOutlivesArenaTest Passed!" : "contextOutlivesArenaTest Failed!");
+        return passed;
+    }
+
+
+    public bool RunTests()
+    {
+        int numPassed = 0;
+
+        if (flowTest())
+            numPassed++;
+
+        if (noFlowTest())
+            numPassed++;
+
+        if (gcHeapInArenaTest())
+            numPassed++;
+
+        if (defaultContextTest())
+            numPassed++;
+
+        if (contextOutlivesArenaTest())
+            numPassed++;
+
+
+        Console.WriteLine();
+        if (s_numTests == numPassed)
+            return true;
+
+        return false;
+    }
+
+
+
+    public static int Main()
+    {
+        ArenaFlowTest t = new ArenaFlowTest();
+
+        if (t.RunTests())
+        {
+            Console.WriteLine("Test for arena flow passed!");
+            return 100;
+        }
+
+
+        Console.WriteLine("Test for arena flow FAILED!");
+        return 1;
+    }
+}